@@ -263,6 +263,30 @@ MIOPEN_EXPORT miopenStatus_t miopenGetKernelTime(miopenHandle_t handle, float* t
  * @return           miopenStatus_t
  */
 MIOPEN_EXPORT miopenStatus_t miopenEnableProfiling(miopenHandle_t handle, bool enable);
+
+#ifdef MIOPEN_BETA_API
+/*! @struct miopenKernelCacheStats_t
+ * @brief Kernel cache activity of the calling process
+ */
+typedef struct
+{
+    size_t hits;         /*!< Kernels loaded from the cache */
+    size_t misses;       /*!< Kernels looked up but not found in the cache */
+    size_t loaded_bytes; /*!< Size of the loaded kernels in bytes */
+    size_t saved;        /*!< Kernels saved to the cache */
+    size_t saved_bytes;  /*!< Size of the saved kernels in bytes */
+    size_t evicted;      /*!< Kernels evicted from the user cache to keep it within its limit */
+} miopenKernelCacheStats_t;
+
+/*! @brief Get the kernel cache activity of the calling process
+ *
+ * The counts cover all handles of the process since it started. They are not stored in the
+ * cache, so other processes using the same cache are not included.
+ * @param stats      Pointer to the kernel cache statistics (output)
+ * @return           miopenStatus_t
+ */
+MIOPEN_EXPORT miopenStatus_t miopenGetKernelCacheStats(miopenKernelCacheStats_t* stats);
+#endif
 /** @} */
 // CLOSEOUT HANDLE DOXYGEN GROUP
 
@@ -0,0 +1,96 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/handle.hpp>
+#include <miopen/miopen.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Host overhead of the immediate mode solution queries for one convolution, with the solver
+// predicates memoized in the handle and evaluated on every call. Meant for the nogpu backend,
+// where only the host side runs. Set MIOPEN_DEBUG_PARALLEL_APPLICABILITY=1 to compare the first
+// call and the uncached ones with the solvers evaluated on the thread pool.
+// Usage: speedtest_conv_applicability [calls]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void Check(miopenStatus_t status)
+{
+    if(status != miopenStatusSuccess)
+    {
+        std::cerr << "MIOpen call failed: " << status << std::endl;
+        std::exit(1); // NOLINT (concurrency-mt-unsafe)
+    }
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    const auto calls = argc > 1 ? std::stoi(argv[1]) : 1000;
+
+    miopenHandle_t handle;
+    miopenTensorDescriptor_t x, w, y;
+    miopenConvolutionDescriptor_t conv;
+    Check(miopenCreate(&handle));
+    Check(miopenCreateTensorDescriptor(&x));
+    Check(miopenCreateTensorDescriptor(&w));
+    Check(miopenCreateTensorDescriptor(&y));
+    Check(miopenCreateConvolutionDescriptor(&conv));
+    Check(miopenSet4dTensorDescriptor(x, miopenFloat, 64, 256, 56, 56));
+    Check(miopenSet4dTensorDescriptor(w, miopenFloat, 256, 256, 3, 3));
+    Check(miopenInitConvolutionDescriptor(conv, miopenConvolution, 1, 1, 1, 1, 1, 1));
+    int n, c, h, wd;
+    Check(miopenGetConvolutionForwardOutputDim(conv, x, w, &n, &c, &h, &wd));
+    Check(miopenSet4dTensorDescriptor(y, miopenFloat, n, c, h, wd));
+
+    auto solutions = std::vector<miopenConvSolution_t>(10);
+    auto count     = std::size_t{0};
+    const auto query = [&]() {
+        Check(miopenConvolutionForwardGetSolution(
+            handle, w, x, conv, y, solutions.size(), &count, solutions.data()));
+        for(auto i = std::size_t{0}; i < count; ++i)
+        {
+            auto ws = std::size_t{0};
+            Check(miopenConvolutionForwardGetSolutionWorkspaceSize(
+                handle, w, x, conv, y, solutions[i].solution_id, &ws));
+        }
+    };
+
+    auto& cache = miopen::deref(handle).GetApplicabilityCache();
+
+    const auto first_start = Clock::now();
+    query();
+    const auto first_time = Clock::now() - first_start;
+
+    const auto memoized_start = Clock::now();
+    for(auto i = 0; i < calls; ++i)
+        query();
+    const auto memoized_time = Clock::now() - memoized_start;
+
+    const auto evaluated_start = Clock::now();
+    for(auto i = 0; i < calls; ++i)
+    {
+        cache.Clear();
+        query();
+    }
+    const auto evaluated_time = Clock::now() - evaluated_start;
+
+    const auto us = [&](auto time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() / 1000.0;
+    };
+    std::cout << count << " solutions, first call " << us(first_time) << " us, memoized "
+              << us(memoized_time) / calls << " us, evaluated on every call "
+              << us(evaluated_time) / calls << " us" << std::endl;
+
+    Check(miopenDestroyConvolutionDescriptor(conv));
+    Check(miopenDestroyTensorDescriptor(y));
+    Check(miopenDestroyTensorDescriptor(w));
+    Check(miopenDestroyTensorDescriptor(x));
+    Check(miopenDestroy(handle));
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/find_db_index.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// How often the nearest find-db records predict the fastest solver of a problem. Records of
+// the db are looked up leave-one-out; as there is no GPU to check applicability, picks are
+// limited to the solvers the record itself has. The baseline picks the solver which wins most
+// often among the other records of the same category.
+// Usage: speedtest_find_db_nearest <db.fdb.txt> [max_queries]
+
+namespace {
+
+using Record = miopen::FindDbIndex::Record;
+
+struct Score
+{
+    std::string name;
+    std::size_t answered = 0;
+    std::size_t best     = 0;
+    std::size_t close    = 0; // within 10% of the fastest
+    double slowdown      = 0;
+
+    void Add(const Record& record, std::uint32_t pick)
+    {
+        const auto& entries = record.entries;
+        const auto it       = std::find_if(
+            entries.begin(), entries.end(), [&](auto entry) { return entry.solver == pick; });
+        const auto ratio = it->time / std::max(entries[0].time, 1e-6f);
+        ++answered;
+        best += it == entries.begin() ? 1 : 0;
+        close += ratio <= 1.1f ? 1 : 0;
+        slowdown += ratio;
+    }
+
+    void Print(std::size_t total) const
+    {
+        const auto percent = [&](std::size_t n) {
+            return 100.0 * n / std::max<std::size_t>(total, 1);
+        };
+        std::cout << std::setw(10) << name << std::fixed << std::setprecision(1) << std::setw(10)
+                  << percent(answered) << '%' << std::setw(10) << percent(best) << '%'
+                  << std::setw(10) << percent(close) << '%' << std::setprecision(2)
+                  << std::setw(10) << slowdown / std::max<std::size_t>(answered, 1) << 'x'
+                  << std::endl;
+    }
+};
+
+bool Has(const Record& record, std::uint32_t solver)
+{
+    return std::any_of(record.entries.begin(), record.entries.end(), [&](auto entry) {
+        return entry.solver == solver;
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <db.fdb.txt> [max_queries]" << std::endl;
+        return 1;
+    }
+
+    const auto max_queries = std::max(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000ul, 1ul);
+
+    auto index      = miopen::FindDbIndex{};
+    auto keys       = std::vector<std::string>{};
+    const auto load = std::chrono::steady_clock::now();
+    {
+        auto file = std::ifstream{argv[1]};
+        auto line = std::string{};
+        while(std::getline(file, line))
+        {
+            const auto pos = line.find('=');
+            if(pos != std::string::npos && index.Add(line.substr(0, pos), line.substr(pos + 1)))
+                keys.push_back(line.substr(0, pos));
+        }
+    }
+    const auto loaded = std::chrono::steady_clock::now();
+    std::cout << "Indexed " << index.Size() << " records in " << std::setprecision(4)
+              << std::chrono::duration<double, std::milli>(loaded - load).count() << " ms"
+              << std::endl;
+
+    // How often each solver wins within a category.
+    auto wins = std::map<std::string, std::map<std::uint32_t, std::size_t>>{};
+    for(const auto& key : keys)
+        ++wins[miopen::ParseFindDbKey(key)->category][index.Find(key)->entries[0].solver];
+
+    auto scores = std::vector<Score>{{"baseline"}, {"k=1"}, {"k=3"}, {"k=5"}, {"k=10"}};
+    const std::size_t ks[] = {1, 3, 5, 10};
+
+    // Spread the queries evenly over the db, records are sorted by key.
+    const auto step = std::max<std::size_t>(1, keys.size() / max_queries);
+    auto queries    = std::size_t{0};
+    auto lookups    = std::chrono::steady_clock::duration{};
+
+    for(std::size_t i = 0; i < keys.size(); i += step)
+    {
+        const auto& key    = keys[i];
+        const auto& record = *index.Find(key);
+        ++queries;
+
+        auto counts = wins[miopen::ParseFindDbKey(key)->category];
+        --counts[record.entries[0].solver];
+        auto baseline = std::pair<std::size_t, std::uint32_t>{0, 0};
+        for(const auto& count : counts)
+        {
+            if(count.second > baseline.first && Has(record, count.first))
+                baseline = {count.second, count.first};
+        }
+        if(baseline.first > 0)
+            scores[0].Add(record, baseline.second);
+
+        for(std::size_t k = 0; k < std::size(ks); ++k)
+        {
+            const auto start       = std::chrono::steady_clock::now();
+            const auto suggestions = index.Suggest(key, ks[k]);
+            lookups += std::chrono::steady_clock::now() - start;
+
+            for(const auto& suggestion : suggestions)
+            {
+                const auto& entries = record.entries;
+                const auto it = std::find_if(entries.begin(), entries.end(), [&](auto entry) {
+                    return index.GetSolverName(entry.solver) == suggestion.solver;
+                });
+                if(it == entries.end())
+                    continue;
+                scores[k + 1].Add(record, it->solver);
+                break;
+            }
+        }
+    }
+
+    std::cout << queries << " queries, "
+              << std::chrono::duration<double, std::micro>(lookups).count() /
+                     (queries * std::size(ks))
+              << " us per lookup" << std::endl;
+    std::cout << std::setw(10) << "pick" << std::setw(11) << "answered" << std::setw(11)
+              << "best" << std::setw(11) << "<=1.1x" << std::setw(11) << "avg" << std::endl;
+    for(const auto& score : scores)
+        score.Print(queries);
+    return 0;
+}
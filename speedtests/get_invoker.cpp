@@ -0,0 +1,77 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/handle.hpp>
+#include <miopen/invoker.hpp>
+#include <miopen/names.hpp>
+#include <miopen/solver_id.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Host overhead of Handle::GetInvoker on a warm invoker cache.
+// Usage: speedtest_get_invoker [configs]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Ns(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+// Shaped as the convolution network configs.
+std::string MakeConfig(int i)
+{
+    return "64x" + std::to_string(16 + i % 512) + "x" + std::to_string(7 + i % 57) + "x" +
+           std::to_string(7 + i % 57) + "x3x3x" + std::to_string(64 + i) +
+           "x1x1x1x1x1x1xNCHWxNCHWxNCHWxFP32xF";
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    const auto count       = argc > 1 ? std::stoi(argv[1]) : 10000;
+    constexpr auto lookups = 1000000;
+
+    auto handle = miopen::Handle{};
+    const auto& ids =
+        miopen::solver::GetSolversByPrimitive(miopen::solver::Primitive::Convolution);
+    const auto solvers = std::vector<miopen::solver::Id>(
+        ids.begin(), ids.begin() + std::min<std::size_t>(ids.size(), 8));
+
+    auto strings = std::vector<std::string>{};
+    auto configs = std::vector<miopen::NetworkConfig>{};
+    for(auto i = 0; i < count; ++i)
+    {
+        strings.push_back(MakeConfig(i));
+        configs.emplace_back(strings.back());
+        for(const auto& solver : solvers)
+            handle.RegisterInvoker([](auto&&...) {}, configs.back(), solver.ToString());
+    }
+
+    auto found       = 0;
+    const auto start = Clock::now();
+    for(auto i = 0; i < lookups; ++i)
+        found += handle.GetInvoker(configs[i % count], solvers[i % solvers.size()]) ? 1 : 0;
+    const auto lookup_time = Clock::now() - start;
+
+    // As in the API calls, where the config is made for every call.
+    const auto build_start = Clock::now();
+    for(auto i = 0; i < lookups; ++i)
+    {
+        const auto config = miopen::NetworkConfig{strings[i % count]};
+        found += handle.GetInvoker(config, solvers[i % solvers.size()]) ? 1 : 0;
+    }
+    const auto build_time = Clock::now() - build_start;
+
+    std::cout << count << " configs x " << solvers.size() << " solvers: lookup "
+              << Ns(lookup_time) / lookups << " ns, with the config made per call "
+              << Ns(build_time) / lookups << " ns, found " << found << "/" << 2 * lookups
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/graphapi/opgraph.hpp>
+#include <miopen/miopen.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Op graph matching on synthetic residual graphs of growing width: every block fans one tensor
+// out to `width` branches and joins them with the block input, like the attention heads and
+// MLPs of a transformer layer. Compares the canonical form comparison done by isIsomorphic
+// against the enumeration and sorting of all source to sink paths it used to do.
+// Usage: speedtest_graph_matching [blocks] [max_width]
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+struct Node : gr::OpNode
+{
+    std::string name;
+    std::vector<gr::Tensor*> ins;
+    std::vector<gr::Tensor*> outs;
+
+    Node(std::string name_, std::vector<gr::Tensor*> ins_, std::vector<gr::Tensor*> outs_)
+        : name(std::move(name_)), ins(std::move(ins_)), outs(std::move(outs_))
+    {
+    }
+
+    const std::string& signName() const final { return name; }
+    std::vector<gr::Tensor*> getInTensors() const final { return ins; }
+    std::vector<gr::Tensor*> getOutTensors() const final { return outs; }
+};
+
+struct ResidualGraph
+{
+    std::deque<gr::Tensor> tensors;
+    std::deque<Node> nodes;
+    gr::OpGraph graph;
+
+    ResidualGraph(miopenHandle_t handle, std::size_t blocks, std::size_t width, bool reversed)
+    {
+        auto tensor = [&]() {
+            return &tensors.emplace_back(gr::TensorBuilder{}
+                                             .setDataType(miopenFloat)
+                                             .setDim({1})
+                                             .setStride({1})
+                                             .setId(static_cast<int64_t>(tensors.size()))
+                                             .setVirtual(true)
+                                             .build());
+        };
+
+        auto* x = tensor();
+        for(std::size_t b = 0; b < blocks; ++b)
+        {
+            auto* norm = tensor();
+            nodes.emplace_back("norm", std::vector<gr::Tensor*>{x}, std::vector<gr::Tensor*>{norm});
+
+            std::vector<gr::Tensor*> joined{x};
+            for(std::size_t w = 0; w < width; ++w)
+            {
+                auto* branch = tensor();
+                nodes.emplace_back(
+                    "branch", std::vector<gr::Tensor*>{norm}, std::vector<gr::Tensor*>{branch});
+                joined.push_back(branch);
+            }
+
+            auto* out = tensor();
+            nodes.emplace_back("join", joined, std::vector<gr::Tensor*>{out});
+            x = out;
+        }
+
+        std::vector<gr::OpNode*> order;
+        for(auto& node : nodes)
+            order.push_back(&node);
+        if(reversed)
+            std::reverse(order.begin(), order.end());
+
+        gr::OpGraphBuilder builder;
+        builder.setHandle(handle);
+        builder.setNodes(std::move(order));
+        graph = std::move(builder).build();
+    }
+};
+
+bool SamePaths(const gr::OpGraph& left, const gr::OpGraph& right)
+{
+    auto to_strings = [](const gr::OpGraph& graph) {
+        std::vector<std::string> ret;
+        for(const auto& path : graph.getAllPaths())
+            ret.push_back(gr::pathToStr(path));
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    };
+    return to_strings(left) == to_strings(right);
+}
+
+template <class F>
+double TimeUs(F&& f, std::size_t reps)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < reps; ++i)
+        f();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+               .count() /
+           reps;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto blocks    = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4ul;
+    const auto max_width = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16ul;
+
+    miopenHandle_t handle = nullptr;
+    miopenCreate(&handle);
+
+    std::cout << std::setw(6) << "width" << std::setw(8) << "nodes" << std::setw(12) << "paths"
+              << std::setw(12) << "build us" << std::setw(12) << "match us" << std::setw(12)
+              << "paths us" << std::endl;
+
+    for(std::size_t width = 1; width <= max_width; width *= 2)
+    {
+        const ResidualGraph left{handle, blocks, width, false};
+        const ResidualGraph right{handle, blocks, width, true};
+
+        const auto build_us =
+            TimeUs([&]() { const ResidualGraph g{handle, blocks, width, false}; }, 10);
+
+        auto matched        = true;
+        const auto match_us = TimeUs(
+            [&]() { matched = matched && gr::isIsomorphic(left.graph, right.graph); }, 100);
+
+        // Every block multiplies the number of paths by width + 1.
+        auto paths = 1.0;
+        for(std::size_t b = 0; b < blocks; ++b)
+            paths *= static_cast<double>(width + 1);
+
+        std::cout << std::setw(6) << width << std::setw(8) << left.graph.numNodes()
+                  << std::fixed << std::setprecision(0) << std::setw(12) << paths
+                  << std::setprecision(1) << std::setw(12) << build_us << std::setw(12) << match_us;
+        if(paths <= 1e6)
+        {
+            const auto paths_us =
+                TimeUs([&]() { matched = matched && SamePaths(left.graph, right.graph); }, 1);
+            std::cout << std::setw(12) << paths_us;
+        }
+        else
+        {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::defaultfloat << (matched ? "" : "  MISMATCH") << std::endl;
+    }
+
+    miopenDestroy(handle);
+    return 0;
+}
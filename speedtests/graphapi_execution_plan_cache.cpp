@@ -0,0 +1,117 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/execution_plan_cache.hpp>
+#include <miopen/graphapi/engineheur.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+#include <miopen/miopen.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Graph API set up of a job with a varying batch size: every iteration builds its operation
+// graph, here a chain of pointwise operations, and then an execution plan for it. Compares
+// selecting the engine with EngineHeurBuilder and building the plan at every iteration against
+// finding the plan in ExecutionPlanCache, which only has to bind it to the graph.
+// Usage: speedtest_graphapi_execution_plan_cache [iterations] [chain_length] [batch_sizes]
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+struct Chain
+{
+    gr::Pointwise add{MIOPEN_POINTWISE_ADD, miopenFloat};
+    std::deque<gr::Tensor> tensors;
+    std::deque<gr::OperationPointwise> nodes;
+    gr::OpGraph graph;
+
+    Chain(miopenHandle_t handle, std::size_t length, int64_t batch)
+    {
+        auto tensor = [&](int64_t rows, bool isVirtual) {
+            return &tensors.emplace_back(gr::TensorBuilder{}
+                                             .setDataType(miopenFloat)
+                                             .setDim({rows, 64})
+                                             .setStride({64, 1})
+                                             .setId(static_cast<int64_t>(tensors.size()))
+                                             .setVirtual(isVirtual)
+                                             .build());
+        };
+
+        auto* x = tensor(batch, false);
+        for(std::size_t i = 0; i < length; ++i)
+        {
+            auto* bias = tensor(1, false);
+            auto* out  = tensor(batch, i + 1 < length);
+            nodes.emplace_back(&add, x, bias, out);
+            x = out;
+        }
+
+        std::vector<gr::OpNode*> order;
+        for(auto& node : nodes)
+            order.push_back(&node);
+
+        gr::OpGraphBuilder builder;
+        builder.setHandle(handle);
+        builder.setNodes(std::move(order));
+        graph = std::move(builder).build();
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const auto iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000ul;
+    const auto length     = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16ul;
+    const auto batches    = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8ul;
+
+    miopenHandle_t handle = nullptr;
+    miopenCreate(&handle);
+
+    auto& cache = gr::ExecutionPlanCache::instance();
+    cache.clear();
+
+    int64_t workspace = 0;
+    auto time_us      = [&](bool cached) {
+        const auto start = std::chrono::steady_clock::now();
+        for(std::size_t i = 0; i < iterations; ++i)
+        {
+            Chain chain{handle, length, static_cast<int64_t>(1 + i % batches)};
+            if(cached)
+            {
+                workspace += cache.findOrBuild(chain.graph, handle).getWorkspaceSize();
+            }
+            else
+            {
+                auto heur = gr::EngineHeurBuilder()
+                                .setOpGraph(&chain.graph)
+                                .setMode(MIOPEN_HEUR_MODE_INSTANT)
+                                .build();
+                workspace += gr::ExecutionPlanBuilder()
+                                 .setHandle(handle)
+                                 .setEngineCfg(heur.getResults().front())
+                                 .build()
+                                 .getWorkspaceSize();
+            }
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                         start)
+                   .count() /
+               iterations;
+    };
+
+    const auto rebuild_us = time_us(false);
+    const auto cached_us  = time_us(true);
+
+    std::cout << std::fixed << std::setprecision(1) << "rebuild: " << rebuild_us
+              << " us/iteration, cached: " << cached_us << " us/iteration, " << cache.size()
+              << " plans (" << workspace << ")" << std::endl;
+
+    miopenDestroy(handle);
+    return 0;
+}
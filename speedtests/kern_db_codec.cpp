@@ -0,0 +1,160 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/kernel_codec.hpp>
+#include <miopen/kern_db.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Compares the kernel db codecs: compression ratio and decompression throughput.
+// Usage: speedtest_kern_db_codec [path/to/kernels.kdb]
+// Without arguments a synthetic corpus is generated. The dictionary is trained on
+// the measured corpus itself, so its ratio is an upper bound.
+
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Ms(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() * .000001;
+}
+
+// Code objects of the same db share most of the ELF layout, metadata and instruction
+// sequences, which is approximated by a pool of common chunks.
+std::vector<std::vector<char>> GenerateCorpus(int blobs)
+{
+    auto gen   = std::mt19937{42};
+    auto bytes = std::uniform_int_distribution<int>{0, 255};
+    auto chunk = [&](std::size_t size) {
+        auto result = std::vector<char>(size);
+        for(auto& c : result)
+            c = static_cast<char>(bytes(gen));
+        return result;
+    };
+
+    auto pool = std::vector<std::vector<char>>{};
+    for(auto i = 0; i < 64; ++i)
+        pool.push_back(chunk(1024));
+    auto pick = std::uniform_int_distribution<std::size_t>{0, pool.size() - 1};
+
+    auto corpus = std::vector<std::vector<char>>{};
+    for(auto i = 0; i < blobs; ++i)
+    {
+        auto blob = std::vector<char>{};
+        for(auto j = 0; j < 16 + i % 32; ++j)
+        {
+            const auto& common = pool[pick(gen)];
+            blob.insert(blob.end(), common.begin(), common.end());
+        }
+        const auto unique = chunk(512 + i % 2048);
+        blob.insert(blob.end(), unique.begin(), unique.end());
+        corpus.push_back(std::move(blob));
+    }
+    return corpus;
+}
+
+void Measure(const std::string& name,
+             miopen::KernelCodec codec,
+             const std::vector<std::vector<char>>& corpus,
+             const std::vector<char>* dict)
+{
+    auto dicts = miopen::KernelCodecDicts{};
+    if(dict != nullptr)
+        dicts.emplace(miopen::GetKernelCodecDictId(*dict), *dict);
+
+    // Blobs which do not shrink are stored as is, like KernDb does.
+    auto compressed           = std::vector<std::vector<char>>{};
+    auto is_compressed        = std::vector<bool>{};
+    auto compressed_size      = std::size_t{0};
+    auto uncompressed_size    = std::size_t{0};
+    const auto compress_start = Clock::now();
+    for(const auto& blob : corpus)
+    {
+        auto success = false;
+        compressed.push_back(miopen::CompressBlob(codec, blob, &success, dict));
+        is_compressed.push_back(success);
+        compressed_size += compressed.back().size();
+        uncompressed_size += blob.size();
+    }
+    const auto compress_time = Clock::now() - compress_start;
+
+    constexpr auto repeats      = 5;
+    const auto decompress_start = Clock::now();
+    for(auto r = 0; r < repeats; ++r)
+    {
+        for(std::size_t i = 0; i < corpus.size(); ++i)
+        {
+            const auto blob =
+                is_compressed[i]
+                    ? miopen::DecompressBlob(codec, compressed[i], corpus[i].size(), dicts)
+                    : compressed[i];
+            if(blob != corpus[i])
+                std::cerr << name << ": blob " << i << " is corrupted" << std::endl;
+        }
+    }
+    const auto decompress_time = Clock::now() - decompress_start;
+
+    const auto mib = uncompressed_size / (1024. * 1024.);
+    std::cout << std::setw(10) << name << ": ratio " << std::fixed << std::setprecision(2)
+              << static_cast<double>(uncompressed_size) / compressed_size << ", compress "
+              << mib * 1000. / Ms(compress_time) << " MiB/s, decompress "
+              << repeats * mib * 1000. / Ms(decompress_time) << " MiB/s" << std::endl;
+}
+
+} // namespace
+#endif
+
+int main(int argc, const char* argv[])
+{
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+    auto corpus = std::vector<std::vector<char>>{};
+
+    if(argc > 1)
+    {
+        auto db = miopen::KernDb{miopen::DbKinds::KernelDb, argv[1], true};
+        corpus  = db.LoadBlobsUnsafe();
+    }
+    else
+    {
+        corpus = GenerateCorpus(1000);
+    }
+
+    if(corpus.empty())
+    {
+        std::cerr << "No kernels found" << std::endl;
+        return 1;
+    }
+
+    auto total = std::size_t{0};
+    for(const auto& blob : corpus)
+        total += blob.size();
+    std::cout << corpus.size() << " kernels, " << total / 1024 << " KiB" << std::endl;
+
+    Measure("bz2", miopen::KernelCodec::Bz2, corpus, nullptr);
+    if(!miopen::IsCodecAvailable(miopen::KernelCodec::Zstd))
+    {
+        std::cout << "zstd is not available in this build" << std::endl;
+        return 0;
+    }
+    Measure("zstd", miopen::KernelCodec::Zstd, corpus, nullptr);
+
+    const auto dict = miopen::TrainKernelCodecDict(corpus, 110 * 1024);
+    if(dict.empty())
+        std::cout << "zstd dictionary training failed" << std::endl;
+    else
+        Measure("zstd+dict", miopen::KernelCodec::Zstd, corpus, &dict);
+    return 0;
+#else
+    std::ignore = argc;
+    std::ignore = argv;
+    std::cerr << "Kernel db is not enabled in this build" << std::endl;
+    return 1;
+#endif
+}
@@ -0,0 +1,105 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/binary_cache.hpp>
+#include <miopen/env.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/kern_db.hpp>
+#include <miopen/tmp_dir.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Measures repeated LoadBinary hits on the user kernel db, as when a network is run again and
+// its kernels are loaded from the cache. A KernDb made per load, which opens a connection and
+// prepares its statements every time, is measured for comparison.
+// Usage: speedtest_kern_db_load [kernels]
+// The kernels are synthetic and stored in a temporary cache directory. The shared memory cache
+// is off, so that every load reaches the db.
+
+MIOPEN_DECLARE_ENV_VAR_STR(MIOPEN_CUSTOM_CACHE_DIR)
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_KERNEL_SHM_CACHE_MB)
+
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Us(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() * .001;
+}
+
+std::vector<char> MakeBlob(std::mt19937& gen, std::size_t size)
+{
+    auto bytes = std::uniform_int_distribution<int>{0, 255};
+    auto blob  = std::vector<char>(size);
+    for(auto& c : blob)
+        c = static_cast<char>(bytes(gen));
+    return blob;
+}
+
+} // namespace
+#endif
+
+int main(int argc, const char* argv[])
+{
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+    const auto count     = argc > 1 ? std::stoi(argv[1]) : 256;
+    constexpr auto loads = 10000;
+
+    const auto tmp = miopen::TmpDir{"kern_db_load"};
+    miopen::env::update(MIOPEN_CUSTOM_CACHE_DIR, tmp.path.string());
+    miopen::env::update(MIOPEN_KERNEL_SHM_CACHE_MB, 0);
+    if(miopen::IsCacheDisabled())
+    {
+        std::cerr << "Kernel cache is disabled" << std::endl;
+        return 1;
+    }
+
+    auto handle        = miopen::Handle{};
+    const auto& target = handle.GetTargetProperties();
+    const auto num_cu  = handle.GetMaxComputeUnits();
+    const auto name    = [](int i) { return "kernel" + std::to_string(i) + ".s"; };
+    const auto args    = [](int i) { return "-DINDEX=" + std::to_string(i); };
+    const auto user_db = tmp.path / (miopen::Handle::GetDbBasename(target, num_cu) + ".ukdb");
+
+    auto gen = std::mt19937{42};
+    for(auto i = 0; i < count; ++i)
+        miopen::SaveBinary(MakeBlob(gen, 4096 + i % 16 * 1024), target, num_cu, name(i), args(i));
+    miopen::WaitForCacheEviction();
+
+    auto found       = 0;
+    const auto start = Clock::now();
+    for(auto i = 0; i < loads; ++i)
+    {
+        const auto blob = miopen::LoadBinary(target, num_cu, name(i % count), args(i % count));
+        found += blob.empty() ? 0 : 1;
+    }
+    const auto load_time = Clock::now() - start;
+
+    const auto fresh_start = Clock::now();
+    for(auto i = 0; i < loads; ++i)
+    {
+        auto db        = miopen::KernDb{miopen::DbKinds::KernelDb, user_db, false};
+        const auto cfg = miopen::KernelConfig{miopen::make_object_file_name(name(i % count)),
+                                              args(i % count),
+                                              {}};
+        found += db.FindRecordUnsafe(cfg) ? 1 : 0;
+    }
+    const auto fresh_time = Clock::now() - fresh_start;
+
+    std::cout << count << " kernels: LoadBinary " << Us(load_time) / loads
+              << " us, with a KernDb per load " << Us(fresh_time) / loads << " us, found "
+              << found << "/" << 2 * loads << std::endl;
+    return 0;
+#else
+    std::ignore = argc;
+    std::ignore = argv;
+    std::cerr << "Kernel db is not enabled in this build" << std::endl;
+    return 1;
+#endif
+}
@@ -0,0 +1,87 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/conv/problem_description.hpp>
+#include <miopen/convolution.hpp>
+#include <miopen/key_writer.hpp>
+#include <miopen/tensor.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+// Allocations and host time per call of the network config and the find db key of a
+// convolution problem.
+// Usage: speedtest_network_config
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+void Measure(const std::string& name, F f)
+{
+    constexpr auto calls = 100000;
+    for(auto i = 0; i < 100; ++i)
+        f();
+
+    const auto allocations_before = allocations.load();
+    const auto start              = Clock::now();
+    for(auto i = 0; i < calls; ++i)
+        f();
+    const auto time = Clock::now() - start;
+
+    std::cout << name << ": "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() / calls
+              << " ns, " << static_cast<double>(allocations.load() - allocations_before) / calls
+              << " allocations per call" << std::endl;
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if(auto* const p = std::malloc(size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main()
+{
+    const auto in      = miopen::TensorDescriptor{miopenFloat, {64, 256, 56, 56}};
+    const auto weights = miopen::TensorDescriptor{miopenFloat, {64, 256, 3, 3}};
+    const auto out     = miopen::TensorDescriptor{miopenFloat, {64, 64, 56, 56}};
+    const auto conv    = miopen::ConvolutionDescriptor{{1, 1}, {1, 1}, {1, 1}};
+    const auto problem =
+        miopen::conv::ProblemDescription{in, weights, out, conv, miopen::conv::Direction::Forward};
+
+    auto sink = std::size_t{0};
+
+    Measure("Network config, written", [&]() {
+        miopen::KeyWriter key;
+        problem.MakeNetworkConfig(key);
+        sink += key.View().size();
+    });
+    Measure("Network config", [&]() { sink += problem.MakeNetworkConfig().ToString().size(); });
+    Measure("Find db key, written", [&]() {
+        miopen::KeyWriter key;
+        problem.Serialize(key);
+        sink += key.View().size();
+    });
+    Measure("Find db key, through std::ostream", [&]() {
+        std::ostringstream ss;
+        problem.Serialize(ss);
+        sink += ss.str().size();
+    });
+
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Parallel loops on the shared thread pool, which par_for uses, against threads started for
+// every call, as par_for did before, for small and large loops. MIOPEN_THREAD_POOL_SIZE sets
+// the size of the pool.
+// Usage: speedtest_par_for [calls]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Starts threadsize threads, each taking a contiguous part of [0, n).
+template <class F>
+void SpawnPerCall(std::size_t n, std::size_t threadsize, F f)
+{
+    auto threads     = std::vector<std::thread>{};
+    const auto grain = (n + threadsize - 1) / threadsize;
+    for(auto start = std::size_t{0}; start < n; start += grain)
+    {
+        threads.emplace_back([=]() {
+            for(auto i = start; i < std::min(n, start + grain); ++i)
+                f(i);
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+}
+
+template <class Loop>
+double MeasureUs(int calls, Loop loop)
+{
+    const auto start = Clock::now();
+    for(auto i = 0; i < calls; ++i)
+        loop();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() /
+           1000.0 / calls;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    const auto calls = argc > 1 ? std::stoi(argv[1]) : 1000;
+    const auto threadsize =
+        std::max<std::size_t>(miopen::ThreadPool::Shared().GetWorkerCount() + 1, 2);
+
+    std::cout << "Pool of " << miopen::ThreadPool::Shared().GetWorkerCount() << " workers, "
+              << threadsize << " threads per loop" << std::endl;
+
+    for(const auto n : {std::size_t{16}, std::size_t{1024}, std::size_t{1} << 16})
+    {
+        auto data  = std::vector<std::atomic<unsigned>>(n);
+        const auto f = [&](auto i) { data[i] += static_cast<unsigned>(i); };
+
+        const auto spawned = MeasureUs(calls, [&]() { SpawnPerCall(n, threadsize, f); });
+        const auto pooled  = MeasureUs(
+            calls, [&]() { miopen::ThreadPool::Shared().ParallelFor(n, f, threadsize); });
+
+        std::cout << "n = " << n << ": threads per call " << spawned << " us, pooled " << pooled
+                  << " us" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/search_strategy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// The tuning search strategies on synthetic timings, without a GPU: how many kernel runs each
+// one spends and how far its winner is from the fastest config. Every config has four tuning
+// parameters, the time is a noisy bowl around one of them with some bumps and failures.
+// Usage: speedtest_search_strategy [searches] [jitter]
+
+namespace {
+
+namespace search = miopen::solver::search;
+
+struct Problem
+{
+    std::vector<std::vector<double>> features;
+    std::vector<float> times; // 0 if the config fails
+
+    explicit Problem(std::mt19937& rng)
+    {
+        std::uniform_int_distribution<int> param{0, 7};
+        std::vector<int> fastest{param(rng), param(rng), param(rng), param(rng)};
+        std::uniform_real_distribution<float> bump{0.0f, 0.2f};
+        std::uniform_int_distribution<int> fails{0, 19};
+        for(int i = 0; i < 8 * 8 * 8 * 8; ++i)
+        {
+            const std::vector<int> config{i & 7, (i >> 3) & 7, (i >> 6) & 7, (i >> 9) & 7};
+            auto time = 1.0f;
+            std::string serialized;
+            for(std::size_t d = 0; d < config.size(); ++d)
+            {
+                time += 0.05f * static_cast<float>(std::abs(config[d] - fastest[d]));
+                serialized += std::to_string(1 << config[d]) + ",";
+            }
+            features.push_back(search::ParseFeatures(serialized));
+            times.push_back(fails(rng) == 0 ? 0.0f : time + bump(rng));
+        }
+    }
+
+    float Best() const
+    {
+        auto best = std::numeric_limits<float>::max();
+        for(const auto time : times)
+        {
+            if(time > 0.0f)
+                best = std::min(best, time);
+        }
+        return best;
+    }
+};
+
+struct Totals
+{
+    double runs   = 0;
+    double trials = 0;
+    double regret = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto searches = argc > 1 ? std::stoi(argv[1]) : 20;
+    const auto jitter   = argc > 2 ? std::stof(argv[2]) : 0.1f;
+
+    const std::vector<search::Options> strategies = [] {
+        search::Options random;
+        search::Options patient;
+        patient.patience = 256;
+        search::Options halving;
+        halving.strategy = search::Strategy::SuccessiveHalving;
+        search::Options model;
+        model.strategy = search::Strategy::ModelGuided;
+        model.patience = 64;
+        return std::vector<search::Options>{random, patient, halving, model};
+    }();
+    std::vector<Totals> totals(strategies.size());
+
+    std::mt19937 rng{1};
+    for(int i = 0; i < searches; ++i)
+    {
+        const Problem problem{rng};
+        for(std::size_t s = 0; s < strategies.size(); ++s)
+        {
+            std::uniform_real_distribution<float> noise{-jitter, jitter};
+            const auto strategy = search::MakeSearchStrategy(
+                strategies[s], problem.times.size(), problem.features);
+            const auto result = search::Run(
+                *strategy, [&](std::size_t candidate, std::size_t runs) -> std::optional<float> {
+                    if(problem.times[candidate] == 0.0f)
+                        return std::nullopt;
+                    auto sum = 0.0f;
+                    for(std::size_t r = 0; r < runs; ++r)
+                        sum += problem.times[candidate] * (1.0f + noise(rng));
+                    return sum / static_cast<float>(runs);
+                });
+            totals[s].runs += static_cast<double>(result.runs) / searches;
+            totals[s].trials += static_cast<double>(result.trials) / searches;
+            if(result.best)
+                totals[s].regret += (problem.times[*result.best] / problem.Best() - 1) / searches;
+        }
+    }
+
+    std::cout << searches << " searches among 4096 configs, jitter " << jitter << std::endl;
+    for(std::size_t s = 0; s < strategies.size(); ++s)
+    {
+        std::cout << std::setw(8) << strategies[s].strategy << " patience " << std::setw(4)
+                  << strategies[s].patience << ": " << std::setw(6)
+                  << static_cast<long>(totals[s].runs) << " runs, " << std::setw(6)
+                  << static_cast<long>(totals[s].trials) << " trials, " << std::setprecision(3)
+                  << 100 * totals[s].regret
+                  << "% slower than the fastest" << std::endl;
+    }
+    return 0;
+}
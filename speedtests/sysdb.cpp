@@ -0,0 +1,107 @@
+#include <miopen/config.h> // WORKAROUND_BOOST_ISSUE_392
+#include <miopen/binary_db_format.hpp>
+#include <miopen/readonly_binary_db.hpp>
+#include <miopen/readonlyramdb.hpp>
+#include <miopen/tmp_dir.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Compares the text and the precompiled binary system db: load time and lookup latency.
+// Usage: speedtest_sysdb [path/to/system.fdb.txt]
+// Without arguments a synthetic find-db is generated.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Ms(Clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() * .000001;
+}
+
+void GenerateTextDb(const miopen::fs::path& path, int records)
+{
+    auto out = std::ofstream{path};
+    for(auto i = 0; i < records; ++i)
+    {
+        out << "1-" << 16 + i % 512 << "-" << 16 + (i / 512) % 64 << "-3x3-64-" << i
+            << "-0x0-1x1-1x1-0-NCHW-FP32-F=";
+        out << "ConvBinWinograd3x3U:0.0" << i % 97 << ",0,miopenConvolutionFwdAlgoWinograd;";
+        out << "ConvOclDirectFwd:0.1" << i % 89 << ",0,miopenConvolutionFwdAlgoDirect;";
+        out << "GemmFwdRest:0.2" << i % 83 << ",1024,miopenConvolutionFwdAlgoGEMM" << std::endl;
+    }
+}
+
+std::vector<std::string> ConvertTextDb(const miopen::fs::path& path)
+{
+    auto in      = std::ifstream{path};
+    auto records = std::vector<miopen::binary_db::Record>{};
+    auto keys    = std::vector<std::string>{};
+    auto line    = std::string{};
+
+    while(std::getline(in, line))
+    {
+        auto record = miopen::binary_db::Record{};
+        if(!miopen::binary_db::ParseLine(line, record))
+            continue;
+        keys.push_back(record.first);
+        records.push_back(std::move(record));
+    }
+
+    const auto image = miopen::binary_db::Build(records);
+    auto out = std::ofstream{miopen::ReadonlyBinaryDb::GetImagePath(path), std::ios::binary};
+    out.write(image.data(), image.size());
+    return keys;
+}
+
+template <class TDb>
+void Measure(const std::string& name,
+             const miopen::fs::path& path,
+             const std::vector<std::string>& keys)
+{
+    const auto load_start = Clock::now();
+    const auto& db        = TDb::GetCached(miopen::DbKinds::FindDb, path, true);
+    const auto load_time  = Clock::now() - load_start;
+
+    auto found            = 0;
+    const auto find_start = Clock::now();
+    for(const auto& key : keys)
+        found += db.FindRecord(key) ? 1 : 0;
+    const auto find_time = Clock::now() - find_start;
+
+    std::cout << name << ": load " << Ms(load_time) << " ms, lookup "
+              << Ms(find_time) * 1000. / keys.size() << " us per record, found " << found << "/"
+              << keys.size() << std::endl;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    const auto tmp = miopen::TmpDir{"sysdb"};
+    auto path      = tmp.path / "synthetic.fdb.txt";
+
+    if(argc > 1)
+    {
+        path = tmp.path / miopen::fs::path{argv[1]}.filename();
+        miopen::fs::copy_file(argv[1], path);
+    }
+    else
+    {
+        GenerateTextDb(path, 100000);
+    }
+
+    const auto convert_start = Clock::now();
+    const auto keys          = ConvertTextDb(path);
+    std::cout << "Converted " << keys.size() << " records in " << Ms(Clock::now() - convert_start)
+              << " ms" << std::endl;
+
+    Measure<miopen::ReadonlyRamDb>("Text", path, keys);
+    Measure<miopen::ReadonlyBinaryDb>("Binary", path, keys);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/db_record.hpp>
+#include <miopen/process.hpp>
+#include <miopen/ramdb.hpp>
+#include <miopen/tmp_dir.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct TestValue
+{
+    int x = 0;
+
+    void Serialize(std::ostream& stream) const { stream << x << ",0,miopenConvolutionFwdAlgoGEMM"; }
+};
+
+double Ms(Clock::duration time) { return std::chrono::duration<double, std::milli>(time).count(); }
+
+int Run(const std::string& mode, int records)
+{
+    const auto tmp = miopen::TmpDir{"userdb"};
+    auto& db = miopen::RamDb::GetCached(miopen::DbKinds::FindDb, tmp.path / "user.ufdb.txt", false);
+
+    const auto start = Clock::now();
+    for(auto i = 0; i < records; ++i)
+    {
+        auto key = std::ostringstream{};
+        key << "1-" << 16 + i % 512 << "-" << 16 + (i / 512) % 64 << "-3x3-64-" << i
+            << "-0x0-1x1-1x1-0-NCHW-FP32-F";
+        auto record = miopen::DbRecord{miopen::DbKinds::FindDb, key.str()};
+        record.SetValues("GemmFwdRest", TestValue{i});
+        db.UpdateRecord(record);
+    }
+    db.Flush();
+    const auto time = Clock::now() - start;
+
+    std::cout << mode << ": " << records << " records in " << Ms(time) << " ms, "
+              << Ms(time) * 1000. / records << " us per record" << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    constexpr auto records = 10000;
+
+    // Write-behind mode is read from the environment once, so each mode is run in a child.
+    if(argc > 1)
+        return Run(argv[1], records);
+
+    auto process = miopen::Process{argv[0]};
+    auto ret     = process("direct");
+    ret |= process("write-behind", "", nullptr, {{"MIOPEN_DEBUG_DB_WRITE_BEHIND", "1"}});
+    return ret;
+}
@@ -25,10 +25,10 @@
  *******************************************************************************/
 
 #include <miopen/batchnorm/problem_description.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/names.hpp>
 
 #include <cmath>
-#include <sstream>
 
 #define WORKAROUND_SWDEV_253606 1
 
@@ -49,7 +49,7 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
 
 NetworkConfig ProblemDescription::MakeForwardTrainingNetworkConfig() const
 {
-    std::ostringstream ss;
+    KeyWriter key;
 
     int n, c, h, w;
     std::tie(n, c, h, w) = tien<4>(xDesc.GetLengths());
@@ -135,33 +135,33 @@ NetworkConfig ProblemDescription::MakeForwardTrainingNetworkConfig() const
             ldsgcn             = ylocalsize / 64;
         }
 
-        ss << "variant" << variant;
+        key << "variant" << variant;
 
 #if(WORKAROUND_SWDEV_253606 == 0)
         if(variant == 4)
         {
-            ss << "rs" << static_cast<int>(resultsave);
-            ss << "rr" << static_cast<int>(resultrunning);
-            ss << "fp16" << static_cast<int>(bfp16parm);
-            ss << "fp32" << static_cast<int>(bfp32parm);
-            ss << "c" << c;
+            key << "rs" << static_cast<int>(resultsave);
+            key << "rr" << static_cast<int>(resultrunning);
+            key << "fp16" << static_cast<int>(bfp16parm);
+            key << "fp32" << static_cast<int>(bfp32parm);
+            key << "c" << c;
         }
         else
 #endif
         {
-            ss << "gx" << xgridsize;
-            ss << "gy" << ygridsize;
-            ss << "xl" << xlocalsize;
-            ss << "yl" << ylocalsize;
-            ss << "ldsgcn" << ldsgcn;
-            ss << "rs" << static_cast<int>(resultsave);
-            ss << "rr" << static_cast<int>(resultrunning);
-            ss << "fp16" << static_cast<int>(bfp16parm);
-            ss << "fp32" << static_cast<int>(bfp32parm);
-            ss << "single" << static_cast<int>(single);
-            ss << "n" << n;
-            ss << "c" << c;
-            ss << "hw" << in_cstride;
+            key << "gx" << xgridsize;
+            key << "gy" << ygridsize;
+            key << "xl" << xlocalsize;
+            key << "yl" << ylocalsize;
+            key << "ldsgcn" << ldsgcn;
+            key << "rs" << static_cast<int>(resultsave);
+            key << "rr" << static_cast<int>(resultrunning);
+            key << "fp16" << static_cast<int>(bfp16parm);
+            key << "fp32" << static_cast<int>(bfp32parm);
+            key << "single" << static_cast<int>(single);
+            key << "n" << n;
+            key << "c" << c;
+            key << "hw" << in_cstride;
         }
     }
     else
@@ -172,26 +172,26 @@ NetworkConfig ProblemDescription::MakeForwardTrainingNetworkConfig() const
         xgridsize                 = c;
         ygridsize                 = segment * ylocalsize;
 
-        ss << "fp16" << static_cast<int>(bfp16parm);
-        ss << "fp32" << static_cast<int>(bfp32parm);
-        ss << "gx" << xgridsize;
-        ss << "gy" << ygridsize;
-        ss << "lx" << xlocalsize;
-        ss << "ly" << ylocalsize;
-        ss << "rs" << static_cast<int>(resultsave);
-        ss << "rr" << static_cast<int>(resultrunning);
-        ss << "segment" << segment;
-        ss << "n" << n;
-        ss << "c" << c;
-        ss << "hw" << in_cstride;
+        key << "fp16" << static_cast<int>(bfp16parm);
+        key << "fp32" << static_cast<int>(bfp32parm);
+        key << "gx" << xgridsize;
+        key << "gy" << ygridsize;
+        key << "lx" << xlocalsize;
+        key << "ly" << ylocalsize;
+        key << "rs" << static_cast<int>(resultsave);
+        key << "rr" << static_cast<int>(resultrunning);
+        key << "segment" << segment;
+        key << "n" << n;
+        key << "c" << c;
+        key << "hw" << in_cstride;
     }
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 NetworkConfig ProblemDescription::MakeForwardInferenceNetworkConfig() const
 {
-    std::ostringstream ss;
+    KeyWriter key;
 
     bool bfp16parm = false;
     bool bfp32parm = true;
@@ -210,18 +210,18 @@ NetworkConfig ProblemDescription::MakeForwardInferenceNetworkConfig() const
 
     const unsigned int in_cstride = h * w;
 
-    ss << "fp16" << static_cast<int>(bfp16parm);
-    ss << "fp32" << static_cast<int>(bfp32parm);
-    ss << "mode" << bn_mode;
-    ss << "HWdims" << in_cstride;
-    ss << "C" << c;
+    key << "fp16" << static_cast<int>(bfp16parm);
+    key << "fp32" << static_cast<int>(bfp32parm);
+    key << "mode" << bn_mode;
+    key << "HWdims" << in_cstride;
+    key << "C" << c;
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 NetworkConfig ProblemDescription::MakeBackwardNetworkConfig() const
 {
-    std::ostringstream ss;
+    KeyWriter key;
 
     bool bfpmixparm = false;
     bool bfp16parm  = false;
@@ -313,19 +313,19 @@ NetworkConfig ProblemDescription::MakeBackwardNetworkConfig() const
             ldsgcn     = xlocalsize / 64;
         }
 
-        ss << "variant" << variant;
-        ss << "gx" << xgridsize;
-        ss << "n" << n;
-        ss << "c" << c;
-        ss << "hw" << in_cstride;
-        ss << "gy" << ygridsize;
-        ss << "lx" << xlocalsize;
-        ss << "ly" << ylocalsize;
-        ss << "us" << static_cast<int>(useSaved);
-        ss << "fp16" << static_cast<int>(bfp16parm);
-        ss << "fp32" << static_cast<int>(bfp32parm);
-        ss << "single" << static_cast<int>(single);
-        ss << "gcn" << ldsgcn;
+        key << "variant" << variant;
+        key << "gx" << xgridsize;
+        key << "n" << n;
+        key << "c" << c;
+        key << "hw" << in_cstride;
+        key << "gy" << ygridsize;
+        key << "lx" << xlocalsize;
+        key << "ly" << ylocalsize;
+        key << "us" << static_cast<int>(useSaved);
+        key << "fp16" << static_cast<int>(bfp16parm);
+        key << "fp32" << static_cast<int>(bfp32parm);
+        key << "single" << static_cast<int>(single);
+        key << "gcn" << ldsgcn;
     }
     else
     {
@@ -334,20 +334,20 @@ NetworkConfig ProblemDescription::MakeBackwardNetworkConfig() const
         xgridsize                  = c;
         ygridsize                  = segment * ylocalsize;
 
-        ss << "gx" << xgridsize;
-        ss << "gy" << ygridsize;
-        ss << "lx" << xlocalsize;
-        ss << "ly" << ylocalsize;
-        ss << "n" << n;
-        ss << "c" << c;
-        ss << "hw" << in_cstride;
-        ss << "u" << static_cast<int>(useSaved);
-        ss << "fp16" << static_cast<int>(bfp16parm);
-        ss << "fp32" << static_cast<int>(bfp32parm);
-        ss << "nhw" << in_nhw;
+        key << "gx" << xgridsize;
+        key << "gy" << ygridsize;
+        key << "lx" << xlocalsize;
+        key << "ly" << ylocalsize;
+        key << "n" << n;
+        key << "c" << c;
+        key << "hw" << in_cstride;
+        key << "u" << static_cast<int>(useSaved);
+        key << "fp16" << static_cast<int>(bfp16parm);
+        key << "fp32" << static_cast<int>(bfp32parm);
+        key << "nhw" << in_nhw;
     }
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 } // namespace batchnorm
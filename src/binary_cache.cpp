@@ -37,18 +37,126 @@
 #include <miopen/sqlite_db.hpp>
 #endif
 #include <miopen/kern_db.hpp>
+#include <miopen/kernel_shm_cache.hpp>
 #include <miopen/db.hpp>
 #include <miopen/db_path.hpp>
 #include <miopen/target_properties.hpp>
+#include <miopen/thread_pool.hpp>
 #include <miopen/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
 
 MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DISABLE_CACHE)
 MIOPEN_DECLARE_ENV_VAR_STR(MIOPEN_CUSTOM_CACHE_DIR)
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_CACHE_SIZE_LIMIT_MB)
 
 namespace miopen {
 
+namespace {
+
+struct CacheCounters
+{
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+    std::atomic<std::size_t> loaded_bytes{0};
+    std::atomic<std::size_t> saved{0};
+    std::atomic<std::size_t> saved_bytes{0};
+    std::atomic<std::size_t> evicted{0};
+};
+
+CacheCounters& GetCacheCounters()
+{
+    static CacheCounters counters;
+    return counters;
+}
+
+/// Maintenance tasks of the kernel cache, run one at a time on the shared thread pool.
+struct CacheEviction
+{
+    using Task = std::function<std::size_t()>;
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    // Tasks which have not started, by key.
+    std::deque<std::pair<std::string, Task>> tasks;
+    bool running = false;
+    std::future<void> worker;
+};
+
+CacheEviction& GetCacheEviction()
+{
+    static CacheEviction eviction;
+    return eviction;
+}
+
+void RunCacheMaintenance()
+{
+    auto& eviction = GetCacheEviction();
+    while(true)
+    {
+        auto task = CacheEviction::Task{};
+        {
+            std::lock_guard<std::mutex> lock(eviction.mutex);
+            if(eviction.tasks.empty())
+            {
+                eviction.running = false;
+                eviction.idle.notify_all();
+                return;
+            }
+            task = std::move(eviction.tasks.front().second);
+            eviction.tasks.pop_front();
+        }
+
+        try
+        {
+            GetCacheCounters().evicted += task();
+        }
+        catch(const std::exception& ex)
+        {
+            MIOPEN_LOG_W("Kernel cache maintenance failed: " << ex.what());
+        }
+        const auto stats = GetKernelCacheStats();
+        MIOPEN_LOG_I("Kernel cache: " << stats.hits << " hits (" << stats.loaded_bytes
+                                      << " bytes), " << stats.misses << " misses, " << stats.saved
+                                      << " saved (" << stats.saved_bytes << " bytes), "
+                                      << stats.evicted << " evicted");
+    }
+}
+
+/// Queues the task to run in the background after the ones queued before. A task with the same
+/// key which has not started yet would do the same work, so the new one is dropped then. The task
+/// returns the number of evicted kernels.
+void ScheduleCacheMaintenance(const std::string& key, CacheEviction::Task task)
+{
+    auto& eviction = GetCacheEviction();
+    std::lock_guard<std::mutex> lock(eviction.mutex);
+    const auto queued =
+        std::any_of(eviction.tasks.begin(), eviction.tasks.end(), [&](const auto& queued_task) {
+            return queued_task.first == key;
+        });
+    if(queued)
+        return;
+
+    eviction.tasks.emplace_back(key, std::move(task));
+    if(eviction.running)
+        return;
+    eviction.running = true;
+    // Spawn() never runs the task on this thread, which holds the lock.
+    eviction.worker = ThreadPool::Shared().Spawn(RunCacheMaintenance);
+}
+
+} // namespace
+
 static fs::path ComputeSysCachePath()
 {
     auto p = miopen::ExpandUser(GetSystemDbPath());
@@ -123,16 +231,107 @@ bool IsCacheDisabled()
 #endif
 }
 
+KernelCacheStats GetKernelCacheStats()
+{
+    const auto& counters = GetCacheCounters();
+    auto stats           = KernelCacheStats{};
+    stats.hits           = counters.hits;
+    stats.misses         = counters.misses;
+    stats.loaded_bytes   = counters.loaded_bytes;
+    stats.saved          = counters.saved;
+    stats.saved_bytes    = counters.saved_bytes;
+    stats.evicted        = counters.evicted;
+    return stats;
+}
+
+std::size_t GetCacheSizeLimit()
+{
+    return env::value(MIOPEN_CACHE_SIZE_LIMIT_MB) * 1024 * 1024;
+}
+
+void WaitForCacheEviction()
+{
+    auto& eviction = GetCacheEviction();
+    std::unique_lock<std::mutex> lock(eviction.mutex);
+    eviction.idle.wait(lock, [&]() { return !eviction.running; });
+}
+
+std::size_t
+EvictCacheFiles(const fs::path& cache_dir, std::size_t max_bytes, std::uintmax_t* remaining_bytes)
+{
+    struct CacheFile
+    {
+        fs::path path;
+        fs::file_time_type last_access;
+        std::uintmax_t size;
+    };
+
+    // Kernels are in the subdirectories, see GetCacheFile(). The user databases are at the top.
+    auto files = std::vector<CacheFile>{};
+    auto total = std::uintmax_t{0};
+    auto ec    = std::error_code{};
+    for(const auto& dir : fs::directory_iterator{cache_dir, ec})
+    {
+        if(!fs::is_directory(dir.path(), ec))
+            continue;
+        for(const auto& file : fs::directory_iterator{dir.path(), ec})
+        {
+            auto cache_file = CacheFile{file.path(),
+                                        fs::last_write_time(file.path(), ec),
+                                        fs::file_size(file.path(), ec)};
+            if(ec)
+                continue;
+            total += cache_file.size;
+            files.push_back(std::move(cache_file));
+        }
+    }
+    if(remaining_bytes != nullptr)
+        *remaining_bytes = total;
+    if(total <= max_bytes)
+        return 0;
+
+    std::sort(files.begin(), files.end(), [](const auto& l, const auto& r) {
+        return l.last_access < r.last_access;
+    });
+
+    const auto target = max_bytes / 10 * 9;
+    auto evicted      = std::size_t{0};
+    for(const auto& file : files)
+    {
+        if(total <= target)
+            break;
+        if(!fs::remove(file.path, ec))
+            continue;
+        total -= file.size;
+        ++evicted;
+        // Fails unless the directory is empty.
+        fs::remove(file.path.parent_path(), ec);
+    }
+    if(remaining_bytes != nullptr)
+        *remaining_bytes = total;
+    MIOPEN_LOG_I("Evicted " << evicted << " kernels from " << cache_dir);
+    return evicted;
+}
+
 #if MIOPEN_ENABLE_SQLITE_KERN_CACHE
-using KDb = DbTimer<MultiFileDb<KernDb, KernDb, false>>;
-KDb GetDb(const TargetProperties& target, size_t num_cu)
+/// A zstd dictionary of the user kernel db is trained once it holds this many kernels.
+constexpr std::size_t KernDbDictionaryMinKernels = 64;
+constexpr std::size_t KernDbDictionaryInterval   = 64;
+
+static fs::path GetUserKernDbPath(const TargetProperties& target, size_t num_cu)
 {
     static const auto user_dir = ComputeUserCachePath();
-    static const auto sys_dir  = ComputeSysCachePath();
-    fs::path user_path         = user_dir / (Handle::GetDbBasename(target, num_cu) + ".ukdb");
-    fs::path sys_path          = sys_dir / (Handle::GetDbBasename(target, num_cu) + ".kdb");
     if(user_dir.empty())
-        user_path = user_dir;
+        return user_dir;
+    return user_dir / (Handle::GetDbBasename(target, num_cu) + ".ukdb");
+}
+
+using KDb = DbTimer<MultiFileDb<KernDb, KernDb, false>>;
+KDb GetDb(const TargetProperties& target, size_t num_cu)
+{
+    static const auto sys_dir = ComputeSysCachePath();
+    fs::path user_path        = GetUserKernDbPath(target, num_cu);
+    fs::path sys_path         = sys_dir / (Handle::GetDbBasename(target, num_cu) + ".kdb");
     if(!fs::exists(sys_path))
         sys_path = sys_dir / (target.DbId() + ".kdb");
 #if !MIOPEN_EMBED_DB
@@ -141,6 +340,17 @@ KDb GetDb(const TargetProperties& target, size_t num_cu)
 #endif
     return {DbKinds::KernelDb, sys_path, user_path};
 }
+
+static std::string GetShmKey(const TargetProperties& target,
+                             size_t num_cu,
+                             const fs::path& filename,
+                             const std::string& args)
+{
+    // A kernel db which is cleared and created again must not get the entries of the old one.
+    const auto generation = GetFileIdentity(GetUserKernDbPath(target, num_cu));
+    return Handle::GetDbBasename(target, num_cu) + ":" + generation + ":" + filename.string() +
+           ":" + args;
+}
 #endif
 
 fs::path GetCacheFile(const std::string& device, const fs::path& name, const std::string& args)
@@ -158,9 +368,24 @@ std::vector<char> LoadBinary(const TargetProperties& target,
     if(miopen::IsCacheDisabled())
         return {};
 
-    auto db = GetDb(target, num_cu);
-
     const auto filename = make_object_file_name(name);
+    auto* const shm     = GetKernelShmCache();
+    const auto shm_key  = shm != nullptr ? GetShmKey(target, num_cu, filename, args) : "";
+
+    // Another process has already read and decompressed it.
+    if(shm != nullptr)
+    {
+        if(const auto blob = shm->Find(shm_key))
+        {
+            MIOPEN_LOG_I2("Loaded binary from shared memory for: " << filename
+                                                                   << "; args: " << args);
+            ++GetCacheCounters().hits;
+            GetCacheCounters().loaded_bytes += blob->size();
+            return {blob->begin(), blob->end()};
+        }
+    }
+
+    auto db = GetDb(target, num_cu);
     const KernelConfig cfg{filename, args, {}};
 
     MIOPEN_LOG_I2("Loading binary for: " << filename << "; args: " << args);
@@ -168,11 +393,16 @@ std::vector<char> LoadBinary(const TargetProperties& target,
     if(record)
     {
         MIOPEN_LOG_I2("Successfully loaded binary for: " << filename << "; args: " << args);
+        ++GetCacheCounters().hits;
+        GetCacheCounters().loaded_bytes += record->size();
+        if(shm != nullptr)
+            shm->Insert(shm_key, {record->data(), record->size()});
         return *record;
     }
     else
     {
         MIOPEN_LOG_I2("Unable to load binary for: " << filename << "; args: " << args);
+        ++GetCacheCounters().misses;
         return {};
     }
 }
@@ -193,8 +423,63 @@ void SaveBinary(const std::vector<char>& hsaco,
 
     MIOPEN_LOG_I2("Saving binary for: " << filename << "; args: " << args);
     db.StoreRecord(cfg);
+    if(auto* const shm = GetKernelShmCache())
+        shm->Insert(GetShmKey(target, num_cu, filename, args), {hsaco.data(), hsaco.size()});
+    ++GetCacheCounters().saved;
+    GetCacheCounters().saved_bytes += hsaco.size();
+
+    const auto limit     = GetCacheSizeLimit();
+    const auto user_path = GetUserKernDbPath(target, num_cu);
+    if(user_path.empty() || DisableUserDbFileIO)
+        return;
+
+    // Small code objects compress much better with a dictionary trained on the cache itself. It
+    // is trained once per database, the check is only repeated every so many saves.
+    if(GetCacheCounters().saved % KernDbDictionaryInterval == 0 &&
+       GetDefaultKernelCodec() == KernelCodec::Zstd)
+    {
+        // The training takes a connection of its own, so that the loads are not held up.
+        ScheduleCacheMaintenance("dictionary:" + user_path.string(), [user_path]() -> std::size_t {
+            auto user_db = KernDb{DbKinds::KernelDb, user_path, false};
+            if(!user_db.HasDictionary() &&
+               user_db.GetStatsUnsafe().kernels >= KernDbDictionaryMinKernels &&
+               user_db.TrainDictionaryUnsafe())
+                KernDb::GetCached(DbKinds::KernelDb, user_path, false).ReloadDictionaries();
+            return 0;
+        });
+    }
+
+    if(limit == 0)
+        return;
+    // The file size includes the free pages, so it can only rule the eviction out.
+    auto ec = std::error_code{};
+    if(fs::file_size(user_path, ec) <= limit || ec)
+        return;
+    ScheduleCacheMaintenance("evict:" + user_path.string(), [user_path, limit]() {
+        auto user_db = KernDb{DbKinds::KernelDb, user_path, false};
+        return user_db.EvictUnsafe(limit);
+    });
 }
 #else
+namespace {
+
+/// Size of the kernel files of the file based cache as of the last scan, and the bytes this
+/// process has saved since. Other processes only show up on the next scan.
+struct CacheFilesUsage
+{
+    std::atomic<bool> scanned{false};
+    std::atomic<std::uintmax_t> scanned_bytes{0};
+    std::atomic<std::uintmax_t> saved_since_scan{0};
+};
+
+CacheFilesUsage& GetCacheFilesUsage()
+{
+    static CacheFilesUsage usage;
+    return usage;
+}
+
+} // namespace
+
 fs::path LoadBinary(const TargetProperties& target,
                     const size_t num_cu,
                     const fs::path& name,
@@ -204,13 +489,20 @@ fs::path LoadBinary(const TargetProperties& target,
         return {};
 
     (void)num_cu;
-    auto f = GetCacheFile(target.DbId(), name, args);
+    auto f  = GetCacheFile(target.DbId(), name, args);
+    auto ec = std::error_code{};
     if(fs::exists(f))
     {
+        // The modification time tracks the use of the file for the eviction, since the access
+        // time is not updated on most of the file systems.
+        fs::last_write_time(f, fs::file_time_type::clock::now(), ec);
+        ++GetCacheCounters().hits;
+        GetCacheCounters().loaded_bytes += fs::file_size(f, ec);
         return f;
     }
     else
     {
+        ++GetCacheCounters().misses;
         return {};
     }
 }
@@ -229,6 +521,32 @@ void SaveBinary(const fs::path& binary_path,
         auto p = GetCacheFile(target.DbId(), name, args);
         fs::create_directories(p.parent_path());
         fs::rename(binary_path, p);
+        auto ec         = std::error_code{};
+        const auto size = fs::file_size(p, ec);
+        ++GetCacheCounters().saved;
+        GetCacheCounters().saved_bytes += size;
+
+        const auto limit = GetCacheSizeLimit();
+        if(limit == 0)
+            return;
+
+        // The directory is only scanned when this process alone may have crossed the limit, or
+        // has saved a tenth of it since the last scan to catch up with the other processes.
+        auto& usage      = GetCacheFilesUsage();
+        const auto saved = usage.saved_since_scan += ec ? 0 : size;
+        if(usage.scanned && usage.scanned_bytes + saved <= limit && saved < limit / 10)
+            return;
+
+        const auto cache_dir = GetCachePath(false);
+        ScheduleCacheMaintenance("evict:" + cache_dir.string(), [cache_dir, limit]() {
+            auto& usage            = GetCacheFilesUsage();
+            usage.saved_since_scan = 0;
+            auto remaining         = std::uintmax_t{0};
+            const auto evicted     = EvictCacheFiles(cache_dir, limit, &remaining);
+            usage.scanned_bytes    = remaining;
+            usage.scanned          = true;
+            return evicted;
+        });
     }
 }
 #endif
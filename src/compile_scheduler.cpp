@@ -0,0 +1,104 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/compile_scheduler.hpp>
+
+#include <algorithm>
+
+namespace miopen {
+namespace solver {
+
+CompileScheduler::CompileScheduler(std::size_t budget_) : budget(budget_) {}
+
+CompileScheduler::State CompileScheduler::Acquire(const ProgramKey& program)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    const auto inserted = programs.emplace(program, State::Compiling);
+    if(inserted.second)
+        return State::Missing;
+    return inserted.first->second;
+}
+
+void CompileScheduler::Complete(const ProgramKey& program, bool succeeded)
+{
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        programs[program] = succeeded ? State::Compiled : State::Failed;
+    }
+    compiled.notify_all();
+}
+
+CompileScheduler::State CompileScheduler::Wait(const ProgramKey& program)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    const auto found = programs.find(program);
+    if(found == programs.end())
+        return State::Missing;
+    compiled.wait(lock, [&]() { return found->second != State::Compiling; });
+    return found->second;
+}
+
+bool CompileScheduler::Reserve(std::size_t count)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    released.wait(lock, [&]() { return closed || in_flight == 0 || in_flight + count <= budget; });
+    if(closed)
+        return false;
+    in_flight += count;
+    return true;
+}
+
+void CompileScheduler::Add(std::size_t count)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    in_flight += count;
+}
+
+void CompileScheduler::Release(std::size_t count)
+{
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        in_flight -= std::min(count, in_flight);
+    }
+    released.notify_all();
+}
+
+void CompileScheduler::Close()
+{
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        closed = true;
+    }
+    released.notify_all();
+}
+
+std::size_t CompileScheduler::InFlight() const
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    return in_flight;
+}
+
+} // namespace solver
+} // namespace miopen
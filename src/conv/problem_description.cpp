@@ -30,9 +30,10 @@
 #include <miopen/conv/wrw_invoke_params.hpp>
 #include <miopen/datatype.hpp>
 #include <miopen/execution_context.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/tensor_layout.hpp>
 
-#include <sstream>
+#include <ostream>
 
 namespace miopen {
 
@@ -47,20 +48,24 @@ EncodeDataTypesForKey(miopenDataType_t in, miopenDataType_t weights, miopenDataT
 namespace conv {
 namespace {
 
-std::function<void(std::ostream&)>
-PrintDHW(char sep, unsigned spatial_dims, int64_t depth, int64_t height, int64_t width)
+void WriteDHW(KeyWriter& key,
+              char sep,
+              unsigned spatial_dims,
+              int64_t depth,
+              int64_t height,
+              int64_t width)
 {
-    return [=](std::ostream& stream) {
-        if(spatial_dims > 2)
-            stream << depth << sep;
-        stream << height << sep << width;
-    };
+    if(spatial_dims > 2)
+        key << depth << sep;
+    key << height << sep << width;
 }
 
-std::ostream& operator<<(std::ostream& stream, std::function<void(std::ostream&)>&& manipulator)
+// Either NCHW or NCDHW in all three.
+bool HasDefaultLayouts(const ProblemDescription& problem)
 {
-    manipulator(stream);
-    return stream;
+    const auto& layout = problem.GetInLayout();
+    return (layout == "NCHW" || layout == "NCDHW") && problem.GetWeightsLayout() == layout &&
+           problem.GetOutLayout() == layout;
 }
 
 } // namespace
@@ -144,102 +149,110 @@ void ProblemDescription::HeuristicUpdateLayouts()
 
 void ProblemDescription::MakeNetworkConfig(std::string& conf_key) const
 {
-    std::ostringstream ss;
-
-    ss << GetInChannels();
-    ss << 'x' << PrintDHW('x', GetSpatialDims(), GetInDepth(), GetInHeight(), GetInWidth());
-    ss << 'x'
-       << PrintDHW('x', GetSpatialDims(), GetWeightsDepth(), GetWeightsHeight(), GetWeightsWidth());
-    ss << 'x' << GetOutChannels();
-    ss << 'x' << PrintDHW('x', GetSpatialDims(), GetOutDepth(), GetOutHeight(), GetOutWidth());
-    ss << 'x' << GetInBatchSize();
-    if((GetInLayout() == "NCHW" && GetWeightsLayout() == "NCHW" && GetOutLayout() == "NCHW") ||
-       (GetInLayout() == "NCDHW" && GetWeightsLayout() == "NCDHW" && GetOutLayout() == "NCDHW"))
-    {
-        ss << 'x' << GetInLayout();
-    }
-    else
+    KeyWriter key;
+    MakeNetworkConfig(key);
+    conf_key.assign(key.View());
+}
+
+void ProblemDescription::MakeNetworkConfig(KeyWriter& key) const
+{
+    const auto dims = GetSpatialDims();
+
+    key << GetInChannels();
+    key << 'x';
+    WriteDHW(key, 'x', dims, GetInDepth(), GetInHeight(), GetInWidth());
+    key << 'x';
+    WriteDHW(key, 'x', dims, GetWeightsDepth(), GetWeightsHeight(), GetWeightsWidth());
+    key << 'x' << GetOutChannels();
+    key << 'x';
+    WriteDHW(key, 'x', dims, GetOutDepth(), GetOutHeight(), GetOutWidth());
+    key << 'x' << GetInBatchSize();
+    key << 'x' << GetInLayout();
+    if(!HasDefaultLayouts(*this))
     {
-        ss << 'x' << GetInLayout();
-        ss << 'x' << GetWeightsLayout();
-        ss << 'x' << GetOutLayout();
+        key << 'x' << GetWeightsLayout();
+        key << 'x' << GetOutLayout();
     }
-    ss << 'x' << EncodeDataTypesForKey(GetInDataType(), GetWeightsDataType(), GetOutDataType());
+    key << 'x' << EncodeDataTypesForKey(GetInDataType(), GetWeightsDataType(), GetOutDataType());
 
-    std::ostringstream optional;
-    if(const auto ct = GetInCastType())
-        optional << "ci" << GetDataTypeName(*ct);
-    if(const auto ct = GetWeightsCastType())
-        optional << "cw" << GetDataTypeName(*ct);
-    if(const auto ct = GetOutCastType())
-        optional << "co" << GetDataTypeName(*ct);
-    if(!optional.str().empty())
+    const auto in_ct      = GetInCastType();
+    const auto weights_ct = GetWeightsCastType();
+    const auto out_ct     = GetOutCastType();
+    if(in_ct || weights_ct || out_ct)
     {
-        ss << 'x' << optional.str();
+        key << 'x';
+        if(in_ct)
+            key << "ci" << GetDataTypeName(*in_ct);
+        if(weights_ct)
+            key << "cw" << GetDataTypeName(*weights_ct);
+        if(out_ct)
+            key << "co" << GetDataTypeName(*out_ct);
     }
 
-    ss << 'x' << PrintDHW('x', GetSpatialDims(), GetPadD(), GetPadH(), GetPadW());
-    ss << 'x'
-       << PrintDHW(
-              'x', GetSpatialDims(), GetKernelStrideD(), GetKernelStrideH(), GetKernelStrideW());
-    ss << 'x' << PrintDHW('x', GetSpatialDims(), GetDilationD(), GetDilationH(), GetDilationW());
-    ss << 'x' << GetGroupCount();
-    ss << 'x' << GetDirectionStr();
-    ss << 'x' << GetAlphaBetaCaseStr();
-
-    conf_key = ss.str();
+    key << 'x';
+    WriteDHW(key, 'x', dims, GetPadD(), GetPadH(), GetPadW());
+    key << 'x';
+    WriteDHW(key, 'x', dims, GetKernelStrideD(), GetKernelStrideH(), GetKernelStrideW());
+    key << 'x';
+    WriteDHW(key, 'x', dims, GetDilationD(), GetDilationH(), GetDilationW());
+    key << 'x' << GetGroupCount();
+    key << 'x' << GetDirectionStr();
+    key << 'x' << GetAlphaBetaCaseStr();
 }
 
 void ProblemDescription::Serialize(std::ostream& stream) const
 {
-    const auto sep = '-';
+    KeyWriter key;
+    Serialize(key);
+    stream << key.View();
+}
+
+void ProblemDescription::Serialize(KeyWriter& key) const
+{
+    const auto sep  = '-';
+    const auto dims = GetSpatialDims();
     // Problem description with default layout
     // 576-4-4-1x1-192-4-4-8-1x1-2x2-3x3-0-NCHW-FP32-F
     // Problem description with non-default layout
     // 576-4-4-1x1-192-4-4-8-1x1-2x2-3x3-0-NHWC-NCHW-NCHW-FP32-F
-    // clang-format off
-    stream << GetInChannels();
-    stream << sep << PrintDHW(sep, GetSpatialDims(), GetInDepth(), GetInHeight(), GetInWidth());
-    stream << sep << PrintDHW('x', GetSpatialDims(), GetWeightsDepth(), GetWeightsHeight(), GetWeightsWidth());
-    stream << sep << GetOutChannels();
-    stream << sep << PrintDHW(sep, GetSpatialDims(), GetOutDepth(), GetOutHeight(), GetOutWidth());
-    stream << sep << GetInBatchSize();
-    stream << sep << PrintDHW('x', GetSpatialDims(), GetPadD(), GetPadH(), GetPadW());
-    stream << sep << PrintDHW('x', GetSpatialDims(), GetKernelStrideD(), GetKernelStrideH(), GetKernelStrideW());
-    stream << sep << PrintDHW('x', GetSpatialDims(), GetDilationD(), GetDilationH(), GetDilationW());
-    stream << sep << GetBias();
-    if ((GetInLayout() == "NCHW" && GetWeightsLayout() == "NCHW" && GetOutLayout() == "NCHW")
-        || (GetInLayout() == "NCDHW" && GetWeightsLayout() == "NCDHW" && GetOutLayout() == "NCDHW"))
+    key << GetInChannels();
+    key << sep;
+    WriteDHW(key, sep, dims, GetInDepth(), GetInHeight(), GetInWidth());
+    key << sep;
+    WriteDHW(key, 'x', dims, GetWeightsDepth(), GetWeightsHeight(), GetWeightsWidth());
+    key << sep << GetOutChannels();
+    key << sep;
+    WriteDHW(key, sep, dims, GetOutDepth(), GetOutHeight(), GetOutWidth());
+    key << sep << GetInBatchSize();
+    key << sep;
+    WriteDHW(key, 'x', dims, GetPadD(), GetPadH(), GetPadW());
+    key << sep;
+    WriteDHW(key, 'x', dims, GetKernelStrideD(), GetKernelStrideH(), GetKernelStrideW());
+    key << sep;
+    WriteDHW(key, 'x', dims, GetDilationD(), GetDilationH(), GetDilationW());
+    key << sep << GetBias();
+    key << sep << GetInLayout();
+    if(!HasDefaultLayouts(*this))
     {
-        stream << sep << GetInLayout();
-    } else {
-        stream << sep << GetInLayout();
-        stream << sep << GetWeightsLayout();
-        stream << sep << GetOutLayout();
+        key << sep << GetWeightsLayout();
+        key << sep << GetOutLayout();
     }
-    stream << sep << EncodeDataTypesForKey(GetInDataType(), GetWeightsDataType(), GetOutDataType());
-    stream << sep << GetDirectionStr();
+    key << sep << EncodeDataTypesForKey(GetInDataType(), GetWeightsDataType(), GetOutDataType());
+    key << sep << GetDirectionStr();
 
-    // clang-format on
     // New performance config entries shall come into variable/optional part of db key.
     // This is to support backward compatibility with previous versions of databases.
-    std::ostringstream optional;
-    {
-        // Group count > 1 identifies Group/Depthwise modes.
-        if(GetGroupCount() != 1)
-            optional << "_g" << GetGroupCount();
-
-        if(const auto ct = GetInCastType())
-            optional << "_ci" << GetDataTypeName(*ct);
-        if(const auto ct = GetWeightsCastType())
-            optional << "_cw" << GetDataTypeName(*ct);
-        if(const auto ct = GetOutCastType())
-            optional << "_co" << GetDataTypeName(*ct);
-    }
-    if(!optional.str().empty())
-    {
-        stream << optional.str();
-    }
+
+    // Group count > 1 identifies Group/Depthwise modes.
+    if(GetGroupCount() != 1)
+        key << "_g" << GetGroupCount();
+
+    if(const auto ct = GetInCastType())
+        key << "_ci" << GetDataTypeName(*ct);
+    if(const auto ct = GetWeightsCastType())
+        key << "_cw" << GetDataTypeName(*ct);
+    if(const auto ct = GetOutCastType())
+        key << "_co" << GetDataTypeName(*ct);
 }
 
 bool ProblemDescription::IsLayoutDefault() const
@@ -37,20 +37,384 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <fstream>
+#include <iomanip>
 #include <ios>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <sstream>
 #include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace miopen {
 
+namespace {
+
+constexpr char TombstoneChar    = '#';
+constexpr auto IndexFileVersion = 1;
+constexpr auto IndexFieldWidth  = 20;
+
+/// Dead lines are not compacted away until there are at least this many of dead bytes.
+constexpr std::streamoff CompactionThreshold = 64 * 1024;
+
+struct DbFileStat
+{
+    std::uintmax_t size = 0;
+    std::int64_t time   = 0;
+
+    bool operator==(const DbFileStat& other) const
+    {
+        return size == other.size && time == other.time;
+    }
+    bool operator!=(const DbFileStat& other) const { return !(*this == other); }
+};
+
+boost::optional<DbFileStat> GetDbFileStat(const fs::path& path)
+{
+    auto ec         = std::error_code{};
+    const auto size = fs::file_size(path, ec);
+    if(ec)
+        return boost::none;
+    const auto time = fs::last_write_time(path, ec);
+    if(ec)
+        return boost::none;
+    return DbFileStat{size, static_cast<std::int64_t>(time.time_since_epoch().count())};
+}
+
+} // namespace
+
+/// Key->position index of a PlainTextDb file. Shared by all the PlainTextDb instances with the
+/// same path, so it has to be MT-safe itself. Must only be accessed while the db file lock is
+/// held.
+///
+/// The "<db>.idx" sidecar starts with a header which holds the index generation and the size and
+/// modification time of the db file the index has been synchronized with. It is followed by
+/// "<begin> <end> <key>" lines which are appended for each change of the db file. Removed keys
+/// have both positions set to -1. Later lines override former ones.
+class PlainTextDbIndex
+{
+    class PassKey
+    {
+    };
+
+public:
+    PlainTextDbIndex(const fs::path& db_path_, PassKey)
+        : db_path(db_path_), index_path(db_path_ + ".idx")
+    {
+    }
+
+    PlainTextDbIndex(const PlainTextDbIndex&) = delete;
+    PlainTextDbIndex& operator=(const PlainTextDbIndex&) = delete;
+
+    static PlainTextDbIndex& Get(const fs::path& db_path)
+    {
+        // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+        static std::mutex mutex;
+        const std::lock_guard<std::mutex> lock{mutex};
+
+        // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+        static auto instances = std::map<fs::path, std::unique_ptr<PlainTextDbIndex>>{};
+        auto& instance        = instances[db_path];
+        if(!instance)
+            instance = std::make_unique<PlainTextDbIndex>(db_path, PassKey{});
+        return *instance;
+    }
+
+    /// Brings the index in sync with the db file. Returns false if the db file is unreadable.
+    bool Sync()
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        return SyncUnsafe();
+    }
+
+    /// Drops the index and rebuilds it from the db file contents.
+    bool Rebuild()
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const auto stat = GetDbFileStat(db_path);
+        if(!stat)
+            return false;
+        return RebuildUnsafe(*stat);
+    }
+
+    RecordPositions Find(const std::string& key) const
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const auto it = entries.find(key);
+        return it != entries.end() ? it->second : RecordPositions{};
+    }
+
+    /// Records changes of the db file which have been done by this process.
+    void Update(const std::vector<std::pair<std::string, RecordPositions>>& changes)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+
+        for(const auto& change : changes)
+        {
+            const auto old = entries.find(change.first);
+            if(old != entries.end())
+            {
+                live_bytes -= old->second.end - old->second.begin;
+                entries.erase(old);
+            }
+
+            if(change.second.begin >= 0)
+            {
+                entries.emplace(change.first, change.second);
+                live_bytes += change.second.end - change.second.begin;
+            }
+        }
+
+        const auto stat = GetDbFileStat(db_path);
+        if(!stat)
+        {
+            synced = false;
+            return;
+        }
+        db_stat = *stat;
+        synced  = true;
+
+        if(!AppendEntriesUnsafe(changes) || !WriteHeaderUnsafe())
+            MIOPEN_LOG_W("Unable to update db index: " << index_path);
+    }
+
+    bool IsCompactionNeeded() const
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const auto dead_bytes = static_cast<std::streamoff>(db_stat.size) - live_bytes;
+        return dead_bytes > CompactionThreshold && dead_bytes > live_bytes;
+    }
+
+    /// Live records sorted by their position in the db file.
+    std::vector<std::pair<std::string, RecordPositions>> GetLiveRecords() const
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        auto records = std::vector<std::pair<std::string, RecordPositions>>{entries.begin(),
+                                                                            entries.end()};
+        std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.begin < rhs.second.begin;
+        });
+        return records;
+    }
+
+private:
+    fs::path db_path;
+    fs::path index_path;
+    mutable std::mutex mutex;
+
+    std::unordered_map<std::string, RecordPositions> entries;
+    std::streamoff live_bytes = 0;
+    std::uint64_t generation  = 0;
+    DbFileStat db_stat        = {};
+    std::streamoff index_size = 0;
+    bool synced               = false;
+
+    bool SyncUnsafe()
+    {
+        const auto stat = GetDbFileStat(db_path);
+        if(!stat)
+        {
+            entries.clear();
+            live_bytes = 0;
+            synced     = false;
+            return false;
+        }
+
+        if(synced && *stat == db_stat)
+            return true;
+
+        // Somebody else has changed the db file. Replay their changes from the sidecar if it
+        // matches the db file, otherwise fall back to the full scan.
+        if(LoadUnsafe(*stat))
+            return true;
+
+        return RebuildUnsafe(*stat);
+    }
+
+    bool LoadUnsafe(const DbFileStat& stat)
+    {
+        auto file = std::ifstream{index_path, std::ios::binary};
+        if(!file)
+            return false;
+
+        auto header = std::string{};
+        if(!std::getline(file, header))
+            return false;
+
+        auto header_stream   = std::istringstream{header};
+        auto magic           = std::string{};
+        auto version         = 0;
+        auto file_generation = std::uint64_t{};
+        auto file_stat       = DbFileStat{};
+        header_stream >> magic >> version >> file_generation >> file_stat.size >> file_stat.time;
+
+        if(!header_stream || magic != "MIOPEN_DB_INDEX" || version != IndexFileVersion ||
+           file_stat != stat)
+            return false;
+
+        if(!synced || file_generation != generation)
+        {
+            // Compacted or never read: replay from the first entry.
+            entries.clear();
+            live_bytes = 0;
+            index_size = file.tellg();
+        }
+        else
+        {
+            file.seekg(index_size);
+        }
+
+        auto line = std::string{};
+        while(std::getline(file, line))
+        {
+            const auto next_line_begin = file.tellg();
+            auto line_stream           = std::istringstream{line};
+            auto pos                   = RecordPositions{};
+            auto key                   = std::string{};
+            line_stream >> pos.begin >> pos.end >> key;
+
+            if(line_stream.fail() || key.empty())
+                return false;
+
+            const auto old = entries.find(key);
+            if(old != entries.end())
+            {
+                live_bytes -= old->second.end - old->second.begin;
+                entries.erase(old);
+            }
+            if(pos.begin >= 0)
+            {
+                entries.emplace(key, pos);
+                live_bytes += pos.end - pos.begin;
+            }
+            index_size = next_line_begin;
+        }
+
+        generation = file_generation;
+        db_stat    = stat;
+        synced     = true;
+        return true;
+    }
+
+    bool RebuildUnsafe(const DbFileStat& stat)
+    {
+        MIOPEN_LOG_I2("Building db index: " << index_path);
+
+        entries.clear();
+        live_bytes = 0;
+        synced     = false;
+
+        auto file = std::ifstream{db_path, std::ios::binary};
+        if(!file)
+            return false;
+
+        auto line   = std::string{};
+        auto n_line = 0;
+        while(true)
+        {
+            const auto line_begin = file.tellg();
+            if(!std::getline(file, line))
+                break;
+            ++n_line;
+            const auto next_line_begin = file.eof() ? static_cast<std::streamoff>(stat.size)
+                                                    : static_cast<std::streamoff>(file.tellg());
+
+            if(line.empty() || line[0] == TombstoneChar)
+                continue;
+
+            const auto key_size = line.find('=');
+            if(key_size == std::string::npos || key_size == 0)
+            {
+                MIOPEN_LOG_E("Ill-formed record: key not found: " << db_path << "#" << n_line);
+                continue;
+            }
+
+            auto key       = line.substr(0, key_size);
+            const auto old = entries.find(key);
+            if(old != entries.end())
+            {
+                // The last one wins as it has been appended later.
+                live_bytes -= old->second.end - old->second.begin;
+                entries.erase(old);
+            }
+            entries.emplace(std::move(key), RecordPositions{line_begin, next_line_begin});
+            live_bytes += next_line_begin - line_begin;
+        }
+
+        // Generations have to differ between processes rebuilding the same index, so that nobody
+        // replays a foreign sidecar incrementally.
+        generation = std::max<std::uint64_t>(
+            generation + 1, std::chrono::system_clock::now().time_since_epoch().count());
+        db_stat    = stat;
+        synced     = true;
+
+        if(!WriteUnsafe())
+            MIOPEN_LOG_W("Unable to write db index: " << index_path);
+        return true;
+    }
+
+    bool WriteUnsafe()
+    {
+        {
+            auto file = std::ofstream{index_path, std::ios::binary | std::ios::trunc};
+            if(!file)
+                return false;
+            WriteHeaderTo(file);
+            for(const auto& entry : entries)
+                file << entry.second.begin << ' ' << entry.second.end << ' ' << entry.first
+                     << '\n';
+            index_size = file.tellp();
+            if(!file)
+                return false;
+        }
+        fs::permissions(index_path, fs::perms::all);
+        return true;
+    }
+
+    bool AppendEntriesUnsafe(const std::vector<std::pair<std::string, RecordPositions>>& changes)
+    {
+        if(!fs::exists(index_path))
+            return WriteUnsafe();
+
+        auto file = std::ofstream{index_path, std::ios::binary | std::ios::app};
+        if(!file)
+            return false;
+        for(const auto& change : changes)
+            file << change.second.begin << ' ' << change.second.end << ' ' << change.first << '\n';
+        index_size = file.tellp();
+        return file.good();
+    }
+
+    bool WriteHeaderUnsafe()
+    {
+        auto file = std::fstream{index_path, std::ios::binary | std::ios::in | std::ios::out};
+        if(!file)
+            return false;
+        WriteHeaderTo(file);
+        return file.good();
+    }
+
+    void WriteHeaderTo(std::ostream& stream) const
+    {
+        // Fixed width fields allow the header to be updated in place.
+        stream << "MIOPEN_DB_INDEX " << IndexFileVersion << ' ' << std::setw(IndexFieldWidth)
+               << generation << ' ' << std::setw(IndexFieldWidth) << db_stat.size << ' '
+               << std::setw(IndexFieldWidth) << db_stat.time << '\n';
+    }
+};
+
 PlainTextDb::PlainTextDb(DbKinds db_kind_, const fs::path& filename_, bool is_system)
     : db_kind(db_kind_),
       filename(filename_),
       lock_file(LockFile::Get(LockFilePath(filename_))),
+      index(PlainTextDbIndex::Get(filename_)),
       warning_if_unreadable(is_system)
 {
     if(is_system)
@@ -146,9 +510,7 @@ boost::optional<DbRecord> PlainTextDb::FindRecordUnsafe(const std::string& key,
 
     MIOPEN_LOG_I2("Looking for key " << key << " in file " << filename);
 
-    std::ifstream file(filename, std::ios::binary);
-
-    if(!file)
+    if(!index.Sync())
     {
         const auto log_level = IsWarningIfUnreadable() && !MIOPEN_DISABLE_SYSDB
                                    ? LoggingLevel::Warning
@@ -157,86 +519,110 @@ boost::optional<DbRecord> PlainTextDb::FindRecordUnsafe(const std::string& key,
         return boost::none;
     }
 
-    int n_line = 0;
-    while(true)
-    {
-        std::string line;
-        const auto line_begin = file.tellg();
-        if(!std::getline(file, line))
-            break;
-        ++n_line;
-        const auto next_line_begin = file.tellg();
+    auto found = index.Find(key);
+    if(found.begin < 0)
+        return boost::none;
 
-        const auto key_size = line.find('=');
-        const bool is_key   = (key_size != std::string::npos && key_size != 0);
-        if(!is_key)
-        {
-            if(!line.empty()) // Do not blame empty lines.
-            {
-                MIOPEN_LOG_E("Ill-formed record: key not found: " << filename << "#" << n_line);
-            }
-            continue;
-        }
-        const auto current_key = line.substr(0, key_size);
+    auto is_stale = false;
+    auto record   = ReadRecordUnsafe(key, found, is_stale);
 
-        if(current_key != key)
+    if(is_stale)
+    {
+        // The file has been changed behind the index, i.e. not by PlainTextDb.
+        MIOPEN_LOG_I2("Db index is stale, rebuilding: " << filename);
+        if(!index.Rebuild())
+            return boost::none;
+        found = index.Find(key);
+        if(found.begin < 0)
+            return boost::none;
+        record = ReadRecordUnsafe(key, found, is_stale);
+        if(is_stale)
         {
-            continue;
+            MIOPEN_LOG_E("Db index is inconsistent with the file: " << filename);
+            return boost::none;
         }
-        MIOPEN_LOG_I2("Key match: " << current_key);
-        const auto contents = line.substr(key_size + 1);
+    }
 
-        if(contents.empty())
-        {
-            MIOPEN_LOG_E("None contents under the key: " << current_key << " form file " << filename
-                                                         << "#" << n_line);
-            continue;
-        }
-        MIOPEN_LOG_I2("Contents found: " << contents);
+    // A line which fails to parse is still replaced by the next write, not duplicated.
+    if(pos != nullptr)
+        *pos = found;
+    return record;
+}
 
-        DbRecord record(key);
-        const bool is_parse_ok = record.ParseContents(contents);
+boost::optional<DbRecord> PlainTextDb::ReadRecordUnsafe(const std::string& key,
+                                                        const RecordPositions& pos,
+                                                        bool& is_stale)
+{
+    is_stale = false;
 
-        if(!is_parse_ok)
-        {
-            MIOPEN_LOG_E("Error parsing payload under the key: " << current_key << " form file "
-                                                                 << filename << "#" << n_line);
-            MIOPEN_LOG_E("Contents: " << contents);
-        }
-        // A record with matching key have been found.
-        if(pos != nullptr)
-        {
-            pos->begin = line_begin;
-            pos->end   = next_line_begin;
-        }
-        return record;
+    std::ifstream file(filename, std::ios::binary);
+
+    if(!file)
+    {
+        MIOPEN_LOG_E("File is unreadable: " << filename);
+        return boost::none;
     }
-    // Record was not found
-    return boost::none;
+
+    return ReadRecordUnsafe(file, key, pos, is_stale);
 }
 
-static void Copy(std::istream& from, std::ostream& to, std::streamoff count)
+boost::optional<DbRecord> PlainTextDb::ReadRecordUnsafe(std::istream& file,
+                                                        const std::string& key,
+                                                        const RecordPositions& pos,
+                                                        bool& is_stale)
 {
-    constexpr auto buffer_size_limit = 4 * 1024 * 1024;
-    const auto buffer_size           = std::min<std::streamoff>(buffer_size_limit, count);
-    auto buffer                      = std::vector<char>(buffer_size, 0);
-    auto left                        = count;
+    is_stale = false;
 
-    while(left > 0 && !from.eof())
+    auto line = std::string(pos.end - pos.begin, '\0');
+    file.clear();
+    file.seekg(pos.begin);
+    file.read(&line[0], line.size());
+
+    const auto key_size = key.size();
+    if(file.gcount() != static_cast<std::streamsize>(line.size()) ||
+       line.compare(0, key_size, key) != 0 || line.size() <= key_size || line[key_size] != '=')
     {
-        const auto to_read = std::min<std::streamoff>(left, buffer_size);
-        from.read(buffer.data(), to_read);
-        const auto read = from.gcount();
-        to.write(buffer.data(), read);
-        left -= read;
+        is_stale = true;
+        return boost::none;
     }
+
+    if(!line.empty() && line.back() == '\n')
+        line.pop_back();
+    if(!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+    MIOPEN_LOG_I2("Key match: " << key);
+    const auto contents = line.substr(key_size + 1);
+
+    if(contents.empty())
+    {
+        MIOPEN_LOG_E("None contents under the key: " << key << " form file " << filename << "@"
+                                                     << pos.begin);
+        return boost::none;
+    }
+    MIOPEN_LOG_I2("Contents found: " << contents);
+
+    DbRecord record(key);
+    const bool is_parse_ok = record.ParseContents(contents);
+
+    if(!is_parse_ok)
+    {
+        MIOPEN_LOG_E("Error parsing payload under the key: " << key << " form file " << filename
+                                                             << "@" << pos.begin);
+        MIOPEN_LOG_E("Contents: " << contents);
+    }
+    return record;
 }
 
 bool PlainTextDb::FlushUnsafe(const DbRecord& record, const RecordPositions* pos)
 {
     assert(pos);
 
-    if(pos->begin < 0 || pos->end < 0)
+    // The new version is appended before the previous one is marked dead, so the record survives
+    // a failure in between: the last of the duplicates wins when the file is read.
+    auto new_pos = RecordPositions{};
+
+    if(record.GetSize() != 0)
     {
         {
             std::ofstream file(filename, std::ios::app | std::ios::binary);
@@ -247,47 +633,213 @@ bool PlainTextDb::FlushUnsafe(const DbRecord& record, const RecordPositions* pos
                 return false;
             }
 
-            (void)file.tellp();
+            file.seekp(0, std::ios::end);
+            new_pos.begin = file.tellp();
             record.WriteContents(file);
+            new_pos.end = file.tellp();
+
+            if(!file)
+            {
+                MIOPEN_LOG_E("Unable to write a record to file: " << filename);
+                return false;
+            }
         }
 
         fs::permissions(filename, fs::perms::all);
     }
-    else
+
+    if(pos->begin >= 0 && pos->end >= 0)
     {
-        std::ifstream from(filename, std::ios::ate | std::ios::binary);
+        // Mark the previous version of the record dead in place instead of rewriting the file.
+        std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+
+        if(!file)
+        {
+            MIOPEN_LOG_E("File is unwritable: " << filename);
+            return false;
+        }
+
+        file.seekp(pos->begin);
+        file.put(TombstoneChar);
+
+        if(!file)
+        {
+            MIOPEN_LOG_E("Unable to remove a record from file: " << filename);
+            return false;
+        }
+    }
+
+    index.Update({{record.key, new_pos}});
+
+    if(index.IsCompactionNeeded())
+        CompactUnsafe();
+    return true;
+}
+
+void PlainTextDb::CompactUnsafe()
+{
+    MIOPEN_LOG_I2("Compacting db file: " << filename);
+
+    const auto records   = index.GetLiveRecords();
+    const auto temp_name = filename + ".temp";
+
+    {
+        std::ifstream from(filename, std::ios::binary);
 
         if(!from)
         {
             MIOPEN_LOG_E("File is unreadable: " << filename);
-            return false;
+            return;
         }
 
-        const auto temp_name = filename + ".temp";
         std::ofstream to(temp_name, std::ios::binary);
 
         if(!to)
         {
             MIOPEN_LOG_E("Temp file is unwritable: " << temp_name);
+            return;
+        }
+
+        auto buffer = std::vector<char>{};
+        for(const auto& record : records)
+        {
+            buffer.resize(record.second.end - record.second.begin);
+            from.seekg(record.second.begin);
+            from.read(buffer.data(), buffer.size());
+            to.write(buffer.data(), from.gcount());
+        }
+
+        if(!from || !to)
+        {
+            MIOPEN_LOG_E("Unable to compact db file: " << filename);
+            to.close();
+            fs::remove(temp_name);
+            return;
+        }
+    }
+
+    auto ec = std::error_code{};
+    fs::rename(temp_name, filename, ec);
+    if(ec)
+    {
+        MIOPEN_LOG_E("Unable to replace db file with compacted one: " << filename << ", "
+                                                                      << ec.message());
+        fs::remove(temp_name, ec);
+        return;
+    }
+    fs::permissions(filename, fs::perms::all);
+
+    index.Rebuild();
+}
+
+bool PlainTextDb::WriteRecordsUnsafe(std::vector<BatchWrite>& writes)
+{
+    if(writes.empty())
+        return true;
+
+    MIOPEN_LOG_I2("Writing " << writes.size() << " records to " << filename);
+
+    {
+        // Creates the file if it is missing.
+        std::ofstream create(filename, std::ios::app | std::ios::binary);
+
+        if(!create)
+        {
+            MIOPEN_LOG_E("File is unwritable: " << filename);
             return false;
         }
+    }
+    fs::permissions(filename, fs::perms::all);
+
+    index.Sync();
+
+    std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+
+    if(!file)
+    {
+        MIOPEN_LOG_E("File is unwritable: " << filename);
+        return false;
+    }
+
+    // The index is only updated once after the batch, so the records written by the batch itself
+    // are looked up here.
+    auto changes = std::vector<std::pair<std::string, RecordPositions>>{};
+    auto written = std::unordered_map<std::string, std::size_t>{};
+    changes.reserve(writes.size());
+
+    for(auto& write : writes)
+    {
+        const auto& key = write.record.key;
+        const auto own  = written.find(key);
+        auto pos        = own != written.end() ? changes[own->second].second : index.Find(key);
+        auto old        = boost::optional<DbRecord>{};
+
+        if(pos.begin >= 0)
+        {
+            auto is_stale = false;
+            old           = ReadRecordUnsafe(file, key, pos, is_stale);
+
+            if(is_stale)
+            {
+                // The file has been changed behind the index, i.e. not by PlainTextDb.
+                MIOPEN_LOG_I2("Db index is stale, rebuilding: " << filename);
+                index.Rebuild();
+                pos = index.Find(key);
+                if(pos.begin >= 0)
+                    old = ReadRecordUnsafe(file, key, pos, is_stale);
+                if(is_stale)
+                {
+                    MIOPEN_LOG_E("Db index is inconsistent with the file: " << filename);
+                    return false;
+                }
+            }
+
+            file.clear();
+        }
 
-        const auto from_size = from.tellg();
-        from.seekg(std::ios::beg);
+        if(write.is_merge && old)
+            write.record.Merge(*old);
 
-        Copy(from, to, pos->begin);
-        record.WriteContents(to);
-        from.seekg(pos->end);
-        Copy(from, to, from_size - pos->end);
+        auto new_pos = RecordPositions{};
 
-        from.close();
-        to.close();
+        if(write.record.GetSize() != 0)
+        {
+            file.seekp(0, std::ios::end);
+            new_pos.begin = file.tellp();
+            write.record.WriteContents(file);
+            new_pos.end = file.tellp();
+        }
 
-        fs::remove(filename);
-        fs::rename(temp_name, filename);
-        /// \todo What if rename fails? Thou shalt not loose the original file.
-        fs::permissions(filename, fs::perms::all);
+        // Like in FlushUnsafe(), the old line is only marked dead once the new one is written.
+        // The record may have been removed behind the index.
+        if(pos.begin >= 0 && file)
+        {
+            file.seekp(pos.begin);
+            file.put(TombstoneChar);
+        }
+
+        if(!file)
+        {
+            MIOPEN_LOG_E("Unable to write a record to file: " << filename);
+            return false;
+        }
+
+        if(own != written.end())
+        {
+            changes[own->second].second = new_pos;
+        }
+        else
+        {
+            written.emplace(key, changes.size());
+            changes.emplace_back(key, new_pos);
+        }
     }
+
+    file.close();
+    index.Update(changes);
+
+    if(index.IsCompactionNeeded())
+        CompactUnsafe();
     return true;
 }
 
@@ -136,34 +136,37 @@ bool DbRecord::ParseContents(std::istream& contents)
             continue;
         }
 
-        auto id     = id_and_values.substr(0, id_size);
-        auto values = id_and_values.substr(id_size + 1);
+        if(AddItem(id_and_values.substr(0, id_size), id_and_values.substr(id_size + 1)))
+            ++found;
+    }
+
+    return (found > 0);
+}
 
+bool DbRecord::AddItem(std::string id, std::string values)
+{
 #if WORKAROUND_ISSUE_1987
-        // Detect legacy find-db item (v.1.0 ID:VALUES) and transform it to the current format.
-        // For now, *only* legacy find-db record use convolution algorithm as ID, so if ID is
-        // a valid algorithm, then we can safely assume that the item is in legacy format.
-        if(IsValidConvolutionDirAlgo(id))
+    // Detect legacy find-db item (v.1.0 ID:VALUES) and transform it to the current format.
+    // For now, *only* legacy find-db record use convolution algorithm as ID, so if ID is
+    // a valid algorithm, then we can safely assume that the item is in legacy format.
+    if(IsValidConvolutionDirAlgo(id))
+    {
+        if(!TransformFindDbItem10to20(id, values))
         {
-            if(!TransformFindDbItem10to20(id, values))
-            {
-                MIOPEN_LOG_E("Ill-formed legacy find-db item: " << values);
-                continue;
-            }
+            MIOPEN_LOG_E("Ill-formed legacy find-db item: " << values);
+            return false;
         }
+    }
 #endif
 
-        if(map.find(id) != map.end())
-        {
-            MIOPEN_LOG_E("Duplicate ID (ignored): " << id << "; key: " << key);
-            continue;
-        }
-
-        map.emplace(id, values);
-        ++found;
+    if(map.find(id) != map.end())
+    {
+        MIOPEN_LOG_E("Duplicate ID (ignored): " << id << "; key: " << key);
+        return false;
     }
 
-    return (found > 0);
+    map.emplace(std::move(id), std::move(values));
+    return true;
 }
 
 void DbRecord::WriteContents(std::ostream& stream) const
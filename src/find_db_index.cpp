@@ -0,0 +1,348 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/find_db_index.hpp>
+
+#include <miopen/logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace miopen {
+
+namespace {
+
+// Filter size, strides and dilations decide which solvers are applicable at all, so these
+// weigh more than the tensor sizes which mostly shift the balance between applicable ones.
+constexpr float size_weight     = 1.0f;
+constexpr float filter_weight   = 3.0f;
+constexpr float pad_weight      = 1.0f;
+constexpr float stride_weight   = 3.0f;
+constexpr float dilation_weight = 3.0f;
+constexpr float group_weight    = 2.0f;
+
+std::vector<std::string_view> Split(std::string_view str, char sep)
+{
+    auto ret = std::vector<std::string_view>{};
+    while(true)
+    {
+        const auto pos = str.find(sep);
+        ret.push_back(str.substr(0, pos));
+        if(pos == std::string_view::npos)
+            return ret;
+        str.remove_prefix(pos + 1);
+    }
+}
+
+bool ParseUint(std::string_view str, std::uint64_t& value)
+{
+    if(str.empty() || str.size() > 19)
+        return false;
+    value = 0;
+    for(const auto c : str)
+    {
+        if(c < '0' || c > '9')
+            return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+bool ParseFloat(std::string_view str, float& value)
+{
+    const auto copy = std::string{str};
+    char* end       = nullptr;
+    value           = std::strtof(copy.c_str(), &end);
+    return !copy.empty() && end == copy.c_str() + copy.size();
+}
+
+float Scale(std::uint64_t value) { return std::log2(static_cast<float>(value) + 1.0f); }
+
+bool AppendScaled(std::string_view str, float weight, std::vector<float>& values)
+{
+    auto value = std::uint64_t{};
+    if(!ParseUint(str, value))
+        return false;
+    values.push_back(weight * Scale(value));
+    return true;
+}
+
+bool AppendScaled(std::string_view str, char sep, float weight, std::vector<float>& values)
+{
+    for(const auto part : Split(str, sep))
+    {
+        if(!AppendScaled(part, weight, values))
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::optional<FindDbKeyFeatures> ParseFindDbKey(std::string_view key)
+{
+    // 2D: C-H-W-FyxFx-K-oH-oW-N-PxP-SxS-DxD-bias-Layout[-WLayout-OLayout]-Types-Dir[_gN][_ci..]
+    // 3D: C-D-H-W-FdxFyxFx-K-oD-oH-oW-N-PxPxP-SxSxS-DxDxD-bias-Layout[..]-Types-Dir[..]
+    const auto suffix_pos = key.find('_');
+    const auto tokens     = Split(key.substr(0, suffix_pos), '-');
+
+    const auto filter = std::find_if(tokens.begin(), tokens.end(), [](auto token) {
+                            return token.find('x') != std::string_view::npos;
+                        }) -
+                        tokens.begin();
+    if(filter == static_cast<std::ptrdiff_t>(tokens.size()))
+        return std::nullopt;
+
+    const auto dims = std::count(tokens[filter].begin(), tokens[filter].end(), 'x') + 1;
+    const auto layouts = static_cast<std::ptrdiff_t>(tokens.size()) - (2 * dims + 10);
+
+    if(filter != dims + 1 || (layouts != 1 && layouts != 3))
+        return std::nullopt;
+
+    const auto at = [&](std::ptrdiff_t i) { return tokens[i]; };
+    auto ret      = FindDbKeyFeatures{};
+    auto& values  = ret.values;
+
+    for(auto i = 0; i <= dims; ++i)
+    {
+        if(!AppendScaled(at(i), size_weight, values))
+            return std::nullopt;
+    }
+
+    const auto out  = filter + 2;
+    const auto pads = out + dims + 1;
+    if(!AppendScaled(at(filter), 'x', filter_weight, values) ||
+       !AppendScaled(at(filter + 1), size_weight, values) ||
+       !AppendScaled(at(out + dims), size_weight, values) ||
+       !AppendScaled(at(pads), 'x', pad_weight, values) ||
+       !AppendScaled(at(pads + 1), 'x', stride_weight, values) ||
+       !AppendScaled(at(pads + 2), 'x', dilation_weight, values))
+        return std::nullopt;
+
+    auto& category = ret.category;
+    category       = std::to_string(dims);
+    for(auto i = pads + 3; i < static_cast<std::ptrdiff_t>(tokens.size()); ++i)
+    {
+        category += '-';
+        category += at(i);
+    }
+
+    auto groups = std::uint64_t{1};
+    if(suffix_pos != std::string_view::npos)
+    {
+        for(const auto part : Split(key.substr(suffix_pos + 1), '_'))
+        {
+            if(!part.empty() && part[0] == 'g' && ParseUint(part.substr(1), groups))
+                continue;
+            category += '_';
+            category += part;
+        }
+    }
+
+    // Grouped convolutions are served by a different set of solvers.
+    if(groups != 1)
+        category += "_g";
+    values.push_back(group_weight * Scale(groups));
+    return ret;
+}
+
+const FindDbIndex& FindDbIndex::GetCached(const fs::path& path)
+{
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static std::mutex mutex;
+    const std::lock_guard<std::mutex> lock{mutex};
+
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static auto instances = std::map<fs::path, FindDbIndex>{};
+    const auto it         = instances.find(path);
+
+    if(it != instances.end())
+        return it->second;
+
+    auto& instance = instances[path];
+    instance.Load(path);
+    MIOPEN_LOG_I("Find-db index of " << instance.Size() << " records built from " << path);
+    return instance;
+}
+
+void FindDbIndex::Load(const fs::path& path)
+{
+    auto file = std::ifstream{path};
+    if(!file)
+    {
+        MIOPEN_LOG_I2("Unable to read find-db for the index: " << path);
+        return;
+    }
+
+    auto line = std::string{};
+    while(std::getline(file, line))
+    {
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        const auto key_size = line.find('=');
+        if(key_size == std::string::npos || key_size == 0)
+            continue;
+
+        const auto view = std::string_view{line};
+        Add(view.substr(0, key_size), view.substr(key_size + 1));
+    }
+}
+
+bool FindDbIndex::Add(std::string_view key, std::string_view contents)
+{
+    auto features = ParseFindDbKey(key);
+    if(!features)
+        return false;
+
+    auto record   = Record{std::string{key}, std::move(features->values), {}};
+    auto& entries = record.entries;
+
+    for(const auto item : Split(contents, ';'))
+    {
+        const auto id_size = item.find(':');
+        if(id_size == std::string_view::npos)
+            continue;
+
+        const auto id     = item.substr(0, id_size);
+        const auto fields = Split(item.substr(id_size + 1), ',');
+
+        // Legacy records are keyed by the algorithm and start the values with the solver.
+        const auto legacy = !fields.empty() && !fields[0].empty() &&
+                            (fields[0][0] < '0' || fields[0][0] > '9');
+        const auto first  = legacy ? std::size_t{1} : std::size_t{0};
+        auto time         = 0.0f;
+        auto workspace    = std::uint64_t{};
+
+        if(fields.size() < first + 2 || !ParseFloat(fields[first], time) ||
+           !ParseUint(fields[first + 1], workspace))
+            continue;
+
+        entries.push_back({GetSolverId(legacy ? fields[0] : id), time, workspace});
+    }
+
+    if(entries.empty())
+        return false;
+
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& l, const auto& r) {
+        return l.time < r.time;
+    });
+    categories[std::move(features->category)].push_back(std::move(record));
+    ++size;
+    return true;
+}
+
+const FindDbIndex::Record* FindDbIndex::Find(std::string_view key) const
+{
+    const auto features = ParseFindDbKey(key);
+    if(!features)
+        return nullptr;
+
+    const auto category = categories.find(features->category);
+    if(category == categories.end())
+        return nullptr;
+
+    const auto& records = category->second;
+    const auto it       = std::find_if(
+        records.begin(), records.end(), [&](const auto& record) { return record.key == key; });
+    return it != records.end() ? &*it : nullptr;
+}
+
+std::vector<FindDbIndex::Neighbor> FindDbIndex::Nearest(std::string_view key, std::size_t k) const
+{
+    const auto features = ParseFindDbKey(key);
+    if(!features)
+        return {};
+
+    const auto category = categories.find(features->category);
+    if(category == categories.end())
+        return {};
+
+    auto ret = std::vector<Neighbor>{};
+    ret.reserve(category->second.size());
+
+    for(const auto& record : category->second)
+    {
+        if(record.key == key || record.values.size() != features->values.size())
+            continue;
+
+        auto distance = 0.0f;
+        for(std::size_t i = 0; i < record.values.size(); ++i)
+        {
+            const auto diff = record.values[i] - features->values[i];
+            distance += diff * diff;
+        }
+        ret.push_back({&record, std::sqrt(distance)});
+    }
+
+    const auto closer = [](const auto& l, const auto& r) { return l.distance < r.distance; };
+    k                 = std::min(k, ret.size());
+    std::partial_sort(ret.begin(), ret.begin() + k, ret.end(), closer);
+    ret.resize(k);
+    return ret;
+}
+
+std::vector<FindDbIndex::Suggestion> FindDbIndex::Suggest(std::string_view key,
+                                                          std::size_t k) const
+{
+    auto ret = std::vector<Suggestion>{};
+
+    for(const auto& neighbor : Nearest(key, k))
+    {
+        const auto weight = 1.0f / (1.0f + neighbor.distance);
+        auto rank         = 0;
+
+        for(const auto& entry : neighbor.record->entries)
+        {
+            const auto& name = solvers[entry.solver];
+            auto it          = std::find_if(
+                ret.begin(), ret.end(), [&](const auto& item) { return item.solver == name; });
+            if(it == ret.end())
+                it = ret.insert(ret.end(), {name, entry.time, entry.workspace, 0.0f});
+            it->score += weight / static_cast<float>(++rank);
+        }
+    }
+
+    std::stable_sort(ret.begin(), ret.end(), [](const auto& l, const auto& r) {
+        return l.score > r.score;
+    });
+    return ret;
+}
+
+std::uint32_t FindDbIndex::GetSolverId(std::string_view name)
+{
+    const auto inserted =
+        solver_ids.emplace(std::string{name}, static_cast<std::uint32_t>(solvers.size()));
+    if(inserted.second)
+        solvers.emplace_back(name);
+    return inserted.first->second;
+}
+
+} // namespace miopen
@@ -26,6 +26,7 @@
 
 #include <miopen/generic_search.hpp>
 #include <miopen/generic_search_controls.hpp>
+#include <miopen/logger.hpp>
 
 #include <cstddef>
 #include <chrono>
@@ -47,6 +48,20 @@ TuningIterationScopedLimiter::~TuningIterationScopedLimiter()
 {
     tuning_iterations_limit = old_limit;
 }
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+static ThreadPool* tuning_thread_pool = nullptr;
+
+TuningThreadPoolScopedOverride::TuningThreadPoolScopedOverride(ThreadPool& pool)
+    : old_pool(tuning_thread_pool)
+{
+    tuning_thread_pool = &pool;
+}
+
+TuningThreadPoolScopedOverride::~TuningThreadPoolScopedOverride()
+{
+    tuning_thread_pool = old_pool;
+}
 } // namespace debug
 
 std::size_t GetTuningIterationsMax()
@@ -63,5 +78,34 @@ std::chrono::milliseconds GetTuningTimeMax()
 
 std::size_t GetTuningThreadsMax() { return env::value(MIOPEN_COMPILE_PARALLEL_LEVEL); }
 
+ThreadPool& GetTuningThreadPool()
+{
+    if(debug::tuning_thread_pool != nullptr)
+        return *debug::tuning_thread_pool;
+    return ThreadPool::Shared();
+}
+
+search::Options GetSearchOptions(search::Strategy preferred)
+{
+    search::Options options;
+    options.strategy = preferred;
+
+    const auto name = env::value(MIOPEN_DEBUG_TUNING_STRATEGY);
+    if(!name.empty())
+    {
+        const auto strategy = search::ParseStrategy(name);
+        if(strategy)
+            options.strategy = *strategy;
+        else
+            MIOPEN_LOG_W("Unknown search strategy: " << name << ", using " << preferred);
+    }
+
+    // The model is only worth it if it saves measurements.
+    const auto default_patience = options.strategy == search::Strategy::ModelGuided ? 64 : 0;
+    options.patience =
+        env::value_or(MIOPEN_DEBUG_TUNING_PATIENCE, static_cast<uint64_t>(default_patience));
+    return options;
+}
+
 } // namespace solver
 } // namespace miopen
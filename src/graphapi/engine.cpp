@@ -28,6 +28,8 @@
 #include <miopen/graphapi/engine.hpp>
 #include <miopen/graphapi/opgraph.hpp>
 
+#include <nlohmann/json.hpp>
+
 namespace miopen {
 
 namespace graphapi {
@@ -42,7 +44,8 @@ EngineBuilder& EngineBuilder::setGlobalIndex(int64_t globalIndex)
 {
     if(globalIndex >= 0)
     {
-        mGlobalIndex = globalIndex;
+        mGlobalIndex    = globalIndex;
+        mGlobalIndexSet = true;
     }
     else
     {
@@ -70,6 +73,7 @@ Engine EngineBuilder::build()
     {
         // TODO: validate mSmCount
         Engine engine       = mOpGraph->getEngines()[mGlobalIndex];
+        engine.mOpGraph     = mOpGraph;
         engine.mGlobalIndex = mGlobalIndex;
         engine.mSmCount     = mSmCount;
         return engine;
@@ -80,6 +84,42 @@ Engine EngineBuilder::build()
     }
 }
 
+void to_json(nlohmann::json& json, const Engine& engine)
+{
+    const auto& solver = engine.mSolution.GetSolver();
+    json               = nlohmann::json{
+        {"index", engine.mGlobalIndex},
+        {"sm_count", engine.mSmCount},
+        {"solver", solver.IsValid() ? solver.ToString() : std::string{}},
+        {"workspace", engine.mSolution.GetWorkspaceSize()},
+        {"heur_mode", nullptr},
+    };
+    if(engine.mHeurMode.has_value())
+    {
+        json["heur_mode"] = *engine.mHeurMode;
+    }
+}
+
+void from_json(const nlohmann::json& json, Engine& engine)
+{
+    engine = Engine{};
+    json.at("index").get_to(engine.mGlobalIndex);
+    json.at("sm_count").get_to(engine.mSmCount);
+
+    const auto solver = json.at("solver").get<std::string>();
+    if(!solver.empty())
+    {
+        engine.mSolution.SetSolver(solver::Id{solver});
+    }
+    engine.mSolution.SetWorkspaceSize(json.at("workspace").get<std::size_t>());
+
+    const auto& heurMode = json.at("heur_mode");
+    if(!heurMode.is_null())
+    {
+        engine.mHeurMode = heurMode.get<miopenBackendHeurMode_t>();
+    }
+}
+
 void BackendEngineDescriptor::setAttribute(miopenBackendAttributeName_t attributeName,
                                            miopenBackendAttributeType_t attributeType,
                                            int64_t elementCount,
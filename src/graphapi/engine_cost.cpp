@@ -0,0 +1,293 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/errors.hpp>
+#include <miopen/graphapi/convolution.hpp>
+#include <miopen/graphapi/engine_cost.hpp>
+#include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/matmul.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+#include <miopen/graphapi/pointwise_fusion.hpp>
+#include <miopen/graphapi/reduction.hpp>
+#include <miopen/graphapi/rng.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace miopen {
+
+namespace graphapi {
+
+namespace {
+
+// A mid-range device, for when the heuristics are not told the number of compute units
+constexpr int32_t defaultSmCount = 64;
+// 128 fp32 operations per clock at 2 GHz
+constexpr double flopsPerSmPerMs = 2.56e8;
+constexpr double bytesPerMs      = 1.6e9;
+// Kernel launch and the synchronization between two steps
+constexpr double stepOverheadMs = 5e-3;
+// Output elements of one workgroup of a typical kernel
+constexpr double elementsPerWorkgroup = 1024;
+
+double elementCount(const Tensor* tensor)
+{
+    const auto& dims = tensor->getDimensions();
+    return std::accumulate(dims.cbegin(), dims.cend(), 1.0, std::multiplies<double>{});
+}
+
+/// Share of the arithmetic of the direct method that the algorithm of the solver of the engine
+/// does for a convolution
+double convolutionFlopsScale(const Engine& engine)
+{
+    const auto& solver = engine.getSolution().GetSolver();
+    if(!solver.IsValid())
+    {
+        return 1.0;
+    }
+    switch(solver.GetAlgo())
+    {
+    // F(2x2, 3x3) does 16 multiplications per tile where the direct method does 36
+    case miopenConvolutionAlgoWinograd: return 16.0 / 36.0;
+    // Pointwise products in the frequency domain, plus the transforms
+    case miopenConvolutionAlgoFFT: return 0.5;
+    default: return 1.0;
+    }
+}
+
+double nodeFlops(const OpNode& node, const Engine& engine)
+{
+    if(const auto* matmul = dynamic_cast<const OperationMatmul*>(&node))
+    {
+        const auto& a = matmul->getA()->getDimensions();
+        return 2.0 * elementCount(matmul->getC()) * static_cast<double>(a.back());
+    }
+    if(const auto* conv = dynamic_cast<const OperationConvolution*>(&node))
+    {
+        // Every direction does one multiply-add per output position and filter element
+        const auto& y = conv->getY()->getDimensions();
+        const double positions =
+            std::accumulate(y.cbegin() + 2, y.cend(), 1.0, std::multiplies<double>{});
+        return 2.0 * static_cast<double>(y[0]) * positions * elementCount(conv->getW()) *
+               convolutionFlopsScale(engine);
+    }
+    if(const auto* fused = dynamic_cast<const OperationFusedPointwise*>(&node))
+    {
+        const auto& dims      = fused->getDimensions();
+        const double elements =
+            std::accumulate(dims.cbegin(), dims.cend(), 1.0, std::multiplies<double>{});
+        return elements * static_cast<double>(fused->getInstructions().size());
+    }
+    if(const auto* reduction = dynamic_cast<const OperationReduction*>(&node))
+    {
+        return elementCount(reduction->getX());
+    }
+    if(dynamic_cast<const OperationPointwise*>(&node) != nullptr ||
+       dynamic_cast<const OperationRng*>(&node) != nullptr)
+    {
+        return elementCount(node.getOutTensors().front());
+    }
+    return 0;
+}
+
+/// Share of the compute units kept busy by the waves of workgroups that produce outputs elements
+double utilization(double outputs, int32_t smCount)
+{
+    const double workgroups = std::max(1.0, std::ceil(outputs / elementsPerWorkgroup));
+    const double waves      = std::ceil(workgroups / smCount);
+    return workgroups / (waves * smCount);
+}
+
+EngineCost estimateCost(const ExecutionSchedule& schedule,
+                        const Engine& engine,
+                        int32_t smCount,
+                        const TimingRecords* records)
+{
+    smCount = smCount > 0 ? smCount : defaultSmCount;
+
+    const size_t solutionWorkspace = engine.getSolution().GetWorkspaceSize();
+
+    EngineCost cost;
+    cost.mWorkspaceSize = schedule.getWorkspaceSize() + solutionWorkspace;
+    // The solution writes its workspace and reads it back
+    cost.mBytes = 2.0 * static_cast<double>(solutionWorkspace);
+    cost.mTime  = cost.mBytes / bytesPerMs;
+
+    for(const OpNode* step : schedule.getSteps())
+    {
+        const double flops = nodeFlops(*step, engine);
+        double bytes       = 0;
+        double outputs     = 0;
+        for(const Tensor* tensor : step->getInTensors())
+        {
+            bytes += static_cast<double>(getTensorFootprint(*tensor));
+        }
+        for(const Tensor* tensor : step->getOutTensors())
+        {
+            bytes += static_cast<double>(getTensorFootprint(*tensor));
+            outputs += elementCount(tensor);
+        }
+        cost.mFlops += flops;
+        cost.mBytes += bytes;
+
+        if(records != nullptr)
+        {
+            if(const auto recorded = records->find(*step, engine))
+            {
+                cost.mTime += *recorded;
+                ++cost.mRecordedNodes;
+                continue;
+            }
+        }
+
+        const double computeMs =
+            flops / (flopsPerSmPerMs * smCount * utilization(outputs, smCount));
+        cost.mTime += stepOverheadMs + std::max(computeMs, bytes / bytesPerMs);
+    }
+
+    return cost;
+}
+
+} // namespace
+
+EngineCost estimateCost(const OpGraph& graph,
+                        const Engine& engine,
+                        int32_t smCount,
+                        const TimingRecords* records)
+{
+    return estimateCost(ExecutionSchedule(graph), engine, smCount, records);
+}
+
+std::vector<size_t> rankEngines(const OpGraph& graph,
+                                const std::vector<Engine>& engines,
+                                miopenBackendHeurMode_t mode,
+                                int32_t smCount,
+                                const TimingRecords* records)
+{
+    std::vector<size_t> ranking(engines.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    if(mode == MIOPEN_HEUR_MODE_FALLBACK || engines.size() < 2)
+    {
+        return ranking;
+    }
+
+    const ExecutionSchedule schedule(graph);
+    const TimingRecords* used = mode == MIOPEN_HEUR_MODE_B ? records : nullptr;
+    std::vector<EngineCost> costs;
+    costs.reserve(engines.size());
+    for(const auto& engine : engines)
+    {
+        costs.push_back(estimateCost(schedule, engine, smCount, used));
+    }
+
+    std::stable_sort(ranking.begin(), ranking.end(), [&](size_t left, size_t right) {
+        return std::tie(costs[left].mTime, costs[left].mWorkspaceSize) <
+               std::tie(costs[right].mTime, costs[right].mWorkspaceSize);
+    });
+    return ranking;
+}
+
+EngineRankingCache& EngineRankingCache::instance()
+{
+    static EngineRankingCache cache;
+    return cache;
+}
+
+std::optional<std::vector<size_t>>
+EngineRankingCache::find(const OpGraph& graph, miopenBackendHeurMode_t mode, int32_t smCount) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto it =
+        mRankings.find(Key{graph.getShapedForm(), mode, smCount, graph.getEngines().size()});
+    if(it == mRankings.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void EngineRankingCache::insert(const OpGraph& graph,
+                                miopenBackendHeurMode_t mode,
+                                int32_t smCount,
+                                std::vector<size_t> ranking)
+{
+    MIOPEN_THROW_IF(ranking.size() != graph.getEngines().size(),
+                    "The ranking does not cover the engines of the graph");
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRankings[Key{graph.getShapedForm(), mode, smCount, graph.getEngines().size()}] =
+        std::move(ranking);
+}
+
+size_t EngineRankingCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRankings.size();
+}
+
+void EngineRankingCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRankings.clear();
+}
+
+RankingScore scoreRanking(const std::vector<size_t>& ranking, const std::vector<double>& times)
+{
+    MIOPEN_THROW_IF(ranking.size() != times.size(), "Every ranked engine needs a time");
+
+    RankingScore score;
+    if(ranking.empty())
+    {
+        return score;
+    }
+
+    size_t pairs      = 0;
+    size_t concordant = 0;
+    for(size_t i = 0; i < ranking.size(); ++i)
+    {
+        for(size_t j = i + 1; j < ranking.size(); ++j)
+        {
+            ++pairs;
+            // ties in the measurements agree with either order
+            if(times[ranking[i]] <= times[ranking[j]])
+            {
+                ++concordant;
+            }
+        }
+    }
+    if(pairs > 0)
+    {
+        score.mConcordance = static_cast<double>(concordant) / static_cast<double>(pairs);
+    }
+
+    const double best = *std::min_element(times.cbegin(), times.cend());
+    score.mRegret     = best > 0 ? times[ranking.front()] / best : 1.0;
+    return score;
+}
+
+} // namespace graphapi
+
+} // namespace miopen
@@ -26,6 +26,8 @@
 
 #include <miopen/errors.hpp>
 #include <miopen/graphapi/engineheur.hpp>
+#include <miopen/graphapi/execution_plan_cache.hpp>
+#include <miopen/handle.hpp>
 
 #include <algorithm>
 
@@ -52,6 +54,62 @@ EngineHeurBuilder& EngineHeurBuilder::setSmCount(int32_t smCount)
     return *this;
 }
 
+EngineHeurBuilder& EngineHeurBuilder::setTimingRecords(const TimingRecords* timingRecords)
+{
+    mTimingRecords = timingRecords;
+    return *this;
+}
+
+std::vector<size_t> EngineHeurBuilder::rank() const
+{
+    const OpGraph& graph  = *mEngineHeur.mOpGraph;
+    const auto& engines   = graph.getEngines();
+    const auto mode       = mEngineHeur.mMode;
+    const int32_t smCount = mEngineHeur.mSmCount;
+
+    if(mTimingRecords != nullptr)
+    {
+        return rankEngines(graph, engines, mode, smCount, mTimingRecords);
+    }
+
+    // The engine of an execution plan cached for the graph goes first, the others keep their
+    // order: the plan of a graph rebuilt with the same structure and shapes skips the ranking
+    if(graph.getHandle() != nullptr)
+    {
+        if(auto cached = ExecutionPlanCache::instance().findEngineIndex(
+               graph, graph.getHandle(), mode))
+        {
+            std::vector<size_t> ranking{static_cast<size_t>(*cached)};
+            for(size_t i = 0; i < engines.size(); ++i)
+            {
+                if(i != ranking.front())
+                {
+                    ranking.push_back(i);
+                }
+            }
+            return ranking;
+        }
+    }
+
+    // The find-db belongs to the device of the handle and grows as problems are tuned, so
+    // rankings it backs are not shared through the cache
+    if(mode == MIOPEN_HEUR_MODE_B && graph.getHandle() != nullptr)
+    {
+        const FindDbTimingRecords findDb(miopen::deref(graph.getHandle()));
+        return rankEngines(graph, engines, mode, smCount, &findDb);
+    }
+
+    auto& cache = EngineRankingCache::instance();
+    if(auto cached = cache.find(graph, mode, smCount))
+    {
+        return std::move(*cached);
+    }
+
+    auto ranking = rankEngines(graph, engines, mode, smCount);
+    cache.insert(graph, mode, smCount, ranking);
+    return ranking;
+}
+
 EngineHeur EngineHeurBuilder::build()
 {
     if(mEngineHeur.mOpGraph == nullptr || !mModeSet)
@@ -61,14 +119,17 @@ EngineHeur EngineHeurBuilder::build()
 
     EngineHeur engineHeur(mEngineHeur);
 
-    /* TODO: find solutions
-     * For now: just copy
-     * solutions from OpGraph
-     */
+    // The global index of an engine stays its index in the graph, whatever its rank
     const auto& engines = engineHeur.mOpGraph->getEngines();
-    std::for_each(engines.begin(), engines.end(), [&engineHeur](const Engine& engine) {
-        engineHeur.mResults.emplace_back(engine);
-    });
+    for(size_t i : rank())
+    {
+        Engine engine       = engines[i];
+        engine.mOpGraph     = engineHeur.mOpGraph;
+        engine.mGlobalIndex = i;
+        engine.mSmCount     = engineHeur.mSmCount;
+        engine.mHeurMode    = engineHeur.mMode;
+        engineHeur.mResults.emplace_back(std::move(engine));
+    }
 
     return engineHeur;
 }
@@ -24,19 +24,252 @@
  *
  *******************************************************************************/
 
+#include <miopen/datatype.hpp>
+#include <miopen/env.hpp>
 #include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/execution_plan_cache.hpp>
+#include <miopen/graphapi/host_executor.hpp>
+#include <miopen/graphapi/pointwise_fusion.hpp>
+#include <miopen/handle.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <utility>
+
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_GRAPHAPI_FUSE_POINTWISE)
 
 namespace miopen {
 
 namespace graphapi {
 
-std::string ExecutionPlan::getJsonRepresentation() const
+size_t getTensorFootprint(const Tensor& tensor)
+{
+    const auto& dims    = tensor.getDimensions();
+    const auto& strides = tensor.getStrides();
+    size_t last         = 0;
+    for(size_t d = 0; d < dims.size(); ++d)
+    {
+        if(dims[d] == 0)
+        {
+            return 0;
+        }
+        last += (dims[d] - 1) * strides[d];
+    }
+    return (last + 1) * get_data_size(tensor.getDataType());
+}
+
+ExecutionSchedule::ExecutionSchedule(const OpGraph& graph, bool fusePointwise)
+{
+    const auto& order = graph.getTopologicalOrder();
+    mSteps.assign(order.cbegin(), order.cend());
+    if(fusePointwise)
+    {
+        auto fusion = graphapi::fusePointwise(mSteps);
+        mSteps      = std::move(fusion.mSteps);
+        mFusedNodes = std::move(fusion.mFusedNodes);
+    }
+
+    // Lifetime of every virtual tensor, from the step that writes it to the last step that
+    // reads it
+    std::unordered_map<const Tensor*, size_t> allocationOf;
+    for(size_t step = 0; step < mSteps.size(); ++step)
+    {
+        for(const Tensor* input : mSteps[step]->getInTensors())
+        {
+            if(input == nullptr || !input->isVirtual())
+            {
+                continue;
+            }
+            auto it = allocationOf.find(input);
+            MIOPEN_THROW_IF(it == allocationOf.end(),
+                            "Virtual tensor " + std::to_string(input->getId()) +
+                                " is not produced by the operation graph");
+            mAllocations[it->second].mLastStep = step;
+        }
+        for(const Tensor* output : mSteps[step]->getOutTensors())
+        {
+            if(output->isVirtual())
+            {
+                Allocation allocation;
+                allocation.mTensor    = output;
+                allocation.mSize      = getTensorFootprint(*output);
+                allocation.mFirstStep = step;
+                allocation.mLastStep  = step;
+                allocationOf.emplace(output, mAllocations.size());
+                mAllocations.push_back(allocation);
+            }
+        }
+    }
+
+    // Greedy by size: place the largest tensors first, each at the lowest aligned offset that
+    // does not overlap a tensor alive at the same time.
+    std::vector<size_t> bySize(mAllocations.size());
+    std::iota(bySize.begin(), bySize.end(), 0);
+    std::stable_sort(bySize.begin(), bySize.end(), [&](size_t left, size_t right) {
+        return mAllocations[left].mSize > mAllocations[right].mSize;
+    });
+
+    std::vector<size_t> placed;
+    std::vector<std::pair<size_t, size_t>> busy;
+    for(size_t index : bySize)
+    {
+        Allocation& allocation = mAllocations[index];
+
+        busy.clear();
+        for(size_t other_index : placed)
+        {
+            const Allocation& other = mAllocations[other_index];
+            if(other.mFirstStep <= allocation.mLastStep && allocation.mFirstStep <= other.mLastStep)
+            {
+                busy.emplace_back(other.mOffset, other.mOffset + other.mSize);
+            }
+        }
+        std::sort(busy.begin(), busy.end());
+
+        size_t offset = 0;
+        for(const auto& [begin, end] : busy)
+        {
+            if(offset + allocation.mSize <= begin)
+            {
+                break;
+            }
+            offset = std::max(offset, (end + alignment - 1) / alignment * alignment);
+        }
+
+        allocation.mOffset = offset;
+        mWorkspaceSize     = std::max(mWorkspaceSize, offset + allocation.mSize);
+        placed.push_back(index);
+    }
+}
+
+std::unordered_map<const Tensor*, void*>
+ExecutionSchedule::bind(const VariantPack& variantPack) const
+{
+    std::unordered_map<const Tensor*, void*> buffers;
+
+    auto bindTensors = [&](const std::vector<Tensor*>& tensors) {
+        for(const Tensor* tensor : tensors)
+        {
+            if(tensor != nullptr && !tensor->isVirtual() && buffers.count(tensor) == 0)
+            {
+                buffers.emplace(tensor, variantPack.getDataPointer(tensor->getId()));
+            }
+        }
+    };
+    for(const OpNode* step : mSteps)
+    {
+        bindTensors(step->getInTensors());
+        bindTensors(step->getOutTensors());
+    }
+
+    auto* workspace = static_cast<char*>(variantPack.getWorkspace());
+    MIOPEN_THROW_IF(workspace == nullptr && mWorkspaceSize > 0,
+                    "The execution plan needs a workspace of " + std::to_string(mWorkspaceSize) +
+                        " bytes");
+    for(const Allocation& allocation : mAllocations)
+    {
+        buffers.emplace(allocation.mTensor, workspace + allocation.mOffset);
+    }
+
+    return buffers;
+}
+
+namespace {
+
+constexpr int executionPlanJsonVersion = 3;
+
+nlohmann::json shapedFormToJson(const OpGraph::ShapedForm& form)
+{
+    return {
+        {"hash", form.mForm.mHash},
+        {"nodes", form.mForm.mNodes},
+        {"edges", form.mForm.mEdges},
+        {"shape_hash", form.mHash},
+        {"shape_edges", form.mEdges},
+    };
+}
+
+OpGraph::ShapedForm shapedFormFromJson(const nlohmann::json& json)
+{
+    OpGraph::ShapedForm form;
+    json.at("hash").get_to(form.mForm.mHash);
+    json.at("nodes").get_to(form.mForm.mNodes);
+    json.at("edges").get_to(form.mForm.mEdges);
+    json.at("shape_hash").get_to(form.mHash);
+    json.at("shape_edges").get_to(form.mEdges);
+    return form;
+}
+
+} // namespace
+
+std::string ExecutionPlan::getJsonRepresentation() const { return nlohmann::json(*this).dump(); }
+
+void to_json(nlohmann::json& json, const ExecutionPlan& plan)
+{
+    json = nlohmann::json{
+        {"version", executionPlanJsonVersion},
+        {"graph", shapedFormToJson(plan.mGraphForm)},
+        {"device", plan.mDevice},
+        {"engine", plan.mEngineCfg.getEngine()},
+        {"intermediates", plan.mIntermediateIds},
+        {"workspace", plan.mWorkspaceSize},
+    };
+}
+
+void from_json(const nlohmann::json& json, ExecutionPlan& plan)
 {
-    // TODO: Implement ExecutionPlan::getJsonRepresentation
-    return {};
+    if(!json.is_object() || !json.contains("version"))
+    {
+        MIOPEN_THROW(miopenStatusInvalidValue,
+                     "Invalid buffer has been passed to the execution plan deserialization.");
+    }
+
+    try
+    {
+        if(json.at("version").get<int>() != executionPlanJsonVersion)
+        {
+            MIOPEN_THROW(
+                miopenStatusVersionMismatch,
+                "Data from wrong version has been passed to the execution plan deserialization.");
+        }
+
+        plan.mGraphForm = shapedFormFromJson(json.at("graph"));
+        json.at("device").get_to(plan.mDevice);
+        plan.mEngineCfg = EngineCfg{json.at("engine").get<Engine>()};
+        json.at("intermediates").get_to(plan.mIntermediateIds);
+        json.at("workspace").get_to(plan.mWorkspaceSize);
+    }
+    catch(const nlohmann::json::exception& ex)
+    {
+        MIOPEN_THROW(miopenStatusInvalidValue, ex.what());
+    }
+    plan.mSchedule = {};
 }
 
-void ExecutionPlan::execute(const VariantPack& variantPack) {}
+void ExecutionPlan::execute(const VariantPack& variantPack)
+{
+    MIOPEN_THROW_IF(mEngineCfg.getEngine().getOpGraph() == nullptr,
+                    "The engine of the execution plan has no operation graph");
+
+    const auto buffers = mSchedule.bind(variantPack);
+    for(const auto& [tensor, ptr] : buffers)
+    {
+        if(!isHostAccessible(ptr))
+        {
+            MIOPEN_THROW(miopenStatusNotImplemented,
+                         "The execution plan runs on the host and cannot access the device memory "
+                         "of tensor " +
+                             std::to_string(tensor->getId()));
+        }
+    }
+    for(const OpNode* step : mSchedule.getSteps())
+    {
+        executeOnHost(*step, buffers);
+    }
+}
 
 ExecutionPlanBuilder& ExecutionPlanBuilder::setHandle(miopenHandle_t handle) &
 {
@@ -72,15 +305,87 @@ ExecutionPlanBuilder& ExecutionPlanBuilder::setIntermediateIds(std::vector<int64
 
 ExecutionPlanBuilder& ExecutionPlanBuilder::setJsonRepresentation(const std::string_view& s) &
 {
-    // TODO: Implement ExecutionPlanBuilder::setJsonRepresentation
-    (void)s;
+    nlohmann::json json;
+    try
+    {
+        json = nlohmann::json::parse(s);
+    }
+    catch(const nlohmann::json::exception& ex)
+    {
+        MIOPEN_THROW(miopenStatusInvalidValue, ex.what());
+    }
+
+    const miopenHandle_t handle = mExecutionPlan.mHandle;
+    json.get_to(mExecutionPlan);
+    mExecutionPlan.mHandle = handle;
+    mEngineCfgSet          = true;
     return *this;
 }
 
+ExecutionPlanBuilder& ExecutionPlanBuilder::setExecutionPlan(const ExecutionPlan& plan) &
+{
+    const miopenHandle_t handle = mExecutionPlan.mHandle;
+    mExecutionPlan              = plan;
+    mExecutionPlan.mHandle      = handle;
+    mEngineCfgSet               = true;
+    return *this;
+}
+
+ExecutionPlanBuilder& ExecutionPlanBuilder::setOpGraph(const OpGraph* opGraph) &
+{
+    mOpGraph = checkPtr(opGraph);
+    return *this;
+}
+
+void ExecutionPlanBuilder::bindOpGraph()
+{
+    const Engine& engine = mExecutionPlan.mEngineCfg.getEngine();
+    const OpGraph* built = engine.getOpGraph();
+    const auto& form     = built != nullptr ? built->getShapedForm() : mExecutionPlan.mGraphForm;
+
+    MIOPEN_THROW_IF(mOpGraph->getShapedForm() != form,
+                    "The execution plan was built for another operation graph");
+    MIOPEN_THROW_IF(!mExecutionPlan.mDevice.empty() &&
+                        mExecutionPlan.mDevice != deref(mExecutionPlan.mHandle).GetDeviceName(),
+                    "The execution plan was built for another device");
+
+    Engine bound = EngineBuilder()
+                       .setOpGraph(mOpGraph)
+                       .setGlobalIndex(engine.getGlobalIndex())
+                       .setSmCount(engine.getSmCount())
+                       .build();
+    bound.mHeurMode = engine.getHeurMode();
+
+    const auto& solver = engine.getSolution().GetSolver();
+    MIOPEN_THROW_IF(solver.IsValid() && bound.getSolution().GetSolver() != solver,
+                    "The engine of the execution plan does not match the operation graph");
+
+    mExecutionPlan.mEngineCfg = EngineCfg{std::move(bound)};
+}
+
+void ExecutionPlanBuilder::initSchedule()
+{
+    if(mOpGraph != nullptr)
+    {
+        bindOpGraph();
+    }
+
+    const OpGraph* graph = mExecutionPlan.mEngineCfg.getEngine().getOpGraph();
+    if(graph != nullptr)
+    {
+        mExecutionPlan.mSchedule =
+            ExecutionSchedule(*graph, !env::disabled(MIOPEN_DEBUG_GRAPHAPI_FUSE_POINTWISE));
+        mExecutionPlan.mWorkspaceSize = mExecutionPlan.mSchedule.getWorkspaceSize();
+        mExecutionPlan.mGraphForm     = graph->getShapedForm();
+        mExecutionPlan.mDevice        = deref(mExecutionPlan.mHandle).GetDeviceName();
+    }
+}
+
 ExecutionPlan ExecutionPlanBuilder::build() &
 {
     if(mExecutionPlan.mHandle != nullptr && mEngineCfgSet)
     {
+        initSchedule();
         return mExecutionPlan;
     }
     else
@@ -93,6 +398,7 @@ ExecutionPlan ExecutionPlanBuilder::build() &&
 {
     if(mExecutionPlan.mHandle != nullptr && mEngineCfgSet)
     {
+        initSchedule();
         return std::move(mExecutionPlan);
     }
     else
@@ -182,7 +488,13 @@ void BackendExecutionPlanDescriptor::finalize()
         MIOPEN_THROW(miopenStatusNotInitialized);
     }
     mExecutionPlan = std::move(mBuilder).build();
-    mFinalized     = true;
+    // A plan restored from JSON has no graph to run on, the engine heuristics of the next graph
+    // with its shaped form put its engine first
+    if(mExecutionPlan.getEngineCfg().getEngine().getHeurMode().has_value())
+    {
+        ExecutionPlanCache::instance().insert(mExecutionPlan);
+    }
+    mFinalized = true;
 }
 
 void BackendExecutionPlanDescriptor::getAttribute(miopenBackendAttributeName_t attributeName,
@@ -222,6 +534,18 @@ void BackendExecutionPlanDescriptor::getAttribute(miopenBackendAttributeName_t a
         }
         break;
 
+    case MIOPEN_ATTR_EXECUTION_PLAN_WORKSPACE_SIZE:
+        if(attributeType == MIOPEN_TYPE_INT64 && requestedElementCount == 1)
+        {
+            *elementCount                           = 1;
+            *static_cast<int64_t*>(arrayOfElements) = mExecutionPlan.getWorkspaceSize();
+        }
+        else
+        {
+            MIOPEN_THROW(miopenStatusBadParm);
+        }
+        break;
+
     case MIOPEN_ATTR_EXECUTION_PLAN_RUN_ONLY_INTERMEDIATE_UIDS:
         if(attributeType == MIOPEN_TYPE_INT64 && requestedElementCount >= 0)
         {
@@ -256,10 +580,23 @@ void BackendExecutionPlanDescriptor::getAttribute(miopenBackendAttributeName_t a
     }
 }
 
-void BackendExecutionPlanDescriptor::execute(miopenHandle_t handle,
+void BackendExecutionPlanDescriptor::execute([[maybe_unused]] miopenHandle_t handle,
                                              miopenBackendDescriptor_t variantPack)
 {
-    // TODO: Implement BackendExecutionPlanDescriptor::execute
+    if(!mFinalized)
+    {
+        MIOPEN_THROW(miopenStatusNotInitialized);
+    }
+
+    BackendDescriptor& backendDescriptor = deref(variantPack);
+    if(!backendDescriptor.isFinalized())
+    {
+        MIOPEN_THROW(miopenStatusBadParm);
+    }
+
+    BackendVariantPackDescriptor& variantPackDescriptor =
+        dynamic_cast<BackendVariantPackDescriptor&>(backendDescriptor);
+    mExecutionPlan.execute(*variantPackDescriptor.getVariantPack());
 }
 
 } // namespace graphapi
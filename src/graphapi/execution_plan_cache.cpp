@@ -0,0 +1,237 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/errors.hpp>
+#include <miopen/graphapi/engineheur.hpp>
+#include <miopen/graphapi/execution_plan_cache.hpp>
+#include <miopen/handle.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace miopen {
+
+namespace graphapi {
+
+ExecutionPlanCache& ExecutionPlanCache::instance()
+{
+    static ExecutionPlanCache cache;
+    return cache;
+}
+
+ExecutionPlanCache::Key ExecutionPlanCache::makeKey(const OpGraph& graph,
+                                                    miopenHandle_t handle,
+                                                    miopenBackendHeurMode_t mode)
+{
+    return {graph.getShapedForm(), mode, deref(handle).GetDeviceName()};
+}
+
+ExecutionPlanCache::Key ExecutionPlanCache::makeKey(const ExecutionPlan& plan)
+{
+    const Engine& engine = plan.getEngineCfg().getEngine();
+    MIOPEN_THROW_IF(plan.getDevice().empty(),
+                    "Only execution plans built on an operation graph can be cached");
+    MIOPEN_THROW_IF(!engine.getHeurMode().has_value(),
+                    "Only execution plans of engines chosen by heuristics can be cached");
+    return {plan.getGraphForm(), *engine.getHeurMode(), plan.getDevice()};
+}
+
+void ExecutionPlanCache::add(Key key, ExecutionPlan&& plan)
+{
+    auto& entry    = mPlans[std::move(key)];
+    entry.mPlan    = std::move(plan);
+    entry.mLastUse = ++mClock;
+    evict();
+}
+
+void ExecutionPlanCache::evict()
+{
+    while(mPlans.size() > mCapacity)
+    {
+        mPlans.erase(std::min_element(mPlans.begin(), mPlans.end(), [](auto& left, auto& right) {
+            return left.second.mLastUse < right.second.mLastUse;
+        }));
+    }
+}
+
+std::optional<ExecutionPlan> ExecutionPlanCache::find(const OpGraph& graph,
+                                                      miopenHandle_t handle,
+                                                      miopenBackendHeurMode_t mode) const
+{
+    const auto key = makeKey(graph, handle, mode);
+    ExecutionPlanBuilder builder;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto it = mPlans.find(key);
+        if(it == mPlans.end())
+        {
+            return std::nullopt;
+        }
+        it->second.mLastUse = ++mClock;
+        builder.setExecutionPlan(it->second.mPlan);
+    }
+    return std::move(builder).setHandle(handle).setOpGraph(&graph).build();
+}
+
+std::optional<int64_t> ExecutionPlanCache::findEngineIndex(const OpGraph& graph,
+                                                           miopenHandle_t handle,
+                                                           miopenBackendHeurMode_t mode) const
+{
+    const auto key = makeKey(graph, handle, mode);
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto it = mPlans.find(key);
+    if(it == mPlans.end())
+    {
+        return std::nullopt;
+    }
+    const int64_t index = it->second.mPlan.getEngineCfg().getEngine().getGlobalIndex();
+    if(index < 0 || static_cast<size_t>(index) >= graph.getEngines().size())
+    {
+        return std::nullopt;
+    }
+    it->second.mLastUse = ++mClock;
+    return index;
+}
+
+ExecutionPlan
+ExecutionPlanCache::findOrBuild(OpGraph& graph, miopenHandle_t handle, miopenBackendHeurMode_t mode)
+{
+    auto plan = find(graph, handle, mode);
+    if(plan)
+    {
+        return std::move(*plan);
+    }
+
+    EngineHeur heur = EngineHeurBuilder().setOpGraph(&graph).setMode(mode).build();
+    MIOPEN_THROW_IF(heur.getResults().empty(), "The operation graph has no engines");
+
+    auto built = ExecutionPlanBuilder()
+                     .setHandle(handle)
+                     .setEngineCfg(std::move(heur.getResults().front()))
+                     .build();
+    insert(built);
+    return built;
+}
+
+void ExecutionPlanCache::insert(const ExecutionPlan& plan)
+{
+    auto key = makeKey(plan);
+    // Drops the graph, which may not outlive the plan
+    auto unbound = nlohmann::json(plan).get<ExecutionPlan>();
+    std::lock_guard<std::mutex> lock(mMutex);
+    add(std::move(key), std::move(unbound));
+}
+
+size_t ExecutionPlanCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mPlans.size();
+}
+
+void ExecutionPlanCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPlans.clear();
+}
+
+size_t ExecutionPlanCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCapacity;
+}
+
+void ExecutionPlanCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCapacity = capacity;
+    evict();
+}
+
+std::string ExecutionPlanCache::serialize() const
+{
+    auto json = nlohmann::json::array();
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(const auto& [key, entry] : mPlans)
+    {
+        json.push_back(entry.mPlan);
+    }
+    return json.dump();
+}
+
+void ExecutionPlanCache::deserialize(const std::string_view& s)
+{
+    nlohmann::json json;
+    try
+    {
+        json = nlohmann::json::parse(s);
+    }
+    catch(const nlohmann::json::exception& ex)
+    {
+        MIOPEN_THROW(miopenStatusInvalidValue, ex.what());
+    }
+    if(!json.is_array())
+    {
+        MIOPEN_THROW(miopenStatusInvalidValue, "The execution plan cache is not a JSON array");
+    }
+
+    // Check every plan before adding any
+    std::map<Key, ExecutionPlan> plans;
+    for(const auto& item : json)
+    {
+        auto plan = item.get<ExecutionPlan>();
+        plans[makeKey(plan)] = std::move(plan);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(auto& [key, plan] : plans)
+    {
+        add(key, std::move(plan));
+    }
+}
+
+void ExecutionPlanCache::save(const fs::path& path) const
+{
+    std::ofstream file(path);
+    MIOPEN_THROW_IF(!file, "Cannot open " + path.string());
+    file << serialize();
+}
+
+void ExecutionPlanCache::load(const fs::path& path)
+{
+    std::ifstream file(path);
+    MIOPEN_THROW_IF(!file, "Cannot open " + path.string());
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    deserialize(buffer.str());
+}
+
+} // namespace graphapi
+
+} // namespace miopen
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/conv/problem_description.hpp>
+#include <miopen/convolution.hpp>
+#include <miopen/find_db.hpp>
+#include <miopen/graphapi/convolution.hpp>
+#include <miopen/graphapi/engine_cost.hpp>
+#include <miopen/tensor.hpp>
+
+namespace miopen {
+
+namespace graphapi {
+
+namespace {
+
+TensorDescriptor makeTensorDescriptor(const Tensor& tensor)
+{
+    const auto& dims    = tensor.getDimensions();
+    const auto& strides = tensor.getStrides();
+    return {tensor.getDataType(),
+            std::vector<size_t>(dims.cbegin(), dims.cend()),
+            std::vector<size_t>(strides.cbegin(), strides.cend())};
+}
+
+std::vector<int> toInt(const std::vector<int64_t>& values)
+{
+    return {values.cbegin(), values.cend()};
+}
+
+/// The problem the find-db records a convolution node under
+conv::ProblemDescription makeProblem(const OperationConvolution& node)
+{
+    const Convolution& conv = *node.getConvolution();
+    const auto spatialDims  = static_cast<size_t>(conv.getSpatialDims());
+    const int groups =
+        static_cast<int>(node.getX()->getDimensions()[1] / node.getW()->getDimensions()[1]);
+
+    const ConvolutionDescriptor descriptor(spatialDims,
+                                           conv.getMode(),
+                                           miopenPaddingDefault,
+                                           toInt(conv.getPrePaddings()),
+                                           toInt(conv.getFilterStrides()),
+                                           toInt(conv.getDilations()),
+                                           std::vector<int>(spatialDims, 0),
+                                           groups);
+
+    const auto x = makeTensorDescriptor(*node.getX());
+    const auto w = makeTensorDescriptor(*node.getW());
+    const auto y = makeTensorDescriptor(*node.getY());
+
+    if(dynamic_cast<const OperationConvolutionForward*>(&node) != nullptr)
+    {
+        return {x, w, y, descriptor, conv::Direction::Forward};
+    }
+    if(dynamic_cast<const OperationConvolutionBackwardData*>(&node) != nullptr)
+    {
+        return {y, w, x, descriptor, conv::Direction::BackwardData};
+    }
+    return {y, w, x, descriptor, conv::Direction::BackwardWeights};
+}
+
+} // namespace
+
+std::optional<double> FindDbTimingRecords::find(const OpNode& node, const Engine& engine) const
+{
+    const auto* conv   = dynamic_cast<const OperationConvolution*>(&node);
+    const auto& solver  = engine.getSolution().GetSolver();
+    if(conv == nullptr || !solver.IsValid())
+    {
+        return std::nullopt;
+    }
+
+    const FindDbRecord record{*mHandle, makeProblem(*conv)};
+    if(record.empty())
+    {
+        return std::nullopt;
+    }
+
+    const auto name = solver.ToString();
+    for(const auto& [id, data] : record)
+    {
+        if(id == name)
+        {
+            return data.time;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace graphapi
+
+} // namespace miopen
@@ -0,0 +1,900 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/errors.hpp>
+#include <miopen/graphapi/convolution.hpp>
+#include <miopen/graphapi/host_executor.hpp>
+#include <miopen/graphapi/matmul.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+#include <miopen/graphapi/pointwise_fusion.hpp>
+#include <miopen/graphapi/reduction.hpp>
+#include <miopen/graphapi/rng.hpp>
+#include <miopen/visit_float.hpp>
+
+#if MIOPEN_BACKEND_HIP
+#include <hip/hip_runtime_api.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace miopen {
+
+namespace graphapi {
+
+namespace {
+
+using Dims    = std::vector<int64_t>;
+using Buffers = std::unordered_map<const Tensor*, void*>;
+
+size_t elementCount(const Dims& dims)
+{
+    return std::accumulate(dims.cbegin(), dims.cend(), size_t{1}, std::multiplies<size_t>{});
+}
+
+/// Calls f(index, i) for every multi-index of dims, i being its row-major position
+template <typename F>
+void forEachIndex(const Dims& dims, F&& f)
+{
+    const size_t count = elementCount(dims);
+    Dims index(dims.size(), 0);
+    for(size_t i = 0; i < count; ++i)
+    {
+        f(index, i);
+        for(size_t d = dims.size(); d-- > 0;)
+        {
+            if(++index[d] < dims[d])
+            {
+                break;
+            }
+            index[d] = 0;
+        }
+    }
+}
+
+/// Row-major position in a dense tensor of dims of the element broadcast to index. The
+/// dimensions are aligned to the right and the dimensions of size 1 are broadcast.
+size_t broadcastOffset(const Dims& index, const Dims& dims)
+{
+    const size_t lead = index.size() - dims.size();
+    size_t offset     = 0;
+    for(size_t d = 0; d < dims.size(); ++d)
+    {
+        offset = offset * dims[d] + (dims[d] == 1 ? 0 : index[lead + d]);
+    }
+    return offset;
+}
+
+void* bufferOf(const Buffers& buffers, const Tensor* tensor)
+{
+    auto it = buffers.find(tensor);
+    MIOPEN_THROW_IF(it == buffers.end() || it->second == nullptr,
+                    "No buffer bound to tensor " + std::to_string(tensor->getId()));
+    return it->second;
+}
+
+template <typename T>
+double asDouble(T value)
+{
+    if constexpr(std::is_arithmetic_v<T>)
+    {
+        return static_cast<double>(value);
+    }
+    else
+    {
+        return static_cast<double>(static_cast<float>(value));
+    }
+}
+
+template <typename T>
+T fromDouble(double value)
+{
+    if constexpr(std::is_arithmetic_v<T>)
+    {
+        return static_cast<T>(value);
+    }
+    else
+    {
+        return T(static_cast<float>(value));
+    }
+}
+
+template <typename... Ts>
+double asDouble(const std::variant<Ts...>& value)
+{
+    return std::visit([](auto v) { return asDouble(v); }, value);
+}
+
+template <typename F>
+void visitHostType(miopenDataType_t type, F&& f)
+{
+    if(type == miopenFloat8 || type == miopenBFloat8)
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented, "8-bit floats are not supported on the host");
+    }
+    visit_float(type, std::forward<F>(f));
+}
+
+/// Reads a tensor into a dense row-major vector
+std::vector<double> load(const Buffers& buffers, const Tensor* tensor)
+{
+    const void* data = bufferOf(buffers, tensor);
+    std::vector<double> values(elementCount(tensor->getDimensions()));
+    visitHostType(tensor->getDataType(), [&](auto as_type) {
+        const auto* typed     = as_type(data);
+        const auto& strides   = tensor->getStrides();
+        forEachIndex(tensor->getDimensions(), [&](const Dims& index, size_t i) {
+            values[i] = asDouble(typed[std::inner_product(
+                index.cbegin(), index.cend(), strides.cbegin(), int64_t{0})]);
+        });
+    });
+    return values;
+}
+
+void store(const Buffers& buffers, const Tensor* tensor, const std::vector<double>& values)
+{
+    void* data = bufferOf(buffers, tensor);
+    visitHostType(tensor->getDataType(), [&](auto as_type) {
+        auto* typed         = as_type(data);
+        using T             = std::remove_pointer_t<decltype(typed)>;
+        const auto& strides = tensor->getStrides();
+        forEachIndex(tensor->getDimensions(), [&](const Dims& index, size_t i) {
+            typed[std::inner_product(index.cbegin(), index.cend(), strides.cbegin(), int64_t{0})] =
+                fromDouble<T>(values[i]);
+        });
+    });
+}
+
+int64_t loadInteger(const Buffers& buffers, const Tensor* tensor)
+{
+    const void* data = bufferOf(buffers, tensor);
+    int64_t value    = 0;
+    visitHostType(tensor->getDataType(), [&](auto as_type) {
+        const auto* typed = as_type(data);
+        using T           = std::remove_cv_t<std::remove_pointer_t<decltype(typed)>>;
+        if constexpr(std::is_integral_v<T>)
+        {
+            value = *typed;
+        }
+        else
+        {
+            value = static_cast<int64_t>(asDouble(*typed));
+        }
+    });
+    return value;
+}
+
+double sigmoid(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+
+double gaussianCdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+double gaussianPdf(double x)
+{
+    constexpr double invSqrt2Pi = 0.3989422804014327;
+    return invSqrt2Pi * std::exp(-0.5 * x * x);
+}
+
+struct PointwiseParams
+{
+    miopenPointwiseMode_t mode;
+    double alpha1;
+    double alpha2;
+    double lowerClip;
+    double upperClip;
+    double lowerSlope;
+    double eluAlpha;
+    double softPlusBeta;
+    double swishBeta;
+    bool propagateNan;
+
+    explicit PointwiseParams(const OperationPointwise& op)
+        : mode(op.getPointwise()->getMode()),
+          alpha1(asDouble(op.getAlpha1())),
+          alpha2(asDouble(op.getAlpha2())),
+          lowerClip(asDouble(op.getPointwise()->getReluLowerClip())),
+          upperClip(asDouble(op.getPointwise()->getReluUpperClip())),
+          lowerSlope(asDouble(op.getPointwise()->getReluLowerClipSlope())),
+          eluAlpha(asDouble(op.getPointwise()->getEluAlpha())),
+          softPlusBeta(asDouble(op.getPointwise()->getSoftPlusBeta())),
+          swishBeta(asDouble(op.getPointwise()->getSwishBeta())),
+          propagateNan(op.getPointwise()->getNanPropagation() == MIOPEN_PROPAGATE_NAN)
+    {
+    }
+};
+
+/// y[i] = op(alpha1 * x[i], alpha2 * b[i], t[i]) for i < n. The inputs are those of
+/// getInTensors(), so for the backward modes x is the input of the forward operation and b
+/// the incoming gradient. Unused inputs may alias x. The mode is dispatched once per call so
+/// that every loop is a plain elementwise loop the compiler can vectorize.
+void applyPointwise(const PointwiseParams& p,
+                    size_t n,
+                    const double* __restrict x,
+                    const double* __restrict b,
+                    const double* __restrict t,
+                    double* __restrict y)
+{
+    const double alpha1 = p.alpha1;
+    const double alpha2 = p.alpha2;
+    auto loop           = [&](auto f) {
+        for(size_t i = 0; i < n; ++i)
+        {
+            y[i] = f(alpha1 * x[i], alpha2 * b[i], t[i]);
+        }
+    };
+
+    const double lowerClip  = p.lowerClip;
+    const double upperClip  = p.upperClip;
+    const double lowerSlope = p.lowerSlope;
+    const double eluAlpha   = p.eluAlpha;
+    const double softPlusB  = p.softPlusBeta;
+    const double swishBeta  = p.swishBeta;
+    const bool propagateNan = p.propagateNan;
+    constexpr double nan    = std::numeric_limits<double>::quiet_NaN();
+    constexpr double geluK  = 0.7978845608028654; // sqrt(2 / pi)
+    constexpr double geluC  = 0.044715;
+
+    switch(p.mode)
+    {
+    case MIOPEN_POINTWISE_ADD:
+        loop([](double x, double b, double) { return x + b; });
+        break;
+    case MIOPEN_POINTWISE_ADD_SQUARE:
+        loop([](double x, double b, double) { return x + b * b; });
+        break;
+    case MIOPEN_POINTWISE_DIV:
+        loop([](double x, double b, double) { return x / b; });
+        break;
+    case MIOPEN_POINTWISE_MAX:
+        if(propagateNan)
+            loop([](double x, double b, double) {
+                return std::isnan(x) || std::isnan(b) ? nan : std::fmax(x, b);
+            });
+        else
+            loop([](double x, double b, double) { return std::fmax(x, b); });
+        break;
+    case MIOPEN_POINTWISE_MIN:
+        if(propagateNan)
+            loop([](double x, double b, double) {
+                return std::isnan(x) || std::isnan(b) ? nan : std::fmin(x, b);
+            });
+        else
+            loop([](double x, double b, double) { return std::fmin(x, b); });
+        break;
+    case MIOPEN_POINTWISE_MOD:
+        loop([](double x, double b, double) { return std::fmod(x, b); });
+        break;
+    case MIOPEN_POINTWISE_MUL:
+        loop([](double x, double b, double) { return x * b; });
+        break;
+    case MIOPEN_POINTWISE_POW:
+        loop([](double x, double b, double) { return std::pow(x, b); });
+        break;
+    case MIOPEN_POINTWISE_SUB:
+        loop([](double x, double b, double) { return x - b; });
+        break;
+    case MIOPEN_POINTWISE_CMP_EQ:
+        loop([](double x, double b, double) { return x == b ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_CMP_NEQ:
+        loop([](double x, double b, double) { return x != b ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_CMP_GT:
+        loop([](double x, double b, double) { return x > b ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_CMP_GE:
+        loop([](double x, double b, double) { return x >= b ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_CMP_LT:
+        loop([](double x, double b, double) { return x < b ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_CMP_LE:
+        loop([](double x, double b, double) { return x <= b ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_LOGICAL_AND:
+        loop([](double x, double b, double) { return x != 0.0 && b != 0.0 ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_LOGICAL_OR:
+        loop([](double x, double b, double) { return x != 0.0 || b != 0.0 ? 1.0 : 0.0; });
+        break;
+
+    case MIOPEN_POINTWISE_ABS:
+        loop([](double x, double, double) { return std::fabs(x); });
+        break;
+    case MIOPEN_POINTWISE_CEIL:
+        loop([](double x, double, double) { return std::ceil(x); });
+        break;
+    case MIOPEN_POINTWISE_COS:
+        loop([](double x, double, double) { return std::cos(x); });
+        break;
+    case MIOPEN_POINTWISE_EXP:
+        loop([](double x, double, double) { return std::exp(x); });
+        break;
+    case MIOPEN_POINTWISE_FLOOR:
+        loop([](double x, double, double) { return std::floor(x); });
+        break;
+    case MIOPEN_POINTWISE_LOG:
+        loop([](double x, double, double) { return std::log(x); });
+        break;
+    case MIOPEN_POINTWISE_NEG:
+        loop([](double x, double, double) { return -x; });
+        break;
+    case MIOPEN_POINTWISE_RSQRT:
+        loop([](double x, double, double) { return 1.0 / std::sqrt(x); });
+        break;
+    case MIOPEN_POINTWISE_SIN:
+        loop([](double x, double, double) { return std::sin(x); });
+        break;
+    case MIOPEN_POINTWISE_SQRT:
+        loop([](double x, double, double) { return std::sqrt(x); });
+        break;
+    case MIOPEN_POINTWISE_TAN:
+        loop([](double x, double, double) { return std::tan(x); });
+        break;
+    case MIOPEN_POINTWISE_IDENTITY:
+        loop([](double x, double, double) { return x; });
+        break;
+    case MIOPEN_POINTWISE_ERF:
+        loop([](double x, double, double) { return std::erf(x); });
+        break;
+    case MIOPEN_POINTWISE_LOGICAL_NOT:
+        loop([](double x, double, double) { return x == 0.0 ? 1.0 : 0.0; });
+        break;
+    case MIOPEN_POINTWISE_RECIPROCAL:
+        loop([](double x, double, double) { return 1.0 / x; });
+        break;
+
+    case MIOPEN_POINTWISE_RELU_FWD:
+        loop([=](double x, double, double) {
+            return x > upperClip ? upperClip
+                                 : (x < lowerClip ? lowerClip + lowerSlope * (x - lowerClip) : x);
+        });
+        break;
+    case MIOPEN_POINTWISE_TANH_FWD:
+        loop([](double x, double, double) { return std::tanh(x); });
+        break;
+    case MIOPEN_POINTWISE_SIGMOID_FWD:
+        loop([](double x, double, double) { return sigmoid(x); });
+        break;
+    case MIOPEN_POINTWISE_ELU_FWD:
+        loop([=](double x, double, double) { return x > 0.0 ? x : eluAlpha * std::expm1(x); });
+        break;
+    case MIOPEN_POINTWISE_GELU_FWD:
+        loop([](double x, double, double) { return x * gaussianCdf(x); });
+        break;
+    case MIOPEN_POINTWISE_SOFTPLUS_FWD:
+        loop([=](double x, double, double) {
+            return std::log1p(std::exp(softPlusB * x)) / softPlusB;
+        });
+        break;
+    case MIOPEN_POINTWISE_SWISH_FWD:
+        loop([=](double x, double, double) { return x * sigmoid(swishBeta * x); });
+        break;
+    case MIOPEN_POINTWISE_GELU_APPROX_TANH_FWD:
+        loop([](double x, double, double) {
+            return 0.5 * x * (1.0 + std::tanh(geluK * (x + geluC * x * x * x)));
+        });
+        break;
+
+    case MIOPEN_POINTWISE_BINARY_SELECT:
+        loop([](double x, double b, double t) { return t != 0.0 ? x : b; });
+        break;
+
+    case MIOPEN_POINTWISE_RELU_BWD:
+        loop([=](double x, double b, double) {
+            return b * (x > upperClip ? 0.0 : (x > lowerClip ? 1.0 : lowerSlope));
+        });
+        break;
+    case MIOPEN_POINTWISE_TANH_BWD:
+        loop([](double x, double b, double) {
+            const double y = std::tanh(x);
+            return b * (1.0 - y * y);
+        });
+        break;
+    case MIOPEN_POINTWISE_SIGMOID_BWD:
+        loop([](double x, double b, double) {
+            const double y = sigmoid(x);
+            return b * y * (1.0 - y);
+        });
+        break;
+    case MIOPEN_POINTWISE_ELU_BWD:
+        loop([=](double x, double b, double) {
+            return b * (x > 0.0 ? 1.0 : eluAlpha * std::exp(x));
+        });
+        break;
+    case MIOPEN_POINTWISE_GELU_BWD:
+        loop([](double x, double b, double) { return b * (gaussianCdf(x) + x * gaussianPdf(x)); });
+        break;
+    case MIOPEN_POINTWISE_SOFTPLUS_BWD:
+        loop([=](double x, double b, double) { return b * sigmoid(softPlusB * x); });
+        break;
+    case MIOPEN_POINTWISE_SWISH_BWD:
+        loop([=](double x, double b, double) {
+            const double s = sigmoid(swishBeta * x);
+            return b * (s + swishBeta * x * s * (1.0 - s));
+        });
+        break;
+    case MIOPEN_POINTWISE_GELU_APPROX_TANH_BWD:
+        loop([](double x, double b, double) {
+            const double y = std::tanh(geluK * (x + geluC * x * x * x));
+            const double dy = geluK * (1.0 + 3.0 * geluC * x * x);
+            return b * (0.5 * (1.0 + y) + 0.5 * x * (1.0 - y * y) * dy);
+        });
+        break;
+
+    default: MIOPEN_THROW(miopenStatusNotImplemented);
+    }
+}
+
+/// Pointer to n elements of a dense tensor of dims broadcast to the dense tensor of out_dims,
+/// starting at the element `first` of the latter. Reads in place when no dimension is
+/// broadcast, gathers into scratch otherwise.
+const double* broadcastRange(const std::vector<double>& values,
+                             const Dims& dims,
+                             const Dims& out_dims,
+                             size_t first,
+                             size_t n,
+                             std::vector<double>& scratch)
+{
+    if(dims == out_dims)
+    {
+        return values.data() + first;
+    }
+
+    scratch.resize(n);
+    Dims index(out_dims.size());
+    size_t rest = first;
+    for(size_t d = out_dims.size(); d-- > 0;)
+    {
+        index[d] = rest % out_dims[d];
+        rest /= out_dims[d];
+    }
+    for(size_t i = 0; i < n; ++i)
+    {
+        scratch[i] = values[broadcastOffset(index, dims)];
+        for(size_t d = out_dims.size(); d-- > 0;)
+        {
+            if(++index[d] < out_dims[d])
+            {
+                break;
+            }
+            index[d] = 0;
+        }
+    }
+    return scratch.data();
+}
+
+void executePointwise(const OperationPointwise& op, const Buffers& buffers)
+{
+    const Pointwise& pointwise = *op.getPointwise();
+
+    if(pointwise.getMode() == MIOPEN_POINTWISE_GEN_INDEX)
+    {
+        const Dims& dims   = op.getY()->getDimensions();
+        const int64_t axis = pointwise.getAxis();
+        MIOPEN_THROW_IF(axis < 0 || axis >= static_cast<int64_t>(dims.size()),
+                        "GEN_INDEX axis is out of range");
+        std::vector<double> out(elementCount(dims));
+        forEachIndex(dims, [&](const Dims& index, size_t i) { out[i] = index[axis]; });
+        store(buffers, op.getY(), out);
+        return;
+    }
+
+    const auto inputs    = op.getInTensors();
+    const Tensor* out    = op.getOutTensors().front();
+    const Dims& out_dims = out->getDimensions();
+    const size_t count   = elementCount(out_dims);
+
+    std::vector<std::vector<double>> values(inputs.size());
+    std::vector<std::vector<double>> scratch(inputs.size());
+    const double* args[3] = {};
+    for(size_t k = 0; k < inputs.size(); ++k)
+    {
+        values[k] = load(buffers, inputs[k]);
+        args[k]   = broadcastRange(
+            values[k], inputs[k]->getDimensions(), out_dims, 0, count, scratch[k]);
+    }
+    for(size_t k = inputs.size(); k < 3; ++k)
+    {
+        args[k] = args[0];
+    }
+
+    std::vector<double> out_values(count);
+    applyPointwise(PointwiseParams{op}, count, args[0], args[1], args[2], out_values.data());
+    store(buffers, out, out_values);
+}
+
+void executeFusedPointwise(const OperationFusedPointwise& op, const Buffers& buffers)
+{
+    // Small enough for the registers of a block to stay in the cache
+    constexpr size_t blockSize = 256;
+
+    const Dims& dims    = op.getDimensions();
+    const size_t count  = elementCount(dims);
+    const auto& inputs  = op.getInputs();
+    const auto& program = op.getInstructions();
+
+    std::vector<std::vector<double>> values(inputs.size());
+    for(size_t k = 0; k < inputs.size(); ++k)
+    {
+        values[k] = load(buffers, inputs[k]);
+    }
+
+    std::vector<PointwiseParams> params;
+    params.reserve(program.size());
+    for(const auto& instruction : program)
+    {
+        params.emplace_back(*instruction.mOperation);
+    }
+
+    std::vector<std::vector<double>> results(program.size(), std::vector<double>(blockSize));
+    std::vector<std::vector<double>> scratch(inputs.size());
+    std::vector<const double*> registers(op.getNumRegisters());
+
+    const auto& outputs = op.getOutputs();
+    std::vector<std::vector<double>> out_values(outputs.size(), std::vector<double>(count));
+
+    for(size_t first = 0; first < count; first += blockSize)
+    {
+        const size_t n = std::min(blockSize, count - first);
+
+        for(size_t k = 0; k < inputs.size(); ++k)
+        {
+            registers[k] =
+                broadcastRange(values[k], inputs[k]->getDimensions(), dims, first, n, scratch[k]);
+        }
+
+        for(size_t k = 0; k < program.size(); ++k)
+        {
+            const auto& args = program[k].mArgs;
+            const double* x  = registers[args[0]];
+            const double* b  = args.size() > 1 ? registers[args[1]] : x;
+            const double* t  = args.size() > 2 ? registers[args[2]] : x;
+            applyPointwise(params[k], n, x, b, t, results[k].data());
+            registers[inputs.size() + k] = results[k].data();
+        }
+
+        for(size_t o = 0; o < outputs.size(); ++o)
+        {
+            std::copy_n(registers[outputs[o].first], n, out_values[o].begin() + first);
+        }
+    }
+
+    for(size_t o = 0; o < outputs.size(); ++o)
+    {
+        store(buffers, outputs[o].second, out_values[o]);
+    }
+}
+
+void executeMatmul(const OperationMatmul& op, const Buffers& buffers)
+{
+    const Dims& a_dims = op.getA()->getDimensions();
+    const Dims& b_dims = op.getB()->getDimensions();
+    const Dims& c_dims = op.getC()->getDimensions();
+    const auto a       = load(buffers, op.getA());
+    const auto b       = load(buffers, op.getB());
+
+    const int64_t m = c_dims[c_dims.size() - 2];
+    const int64_t n = c_dims[c_dims.size() - 1];
+    const int64_t k = a_dims[a_dims.size() - 1];
+
+    const Dims batch_dims(c_dims.cbegin(), c_dims.cend() - 2);
+    const Dims a_batch_dims(a_dims.cbegin(), a_dims.cend() - 2);
+    const Dims b_batch_dims(b_dims.cbegin(), b_dims.cend() - 2);
+
+    std::vector<double> c(elementCount(c_dims));
+    forEachIndex(batch_dims, [&](const Dims& batch, size_t batch_pos) {
+        const double* a_mat = a.data() + broadcastOffset(batch, a_batch_dims) * m * k;
+        const double* b_mat = b.data() + broadcastOffset(batch, b_batch_dims) * k * n;
+        double* c_mat       = c.data() + batch_pos * m * n;
+        for(int64_t i = 0; i < m; ++i)
+        {
+            for(int64_t l = 0; l < k; ++l)
+            {
+                const double a_il = a_mat[i * k + l];
+                for(int64_t j = 0; j < n; ++j)
+                {
+                    c_mat[i * n + j] += a_il * b_mat[l * n + j];
+                }
+            }
+        }
+    });
+    store(buffers, op.getC(), c);
+}
+
+void executeReduction(const OperationReduction& op, const Buffers& buffers)
+{
+    const Dims& x_dims = op.getX()->getDimensions();
+    const Dims& y_dims = op.getY()->getDimensions();
+    for(size_t d = 0; d < x_dims.size(); ++d)
+    {
+        if(y_dims[d] != x_dims[d] && y_dims[d] != 1)
+        {
+            MIOPEN_THROW(miopenStatusNotImplemented, "Only reductions to dimensions of size 1");
+        }
+    }
+
+    const auto op_kind = op.getReduction()->getReductionOperator();
+    double init        = 0.0;
+    if(op_kind == MIOPEN_REDUCE_TENSOR_MUL)
+    {
+        init = 1.0;
+    }
+    else if(op_kind == MIOPEN_REDUCE_TENSOR_MIN)
+    {
+        init = std::numeric_limits<double>::infinity();
+    }
+    else if(op_kind == MIOPEN_REDUCE_TENSOR_MAX)
+    {
+        init = -std::numeric_limits<double>::infinity();
+    }
+
+    const auto x = load(buffers, op.getX());
+    std::vector<double> y(elementCount(y_dims), init);
+    forEachIndex(x_dims, [&](const Dims& index, size_t i) {
+        double& acc = y[broadcastOffset(index, y_dims)];
+        switch(op_kind)
+        {
+        case MIOPEN_REDUCE_TENSOR_ADD:
+        case MIOPEN_REDUCE_TENSOR_AVG: acc += x[i]; break;
+        case MIOPEN_REDUCE_TENSOR_MUL: acc *= x[i]; break;
+        case MIOPEN_REDUCE_TENSOR_MIN: acc = std::min(acc, x[i]); break;
+        case MIOPEN_REDUCE_TENSOR_MAX: acc = std::max(acc, x[i]); break;
+        case MIOPEN_REDUCE_TENSOR_AMAX: acc = std::max(acc, std::fabs(x[i])); break;
+        case MIOPEN_REDUCE_TENSOR_NORM1: acc += std::fabs(x[i]); break;
+        case MIOPEN_REDUCE_TENSOR_NORM2: acc += x[i] * x[i]; break;
+        default: MIOPEN_THROW(miopenStatusNotImplemented);
+        }
+    });
+
+    if(op_kind == MIOPEN_REDUCE_TENSOR_AVG)
+    {
+        const double count = static_cast<double>(x.size() / y.size());
+        std::for_each(y.begin(), y.end(), [count](double& v) { v /= count; });
+    }
+    else if(op_kind == MIOPEN_REDUCE_TENSOR_NORM2)
+    {
+        std::for_each(y.begin(), y.end(), [](double& v) { v = std::sqrt(v); });
+    }
+    store(buffers, op.getY(), y);
+}
+
+void executeRng(const OperationRng& op, const Buffers& buffers)
+{
+    const Rng& rng     = *op.getRng();
+    const auto seed    = op.getSeed();
+    const auto seed_v  = seed.index() == 0 ? std::get<int64_t>(seed)
+                                           : loadInteger(buffers, std::get<Tensor*>(seed));
+    const auto offset  = op.getOffset() != nullptr ? loadInteger(buffers, op.getOffset()) : 0;
+    const auto seed_u  = static_cast<uint64_t>(seed_v);
+    const auto offset_u = static_cast<uint64_t>(offset);
+
+    std::seed_seq seq{static_cast<uint32_t>(seed_u),
+                      static_cast<uint32_t>(seed_u >> 32),
+                      static_cast<uint32_t>(offset_u),
+                      static_cast<uint32_t>(offset_u >> 32)};
+    std::mt19937_64 engine(seq);
+
+    std::vector<double> out(elementCount(op.getOutput()->getDimensions()));
+    switch(rng.getDistribution())
+    {
+    case MIOPEN_RNG_DISTRIBUTION_BERNOULLI: {
+        std::bernoulli_distribution dist(rng.getBernoulliProb());
+        std::generate(out.begin(), out.end(), [&]() { return dist(engine) ? 1.0 : 0.0; });
+        break;
+    }
+    case MIOPEN_RNG_DISTRIBUTION_UNIFORM: {
+        std::uniform_real_distribution<double> dist(rng.getUniformMin(), rng.getUniformMax());
+        std::generate(out.begin(), out.end(), [&]() { return dist(engine); });
+        break;
+    }
+    case MIOPEN_RNG_DISTRIBUTION_NORMAL: {
+        std::normal_distribution<double> dist(rng.getNormalMean(), rng.getNormalStdev());
+        std::generate(out.begin(), out.end(), [&]() { return dist(engine); });
+        break;
+    }
+    default: MIOPEN_THROW(miopenStatusNotImplemented);
+    }
+    store(buffers, op.getOutput(), out);
+}
+
+enum class ConvDirection
+{
+    Forward,
+    BackwardData,
+    BackwardFilter,
+};
+
+void executeConvolution(const OperationConvolution& op,
+                        const Buffers& buffers,
+                        ConvDirection direction)
+{
+    const Convolution& conv = *op.getConvolution();
+    if(conv.getMode() == miopenTranspose)
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented, "Transposed convolution on the host");
+    }
+
+    const Dims& x_dims = op.getX()->getDimensions();
+    const Dims& w_dims = op.getW()->getDimensions();
+    const Dims& y_dims = op.getY()->getDimensions();
+    const Dims& pads   = conv.getPrePaddings();
+    const Dims& steps  = conv.getFilterStrides();
+    const Dims& dils   = conv.getDilations();
+
+    const Dims in_spatial(x_dims.cbegin() + 2, x_dims.cend());
+    const Dims kernel(w_dims.cbegin() + 2, w_dims.cend());
+    const Dims out_spatial(y_dims.cbegin() + 2, y_dims.cend());
+    const size_t in_size     = elementCount(in_spatial);
+    const size_t kernel_size = elementCount(kernel);
+    const size_t out_size    = elementCount(out_spatial);
+
+    const int64_t batch       = x_dims[0];
+    const int64_t channels    = x_dims[1];
+    const int64_t filters     = w_dims[0];
+    const int64_t group_chans = w_dims[1];
+    MIOPEN_THROW_IF(group_chans <= 0 || channels % group_chans != 0,
+                    "Channels of X are not a multiple of the channels of W");
+    const int64_t group_filters = filters / (channels / group_chans);
+
+    Tensor* out_tensor = direction == ConvDirection::Forward        ? op.getY()
+                         : direction == ConvDirection::BackwardData ? op.getX()
+                                                                    : op.getW();
+
+    auto input = [&](Tensor* tensor) {
+        return tensor == out_tensor ? std::vector<double>(elementCount(tensor->getDimensions()))
+                                    : load(buffers, tensor);
+    };
+    auto x = input(op.getX());
+    auto w = input(op.getW());
+    auto y = input(op.getY());
+    auto& acc = direction == ConvDirection::Forward        ? y
+                : direction == ConvDirection::BackwardData ? x
+                                                           : w;
+
+    Dims in_pos(in_spatial.size());
+    for(int64_t n = 0; n < batch; ++n)
+    {
+        for(int64_t k = 0; k < filters; ++k)
+        {
+            const int64_t group = k / group_filters;
+            forEachIndex(out_spatial, [&](const Dims& out_idx, size_t out_pos) {
+                const size_t yi = (n * filters + k) * out_size + out_pos;
+                for(int64_t cg = 0; cg < group_chans; ++cg)
+                {
+                    const int64_t c = group * group_chans + cg;
+                    forEachIndex(kernel, [&](const Dims& kernel_idx, size_t kernel_pos) {
+                        size_t in_lin = 0;
+                        for(size_t d = 0; d < in_spatial.size(); ++d)
+                        {
+                            in_pos[d] = out_idx[d] * steps[d] - pads[d] + kernel_idx[d] * dils[d];
+                            if(in_pos[d] < 0 || in_pos[d] >= in_spatial[d])
+                            {
+                                return;
+                            }
+                            in_lin = in_lin * in_spatial[d] + in_pos[d];
+                        }
+                        const size_t xi = (n * channels + c) * in_size + in_lin;
+                        const size_t wi = (k * group_chans + cg) * kernel_size + kernel_pos;
+                        switch(direction)
+                        {
+                        case ConvDirection::Forward: y[yi] += x[xi] * w[wi]; break;
+                        case ConvDirection::BackwardData: x[xi] += w[wi] * y[yi]; break;
+                        case ConvDirection::BackwardFilter: w[wi] += x[xi] * y[yi]; break;
+                        }
+                    });
+                }
+            });
+        }
+    }
+
+    const double alpha = op.getAlpha();
+    const double beta  = op.getBeta();
+    const auto prior   = beta != 0.0 ? load(buffers, out_tensor) : std::vector<double>{};
+    for(size_t i = 0; i < acc.size(); ++i)
+    {
+        acc[i] = alpha * acc[i] + (beta != 0.0 ? beta * prior[i] : 0.0);
+    }
+    store(buffers, out_tensor, acc);
+}
+
+} // namespace
+
+void executeOnHost(const OpNode& node, const Buffers& buffers)
+{
+    if(const auto* pointwise = dynamic_cast<const OperationPointwise*>(&node))
+    {
+        executePointwise(*pointwise, buffers);
+    }
+    else if(const auto* fused = dynamic_cast<const OperationFusedPointwise*>(&node))
+    {
+        executeFusedPointwise(*fused, buffers);
+    }
+    else if(const auto* matmul = dynamic_cast<const OperationMatmul*>(&node))
+    {
+        executeMatmul(*matmul, buffers);
+    }
+    else if(const auto* reduction = dynamic_cast<const OperationReduction*>(&node))
+    {
+        executeReduction(*reduction, buffers);
+    }
+    else if(const auto* rng = dynamic_cast<const OperationRng*>(&node))
+    {
+        executeRng(*rng, buffers);
+    }
+    else if(const auto* fwd = dynamic_cast<const OperationConvolutionForward*>(&node))
+    {
+        executeConvolution(*fwd, buffers, ConvDirection::Forward);
+    }
+    else if(const auto* bwd_data = dynamic_cast<const OperationConvolutionBackwardData*>(&node))
+    {
+        executeConvolution(*bwd_data, buffers, ConvDirection::BackwardData);
+    }
+    else if(const auto* bwd_filter =
+                dynamic_cast<const OperationConvolutionBackwardFilter*>(&node))
+    {
+        executeConvolution(*bwd_filter, buffers, ConvDirection::BackwardFilter);
+    }
+    else
+    {
+        MIOPEN_THROW(miopenStatusNotImplemented, "No host implementation of " + node.signName());
+    }
+}
+
+bool isHostAccessible(const void* ptr)
+{
+#if MIOPEN_BACKEND_HIP
+    hipPointerAttribute_t attributes{};
+    if(hipPointerGetAttributes(&attributes, ptr) != hipSuccess)
+    {
+        // Not allocated by the runtime, so plain host memory.
+        std::ignore = hipGetLastError();
+        return true;
+    }
+#if HIP_PACKAGE_VERSION_FLAT >= 6000000000ULL
+    const auto type = attributes.type;
+#else
+    const auto type = attributes.memoryType;
+#endif
+    return type != hipMemoryTypeDevice || attributes.isManaged != 0;
+#else
+    std::ignore = ptr;
+    return true;
+#endif
+}
+
+} // namespace graphapi
+
+} // namespace miopen
@@ -28,6 +28,8 @@
 #include <miopen/graphapi/opgraph.hpp>
 
 #include <deque>
+#include <functional>
+#include <sstream>
 #include <unordered_map>
 
 namespace miopen {
@@ -35,6 +37,8 @@ namespace graphapi {
 
 OpNode::~OpNode() = default;
 
+size_t OpNode::hashAttributes() const { return 0; }
+
 void OpGraphBuilder::setHandle(miopenHandle_t handle) { mHandle = checkPtr(handle); }
 
 OpGraph OpGraphBuilder::build() &&
@@ -54,6 +58,10 @@ OpGraph OpGraphBuilder::build() &&
 
     for(OpNode* n : mNodes)
     {
+        // A node may have been built into another graph before (e.g. a backend operation
+        // descriptor shared by operation graph descriptors), it keeps the edges of the latest
+        n->mInEdges.clear();
+        n->mOutEdges.clear();
 
         for(Tensor* i : n->getInTensors())
         {
@@ -100,222 +108,290 @@ OpGraph OpGraphBuilder::build() &&
         }
     }
 
+    graph.initTopologicalOrder();
+    graph.initCanonicalForm();
+
+    // The host reference engine, see ExecutionPlan
+    graph.mEngines.emplace_back();
+
     return graph;
 }
 
-VecOfPaths OpGraph::getAllPaths() const
+namespace {
+
+using internal::combineHash;
+
+size_t hashTensor(const Tensor* tens_ptr)
 {
-    // TODO(Amber): does not check for cycles. Use DFS to first check for cycles
-    // at construction time perhaps.
-    VecOfPaths all_paths;
+    assert(tens_ptr);
+    return combineHash(std::hash<int>{}(tens_ptr->getDataType()), tens_ptr->isVirtual() ? 1 : 0);
+}
 
-    std::deque<Path> paths_to_explore;
-    paths_to_explore.emplace_back(Path{mSrcNode.get()});
+/// Folds the labels of the neighbors into seed. The neighbors are sorted first to make the
+/// result independent of the edge order.
+template <typename LabelOf>
+size_t hashNeighbors(size_t seed,
+                          const std::vector<OpEdge>& edges,
+                          LabelOf&& label_of,
+                          std::vector<size_t>& scratch)
+{
+    scratch.clear();
+    for(const auto& [node, tens_ptr] : edges)
+    {
+        scratch.emplace_back(combineHash(label_of(node), hashTensor(tens_ptr)));
+    }
+    std::sort(scratch.begin(), scratch.end());
 
-    while(!paths_to_explore.empty())
+    seed = combineHash(seed, scratch.size());
+    for(size_t label : scratch)
     {
-        Path path = paths_to_explore.front();
-        paths_to_explore.pop_front();
+        seed = combineHash(seed, label);
+    }
+    return seed;
+}
 
-        assert(!path.empty());
-        const OpNode* last_node = path.back();
-        assert(last_node);
-        if(last_node->getOutEdges().empty())
-        {
-            // all paths should terminate at the sink
-            assert(last_node == mSinkNode.get());
-            all_paths.emplace_back(std::move(path));
-        }
-        else
+/// hashTensor() refined with the layout of the tensor
+size_t hashTensorShape(const Tensor* tens_ptr)
+{
+    size_t seed   = hashTensor(tens_ptr);
+    auto addRange = [&seed](const std::vector<int64_t>& values) {
+        seed = combineHash(seed, values.size());
+        for(int64_t value : values)
         {
-            for(const auto& [dst, tens_ptr] : last_node->getOutEdges())
-            {
-                Path newPath{path};
-                newPath.emplace_back(dst);
-                paths_to_explore.emplace_back(std::move(newPath));
-            }
+            seed = combineHash(seed, std::hash<int64_t>{}(value));
         }
-    } // end while
-
-    return all_paths;
+    };
+    addRange(tens_ptr->getDimensions());
+    addRange(tens_ptr->getStrides());
+    return seed;
 }
 
-std::string pathToStr(const Path& path)
+size_t countDistinct(std::vector<size_t> labels)
 {
-    std::ostringstream oss;
-    for(const OpNode* n : path)
-    {
-        oss << n->signName() << ",";
-    }
-    return oss.str();
+    std::sort(labels.begin(), labels.end());
+    return std::unique(labels.begin(), labels.end()) - labels.begin();
 }
 
-namespace internal {
-
-using MapSizeToPathVec = std::unordered_map<size_t, VecOfPaths>;
+} // namespace
 
-bool checkSameNodesByName(const OpGraph& left, const OpGraph& right)
+void OpGraph::initTopologicalOrder()
 {
-    auto l_names = left.getNodeNames();
-    auto r_names = right.getNodeNames();
-    if(l_names.size() != r_names.size())
+    // Kahn's algorithm
+    std::unordered_map<const OpNode*, size_t> index;
+    index.reserve(mNodes.size());
+    std::vector<size_t> in_degree(mNodes.size());
+    for(size_t i = 0; i < mNodes.size(); ++i)
     {
-        return false;
+        index.emplace(mNodes[i], i);
+        in_degree[i] = mNodes[i]->getInDegree();
     }
 
-    std::sort(l_names.begin(), l_names.end());
-    std::sort(r_names.begin(), r_names.end());
-
-    return l_names == r_names;
-}
-
-bool checkSameDegreeVecs(const OpGraph& left, const OpGraph& right)
-{
-    auto l_degs = left.getInOutDegrees();
-    auto r_degs = right.getInOutDegrees();
+    // the graph inputs are ready from the start
+    for(const auto& [dst, tens_ptr] : mSrcNode->getOutEdges())
+    {
+        --in_degree[index.at(dst)];
+    }
 
-    /*
-    auto sort_deg_vec = [] (auto& deg_vec) {
+    std::vector<OpNode*> order;
+    order.reserve(mNodes.size());
+    for(size_t i = 0; i < mNodes.size(); ++i)
+    {
+        if(in_degree[i] == 0)
+        {
+            order.emplace_back(mNodes[i]);
+        }
+    }
 
-        std::sort(deg_vec.begin(), deg_vec.end(),
-            [] (const auto& left, const auto& right) {
-              if (left.first == right.first) {
-                return left.second < right.second;
-              }
-              return left.first < right.first;
-            });
+    for(size_t next = 0; next < order.size(); ++next)
+    {
+        for(const auto& [dst, tens_ptr] : order[next]->getOutEdges())
+        {
+            if(dst == mSinkNode.get())
+            {
+                continue;
+            }
+            const size_t d = index.at(dst);
+            if(--in_degree[d] == 0)
+            {
+                order.emplace_back(mNodes[d]);
+            }
+        }
+    }
+    MIOPEN_THROW_IF(order.size() != mNodes.size(), "Operation graph has a cycle");
 
-    };
-    sort_deg_vec(l_degs);
-    sort_deg_vec(r_degs);
-    */
-    std::sort(l_degs.begin(), l_degs.end());
-    std::sort(r_degs.begin(), r_degs.end());
-    return l_degs == r_degs;
+    mTopologicalOrder = std::move(order);
 }
 
-auto groupBySize(VecOfPaths&& all_paths)
+void OpGraph::initCanonicalForm()
 {
-    MapSizeToPathVec paths_by_size;
+    // The source first and the sink last keep the order topological
+    std::vector<const OpNode*> nodes;
+    nodes.reserve(mNodes.size() + 2);
+    nodes.emplace_back(mSrcNode.get());
+    nodes.insert(nodes.end(), mTopologicalOrder.cbegin(), mTopologicalOrder.cend());
+    nodes.emplace_back(mSinkNode.get());
+
+    const size_t num_nodes = nodes.size();
+    std::unordered_map<const OpNode*, size_t> index;
+    index.reserve(num_nodes);
+    for(size_t i = 0; i < num_nodes; ++i)
+    {
+        index.emplace(nodes[i], i);
+    }
 
-    for(auto& p : all_paths)
+    std::vector<size_t> kinds(num_nodes);
+    for(size_t i = 0; i < num_nodes; ++i)
     {
-        auto [it, _ignore] = paths_by_size.emplace(p.size(), VecOfPaths{});
-        it->second.emplace_back(std::move(p));
+        kinds[i] =
+            combineHash(std::hash<std::string>{}(nodes[i]->signName()), nodes[i]->hashAttributes());
     }
 
-    return paths_by_size;
-}
+    std::vector<size_t> scratch;
 
-/*
-auto sumPathSizes(const VecOfPaths& all_paths) {
-    size_t ret = 0;
-    for (const auto& p: all_paths) {
-      ret += p.size();
+    // One pass in topological order labels every node with all of its ancestors, one in
+    // reverse order with all of its descendants.
+    std::vector<size_t> down(num_nodes);
+    for(size_t i = 0; i < num_nodes; ++i)
+    {
+        down[i] = hashNeighbors(
+            kinds[i], nodes[i]->getInEdges(), [&](auto n) { return down[index.at(n)]; }, scratch);
     }
-    return ret;
-}
-*/
 
-bool checkSamePathVecs(const VecOfPaths& left, const VecOfPaths& right)
-{
-    if(left.size() != right.size())
+    std::vector<size_t> up(num_nodes);
+    for(size_t i = num_nodes; i-- > 0;)
     {
-        return false;
+        up[i] = hashNeighbors(
+            kinds[i], nodes[i]->getOutEdges(), [&](auto n) { return up[index.at(n)]; }, scratch);
     }
 
-    using VecOfStr = std::vector<std::string>;
+    std::vector<size_t> labels(num_nodes);
+    for(size_t i = 0; i < num_nodes; ++i)
+    {
+        labels[i] = combineHash(down[i], up[i]);
+    }
 
-    auto pathvec_to_strvec = [](const VecOfPaths& pathvec) {
-        VecOfStr ret;
-        for(const Path& path : pathvec)
+    // Refine until the partition of the nodes by label stops splitting, which separates nodes
+    // with the same ancestors and descendants but different siblings.
+    size_t num_distinct = countDistinct(labels);
+    std::vector<size_t> refined(num_nodes);
+    for(size_t round = 0; round < num_nodes; ++round)
+    {
+        auto label_of = [&](auto n) { return labels[index.at(n)]; };
+        for(size_t i = 0; i < num_nodes; ++i)
         {
-            ret.emplace_back(pathToStr(path));
+            refined[i] = hashNeighbors(labels[i], nodes[i]->getInEdges(), label_of, scratch);
+            refined[i] = hashNeighbors(refined[i], nodes[i]->getOutEdges(), label_of, scratch);
         }
-        return ret;
-    };
-
-    VecOfStr l_paths_as_str = pathvec_to_strvec(left);
-    VecOfStr r_paths_as_str = pathvec_to_strvec(right);
-
-    std::sort(l_paths_as_str.begin(), l_paths_as_str.end());
-    std::sort(r_paths_as_str.begin(), r_paths_as_str.end());
-
-    return l_paths_as_str == r_paths_as_str;
-}
+        labels.swap(refined);
 
-bool checkSamePaths(const OpGraph& left, const OpGraph& right)
-{
+        const size_t refined_distinct = countDistinct(labels);
+        if(refined_distinct == num_distinct)
+        {
+            break;
+        }
+        num_distinct = refined_distinct;
+    }
 
-    auto l_paths = left.getAllPaths();
-    auto r_paths = right.getAllPaths();
+    CanonicalForm form;
+    form.mNodes = labels;
+    std::sort(form.mNodes.begin(), form.mNodes.end());
 
-    if(l_paths.size() != r_paths.size())
+    for(size_t i = 0; i < num_nodes; ++i)
     {
-        return false;
+        for(const auto& [dst, tens_ptr] : nodes[i]->getOutEdges())
+        {
+            form.mEdges.push_back({labels[i], hashTensor(tens_ptr), labels[index.at(dst)]});
+        }
     }
+    std::sort(form.mEdges.begin(), form.mEdges.end());
 
-    auto l_paths_by_sz = groupBySize(std::move(l_paths));
-    auto r_paths_by_sz = groupBySize(std::move(r_paths));
-
-    auto get_keys = [](const MapSizeToPathVec& paths_by_size) {
-        std::vector<size_t> keys{};
-        for(const auto& [k, v] : paths_by_size)
+    form.mHash = combineHash(form.mNodes.size(), form.mEdges.size());
+    for(size_t label : form.mNodes)
+    {
+        form.mHash = combineHash(form.mHash, label);
+    }
+    for(const auto& edge : form.mEdges)
+    {
+        for(size_t label : edge)
         {
-            keys.emplace_back(k);
+            form.mHash = combineHash(form.mHash, label);
         }
-        return keys;
-    };
-
-    auto l_keys = get_keys(l_paths_by_sz);
-    auto r_keys = get_keys(r_paths_by_sz);
+    }
 
-    if(l_keys != r_keys)
+    ShapedForm shaped;
+    shaped.mEdges.reserve(form.mEdges.size());
+    for(size_t i = 0; i < num_nodes; ++i)
     {
-        return false;
+        for(const auto& [dst, tens_ptr] : nodes[i]->getOutEdges())
+        {
+            shaped.mEdges.push_back({labels[i], hashTensorShape(tens_ptr), labels[index.at(dst)]});
+        }
     }
+    std::sort(shaped.mEdges.begin(), shaped.mEdges.end());
 
-    for(size_t k : l_keys)
+    shaped.mHash = form.mHash;
+    for(const auto& edge : shaped.mEdges)
     {
-        if(!checkSamePathVecs(l_paths_by_sz[k], r_paths_by_sz[k]))
+        for(size_t label : edge)
         {
-            return false;
+            shaped.mHash = combineHash(shaped.mHash, label);
         }
     }
 
-    return true;
+    shaped.mForm = std::move(form);
+    mShapedForm  = std::move(shaped);
 }
 
-} // end namespace internal
-
-bool isIsomorphic(const OpGraph& left, const OpGraph& right)
+VecOfPaths OpGraph::getAllPaths() const
 {
-    if(left.numNodes() != right.numNodes())
-    {
-        return false;
-    }
+    // cycles are rejected by OpGraphBuilder::build()
+    VecOfPaths all_paths;
 
-    if(left.numEdges() != right.numEdges())
-    {
-        return false;
-    }
+    std::deque<Path> paths_to_explore;
+    paths_to_explore.emplace_back(Path{mSrcNode.get()});
 
-    if(!internal::checkSameNodesByName(left, right))
+    while(!paths_to_explore.empty())
     {
-        return false;
-    }
+        Path path = paths_to_explore.front();
+        paths_to_explore.pop_front();
 
-    if(!internal::checkSameDegreeVecs(left, right))
-    {
-        return false;
-    }
+        assert(!path.empty());
+        const OpNode* last_node = path.back();
+        assert(last_node);
+        if(last_node->getOutEdges().empty())
+        {
+            // all paths should terminate at the sink
+            assert(last_node == mSinkNode.get());
+            all_paths.emplace_back(std::move(path));
+        }
+        else
+        {
+            for(const auto& [dst, tens_ptr] : last_node->getOutEdges())
+            {
+                Path newPath{path};
+                newPath.emplace_back(dst);
+                paths_to_explore.emplace_back(std::move(newPath));
+            }
+        }
+    } // end while
 
-    if(!internal::checkSamePaths(left, right))
+    return all_paths;
+}
+
+std::string pathToStr(const Path& path)
+{
+    std::ostringstream oss;
+    for(const OpNode* n : path)
     {
-        return false;
+        oss << n->signName() << ",";
     }
+    return oss.str();
+}
 
-    return true;
+bool isIsomorphic(const OpGraph& left, const OpGraph& right)
+{
+    return left.numNodes() == right.numNodes() &&
+           left.getCanonicalForm() == right.getCanonicalForm();
 }
 
 void BackendOperationGraphDescriptor::setAttribute(miopenBackendAttributeName_t attributeName,
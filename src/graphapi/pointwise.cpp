@@ -460,6 +460,27 @@ const std::string& OperationPointwise::signName() const
     }
 }
 
+size_t OperationPointwise::hashAttributes() const
+{
+    // float and half alternatives of equal value select the same computation
+    auto value = [](const auto& attribute) {
+        return std::visit([](auto v) { return static_cast<double>(v); }, attribute);
+    };
+    return AttributeHash{}
+        .add(mPointwise->getMathPrecision())
+        .add(mPointwise->getNanPropagation())
+        .add(value(mPointwise->getReluLowerClip()))
+        .add(value(mPointwise->getReluUpperClip()))
+        .add(value(mPointwise->getReluLowerClipSlope()))
+        .add(value(mPointwise->getEluAlpha()))
+        .add(value(mPointwise->getSoftPlusBeta()))
+        .add(value(mPointwise->getSwishBeta()))
+        .add(mPointwise->getAxis())
+        .add(value(mAlpha1))
+        .add(value(mAlpha2))
+        .get();
+}
+
 std::vector<Tensor*> OperationPointwise::getInTensors() const
 {
     switch(mPointwise->getMode())
@@ -512,7 +533,9 @@ std::vector<Tensor*> OperationPointwise::getInTensors() const
     case MIOPEN_POINTWISE_SWISH_FWD:
     case MIOPEN_POINTWISE_GELU_APPROX_TANH_FWD:
     case MIOPEN_POINTWISE_LOGICAL_NOT:
-    case MIOPEN_POINTWISE_RECIPROCAL: return {mX};
+    case MIOPEN_POINTWISE_RECIPROCAL:
+    case MIOPEN_POINTWISE_ERF:
+    case MIOPEN_POINTWISE_GEN_INDEX: return {mX};
 
     /* 3-inputs operations
      * x input
@@ -536,11 +559,6 @@ std::vector<Tensor*> OperationPointwise::getInTensors() const
     case MIOPEN_POINTWISE_SWISH_BWD:
     case MIOPEN_POINTWISE_GELU_APPROX_TANH_BWD: return {mY, mDy};
 
-    /* TODO: Implement the remaining cases
-     */
-    case MIOPEN_POINTWISE_ERF:
-    case MIOPEN_POINTWISE_GEN_INDEX: return {};
-
     default: MIOPEN_THROW(miopenStatusNotImplemented);
     }
 }
@@ -597,6 +615,8 @@ std::vector<Tensor*> OperationPointwise::getOutTensors() const
     case MIOPEN_POINTWISE_GELU_APPROX_TANH_FWD:
     case MIOPEN_POINTWISE_LOGICAL_NOT:
     case MIOPEN_POINTWISE_RECIPROCAL:
+    case MIOPEN_POINTWISE_ERF:
+    case MIOPEN_POINTWISE_GEN_INDEX:
         /* 3-inputs operations
          * x input
          * b input
@@ -619,11 +639,6 @@ std::vector<Tensor*> OperationPointwise::getOutTensors() const
     case MIOPEN_POINTWISE_SWISH_BWD:
     case MIOPEN_POINTWISE_GELU_APPROX_TANH_BWD: return {mDx};
 
-    /* TODO: Implement the remaining cases
-     */
-    case MIOPEN_POINTWISE_ERF:
-    case MIOPEN_POINTWISE_GEN_INDEX: return {};
-
     default: MIOPEN_THROW(miopenStatusNotImplemented);
     }
 }
@@ -779,6 +794,8 @@ OperationPointwise OperationPointwiseBuilder::build()
     case MIOPEN_POINTWISE_GELU_APPROX_TANH_FWD:
     case MIOPEN_POINTWISE_LOGICAL_NOT:
     case MIOPEN_POINTWISE_RECIPROCAL:
+    case MIOPEN_POINTWISE_ERF:
+    case MIOPEN_POINTWISE_GEN_INDEX:
         if(mOperationPointwise.mX == nullptr || mOperationPointwise.mY == nullptr ||
            mOperationPointwise.mB != nullptr || mOperationPointwise.mT != nullptr ||
            mOperationPointwise.mDx != nullptr || mOperationPointwise.mDy != nullptr || mAlpha2Set ||
@@ -842,11 +859,6 @@ OperationPointwise OperationPointwiseBuilder::build()
         }
         break;
 
-    /* TODO: Implement the remaining cases
-     */
-    case MIOPEN_POINTWISE_ERF:
-    case MIOPEN_POINTWISE_GEN_INDEX: MIOPEN_THROW(miopenStatusNotImplemented);
-
     default: MIOPEN_THROW(miopenStatusNotImplemented);
     }
 
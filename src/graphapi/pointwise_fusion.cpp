@@ -0,0 +1,383 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/errors.hpp>
+#include <miopen/graphapi/pointwise_fusion.hpp>
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace miopen {
+
+namespace graphapi {
+
+namespace {
+
+const OperationPointwise* asFusable(const OpNode* node)
+{
+    const auto* pointwise = dynamic_cast<const OperationPointwise*>(node);
+    // GEN_INDEX depends on the position of the element rather than on its value
+    return pointwise != nullptr && pointwise->getPointwise()->getMode() != MIOPEN_POINTWISE_GEN_INDEX
+               ? pointwise
+               : nullptr;
+}
+
+const std::vector<int64_t>& outDimensions(const OpNode* node)
+{
+    return node->getOutTensors().front()->getDimensions();
+}
+
+} // namespace
+
+const std::string& OperationFusedPointwise::signName() const
+{
+    static const std::string name = "OP_POINTWISE:FUSED";
+    return name;
+}
+
+size_t OperationFusedPointwise::hashAttributes() const
+{
+    AttributeHash hash;
+    hash.add(mInputs.size()).add(mInstructions.size());
+    for(const auto& instruction : mInstructions)
+    {
+        hash.add(instruction.mOperation->signName())
+            .add(instruction.mOperation->hashAttributes())
+            .add(instruction.mArgs);
+    }
+    for(const auto& output : mOutputs)
+    {
+        hash.add(output.first);
+    }
+    return hash.get();
+}
+
+std::vector<Tensor*> OperationFusedPointwise::getOutTensors() const
+{
+    std::vector<Tensor*> ret;
+    ret.reserve(mOutputs.size());
+    for(const auto& [reg, tensor] : mOutputs)
+    {
+        ret.push_back(tensor);
+    }
+    return ret;
+}
+
+std::shared_ptr<OperationFusedPointwise>
+fusePointwiseOperations(const std::vector<const OperationPointwise*>& operations,
+                        const std::vector<const OpNode*>& consumers)
+{
+    MIOPEN_THROW_IF(operations.empty(), "Nothing to fuse");
+
+    auto fused         = std::make_shared<OperationFusedPointwise>();
+    fused->mDimensions = outDimensions(operations.front());
+
+    std::unordered_set<const Tensor*> produced;
+    for(const auto* operation : operations)
+    {
+        const auto outputs = operation->getOutTensors();
+        produced.insert(outputs.cbegin(), outputs.cend());
+    }
+
+    std::unordered_map<const Tensor*, size_t> registerOf;
+    for(const auto* operation : operations)
+    {
+        for(Tensor* input : operation->getInTensors())
+        {
+            if(produced.count(input) == 0 &&
+               registerOf.emplace(input, fused->mInputs.size()).second)
+            {
+                fused->mInputs.push_back(input);
+            }
+        }
+    }
+
+    std::unordered_set<const Tensor*> readOutside;
+    for(const OpNode* consumer : consumers)
+    {
+        const auto inputs = consumer->getInTensors();
+        readOutside.insert(inputs.cbegin(), inputs.cend());
+    }
+
+    for(const auto* operation : operations)
+    {
+        MIOPEN_THROW_IF(outDimensions(operation) != fused->mDimensions,
+                        "Fused pointwise operations must have equal output dimensions");
+
+        OperationFusedPointwise::Instruction instruction{operation, {}};
+        for(Tensor* input : operation->getInTensors())
+        {
+            auto it = registerOf.find(input);
+            MIOPEN_THROW_IF(it == registerOf.end(),
+                            "Fused pointwise operations are not in topological order");
+            instruction.mArgs.push_back(it->second);
+        }
+
+        const size_t reg = fused->mInputs.size() + fused->mInstructions.size();
+        Tensor* output   = operation->getOutTensors().front();
+        registerOf[output] = reg;
+        if(!output->isVirtual() || readOutside.count(output) != 0)
+        {
+            fused->mOutputs.emplace_back(reg, output);
+        }
+        fused->mInstructions.push_back(std::move(instruction));
+    }
+
+    return fused;
+}
+
+PointwiseFusion fusePointwise(const std::vector<const OpNode*>& steps)
+{
+    const size_t numSteps = steps.size();
+
+    std::unordered_map<const Tensor*, size_t> producer;
+    for(size_t i = 0; i < numSteps; ++i)
+    {
+        for(const Tensor* output : steps[i]->getOutTensors())
+        {
+            producer.emplace(output, i);
+        }
+    }
+
+    auto producersOf = [&](size_t i) {
+        std::vector<size_t> ret;
+        for(const Tensor* input : steps[i]->getInTensors())
+        {
+            auto it = producer.find(input);
+            if(it != producer.end())
+            {
+                ret.push_back(it->second);
+            }
+        }
+        return ret;
+    };
+
+    std::vector<std::vector<size_t>> successors(numSteps);
+    for(size_t i = 0; i < numSteps; ++i)
+    {
+        for(size_t p : producersOf(i))
+        {
+            successors[p].push_back(i);
+        }
+    }
+
+    std::vector<int> groupOf(numSteps, -1);
+    std::vector<std::vector<size_t>> groups;
+
+    // Whether contracting members into one node closes a cycle, given the groups formed so far
+    // are contracted too: a path leaves the members and comes back to them.
+    std::vector<char> inside(numSteps);
+    std::vector<char> seen(numSteps);
+    std::vector<size_t> stack;
+    auto createsCycle = [&](const std::vector<size_t>& members) {
+        std::fill(inside.begin(), inside.end(), 0);
+        std::fill(seen.begin(), seen.end(), 0);
+        stack.clear();
+        for(size_t m : members)
+        {
+            inside[m] = 1;
+        }
+
+        auto visit = [&](size_t v) {
+            auto push = [&](size_t node) {
+                if(seen[node] == 0)
+                {
+                    seen[node] = 1;
+                    stack.push_back(node);
+                }
+            };
+            // a node of a group stands for the whole group
+            if(groupOf[v] >= 0)
+            {
+                for(size_t g : groups[groupOf[v]])
+                {
+                    push(g);
+                }
+            }
+            push(v);
+        };
+
+        for(size_t m : members)
+        {
+            for(size_t s : successors[m])
+            {
+                if(inside[s] == 0)
+                {
+                    visit(s);
+                }
+            }
+        }
+        while(!stack.empty())
+        {
+            const size_t v = stack.back();
+            stack.pop_back();
+            for(size_t s : successors[v])
+            {
+                if(inside[s] != 0)
+                {
+                    return true;
+                }
+                visit(s);
+            }
+        }
+        return false;
+    };
+
+    for(size_t i = 0; i < numSteps; ++i)
+    {
+        if(asFusable(steps[i]) == nullptr)
+        {
+            continue;
+        }
+
+        std::vector<size_t> members{i};
+        std::vector<int> merged;
+        for(size_t p : producersOf(i))
+        {
+            const int g = groupOf[p];
+            if(g < 0 || std::find(merged.cbegin(), merged.cend(), g) != merged.cend() ||
+               outDimensions(steps[p]) != outDimensions(steps[i]))
+            {
+                continue;
+            }
+            auto candidate = members;
+            candidate.insert(candidate.end(), groups[g].cbegin(), groups[g].cend());
+            if(!createsCycle(candidate))
+            {
+                members = std::move(candidate);
+                merged.push_back(g);
+            }
+        }
+
+        for(int g : merged)
+        {
+            groups[g].clear();
+        }
+        std::sort(members.begin(), members.end());
+        for(size_t m : members)
+        {
+            groupOf[m] = static_cast<int>(groups.size());
+        }
+        groups.push_back(std::move(members));
+    }
+
+    // Every group of two or more operations is one unit, every other node is a unit of its own
+    std::vector<std::vector<size_t>> units;
+    std::vector<size_t> unitOf(numSteps);
+    std::unordered_map<int, size_t> unitOfGroup;
+    for(size_t i = 0; i < numSteps; ++i)
+    {
+        const int g = groupOf[i];
+        if(g >= 0 && groups[g].size() > 1)
+        {
+            auto [it, inserted] = unitOfGroup.emplace(g, units.size());
+            if(inserted)
+            {
+                units.push_back(groups[g]);
+            }
+            unitOf[i] = it->second;
+        }
+        else
+        {
+            unitOf[i] = units.size();
+            units.push_back({i});
+        }
+    }
+
+    std::vector<std::set<size_t>> unitSuccessors(units.size());
+    std::vector<size_t> inDegree(units.size());
+    for(size_t u = 0; u < units.size(); ++u)
+    {
+        for(size_t m : units[u])
+        {
+            for(size_t p : producersOf(m))
+            {
+                if(unitOf[p] != u && unitSuccessors[unitOf[p]].insert(u).second)
+                {
+                    ++inDegree[u];
+                }
+            }
+        }
+    }
+
+    // Kahn's algorithm, taking the unit that comes first in the original order when several
+    // are ready
+    PointwiseFusion fusion;
+    std::set<size_t> ready;
+    for(size_t u = 0; u < units.size(); ++u)
+    {
+        if(inDegree[u] == 0)
+        {
+            ready.insert(u);
+        }
+    }
+    while(!ready.empty())
+    {
+        const size_t u = *ready.begin();
+        ready.erase(ready.begin());
+
+        if(units[u].size() == 1)
+        {
+            fusion.mSteps.push_back(steps[units[u].front()]);
+        }
+        else
+        {
+            std::vector<const OperationPointwise*> operations;
+            for(size_t m : units[u])
+            {
+                operations.push_back(asFusable(steps[m]));
+            }
+            std::vector<const OpNode*> consumers;
+            for(size_t i = 0; i < numSteps; ++i)
+            {
+                if(unitOf[i] != u)
+                {
+                    consumers.push_back(steps[i]);
+                }
+            }
+            auto fused = fusePointwiseOperations(operations, consumers);
+            fusion.mSteps.push_back(fused.get());
+            fusion.mFusedNodes.push_back(std::move(fused));
+        }
+
+        for(size_t s : unitSuccessors[u])
+        {
+            if(--inDegree[s] == 0)
+            {
+                ready.insert(s);
+            }
+        }
+    }
+    MIOPEN_THROW_IF(fusion.mSteps.size() != units.size(), "Pointwise fusion created a cycle");
+
+    return fusion;
+}
+
+} // namespace graphapi
+
+} // namespace miopen
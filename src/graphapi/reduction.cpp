@@ -176,6 +176,11 @@ const std::string& OperationReduction::signName() const
     }
 }
 
+size_t OperationReduction::hashAttributes() const
+{
+    return AttributeHash{}.add(mReduction->getCompType()).get();
+}
+
 std::vector<Tensor*> OperationReduction::getInTensors() const { return {mX}; }
 
 std::vector<Tensor*> OperationReduction::getOutTensors() const { return {mY}; }
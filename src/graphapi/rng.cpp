@@ -200,6 +200,24 @@ const std::string& OperationRng::signName() const
     return name;
 }
 
+size_t OperationRng::hashAttributes() const
+{
+    AttributeHash hash;
+    hash.add(mRng->getDistribution())
+        .add(mRng->getNormalMean())
+        .add(mRng->getNormalStdev())
+        .add(mRng->getUniformMin())
+        .add(mRng->getUniformMax())
+        .add(mRng->getBernoulliProb())
+        .add(mSeed.index());
+    // A seed given as a tensor is an input edge
+    if(mSeed.index() == 0)
+    {
+        hash.add(std::get<int64_t>(mSeed));
+    }
+    return hash.get();
+}
+
 std::vector<Tensor*> OperationRng::getInTensors() const
 {
     if(mSeed.index() == 0)
@@ -25,6 +25,7 @@
  *******************************************************************************/
 #include <cstdio>
 #include <miopen/version.h>
+#include <miopen/binary_cache.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/handle.hpp>
 
@@ -114,3 +115,17 @@ extern "C" miopenStatus_t miopenEnableProfiling(miopenHandle_t handle, bool enab
 {
     return miopen::try_([&] { miopen::deref(handle).EnableProfiling(enable); });
 }
+
+extern "C" miopenStatus_t miopenGetKernelCacheStats(miopenKernelCacheStats_t* stats)
+{
+    return miopen::try_([&] {
+        const auto cache_stats = miopen::GetKernelCacheStats();
+        auto& result           = miopen::deref(stats);
+        result.hits            = cache_stats.hits;
+        result.misses          = cache_stats.misses;
+        result.loaded_bytes    = cache_stats.loaded_bytes;
+        result.saved           = cache_stats.saved;
+        result.saved_bytes     = cache_stats.saved_bytes;
+        result.evicted         = cache_stats.evicted;
+    });
+}
@@ -34,6 +34,7 @@
 #include <miopen/invoker.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/ramdb.hpp>
 #include <miopen/stringutils.hpp>
 #include <miopen/target_properties.hpp>
 #include <miopen/timer.hpp>
@@ -313,7 +314,7 @@ Handle::Handle() : impl(std::make_unique<HandleImpl>())
     MIOPEN_LOG_NQI(*this);
 }
 
-Handle::~Handle() {}
+Handle::~Handle() { RamDb::FlushAll(); }
 
 // not MT safe
 void Handle::SetStream(miopenAcceleratorQueue_t streamID) const
@@ -668,6 +669,8 @@ std::size_t Handle::GetMaxMemoryAllocSize()
 {
     if(m_MaxMemoryAllocSizeCached == 0)
     {
+        // The memory info is of the current device of the calling thread.
+        this->impl->set_ctx();
         size_t free, total;
         auto status = hip_mem_get_info_wrapper(&free, &total);
         if(status != hipSuccess)
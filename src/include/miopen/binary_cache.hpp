@@ -30,11 +30,40 @@
 #include <miopen/config.hpp>
 #include <miopen/target_properties.hpp>
 #include <miopen/filesystem.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace miopen {
 
-bool IsCacheDisabled();
+struct KernelCacheStats
+{
+    std::size_t hits         = 0;
+    std::size_t misses       = 0;
+    std::size_t loaded_bytes = 0;
+    std::size_t saved        = 0;
+    std::size_t saved_bytes  = 0;
+    std::size_t evicted      = 0;
+};
+
+MIOPEN_INTERNALS_EXPORT bool IsCacheDisabled();
+
+/// Kernel cache activity of this process.
+MIOPEN_INTERNALS_EXPORT KernelCacheStats GetKernelCacheStats();
+
+/// Size limit of the user kernel cache in bytes, 0 for none.
+MIOPEN_INTERNALS_EXPORT std::size_t GetCacheSizeLimit();
+
+/// SaveBinary evicts the least recently used kernels on the shared thread pool once the user
+/// kernel cache outgrows GetCacheSizeLimit(). This waits for all queued maintenance tasks.
+MIOPEN_INTERNALS_EXPORT void WaitForCacheEviction();
+
+/// Removes the least recently used kernel files of a file based cache until they take 90% of
+/// max_bytes, if they take more than max_bytes. Returns the number of removed files and sets
+/// remaining_bytes, if given, to the size of the files left.
+MIOPEN_INTERNALS_EXPORT std::size_t EvictCacheFiles(const fs::path& cache_dir,
+                                                    std::size_t max_bytes,
+                                                    std::uintmax_t* remaining_bytes = nullptr);
 
 MIOPEN_INTERNALS_EXPORT fs::path
 GetCacheFile(const std::string& device, const fs::path& name, const std::string& args);
@@ -42,26 +71,26 @@ GetCacheFile(const std::string& device, const fs::path& name, const std::string&
 MIOPEN_INTERNALS_EXPORT fs::path GetCachePath(bool is_system);
 
 #if !MIOPEN_ENABLE_SQLITE_KERN_CACHE
-fs::path LoadBinary(const TargetProperties& target,
-                    std::size_t num_cu,
-                    const fs::path& name,
-                    const std::string& args);
-
-void SaveBinary(const fs::path& binary_path,
-                const TargetProperties& target,
-                const fs::path& name,
-                const std::string& args);
+MIOPEN_INTERNALS_EXPORT fs::path LoadBinary(const TargetProperties& target,
+                                            std::size_t num_cu,
+                                            const fs::path& name,
+                                            const std::string& args);
+
+MIOPEN_INTERNALS_EXPORT void SaveBinary(const fs::path& binary_path,
+                                        const TargetProperties& target,
+                                        const fs::path& name,
+                                        const std::string& args);
 #else
-std::vector<char> LoadBinary(const TargetProperties& target,
-                             std::size_t num_cu,
-                             const fs::path& name,
-                             const std::string& args);
-
-void SaveBinary(const std::vector<char>& hsaco,
-                const TargetProperties& target,
-                std::size_t num_cu,
-                const fs::path& name,
-                const std::string& args);
+MIOPEN_INTERNALS_EXPORT std::vector<char> LoadBinary(const TargetProperties& target,
+                                                     std::size_t num_cu,
+                                                     const fs::path& name,
+                                                     const std::string& args);
+
+MIOPEN_INTERNALS_EXPORT void SaveBinary(const std::vector<char>& hsaco,
+                                        const TargetProperties& target,
+                                        std::size_t num_cu,
+                                        const fs::path& name,
+                                        const std::string& args);
 #endif
 
 } // namespace miopen
@@ -0,0 +1,330 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_BINARY_DB_FORMAT_HPP_
+#define GUARD_MIOPEN_BINARY_DB_FORMAT_HPP_
+
+// This header is shared with the offline converter (tools/txt2bdb), so it shall not depend on
+// anything but the standard library.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace miopen {
+namespace binary_db {
+
+/// Precompiled image of a system db. All the records are located by a minimal perfect hash
+/// (hash and displace), and the ID:VALUES pairs of each record are split in advance, so a lookup
+/// requires neither parsing nor key comparisons other than the final one.
+///
+/// Layout:
+///     Header
+///     uint32_t seeds[bucket_count]
+///     Slot     slots[record_count]
+///     Entry    entries[entry_count]
+///     char     strings[strings_size]
+/// All the offsets are relative to the beginning of the strings.
+constexpr char Magic[8]            = {'M', 'I', 'O', 'P', 'E', 'N', 'B', 'D'};
+constexpr std::uint32_t Version    = 1;
+constexpr std::uint32_t EndianMark = 0x01020304;
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian_mark;
+    std::uint32_t record_count;
+    std::uint32_t bucket_count;
+    std::uint32_t entry_count;
+    std::uint32_t strings_size;
+};
+
+struct Slot
+{
+    std::uint32_t key_offset;
+    std::uint32_t key_size;
+    std::uint32_t first_entry;
+    std::uint32_t entry_count;
+};
+
+struct Entry
+{
+    std::uint32_t id_offset;
+    std::uint32_t id_size;
+    std::uint32_t values_offset;
+    std::uint32_t values_size;
+};
+
+static_assert(sizeof(Header) == 32, "Binary db header layout is a part of the file format");
+static_assert(sizeof(Slot) == 16, "Binary db slot layout is a part of the file format");
+static_assert(sizeof(Entry) == 16, "Binary db entry layout is a part of the file format");
+
+inline std::uint64_t Hash(std::string_view key, std::uint32_t seed)
+{
+    // FNV-1a with the seed mixed into the offset basis.
+    auto hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+    for(const auto c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash ^ (hash >> 32);
+}
+
+/// Lookup over a validated image. Returns the slot index which is the only candidate for the key,
+/// the caller has to compare the keys.
+inline std::uint32_t
+GetSlotIndex(std::string_view key, const std::uint32_t* seeds, const Header& header)
+{
+    const auto bucket = Hash(key, 0) % header.bucket_count;
+    return static_cast<std::uint32_t>(Hash(key, seeds[bucket]) % header.record_count);
+}
+
+struct View
+{
+    const Header* header       = nullptr;
+    const std::uint32_t* seeds = nullptr;
+    const Slot* slots          = nullptr;
+    const Entry* entries       = nullptr;
+    const char* strings        = nullptr;
+
+    /// Checks the image and locates its sections. Returns false if the image is malformed, i.e. it
+    /// is truncated or any slot or entry points out of its section.
+    bool Init(const char* data, std::size_t size)
+    {
+        if(size < sizeof(Header))
+            return false;
+
+        header = reinterpret_cast<const Header*>(data);
+        if(std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 || header->version != Version ||
+           header->endian_mark != EndianMark)
+            return false;
+        if(header->record_count != 0 && header->bucket_count == 0)
+            return false;
+
+        const auto expected_size = sizeof(Header) + header->bucket_count * sizeof(std::uint32_t) +
+                                   header->record_count * sizeof(Slot) +
+                                   header->entry_count * sizeof(Entry) + header->strings_size;
+        if(size < expected_size)
+            return false;
+
+        seeds   = reinterpret_cast<const std::uint32_t*>(data + sizeof(Header));
+        slots   = reinterpret_cast<const Slot*>(seeds + header->bucket_count);
+        entries = reinterpret_cast<const Entry*>(slots + header->record_count);
+        strings = reinterpret_cast<const char*>(entries + header->entry_count);
+
+        // Lookups trust the offsets, so they are checked once here.
+        const auto fits = [](std::uint64_t offset, std::uint64_t length, std::uint64_t limit) {
+            return offset + length <= limit;
+        };
+        for(std::uint32_t i = 0; i < header->record_count; ++i)
+        {
+            const auto& slot = slots[i];
+            if(!fits(slot.key_offset, slot.key_size, header->strings_size) ||
+               !fits(slot.first_entry, slot.entry_count, header->entry_count))
+                return false;
+        }
+        for(std::uint32_t i = 0; i < header->entry_count; ++i)
+        {
+            const auto& entry = entries[i];
+            if(!fits(entry.id_offset, entry.id_size, header->strings_size) ||
+               !fits(entry.values_offset, entry.values_size, header->strings_size))
+                return false;
+        }
+        return true;
+    }
+
+    std::string_view GetString(std::uint32_t offset, std::uint32_t size) const
+    {
+        return {strings + offset, size};
+    }
+
+    const Slot* Find(std::string_view key) const
+    {
+        if(header->record_count == 0)
+            return nullptr;
+        const auto& slot = slots[GetSlotIndex(key, seeds, *header)];
+        if(GetString(slot.key_offset, slot.key_size) != key)
+            return nullptr;
+        return &slot;
+    }
+};
+
+using Record = std::pair<std::string, std::vector<std::pair<std::string, std::string>>>;
+
+/// Builds the image. Keys are expected to be unique.
+inline std::vector<char> Build(const std::vector<Record>& records)
+{
+    const auto record_count = static_cast<std::uint32_t>(records.size());
+    // About three keys per bucket keeps the displacement search fast.
+    const auto bucket_count = std::max<std::uint32_t>(1, (record_count + 2) / 3);
+
+    auto buckets = std::vector<std::vector<std::uint32_t>>(bucket_count);
+    for(std::uint32_t i = 0; i < record_count; ++i)
+        buckets[Hash(records[i].first, 0) % bucket_count].push_back(i);
+
+    auto order = std::vector<std::uint32_t>(bucket_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    auto seeds      = std::vector<std::uint32_t>(bucket_count, 0);
+    auto slot_owner = std::vector<std::uint32_t>(record_count, record_count);
+    auto candidate  = std::vector<std::uint32_t>{};
+
+    for(const auto bucket : order)
+    {
+        const auto& keys = buckets[bucket];
+        if(keys.empty())
+            break;
+
+        for(std::uint32_t seed = 1;; ++seed)
+        {
+            if(seed == 0)
+                throw std::runtime_error("Unable to build perfect hash, duplicate keys?");
+
+            candidate.clear();
+            auto ok = true;
+            for(const auto key : keys)
+            {
+                const auto slot =
+                    static_cast<std::uint32_t>(Hash(records[key].first, seed) % record_count);
+                if(slot_owner[slot] != record_count ||
+                   std::find(candidate.begin(), candidate.end(), slot) != candidate.end())
+                {
+                    ok = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+
+            if(!ok)
+                continue;
+
+            seeds[bucket] = seed;
+            for(std::size_t i = 0; i < keys.size(); ++i)
+                slot_owner[candidate[i]] = keys[i];
+            break;
+        }
+    }
+
+    auto strings   = std::string{};
+    auto slots     = std::vector<Slot>(record_count);
+    auto entries   = std::vector<Entry>{};
+    const auto add = [&](const std::string& str) {
+        const auto offset = static_cast<std::uint32_t>(strings.size());
+        strings.append(str);
+        return offset;
+    };
+
+    for(std::uint32_t slot = 0; slot < record_count; ++slot)
+    {
+        const auto& record = records[slot_owner[slot]];
+
+        slots[slot] = {add(record.first),
+                       static_cast<std::uint32_t>(record.first.size()),
+                       static_cast<std::uint32_t>(entries.size()),
+                       static_cast<std::uint32_t>(record.second.size())};
+
+        for(const auto& id_values : record.second)
+        {
+            const auto id_offset = add(id_values.first);
+            entries.push_back({id_offset,
+                               static_cast<std::uint32_t>(id_values.first.size()),
+                               add(id_values.second),
+                               static_cast<std::uint32_t>(id_values.second.size())});
+        }
+    }
+
+    auto header = Header{};
+    std::copy(std::begin(Magic), std::end(Magic), std::begin(header.magic));
+    header.version      = Version;
+    header.endian_mark  = EndianMark;
+    header.record_count = record_count;
+    header.bucket_count = bucket_count;
+    header.entry_count  = static_cast<std::uint32_t>(entries.size());
+    header.strings_size = static_cast<std::uint32_t>(strings.size());
+
+    auto image       = std::vector<char>{};
+    const auto write = [&](const void* data, std::size_t size) {
+        const auto bytes = static_cast<const char*>(data);
+        image.insert(image.end(), bytes, bytes + size);
+    };
+
+    write(&header, sizeof(header));
+    write(seeds.data(), seeds.size() * sizeof(std::uint32_t));
+    write(slots.data(), slots.size() * sizeof(Slot));
+    write(entries.data(), entries.size() * sizeof(Entry));
+    write(strings.data(), strings.size());
+    return image;
+}
+
+/// Parses a line of a text db: "KEY=ID:VALUES;ID:VALUES". Returns false if there is no key.
+/// Items without an ID are skipped, same as DbRecord::ParseContents does; they are appended
+/// to `malformed` (if given) so the caller can report them.
+inline bool
+ParseLine(std::string_view line, Record& record, std::vector<std::string_view>* malformed = nullptr)
+{
+    const auto key_size = line.find('=');
+    if(key_size == std::string_view::npos || key_size == 0)
+        return false;
+
+    record.first = std::string{line.substr(0, key_size)};
+    record.second.clear();
+
+    auto contents = line.substr(key_size + 1);
+    while(!contents.empty())
+    {
+        const auto item_size = contents.find(';');
+        const auto item      = contents.substr(0, item_size);
+        contents.remove_prefix(item_size == std::string_view::npos ? contents.size()
+                                                                   : item_size + 1);
+
+        const auto id_size = item.find(':');
+        if(id_size == std::string_view::npos)
+        {
+            if(malformed != nullptr)
+                malformed->push_back(item);
+            continue;
+        }
+
+        // Duplicates and legacy items are left to DbRecord, same as for the text db.
+        record.second.emplace_back(item.substr(0, id_size), item.substr(id_size + 1));
+    }
+    return true;
+}
+
+} // namespace binary_db
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_BINARY_DB_FORMAT_HPP_
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+
+#include <miopen/config.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace miopen {
+namespace solver {
+
+/// Coordinates the threads that compile the kernels of the configs of a tuning search ahead of
+/// the one that benchmarks them.
+///
+/// Configs often share programs, so each program, identified by its kernel file and compile
+/// options, is compiled once per search: the first thread that needs it compiles it, the others
+/// skip it, and the benchmarking thread waits for it if it is still being compiled.
+///
+/// The programs compiled ahead are limited by a budget, so that little is wasted if the search
+/// ends early, and few programs are held if they are handed over in memory.
+class MIOPEN_INTERNALS_EXPORT CompileScheduler
+{
+public:
+    using ProgramKey = std::pair<std::string, std::string>;
+
+    enum class State
+    {
+        Missing,
+        Compiling,
+        Compiled,
+        Failed,
+    };
+
+    explicit CompileScheduler(std::size_t budget_);
+
+    /// Returns the state of the program. If it is Missing, the caller has to compile it and
+    /// report with Complete.
+    State Acquire(const ProgramKey& program);
+    void Complete(const ProgramKey& program, bool succeeded);
+    /// Waits while the program is compiled by another thread, returns the state after.
+    State Wait(const ProgramKey& program);
+
+    /// Waits until count more programs fit into the budget. Always lets through when nothing is
+    /// in flight, so that configs with more programs than the budget are compiled. Returns false
+    /// once closed.
+    bool Reserve(std::size_t count);
+    /// Counts more programs without waiting, for a config that turned out to have more.
+    void Add(std::size_t count);
+    /// Returns programs that are benchmarked, or that will not be.
+    void Release(std::size_t count);
+    /// Wakes up and turns away everybody waiting for the budget.
+    void Close();
+
+    std::size_t InFlight() const;
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable compiled;
+    std::condition_variable released;
+    std::map<ProgramKey, State> programs;
+    std::size_t budget;
+    std::size_t in_flight = 0;
+    bool closed           = false;
+};
+
+} // namespace solver
+} // namespace miopen
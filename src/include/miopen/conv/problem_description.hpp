@@ -28,6 +28,7 @@
 
 #include <boost/any.hpp>
 #include <miopen/conv_algo_name.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/names.hpp>
 #include <miopen/scalar.hpp>
 
@@ -372,18 +373,20 @@ struct MIOPEN_INTERNALS_EXPORT ProblemDescription : ProblemDescriptionBase
     void HeuristicUpdateLayouts();
 
     void MakeNetworkConfig(std::string& conf_key) const;
+    void MakeNetworkConfig(KeyWriter& key) const;
 
     NetworkConfig MakeNetworkConfig() const override
     {
-        std::string ret;
-        MakeNetworkConfig(ret);
-        return NetworkConfig{ret};
+        KeyWriter key;
+        MakeNetworkConfig(key);
+        return NetworkConfig{key.Str()};
     }
 
     // Todo: remove after fixing fin
     [[deprecated]] NetworkConfig BuildConfKey() const { return MakeNetworkConfig(); }
 
     void Serialize(std::ostream& stream) const;
+    void Serialize(KeyWriter& key) const;
 
     friend std::ostream& operator<<(std::ostream& os, const ProblemDescription& obj)
     {
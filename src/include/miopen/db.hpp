@@ -35,7 +35,9 @@
 #include <boost/optional/optional.hpp>
 
 #include <chrono>
+#include <iosfwd>
 #include <string>
+#include <vector>
 
 namespace miopen {
 
@@ -46,10 +48,16 @@ struct RecordPositions
 };
 
 class LockFile;
+class PlainTextDbIndex;
 
 constexpr bool DisableUserDbFileIO = MIOPEN_DISABLE_USERDB;
 
 /// No instance of this class should be used from several threads at the same time.
+///
+/// Records are stored one per line as "key=id:values;id:values". Lookups go through a
+/// key->offset index which is kept in the "<db>.idx" sidecar file. Modified records are appended
+/// to the end of the file and their previous line is marked dead in place by the '#' tombstone
+/// character. The file is compacted once dead lines take more space than live ones.
 class MIOPEN_INTERNALS_EXPORT PlainTextDb
 {
 public:
@@ -149,12 +157,32 @@ protected:
     bool UpdateRecordUnsafe(DbRecord& record);
     bool RemoveRecordUnsafe(const std::string& key);
 
+    struct BatchWrite
+    {
+        /// An empty record removes the stored one.
+        DbRecord record;
+        /// Merge with the stored record instead of replacing it, the record gets the result.
+        bool is_merge;
+    };
+
+    /// Applies the writes in order with a single open of the file and a single index update.
+    bool WriteRecordsUnsafe(std::vector<BatchWrite>& writes);
+
 private:
     fs::path filename;
     LockFile& lock_file;
+    PlainTextDbIndex& index;
     const bool warning_if_unreadable;
 
+    boost::optional<DbRecord> ReadRecordUnsafe(const std::string& key,
+                                               const RecordPositions& pos,
+                                               bool& is_stale);
+    boost::optional<DbRecord> ReadRecordUnsafe(std::istream& file,
+                                               const std::string& key,
+                                               const RecordPositions& pos,
+                                               bool& is_stale);
     bool FlushUnsafe(const DbRecord& record, const RecordPositions* pos);
+    void CompactUnsafe();
 
     template <class T>
     inline boost::optional<DbRecord> FindRecordUnsafe(const T& problem_config)
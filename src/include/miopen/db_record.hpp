@@ -27,13 +27,16 @@
 #define GUARD_MIOPEN_DB_RECORD_HPP_
 
 #include <miopen/config.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/logger.hpp>
 
 #include <cassert>
 #include <istream>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 namespace miopen {
 
@@ -176,28 +179,52 @@ private:
         return ss.str();
     }
 
+    template <class T, class = void>
+    struct HasKeyWriterSerialize : std::false_type
+    {
+    };
+
+    template <class T>
+    struct HasKeyWriterSerialize<
+        T,
+        std::void_t<decltype(std::declval<const T&>().Serialize(std::declval<KeyWriter&>()))>>
+        : std::true_type
+    {
+    };
+
     template <class T>
     static // 'static' is for calling from ctor
         std::string
         SerializeKey(DbKinds db_kind, const T& data)
     {
-        std::ostringstream ss;
+        KeyWriter key;
         if(db_kind == DbKinds::FindDb)
         {
-            data.Serialize(ss);
+            if constexpr(HasKeyWriterSerialize<T>::value)
+            {
+                data.Serialize(key);
+            }
+            else
+            {
+                std::ostringstream ss;
+                data.Serialize(ss);
+                return ss.str();
+            }
         }
         else
         {
             T::VisitAll(data, [&](auto&& value, auto&&) {
-                if(ss.tellp() > 0)
-                    ss << "x";
-                ss << value;
+                if(!key.Empty())
+                    key << "x";
+                key << value;
             });
         }
-        return ss.str();
+        return key.Str();
     }
 
     bool ParseContents(std::istream& contents);
+    /// Adds a single ID:VALUES item as if it has been parsed from the contents.
+    bool AddItem(std::string id, std::string values);
     void WriteContents(std::ostream& stream) const;
     void WriteIdsAndValues(std::ostream& stream) const;
     bool SetValues(const std::string& id, const std::string& values);
@@ -282,6 +309,7 @@ public:
     friend class PlainTextDb;
     friend class SQLitePerfDb;
     friend class ReadonlyRamDb;
+    friend class ReadonlyBinaryDb;
     friend class RamDb;
 };
 
@@ -27,6 +27,7 @@
 #define GUARD_MIOPEN_ENV_HPP
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <optional>
@@ -41,6 +42,9 @@ namespace miopen::env {
 MIOPEN_EXPORT std::optional<std::string> getEnvironmentVariable(std::string_view name);
 MIOPEN_EXPORT void setEnvironmentVariable(std::string_view name, std::string_view value);
 MIOPEN_EXPORT void clearEnvironmentVariable(std::string_view name);
+/// Counts the changes made through the two functions above, so that values derived from the
+/// environment can tell when they are stale.
+MIOPEN_EXPORT std::size_t getUpdateCount();
 
 namespace detail {
 
@@ -35,6 +35,7 @@
 #include <miopen/perf_field.hpp>
 #include <miopen/ramdb.hpp>
 #include <miopen/readonlyramdb.hpp>
+#include <miopen/readonly_binary_db.hpp>
 
 #include <boost/optional.hpp>
 
@@ -51,7 +52,10 @@ struct NetworkConfig;
 template <class TDb>
 class FindDbRecord_t;
 
-#if MIOPEN_DEBUG_FIND_DB_CACHING
+#if MIOPEN_USE_BINARY_SYSDB
+using SystemFindDb = ReadonlyBinaryDb;
+using UserFindDb   = RamDb;
+#elif MIOPEN_DEBUG_FIND_DB_CACHING
 using SystemFindDb = ReadonlyRamDb;
 using UserFindDb   = RamDb;
 #else
@@ -144,6 +148,9 @@ public:
     auto end() { return content->As<FindDbData>().end(); }
     bool empty() const { return !content.is_initialized(); }
 
+    /// Path of the system find-db, also used to build the nearest problem index from.
+    static fs::path GetInstalledPath(Handle& handle, const std::string& path_suffix = "");
+
     template <class TProblemDescription>
     static std::vector<PerfField> TryLoad(Handle& handle,
                                           const TProblemDescription& problem,
@@ -179,7 +186,6 @@ private:
     bool in_sync    = false;
     bool dont_store = false; // E.g. to skip writing sub-optimal find-db records to disk.
 
-    static fs::path GetInstalledPath(Handle& handle, const std::string& path_suffix);
     static fs::path GetInstalledPathEmbed(Handle& handle, const std::string& path_suffix);
     static fs::path GetInstalledPathFile(Handle& handle, const std::string& path_suffix);
     static fs::path GetUserPath(Handle& handle, const std::string& path_suffix);
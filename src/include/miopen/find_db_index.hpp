@@ -0,0 +1,116 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_FIND_DB_INDEX_HPP_
+#define GUARD_MIOPEN_FIND_DB_INDEX_HPP_
+
+#include <miopen/config.hpp>
+#include <miopen/filesystem.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace miopen {
+
+/// Find-db key split into the part which has to match exactly and a vector of weighted,
+/// log-scaled sizes which is compared by distance.
+struct FindDbKeyFeatures
+{
+    /// Spatial dims, bias, layouts, data types, direction, group mode and cast types.
+    std::string category;
+    std::vector<float> values;
+};
+
+/// Returns nothing if the key is not a convolution find-db key.
+MIOPEN_INTERNALS_EXPORT std::optional<FindDbKeyFeatures> ParseFindDbKey(std::string_view key);
+
+/// Similarity index over the records of a find-db. Serves the immediate mode fallback with
+/// the solvers that were the fastest for the recorded problems closest to an unknown one.
+class MIOPEN_INTERNALS_EXPORT FindDbIndex
+{
+public:
+    struct Entry
+    {
+        std::uint32_t solver;
+        float time;
+        std::size_t workspace;
+    };
+
+    struct Record
+    {
+        std::string key;
+        std::vector<float> values;
+        /// Sorted by time.
+        std::vector<Entry> entries;
+    };
+
+    struct Neighbor
+    {
+        const Record* record;
+        float distance;
+    };
+
+    struct Suggestion
+    {
+        std::string solver;
+        /// Taken from the nearest neighbor which has the solver.
+        float time;
+        std::size_t workspace;
+        float score;
+    };
+
+    static const FindDbIndex& GetCached(const fs::path& path);
+
+    /// Parses the "key=contents" lines of a text find-db.
+    void Load(const fs::path& path);
+    /// Accepts both "Solver:time,workspace,algorithm" and the legacy
+    /// "algorithm:Solver,time,workspace,algorithm,<unused>" contents.
+    bool Add(std::string_view key, std::string_view contents);
+
+    const Record* Find(std::string_view key) const;
+    /// Records with the same key are skipped, as the caller looks for a substitute.
+    std::vector<Neighbor> Nearest(std::string_view key, std::size_t k) const;
+    /// Solvers of the k nearest records, closer and faster ones first.
+    std::vector<Suggestion> Suggest(std::string_view key, std::size_t k) const;
+
+    const std::string& GetSolverName(std::uint32_t solver) const { return solvers[solver]; }
+    std::size_t Size() const { return size; }
+
+private:
+    std::unordered_map<std::string, std::vector<Record>> categories;
+    std::vector<std::string> solvers;
+    std::unordered_map<std::string, std::uint32_t> solver_ids;
+    std::size_t size = 0;
+
+    std::uint32_t GetSolverId(std::string_view name);
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_FIND_DB_INDEX_HPP_
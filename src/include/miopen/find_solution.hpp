@@ -35,10 +35,14 @@
 #include <miopen/find_controls.hpp>
 #include <miopen/handle.hpp>
 #include <miopen/mlo_internal.hpp>
+#include <miopen/par_for.hpp>
 #include <miopen/search_options.hpp>
 #include <miopen/solver_id.hpp>
 #include <miopen/solver.hpp>
+#include <miopen/tuning_journal.hpp>
 
+#include <array>
+#include <functional>
 #include <limits>
 #include <type_traits>
 #include <optional>
@@ -76,6 +80,7 @@ auto FindSolutionImpl(rank<1>,
     {
         if(db().Remove(problem, s.SolverDbId()))
             MIOPEN_LOG_W("Perf Db: record removed: " << s.SolverDbId() << ", enforce: " << enforce);
+        RemoveTuningJournal(context, s.SolverDbId(), problem);
     }
     else
     {
@@ -133,6 +138,8 @@ auto FindSolutionImpl(rank<1>,
             {
                 auto c = s.Search(context, problem, invoke_ctx);
                 db().Update(problem, s.SolverDbId(), c);
+                // The search is not resumed past this point.
+                RemoveTuningJournal(context, s.SolverDbId(), problem);
                 return s.GetSolution(context, problem, c);
             }
             catch(const miopen::Exception& ex)
@@ -226,6 +233,32 @@ struct SolverContainer
         miopen::each_args([&](auto solver) { receiver(solver); }, Solvers{}...);
     }
 
+    // Evaluates IsApplicable() of the solvers that are not skipped on the shared thread pool,
+    // in the order of the container.
+    template <class Context, class Problem, class Skip>
+    std::array<bool, sizeof...(Solvers)>
+    EvaluateApplicability(const Context& ctx, const Problem& problem, Skip&& skip) const
+    {
+        auto checks = std::array<std::function<bool()>, sizeof...(Solvers)>{};
+        auto n      = std::size_t{0};
+        miopen::each_args(
+            [&](auto solver) {
+                if(!skip(solver))
+                    checks[n] = [&, solver]() { return solver.IsApplicable(ctx, problem); };
+                ++n;
+            },
+            Solvers{}...);
+
+        // The handle caches the allocation limit on first use without a lock, so it is filled
+        // before the solvers run on the workers.
+        ctx.GetStream().GetMaxMemoryAllocSize();
+        auto applicable = std::array<bool, sizeof...(Solvers)>{};
+        par_for(checks.size(), shared_pool{}, [&](auto i) {
+            applicable[i] = checks[i] && checks[i]();
+        });
+        return applicable;
+    }
+
     // Search for all applicable solutions among many solvers
     template <class Context, class Problem, class Db, class Solution = miopen::solver::ConvSolution>
     std::vector<Solution>
@@ -239,8 +272,24 @@ struct SolverContainer
         std::vector<Solution> ss;
         std::size_t count    = 0;
         const auto find_only = GetEnvFindOnlySolver();
+        const auto skip      = [&](const auto& solver) {
+            return (find_only && std::find(find_only->begin(),
+                                           find_only->end(),
+                                           Id{solver.SolverDbId()}) == find_only->end()) ||
+                   (ctx.use_dynamic_solutions_only && !solver.IsDynamic());
+        };
+
+        // A limited search stops at the first solvers found, which would make evaluating all of
+        // them in advance a waste.
+        auto applicable = std::optional<std::array<bool, sizeof...(Solvers)>>{};
+        if(limit == std::numeric_limits<std::size_t>::max() &&
+           env::enabled(MIOPEN_DEBUG_PARALLEL_APPLICABILITY))
+            applicable = EvaluateApplicability(ctx, problem, skip);
+        auto index = std::size_t{0};
+
         miopen::each_args(
             [&](auto solver) {
+                const auto i = index++;
                 if(count >= limit)
                     return;
                 if(find_only &&
@@ -254,7 +303,7 @@ struct SolverContainer
                 {
                     MIOPEN_LOG_I2(solver.SolverDbId() << ": Skipped (non-dynamic)");
                 }
-                else if(!solver.IsApplicable(ctx, problem))
+                else if(applicable ? !(*applicable)[i] : !solver.IsApplicable(ctx, problem))
                 {
                     MIOPEN_LOG_I2(solver.SolverDbId() << ": Not applicable");
                 }
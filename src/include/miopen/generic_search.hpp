@@ -28,6 +28,7 @@
 #define GUARD_MIOPEN_GENERIC_SEARCH_HPP_
 
 #include <miopen/binary_cache.hpp>
+#include <miopen/compile_scheduler.hpp>
 #include <miopen/config.hpp>
 #include <miopen/conv_solution.hpp>
 #include <miopen/env.hpp>
@@ -39,15 +40,23 @@
 #include <miopen/type_traits.hpp>
 #include <miopen/mt_queue.hpp>
 #include <miopen/generic_search_controls.hpp>
+#include <miopen/thread_pool.hpp>
+#include <miopen/search_strategy.hpp>
+#include <miopen/tuning_journal.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <utility>
 #include <vector>
 #include <cstdlib>
 #include <limits>
 #include <iterator>
 #include <chrono>
 #include <cassert>
+#include <map>
 #include <random>
+#include <sstream>
 
 namespace miopen {
 namespace solver {
@@ -63,6 +72,17 @@ struct MIOPEN_INTERNALS_EXPORT TuningIterationScopedLimiter
 private:
     std::optional<std::size_t> old_limit;
 };
+
+// Makes GenericSearch run its compile agents on the given pool instead of the shared one, which
+// a test may not be able to resize once it has started. Not MT-safe either.
+struct MIOPEN_INTERNALS_EXPORT TuningThreadPoolScopedOverride
+{
+    TuningThreadPoolScopedOverride(ThreadPool& pool);
+    ~TuningThreadPoolScopedOverride();
+
+private:
+    ThreadPool* old_pool;
+};
 } // namespace debug
 
 /// This STL-like container together with corresponding iterator provide access
@@ -317,47 +337,157 @@ GetAllSolutions(const Solver s, const Context& context_, const Problem& problem)
 std::size_t GetTuningIterationsMax();
 std::chrono::milliseconds GetTuningTimeMax(); // returns the max allowed time in milliseconds
 std::size_t GetTuningThreadsMax();
+ThreadPool& GetTuningThreadPool();
+
+search::Options GetSearchOptions(search::Strategy preferred);
+
+template <class Solver, class Context, class Problem>
+using GetSearchStrategy_t = decltype(std::declval<Solver>().GetSearchStrategy(
+    std::declval<const Context&>(), std::declval<const Problem&>()));
+
+/// Solvers may pick the strategy that suits their configs with
+///     search::Strategy GetSearchStrategy(const Context&, const Problem&) const;
+/// The others are searched in random order.
+template <class Solver, class Context, class Problem>
+search::Strategy GetSearchStrategy(const Solver& s, const Context& context, const Problem& problem)
+{
+    if constexpr(HasMember<GetSearchStrategy_t, Solver, Context, Problem>{})
+        return s.GetSearchStrategy(context, problem);
+    else
+        return search::Strategy::Random;
+}
+
+/// A config compiled ahead of its benchmark.
+struct CompiledConfig
+{
+    std::size_t candidate = 0;
+    ConvSolution solution;
+    /// The solution or one of its programs failed to build.
+    bool failed = false;
+    /// Programs counted against the budget of the CompileScheduler.
+    std::size_t reserved = 0;
+    /// Without the binary cache, the programs are handed over rather than built again.
+    std::vector<std::pair<CompileScheduler::ProgramKey, Program>> programs;
+};
 
+inline CompileScheduler::ProgramKey GetProgramKey(const KernelInfo& kernel)
+{
+    return {kernel.kernel_file.string(), kernel.comp_options};
+}
+
+/// Compiles the kernels of the configs the scheduler hands out until there are none left, the
+/// time budget is exhausted or the queue is closed. The last agent to stop closes the queue.
+/// Programs shared with configs compiled before are not compiled again, and configs that fail to
+/// build are passed on as failed.
 template <typename PerformanceConfig, typename Solver, typename Context, typename Problem>
-void CompileAgent(size_t thread_index,
-                  size_t total_threads,
+void CompileAgent(size_t agent_index,
+                  search::Scheduler& scheduler,
+                  CompileScheduler& compile_scheduler,
+                  std::atomic<std::size_t>& agents_running,
+                  std::chrono::steady_clock::time_point start_time,
                   const Solver& s,
                   const Context& context,
                   const Problem& problem,
-                  std::vector<PerformanceConfig>& data,
-                  ThreadSafeQueue<std::tuple<PerformanceConfig, ConvSolution, bool>>& comp_queue)
+                  const std::vector<PerformanceConfig>& data,
+                  ThreadSafeQueue<CompiledConfig>& comp_queue)
 {
-    const auto start_time =
-        std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now());
-    const auto data_size   = data.size();
+    // Also when compilation throws, so that the search does not wait for this agent.
+    struct LastClosesQueue
+    {
+        std::atomic<std::size_t>& running;
+        ThreadSafeQueue<CompiledConfig>& queue;
+        ~LastClosesQueue()
+        {
+            if(--running == 0)
+                queue.close();
+        }
+    } last_closes_queue{agents_running, comp_queue};
+
     const auto time_budget = GetTuningTimeMax();
     const auto& profile_h  = context.GetStream();
-    // start the counter
-    for(auto idx = thread_index; idx < data_size; idx += total_threads)
+    const auto hand_over   = IsCacheDisabled();
+    while(true)
     {
         // Check if we are out of time
-        const auto current_time = std::chrono::time_point_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now());
-        if(current_time - start_time > time_budget)
+        if(std::chrono::steady_clock::now() - start_time > time_budget)
+        {
+            MIOPEN_LOG_I2("Thread: " << agent_index << " Done, exhausted time budget");
+            return;
+        }
+        // Waits while the benchmarking is behind. The slot is taken before the config, so
+        // that the benchmarking never waits for a config held back by the budget.
+        if(!compile_scheduler.Reserve(1))
         {
-            MIOPEN_LOG_I2("Thread: " << thread_index << " Done, exhausted time budget");
-            auto tmp = std::make_tuple<PerformanceConfig, ConvSolution, bool>({}, {}, true);
-            comp_queue.push(std::move(tmp));
+            MIOPEN_LOG_I2("Thread: " << agent_index << " Done, search ended");
+            return;
+        }
+        const auto idx = scheduler.ClaimNext();
+        if(!idx)
+        {
+            compile_scheduler.Release(1);
             break;
         }
-        auto& current_config          = data.at(idx);
-        ConvSolution current_solution = s.GetSolution(context, problem, current_config);
-        for(const auto& kernel : current_solution.construction_params)
+
+        CompiledConfig item;
+        item.candidate = *idx;
+        item.reserved  = 1;
+        try
         {
-            if(profile_h.HasProgram(kernel.kernel_file, kernel.comp_options))
-                continue;
-            std::ignore = profile_h.LoadProgram(kernel.kernel_file, kernel.comp_options, "");
+            item.solution         = s.GetSolution(context, problem, data.at(*idx));
+            const auto n_programs = item.solution.construction_params.size();
+            if(n_programs > item.reserved)
+                compile_scheduler.Add(n_programs - item.reserved);
+            else
+                compile_scheduler.Release(item.reserved - n_programs);
+            item.reserved = n_programs;
+
+            for(const auto& kernel : item.solution.construction_params)
+            {
+                const auto key   = GetProgramKey(kernel);
+                const auto state = compile_scheduler.Acquire(key);
+                if(state == CompileScheduler::State::Failed)
+                {
+                    item.failed = true;
+                    break;
+                }
+                // Compiled before, or being compiled by another agent.
+                if(state != CompileScheduler::State::Missing)
+                    continue;
+                try
+                {
+                    auto program =
+                        profile_h.LoadProgram(kernel.kernel_file, kernel.comp_options, "");
+                    if(hand_over)
+                        item.programs.emplace_back(key, std::move(program));
+                    compile_scheduler.Complete(key, true);
+                }
+                catch(...)
+                {
+                    compile_scheduler.Complete(key, false);
+                    throw;
+                }
+            }
+        }
+        catch(const std::exception& ex)
+        {
+            MIOPEN_LOG_E("Thread: " << agent_index << " Failed to build #" << *idx << ": "
+                                    << ex.what());
+            item.failed = true;
+        }
+        catch(...)
+        {
+            MIOPEN_LOG_E("Thread: " << agent_index << " Failed to build #" << *idx);
+            item.failed = true;
+        }
+
+        scheduler.MarkReady(*idx);
+        if(!comp_queue.push(std::move(item)))
+        {
+            MIOPEN_LOG_I2("Thread: " << agent_index << " Done, search ended");
+            return;
         }
-        auto tup = std::make_tuple<PerformanceConfig, ConvSolution, bool>(
-            std::move(current_config), std::move(current_solution), false);
-        comp_queue.push(std::move(tup));
     }
-    MIOPEN_LOG_I2("Thread: " << thread_index << " Done, completed tuning");
+    MIOPEN_LOG_I2("Thread: " << agent_index << " Done, completed tuning");
 }
 
 template <class Solver, class Context, class Problem>
@@ -416,8 +546,43 @@ auto GenericSearch(const Solver s,
         }
     }
 
-    bool is_passed  = false; // left false only if all iterations failed.
-    float best_time = std::numeric_limits<float>::max();
+    const auto options = GetSearchOptions(GetSearchStrategy(s, context, problem));
+    std::vector<std::vector<double>> features;
+    if(options.strategy == search::Strategy::ModelGuided)
+    {
+        features.reserve(all_configs.size());
+        for(const auto& config : all_configs)
+        {
+            std::ostringstream ss;
+            ss << config;
+            features.push_back(search::ParseFeatures(ss.str()));
+        }
+    }
+    search::Scheduler scheduler{
+        search::MakeSearchStrategy(options, all_configs.size(), std::move(features))};
+    MIOPEN_LOG_I2("Search strategy: " << options.strategy << ", patience " << options.patience);
+
+    // The trials of an interrupted search are taken from the journal instead of measured again.
+    auto journal         = OpenTuningJournal(context, s.SolverDbId(), problem);
+    const auto serialize = [&](std::size_t candidate) {
+        std::ostringstream ss;
+        all_configs[candidate].Serialize(ss);
+        return ss.str();
+    };
+    std::vector<bool> measured(all_configs.size());
+    if(journal.Size() != 0)
+    {
+        for(std::size_t candidate = 0; candidate < all_configs.size(); ++candidate)
+        {
+            // Not worth compiling ahead, and compiled here if measured again.
+            if(journal.Find(serialize(candidate), 1) && scheduler.Claim(candidate))
+            {
+                measured[candidate] = true;
+                scheduler.MarkReady(candidate);
+            }
+        }
+    }
+
     size_t n_failed = 0;
     size_t n_best   = 0;
     HeartBeat<PerformanceConfig> heartbeat;
@@ -425,56 +590,151 @@ auto GenericSearch(const Solver s,
 
     const auto total_threads = GetTuningThreadsMax();
 
-    ThreadSafeQueue<std::tuple<PerformanceConfig, ConvSolution, bool>> solution_queue;
-    std::vector<std::thread> compile_agents;
-    compile_agents.reserve(total_threads);
-    for(auto idx = 0; idx < total_threads; ++idx)
+    // The agents are kept at most a few programs ahead of the benchmarks.
+    const auto programs_ahead = std::max<std::size_t>(4 * total_threads, 8);
+    CompileScheduler compile_scheduler{programs_ahead};
+    ThreadSafeQueue<CompiledConfig> solution_queue{programs_ahead};
+    std::atomic<std::size_t> agents_running{total_threads};
+    const auto start_time = std::chrono::steady_clock::now();
+
+    // The agents run on the shared thread pool and refer to the locals above, so they are
+    // stopped and waited for however this function is left. They wait for the benchmarks to take
+    // their configs, so they are spawned rather than run here when the pool has no workers.
+    struct CompileAgents
+    {
+        ThreadSafeQueue<CompiledConfig>& queue;
+        CompileScheduler& compile_scheduler;
+        std::vector<std::future<void>> futures;
+        ~CompileAgents()
+        {
+            queue.close();
+            compile_scheduler.Close();
+            for(auto& future : futures)
+            {
+                if(future.valid())
+                    future.wait();
+            }
+        }
+    } compile_agents{solution_queue, compile_scheduler, {}};
+    compile_agents.futures.reserve(total_threads);
+    for(auto idx = std::size_t{0}; idx < total_threads; ++idx)
     {
-        compile_agents.emplace_back(CompileAgent<PerformanceConfig, Solver, Context, Problem>,
-                                    idx,
-                                    total_threads,
-                                    std::cref(s),
-                                    std::cref(context),
-                                    std::cref(problem),
-                                    std::ref(all_configs),
-                                    std::ref(solution_queue));
+        compile_agents.futures.push_back(GetTuningThreadPool().Spawn([&, idx]() {
+            CompileAgent<PerformanceConfig>(idx,
+                                            scheduler,
+                                            compile_scheduler,
+                                            agents_running,
+                                            start_time,
+                                            s,
+                                            context,
+                                            problem,
+                                            all_configs,
+                                            solution_queue);
+        }));
     }
 
+    // Configs the agents compiled ahead of the one the strategy asked for.
+    std::map<std::size_t, CompiledConfig> compiled;
+    const auto release = [&](const CompiledConfig& config) {
+        // Banchmarked kernels will not be used anymore.
+        // Now we can delete Program objects that belong to OCL/HIP
+        // runtime and free the associated resources (memory, file handles...)
+        for(const auto& kernelInfo : config.solution.construction_params)
+            profile_h.ClearProgram(kernelInfo.kernel_file, kernelInfo.comp_options);
+        compile_scheduler.Release(config.reserved);
+    };
+    const auto take_config = [&](std::size_t candidate) {
+        // Candidates measured again, or not compiled ahead, are compiled here.
+        if(!measured[candidate] && !scheduler.Claim(candidate))
+        {
+            while(true)
+            {
+                const auto found = compiled.find(candidate);
+                if(found != compiled.end())
+                {
+                    auto config = std::move(found->second);
+                    compiled.erase(found);
+                    measured[candidate] = true;
+                    return config;
+                }
+                MIOPEN_LOG_I2("Waiting for item in queue");
+                auto kinder = solution_queue.pop();
+                if(!kinder)
+                    break; // The agent gave up on it.
+                const auto kinder_candidate = kinder->candidate;
+                compiled.emplace(kinder_candidate, std::move(*kinder));
+            }
+        }
+        measured[candidate] = true;
+        CompiledConfig config;
+        config.candidate = candidate;
+        config.solution  = s.GetSolution(context, problem, all_configs[candidate]);
+        return config;
+    };
+    const auto prepare_invoker = [&](const CompiledConfig& config) {
+        if(config.failed)
+            MIOPEN_THROW("Failed to build the kernels");
+        for(const auto& program : config.programs)
+        {
+            if(!profile_h.HasProgram(program.first.first, program.first.second))
+                profile_h.AddProgram(program.second, program.first.first, program.first.second);
+        }
+        // Rather than building them again.
+        for(const auto& kernel : config.solution.construction_params)
+        {
+            if(compile_scheduler.Wait(GetProgramKey(kernel)) == CompileScheduler::State::Failed)
+                MIOPEN_THROW("Failed to build " + kernel.kernel_file.string());
+        }
+        return profile_h.PrepareInvoker(*config.solution.invoker_factory,
+                                        config.solution.construction_params);
+    };
+
     if(!env::enabled(MIOPEN_DEBUG_COMPILE_ONLY))
     {
+        const auto time_budget = GetTuningTimeMax();
         size_t n_current       = 0;
-        auto threads_remaining = total_threads;
-        while(true)
+        size_t n_resumed       = 0;
+        // A candidate re-run right after its first trial keeps its invoker.
+        std::optional<CompiledConfig> current;
+        Invoker invoker;
+        while(const auto trial = scheduler.Next())
         {
-            if(n_current >= n_runs_total)
-                break;
-            MIOPEN_LOG_I2("Waiting for item in queue");
-            const auto kinder     = solution_queue.pop();
-            auto current_config   = std::get<0>(kinder);
-            auto current_solution = std::get<1>(kinder);
+            const auto trial_key =
+                journal.IsEnabled() ? serialize(trial->candidate) : std::string{};
+            if(const auto recorded = journal.Find(trial_key, trial->runs))
+            {
+                scheduler.Report(*trial, *recorded);
+                if(!*recorded)
+                    ++n_failed;
+                ++n_resumed;
+                ++n_current;
+                continue;
+            }
 
-            if(std::get<2>(kinder))
+            if(std::chrono::steady_clock::now() - start_time > time_budget)
             {
-                threads_remaining--;
-                if(threads_remaining == 0)
-                {
-                    break;
-                }
-                else
-                {
-                    continue;
-                }
+                MIOPEN_LOG_I2("Done, exhausted time budget");
+                break;
             }
+            const auto& current_config = all_configs[trial->candidate];
 
             float elapsed_time = 0.0f;
             int ret            = 0;
             MIOPEN_LOG_I2('#' << n_current << '/' << n_failed << '/' << n_runs_total << ' '
-                              << current_config);
-
-            Invoker invoker;
+                              << current_config << " x" << trial->runs);
 
             try
             {
+                if(!current || current->candidate != trial->candidate)
+                {
+                    if(current)
+                        release(*current);
+                    current.reset();
+                    current = take_config(trial->candidate);
+                    invoker = prepare_invoker(*current);
+                }
+
+                const auto& current_solution = current->solution;
                 if(default_solution.workspace_sz != current_solution.workspace_sz)
                 {
                     ret = -2;
@@ -483,11 +743,15 @@ auto GenericSearch(const Solver s,
                                      << default_solution.workspace_sz
                                      << " != " << current_solution.workspace_sz);
                 }
-
-                invoker = profile_h.PrepareInvoker(*current_solution.invoker_factory,
-                                                   current_solution.construction_params);
-                invoker(profile_h, invoke_ctx);
-                elapsed_time = profile_h.GetKernelTime();
+                else
+                {
+                    for(std::size_t i = 0; i < trial->runs; ++i)
+                    {
+                        invoker(profile_h, invoke_ctx);
+                        elapsed_time += profile_h.GetKernelTime();
+                    }
+                    elapsed_time /= static_cast<float>(trial->runs);
+                }
             }
             catch(const std::exception& e)
             {
@@ -500,63 +764,24 @@ auto GenericSearch(const Solver s,
                 ret = 1;
             }
 
+            const auto result      = ret == 0 ? std::make_optional(elapsed_time) : std::nullopt;
+            const auto best_before = scheduler.BestTime();
+            scheduler.Report(*trial, result);
+            journal.Record(trial_key, trial->runs, result);
+            const auto best_time = scheduler.BestTime();
+
             MIOPEN_LOG_T("##"
                          << "(n_current, n_failed, n_runs_total):  " << n_current << '/' << n_failed
                          << '/' << n_runs_total << " elapsed_time: " << elapsed_time
                          << ", best_time: " << best_time << ", " << current_config);
 
-            if(ret == 0)
+            if(best_time < best_before && scheduler.Best() == trial->candidate)
             {
-                // Smooth the jitter of measurements:
-                // If the 1st probe is NOT too bad (measured time <= 1.05 * best known time),
-                // then re-run it 4 times more and compute average time,
-                // and decide using average of all 5 attempts vs. the best.
-                if(elapsed_time / best_time < 1.05f)
-                {
-                    MIOPEN_LOG_I2("Finding average for: " << elapsed_time << " / " << best_time
-                                                          << " = " << (elapsed_time / best_time));
-
-                    try
-                    {
-                        for(int i = 0; i < 4; ++i)
-                        {
-                            invoker(profile_h, invoke_ctx);
-                            elapsed_time += profile_h.GetKernelTime();
-                        }
-                    }
-                    catch(...)
-                    {
-                        ret = 1;
-                    }
-
-                    if(ret == 0)
-                    {
-                        is_passed = true;
-                        elapsed_time /= 5;
-                        if(elapsed_time < best_time)
-                        {
-                            MIOPEN_LOG_I('#' << n_current << '/' << n_failed << '/' << n_runs_total
-                                             << ' ' << elapsed_time << " < " << best_time << ' '
-                                             << current_config);
-                            best_config = current_config;
-                            best_time   = elapsed_time;
-                            n_best      = n_current;
-                        }
-                        else
-                        {
-                            MIOPEN_LOG_I2("Average is not better: " << elapsed_time
-                                                                    << " >= " << best_time);
-                        }
-                    }
-                }
+                MIOPEN_LOG_I('#' << n_current << '/' << n_failed << '/' << n_runs_total << ' '
+                                 << best_time << " < " << best_before << ' ' << current_config);
+                n_best = n_current;
             }
 
-            // Banchmarked kernels will not be used anymore.
-            // Now we can delete Program objects that belong to OCL/HIP
-            // runtime and free the associated resources (memory, file handles...)
-            for(const auto& kernelInfo : current_solution.construction_params)
-                profile_h.ClearProgram(kernelInfo.kernel_file, kernelInfo.comp_options);
-
             if(ret != 0)
             {
                 MIOPEN_LOG_E('#' << n_current << " (" << n_runs_total << ") "
@@ -568,25 +793,49 @@ auto GenericSearch(const Solver s,
                               n_current,
                               best_time,
                               n_failed,
-                              n_runs_total,
+                              std::max(n_runs_total, n_current),
                               current_config);
             ++n_current;
         }
+        if(current)
+            release(*current);
+        if(n_resumed != 0)
+            MIOPEN_LOG_I(n_resumed << " trials taken from the journal of an earlier search");
     }
     else
     {
+        // Let the agents compile everything.
+        while(const auto kinder = solution_queue.pop())
+            compile_scheduler.Release(kinder->reserved);
         MIOPEN_THROW(miopenStatusGpuOperationsSkipped,
                      "Running kernels on GPU is disabled. Search skipped");
     }
 
-    for(auto& agent : compile_agents)
-        agent.join();
+    // Rethrows what failed an agent.
+    solution_queue.close();
+    compile_scheduler.Close();
+    for(auto& future : compile_agents.futures)
+        future.get();
+    for(const auto& leftover : compiled)
+        release(leftover.second);
+    while(const auto leftover = solution_queue.try_pop())
+        release(*leftover);
+
+    const auto best      = scheduler.Best();
+    const auto best_time = scheduler.BestTime();
+    const auto is_passed = best.has_value(); // false only if all iterations failed.
+    if(is_passed)
+        best_config = all_configs[*best];
 
     MIOPEN_LOG_W("Done: " << n_runs_total << '/' << n_failed << '/' << n_runs_total << ", best #"
                           << n_best << ' ' << best_time << ' ' << best_config);
 
     if(!is_passed)
+    {
+        // Nothing to resume.
+        journal.Remove();
         MIOPEN_THROW("Search failed");
+    }
     // Run once with the default config and show score.
 
     const auto& invoker = profile_h.PrepareInvoker(*default_solution.invoker_factory,
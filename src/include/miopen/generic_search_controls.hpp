@@ -43,3 +43,7 @@ MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_COMPILE_PARALLEL_LEVEL,
                               std::thread::hardware_concurrency() / 2)
 #endif
 MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_COMPILE_ONLY)
+/// Overrides the search strategy of the solvers: "random", "halving" or "model".
+MIOPEN_DECLARE_ENV_VAR_STR(MIOPEN_DEBUG_TUNING_STRATEGY)
+/// Ends the search after this many configs in a row without improvement, 0 never.
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_DEBUG_TUNING_PATIENCE)
@@ -276,6 +276,21 @@ public:
     Tensor* getW() const noexcept { return mW; }
     double getAlpha() const noexcept { return mAlpha; }
     double getBeta() const noexcept { return mBeta; }
+
+    virtual size_t hashAttributes() const override
+    {
+        return AttributeHash{}
+            .add(mConvolution->getCompType())
+            .add(mConvolution->getMode())
+            .add(mConvolution->getSpatialDims())
+            .add(mConvolution->getDilations())
+            .add(mConvolution->getFilterStrides())
+            .add(mConvolution->getPrePaddings())
+            .add(mConvolution->getPostPaddings())
+            .add(mAlpha)
+            .add(mBeta)
+            .get();
+    }
 };
 
 class OperationConvolutionForward : public OperationConvolution
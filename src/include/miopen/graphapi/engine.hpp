@@ -29,17 +29,25 @@
 #include <miopen/graphapi/graphapi.hpp>
 #include <miopen/solution.hpp>
 
+#include <optional>
+
 namespace miopen {
 
 namespace graphapi {
 
+class OpGraph;
+
 class Engine
 {
 private:
     Solution mSolution;
-    int64_t mGlobalIndex = -1;
-    int32_t mSmCount     = 0;
+    const OpGraph* mOpGraph = nullptr;
+    int64_t mGlobalIndex    = -1;
+    int32_t mSmCount        = 0;
+    std::optional<miopenBackendHeurMode_t> mHeurMode;
     friend class EngineBuilder;
+    friend class EngineHeurBuilder;
+    friend class ExecutionPlanBuilder;
 
 public:
     Engine()              = default;
@@ -54,11 +62,18 @@ public:
     const Solution& getSolution() const noexcept { return mSolution; }
     Solution& getSolution() noexcept { return mSolution; }
 
+    /// Set when the engine is taken from a graph by EngineBuilder or EngineHeurBuilder
+    const OpGraph* getOpGraph() const noexcept { return mOpGraph; }
     int64_t getGlobalIndex() const noexcept { return mGlobalIndex; }
     int32_t getSmCount() const noexcept { return mSmCount; }
-};
+    /// Mode of the heuristics that ranked the engine, if it was taken by EngineHeurBuilder
+    std::optional<miopenBackendHeurMode_t> getHeurMode() const noexcept { return mHeurMode; }
 
-class OpGraph;
+    /// Identifies the engine among those of its graph: the operation graph and the problem of
+    /// the solution are not serialized. Deserialized engines have no graph.
+    friend void to_json(nlohmann::json& json, const Engine& engine);
+    friend void from_json(const nlohmann::json& json, Engine& engine);
+};
 
 class MIOPEN_INTERNALS_EXPORT EngineBuilder
 {
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include <miopen/graphapi/engine.hpp>
+#include <miopen/graphapi/opgraph.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace miopen {
+
+struct Handle;
+
+namespace graphapi {
+
+/// What running an operation graph with an engine costs
+struct EngineCost
+{
+    /// Arithmetic of all the nodes
+    double mFlops = 0;
+    /// Bytes read and written by all the steps, after pointwise fusion
+    double mBytes = 0;
+    /// Workspace of the schedule plus the workspace of the solution of the engine
+    size_t mWorkspaceSize = 0;
+    /// Estimated time, in ms. Recorded times replace the estimates of the nodes they cover.
+    double mTime = 0;
+    size_t mRecordedNodes = 0;
+};
+
+/// Timings recorded for the sub-problems of operation graphs, e.g. for the convolution of a
+/// convolution + bias + activation graph
+class MIOPEN_INTERNALS_EXPORT TimingRecords
+{
+public:
+    virtual ~TimingRecords() = default;
+
+    /// Time of node when run by the solution of engine, in ms, if it was ever measured
+    virtual std::optional<double> find(const OpNode& node, const Engine& engine) const = 0;
+};
+
+/// Timings of the convolutions of a graph recorded by the find-db of a handle
+class MIOPEN_INTERNALS_EXPORT FindDbTimingRecords : public TimingRecords
+{
+private:
+    Handle* mHandle;
+
+public:
+    explicit FindDbTimingRecords(Handle& handle) : mHandle(&handle) {}
+
+    std::optional<double> find(const OpNode& node, const Engine& engine) const override;
+};
+
+/// Roofline estimate of the time of every step of the schedule of the graph on a device with
+/// smCount compute units (or a typical number of them if smCount is 0). The solver of the
+/// engine selects the algorithm, and so the arithmetic, of the convolutions. Deterministic:
+/// equal graphs, engines and records always get equal costs.
+MIOPEN_INTERNALS_EXPORT EngineCost estimateCost(const OpGraph& graph,
+                                                const Engine& engine,
+                                                int32_t smCount,
+                                                const TimingRecords* records = nullptr);
+
+/// Indices of engines, best first. MIOPEN_HEUR_MODE_INSTANT and MIOPEN_HEUR_MODE_A rank by the
+/// static cost model, MIOPEN_HEUR_MODE_B by the records too, MIOPEN_HEUR_MODE_FALLBACK keeps
+/// the order of engines. Ties go to the smaller workspace, then to the earlier engine. Graphs
+/// only carry the host reference engine for now, so a ranking of a graph never reorders
+/// anything until more candidate engines are enumerated for it.
+MIOPEN_INTERNALS_EXPORT std::vector<size_t> rankEngines(const OpGraph& graph,
+                                                        const std::vector<Engine>& engines,
+                                                        miopenBackendHeurMode_t mode,
+                                                        int32_t smCount,
+                                                        const TimingRecords* records = nullptr);
+
+/// Rankings of the engines of operation graphs, shared by all the graphs with the same shaped
+/// form and number of engines. Rankings that depend on user supplied records or on the find-db
+/// of a handle are not cached.
+class MIOPEN_INTERNALS_EXPORT EngineRankingCache
+{
+private:
+    /// {shaped form, mode, SM count, number of engines}
+    using Key = std::tuple<OpGraph::ShapedForm, miopenBackendHeurMode_t, int32_t, size_t>;
+
+    mutable std::mutex mMutex;
+    std::map<Key, std::vector<size_t>> mRankings;
+
+public:
+    /// The cache EngineHeurBuilder uses
+    static EngineRankingCache& instance();
+
+    std::optional<std::vector<size_t>>
+    find(const OpGraph& graph, miopenBackendHeurMode_t mode, int32_t smCount) const;
+    void insert(const OpGraph& graph,
+                miopenBackendHeurMode_t mode,
+                int32_t smCount,
+                std::vector<size_t> ranking);
+    size_t size() const;
+    void clear();
+};
+
+/// How well a ranking agrees with measured times of the engines it ranks
+struct RankingScore
+{
+    /// Share of the pairs of engines the ranking orders like the measurements, 1 is perfect
+    double mConcordance = 1;
+    /// Measured time of the first ranked engine over the best measured time, 1 is perfect
+    double mRegret = 1;
+};
+
+MIOPEN_INTERNALS_EXPORT RankingScore scoreRanking(const std::vector<size_t>& ranking,
+                                                  const std::vector<double>& times);
+
+} // namespace graphapi
+
+} // namespace miopen
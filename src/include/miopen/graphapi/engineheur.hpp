@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <miopen/graphapi/engine_cost.hpp>
 #include <miopen/graphapi/enginecfg.hpp>
 #include <miopen/graphapi/graphapi.hpp>
 #include <miopen/graphapi/opgraph.hpp>
@@ -61,16 +62,27 @@ public:
     int32_t getSmCount() const noexcept { return mSmCount; }
 };
 
+/// Ranks the engines of an operation graph, see rankEngines() for the modes. Rankings are
+/// cached per shaped form of the graph for the life of the process. MIOPEN_HEUR_MODE_B reads
+/// the find-db of the handle of the graph, unless other records are set, and is not cached.
+/// Without records, the engine of a plan in ExecutionPlanCache for the graph and mode comes
+/// first.
 class MIOPEN_INTERNALS_EXPORT EngineHeurBuilder
 {
 private:
     EngineHeur mEngineHeur;
-    bool mModeSet = false;
+    const TimingRecords* mTimingRecords = nullptr;
+    bool mModeSet                       = false;
+
+    std::vector<size_t> rank() const;
 
 public:
     EngineHeurBuilder& setOpGraph(OpGraph* opGraph);
     EngineHeurBuilder& setMode(miopenBackendHeurMode_t mode);
     EngineHeurBuilder& setSmCount(int32_t smCount);
+    /// Records for MIOPEN_HEUR_MODE_B to use instead of the find-db. The rankings they lead to
+    /// are not cached.
+    EngineHeurBuilder& setTimingRecords(const TimingRecords* timingRecords);
     EngineHeur build();
 };
 
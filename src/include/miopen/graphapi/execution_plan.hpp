@@ -27,16 +27,62 @@
 #pragma once
 
 #include <miopen/graphapi/enginecfg.hpp>
+#include <miopen/graphapi/opgraph.hpp>
 #include <miopen/graphapi/variant_pack.hpp>
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace miopen {
 
 namespace graphapi {
 
+/// Device independent part of an execution plan: the order in which the nodes of an operation
+/// graph run and where its virtual tensors live in the workspace. Virtual tensors whose
+/// lifetimes do not overlap share the same workspace bytes. Connected pointwise operations may
+/// be fused into one step, their intermediate tensors then take no workspace at all.
+class MIOPEN_INTERNALS_EXPORT ExecutionSchedule
+{
+public:
+    static constexpr size_t alignment = 256;
+
+    struct Allocation
+    {
+        const Tensor* mTensor = nullptr;
+        size_t mOffset        = 0;
+        size_t mSize          = 0;
+        /// Steps that produce and last consume the tensor
+        size_t mFirstStep = 0;
+        size_t mLastStep  = 0;
+    };
+
+private:
+    std::vector<const OpNode*> mSteps;
+    /// Owns the fused nodes among mSteps
+    std::vector<std::shared_ptr<const OpNode>> mFusedNodes;
+    std::vector<Allocation> mAllocations;
+    size_t mWorkspaceSize = 0;
+
+public:
+    ExecutionSchedule() = default;
+    /// Throws if a virtual tensor is not produced by any node of the graph
+    explicit ExecutionSchedule(const OpGraph& graph, bool fusePointwise = true);
+
+    const std::vector<const OpNode*>& getSteps() const noexcept { return mSteps; }
+    const std::vector<Allocation>& getAllocations() const noexcept { return mAllocations; }
+    size_t getWorkspaceSize() const noexcept { return mWorkspaceSize; }
+
+    /// Maps every tensor of the graph to its memory: the pointers of the variant pack for the
+    /// real tensors and the workspace of the variant pack for the virtual ones.
+    std::unordered_map<const Tensor*, void*> bind(const VariantPack& variantPack) const;
+};
+
+/// Bytes spanned by the elements of a tensor, from the first element to the last
+MIOPEN_INTERNALS_EXPORT size_t getTensorFootprint(const Tensor& tensor);
+
 class MIOPEN_INTERNALS_EXPORT ExecutionPlan
 {
 private:
@@ -48,6 +94,11 @@ private:
     miopenHandle_t mHandle = nullptr;
     std::vector<int64_t> mIntermediateIds;
     int64_t mWorkspaceSize = 0;
+    ExecutionSchedule mSchedule;
+    /// Shaped form of the operation graph the plan was built for
+    OpGraph::ShapedForm mGraphForm;
+    /// Name of the device of the handle the plan was built with
+    std::string mDevice;
 
     friend class ExecutionPlanBuilder;
 
@@ -63,16 +114,33 @@ public:
     EngineCfg& getEngineCfg() noexcept { return mEngineCfg; }
     const std::vector<int64_t>& getIntermediateIds() const noexcept { return mIntermediateIds; }
     int64_t getWorkspaceSize() const { return mWorkspaceSize; }
+    const ExecutionSchedule& getSchedule() const noexcept { return mSchedule; }
+    const OpGraph::ShapedForm& getGraphForm() const noexcept { return mGraphForm; }
+    size_t getGraphHash() const noexcept { return mGraphForm.mForm.mHash; }
+    size_t getShapeHash() const noexcept { return mGraphForm.mHash; }
+    const std::string& getDevice() const noexcept { return mDevice; }
     std::string getJsonRepresentation() const;
 
+    /// Runs the steps of the schedule on the host. The tensors of the variant pack, and its
+    /// workspace, must be in host memory.
     void execute(const VariantPack& variantPack);
+
+    /// Stores the choice of engine, the shaped form of the graph and the device, not the graph
+    /// itself: a deserialized plan runs once ExecutionPlanBuilder::setOpGraph() binds it to a
+    /// graph. Invalid JSON throws miopenStatusInvalidValue.
+    friend void to_json(nlohmann::json& json, const ExecutionPlan& plan);
+    friend void from_json(const nlohmann::json& json, ExecutionPlan& plan);
 };
 
 class MIOPEN_INTERNALS_EXPORT ExecutionPlanBuilder
 {
 private:
     ExecutionPlan mExecutionPlan;
-    bool mEngineCfgSet = false;
+    const OpGraph* mOpGraph = nullptr;
+    bool mEngineCfgSet      = false;
+
+    void bindOpGraph();
+    void initSchedule();
 
 public:
     ExecutionPlanBuilder& setHandle(miopenHandle_t handle) &;
@@ -81,6 +149,12 @@ public:
     ExecutionPlanBuilder& setIntermediateIds(const std::vector<int64_t>& ids) &;
     ExecutionPlanBuilder& setIntermediateIds(std::vector<int64_t>&& ids) &;
     ExecutionPlanBuilder& setJsonRepresentation(const std::string_view& s) &;
+    /// Starts from a built or deserialized plan, keeps the handle
+    ExecutionPlanBuilder& setExecutionPlan(const ExecutionPlan& plan) &;
+    /// Rebuilds the engine of the plan on another graph with the same canonical form and
+    /// shapes, for instance the plan of a previous job read by setJsonRepresentation(). The
+    /// handle must be of the device the plan was built for.
+    ExecutionPlanBuilder& setOpGraph(const OpGraph* opGraph) &;
 
     ExecutionPlanBuilder&& setHandle(miopenHandle_t handle) &&
     {
@@ -106,6 +180,14 @@ public:
     {
         return std::move(setJsonRepresentation(s));
     }
+    ExecutionPlanBuilder&& setExecutionPlan(const ExecutionPlan& plan) &&
+    {
+        return std::move(setExecutionPlan(plan));
+    }
+    ExecutionPlanBuilder&& setOpGraph(const OpGraph* opGraph) &&
+    {
+        return std::move(setOpGraph(opGraph));
+    }
 
     ExecutionPlan build() &;
     ExecutionPlan build() &&;
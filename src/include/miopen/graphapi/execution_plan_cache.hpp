@@ -0,0 +1,118 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include <miopen/filesystem.hpp>
+#include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/opgraph.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace miopen {
+
+namespace graphapi {
+
+/// Execution plans keyed by the shaped forms of their operation graphs, the mode of the
+/// heuristics that chose their engines and the device, so that graphs rebuilt with the same
+/// structure, attributes and shapes, e.g. at every iteration of a job with a varying batch
+/// size, skip engine ranking and selection. A plan found for a graph is rebuilt on that graph.
+/// The plans do not refer to the graphs they were built for and can be saved at the end of a
+/// job and loaded by the next one. Beyond its capacity the cache drops the plans used least
+/// recently.
+class MIOPEN_INTERNALS_EXPORT ExecutionPlanCache
+{
+private:
+    /// {shaped form of the graph, heuristics mode, device}
+    using Key = std::tuple<OpGraph::ShapedForm, miopenBackendHeurMode_t, std::string>;
+
+    struct Entry
+    {
+        /// Deserialized, without a graph
+        ExecutionPlan mPlan;
+        uint64_t mLastUse = 0;
+    };
+
+    mutable std::mutex mMutex;
+    mutable std::map<Key, Entry> mPlans;
+    mutable uint64_t mClock = 0;
+    size_t mCapacity        = defaultCapacity;
+
+    static Key makeKey(const OpGraph& graph, miopenHandle_t handle, miopenBackendHeurMode_t mode);
+    /// Throws if the plan was never built on a graph or its engine was not chosen by heuristics
+    static Key makeKey(const ExecutionPlan& plan);
+    void add(Key key, ExecutionPlan&& plan);
+    void evict();
+
+public:
+    static constexpr size_t defaultCapacity = 1024;
+
+    /// The cache BackendExecutionPlanDescriptor fills and EngineHeurBuilder reads
+    static ExecutionPlanCache& instance();
+
+    /// A plan built on the graph, if the cache has one for its shaped form, the mode and the
+    /// device of the handle
+    std::optional<ExecutionPlan>
+    find(const OpGraph& graph,
+         miopenHandle_t handle,
+         miopenBackendHeurMode_t mode = MIOPEN_HEUR_MODE_INSTANT) const;
+    /// The global index of the engine of the plan find() would return
+    std::optional<int64_t> findEngineIndex(const OpGraph& graph,
+                                           miopenHandle_t handle,
+                                           miopenBackendHeurMode_t mode) const;
+    /// Ranks the engines of the graph by the mode and builds a plan with the best one if the
+    /// cache has no plan for the graph
+    ExecutionPlan findOrBuild(OpGraph& graph,
+                              miopenHandle_t handle,
+                              miopenBackendHeurMode_t mode = MIOPEN_HEUR_MODE_INSTANT);
+    /// Replaces the plan stored for the same key. The plan may be restored from JSON. Throws if
+    /// the plan was never built on a graph or its engine was not chosen by heuristics.
+    void insert(const ExecutionPlan& plan);
+    size_t size() const;
+    void clear();
+    size_t getCapacity() const;
+    /// Drops the plans used least recently if the cache holds more than capacity
+    void setCapacity(size_t capacity);
+
+    /// JSON array of the plans
+    std::string serialize() const;
+    /// Adds the plans of a string written by serialize(), they replace the plans with the same
+    /// key. Adds nothing if any plan is invalid, invalid JSON throws miopenStatusInvalidValue.
+    void deserialize(const std::string_view& s);
+    void save(const fs::path& path) const;
+    void load(const fs::path& path);
+};
+
+} // namespace graphapi
+
+} // namespace miopen
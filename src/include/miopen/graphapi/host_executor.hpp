@@ -0,0 +1,50 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include <miopen/graphapi/opgraph.hpp>
+
+#include <unordered_map>
+
+namespace miopen {
+
+namespace graphapi {
+
+/// Runs one node of an operation graph on the host. Every input and output tensor of the node
+/// must be mapped to host memory laid out as described by its dimensions and strides.
+/// This is the reference backend of ExecutionPlan: slow, but available on every machine and
+/// precise enough (it computes in double) to validate the device backends against.
+MIOPEN_INTERNALS_EXPORT void
+executeOnHost(const OpNode& node, const std::unordered_map<const Tensor*, void*>& buffers);
+
+/// False for device memory, which the host executor cannot read. Host memory the runtime
+/// does not know of, pinned and managed memory can be used.
+MIOPEN_INTERNALS_EXPORT bool isHostAccessible(const void* ptr);
+
+} // namespace graphapi
+
+} // namespace miopen
@@ -133,6 +133,16 @@ public:
         static const std::string name = "OP_MATMUL";
         return name;
     }
+    virtual size_t hashAttributes() const override
+    {
+        return AttributeHash{}
+            .add(mMatmul->getComputeType())
+            .add(mBatchCount)
+            .add(mGemmMOverride != nullptr)
+            .add(mGemmNOverride != nullptr)
+            .add(mGemmKOverride != nullptr)
+            .get();
+    }
 
 private:
     friend class OperationMatmulBuilder;
@@ -29,8 +29,11 @@
 #include <miopen/graphapi/tensor.hpp>
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
@@ -79,8 +82,41 @@ bool noRepetitions(const R& r)
         return true;
     }
 }
+
+inline size_t combineHash(size_t seed, size_t value) noexcept
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+}
 } // end namespace internal
 
+/// Folds attribute values into a hash, see OpNode::hashAttributes()
+class AttributeHash
+{
+private:
+    size_t mSeed = 0;
+
+public:
+    template <typename T>
+    AttributeHash& add(const T& value)
+    {
+        mSeed = internal::combineHash(mSeed, std::hash<T>{}(value));
+        return *this;
+    }
+
+    template <typename T>
+    AttributeHash& add(const std::vector<T>& values)
+    {
+        add(values.size());
+        for(const auto& value : values)
+        {
+            add(value);
+        }
+        return *this;
+    }
+
+    size_t get() const noexcept { return mSeed; }
+};
+
 class OpGraphBuilder;
 class OpGraph;
 
@@ -92,6 +128,15 @@ public:
 
     virtual const std::string& signName() const = 0;
 
+    /// Hash of the attributes which, besides signName() and the tensors, decide what the
+    /// operation computes, such as the parameters of an activation or the padding of a
+    /// convolution. Nodes are only matched by the canonical form if these are equal.
+    virtual size_t hashAttributes() const;
+
+    virtual std::vector<Tensor*> getInTensors() const = 0;
+
+    virtual std::vector<Tensor*> getOutTensors() const = 0;
+
 private:
     std::vector<Edge> mInEdges;
     std::vector<Edge> mOutEdges;
@@ -100,10 +145,6 @@ private:
     friend class OpGraph;
 
 protected:
-    virtual std::vector<Tensor*> getInTensors() const = 0;
-
-    virtual std::vector<Tensor*> getOutTensors() const = 0;
-
     const auto& getInEdges() const { return mInEdges; }
 
     const auto& getOutEdges() const { return mOutEdges; }
@@ -208,17 +249,68 @@ using VecOfPaths = std::vector<Path>;
 
 class MIOPEN_INTERNALS_EXPORT OpGraph
 {
+public:
+    /// Weisfeiler-Lehman style labels of the nodes and edges (including those of the internal
+    /// source and sink), computed by OpGraphBuilder::build(). A label depends on the node
+    /// kinds and attributes (OpNode::hashAttributes()) and on the data type and virtuality of
+    /// the tensors around the node, but not on the order of the nodes or the tensor ids, so
+    /// isomorphic graphs have equal forms.
+    struct CanonicalForm
+    {
+        std::vector<size_t> mNodes{};
+        /// {src node, tensor, dst node} labels
+        std::vector<std::array<size_t, 3>> mEdges{};
+        size_t mHash = 0;
+
+        bool operator==(const CanonicalForm& other) const
+        {
+            return mHash == other.mHash && mNodes == other.mNodes && mEdges == other.mEdges;
+        }
+        bool operator!=(const CanonicalForm& other) const { return !(*this == other); }
+    };
+
+    /// The canonical form together with the edges labeled by the layouts of their tensors,
+    /// what getShapeHash() hashes. Caches of plans and rankings use it as their key, so that
+    /// graphs whose hashes collide are not taken for one another.
+    struct ShapedForm
+    {
+        CanonicalForm mForm{};
+        /// {src node, tensor with its dimensions and strides, dst node} labels
+        std::vector<std::array<size_t, 3>> mEdges{};
+        size_t mHash = 0;
+
+        bool operator==(const ShapedForm& other) const
+        {
+            return mHash == other.mHash && mForm == other.mForm && mEdges == other.mEdges;
+        }
+        bool operator!=(const ShapedForm& other) const { return !(*this == other); }
+        /// Orders by the hashes first, so that the labels are rarely compared
+        bool operator<(const ShapedForm& other) const
+        {
+            return std::tie(mHash, mForm.mHash, mForm.mNodes, mForm.mEdges, mEdges) <
+                   std::tie(other.mHash,
+                            other.mForm.mHash,
+                            other.mForm.mNodes,
+                            other.mForm.mEdges,
+                            other.mEdges);
+        }
+    };
+
+private:
     // NOTE: mSrcNode and mSinkNode need to reside on the heap because the graph may move
     // to a new memory location after building, while the nodes maintain address
     // of SourceOpNode and SinkOpNode in their in and out edge lists
     std::unique_ptr<SourceOpNode> mSrcNode = std::make_unique<SourceOpNode>();
     std::unique_ptr<SinkOpNode> mSinkNode  = std::make_unique<SinkOpNode>();
     std::vector<OpNode*> mNodes{};
+    std::vector<OpNode*> mTopologicalOrder{};
 
     // Descriptor related members
     miopenHandle_t mHandle = nullptr;
     std::vector<Engine> mEngines;
 
+    ShapedForm mShapedForm{};
+
 public:
     OpGraph(const OpGraph&) = delete;
     OpGraph& operator=(const OpGraph&) = delete;
@@ -273,8 +365,20 @@ public:
         return ret;
     }
 
+    // NOTE: enumerates every path, so it is exponential in the width of the graph. Use
+    // getCanonicalForm() to compare graphs.
     VecOfPaths getAllPaths() const;
 
+    /// mNodes ordered so that every node comes after the producers of its inputs
+    const std::vector<OpNode*>& getTopologicalOrder() const noexcept { return mTopologicalOrder; }
+
+    const CanonicalForm& getCanonicalForm() const noexcept { return mShapedForm.mForm; }
+    size_t getCanonicalHash() const noexcept { return mShapedForm.mForm.mHash; }
+    const ShapedForm& getShapedForm() const noexcept { return mShapedForm; }
+    /// Like getCanonicalHash(), but also depends on the dimensions and strides of the tensors:
+    /// isomorphic graphs over equally laid out tensors have equal shape hashes.
+    size_t getShapeHash() const noexcept { return mShapedForm.mHash; }
+
     // NOTE: for testing only. May remove in the future
     bool hasEdgeFromSource(OpNode* dst, Tensor* tens_ptr) const
     {
@@ -295,6 +399,10 @@ private:
 
     void initNodes(std::vector<OpNode*>&& nodes) { mNodes = std::move(nodes); }
 
+    // Throws if the graph has a cycle
+    void initTopologicalOrder();
+    void initCanonicalForm();
+
     void addEdge(OpNode* src, Tensor* tens_ptr, OpNode* dst)
     {
         assert(src);
@@ -305,7 +413,11 @@ private:
 
     void addEdgeFromSrc(OpNode* dst, Tensor* tens_ptr)
     {
-        mSrcNode->addOutTensor(tens_ptr);
+        // a graph input may feed several nodes, e.g. a residual connection
+        if(!mSrcNode->hasOutTensor(tens_ptr))
+        {
+            mSrcNode->addOutTensor(tens_ptr);
+        }
         addEdge(mSrcNode.get(), tens_ptr, dst);
     }
 
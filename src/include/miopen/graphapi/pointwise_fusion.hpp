@@ -0,0 +1,108 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include <miopen/graphapi/pointwise.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace miopen {
+
+namespace graphapi {
+
+/// Several pointwise operations evaluated in one pass over their output elements. Every
+/// external input is read once and every output written once, the tensors between the
+/// operations never reach memory.
+///
+/// The operations are compiled into a register program: registers [0, inputs) hold the
+/// external inputs, register inputs + k holds the result of instruction k.
+class MIOPEN_INTERNALS_EXPORT OperationFusedPointwise : public OpNode
+{
+public:
+    struct Instruction
+    {
+        /// The fused operation, for its mode and parameters
+        const OperationPointwise* mOperation = nullptr;
+        /// Registers of the inputs, in the order of mOperation->getInTensors()
+        std::vector<size_t> mArgs{};
+    };
+
+private:
+    std::vector<Tensor*> mInputs;
+    std::vector<Instruction> mInstructions;
+    /// {register, tensor}
+    std::vector<std::pair<size_t, Tensor*>> mOutputs;
+    std::vector<int64_t> mDimensions;
+
+    friend MIOPEN_INTERNALS_EXPORT std::shared_ptr<OperationFusedPointwise>
+    fusePointwiseOperations(const std::vector<const OperationPointwise*>& operations,
+                            const std::vector<const OpNode*>& consumers);
+
+public:
+    const std::vector<Tensor*>& getInputs() const noexcept { return mInputs; }
+    const std::vector<Instruction>& getInstructions() const noexcept { return mInstructions; }
+    const std::vector<std::pair<size_t, Tensor*>>& getOutputs() const noexcept
+    {
+        return mOutputs;
+    }
+    /// Dimensions of all the outputs, the inputs may broadcast to them
+    const std::vector<int64_t>& getDimensions() const noexcept { return mDimensions; }
+    size_t getNumRegisters() const noexcept { return mInputs.size() + mInstructions.size(); }
+
+    const std::string& signName() const override;
+    size_t hashAttributes() const override;
+    std::vector<Tensor*> getInTensors() const override { return mInputs; }
+    std::vector<Tensor*> getOutTensors() const override;
+};
+
+/// Compiles operations, given in topological order, into one fused operation. A tensor they
+/// produce is an output unless it is virtual and only read by the operations themselves;
+/// consumers are the other nodes that may read it.
+MIOPEN_INTERNALS_EXPORT std::shared_ptr<OperationFusedPointwise>
+fusePointwiseOperations(const std::vector<const OperationPointwise*>& operations,
+                        const std::vector<const OpNode*>& consumers);
+
+struct PointwiseFusion
+{
+    std::vector<const OpNode*> mSteps{};
+    /// Owns the fused nodes referenced by mSteps
+    std::vector<std::shared_ptr<const OpNode>> mFusedNodes{};
+};
+
+/// Rewrites nodes in topological order so that every maximal group of connected pointwise
+/// operations with equal output dimensions runs as one OperationFusedPointwise. A group never
+/// contains two operations with another node on a path between them. The result is in
+/// topological order too.
+MIOPEN_INTERNALS_EXPORT PointwiseFusion fusePointwise(const std::vector<const OpNode*>& steps);
+
+} // namespace graphapi
+
+} // namespace miopen
@@ -30,6 +30,7 @@
 #include <miopen/kernel_info.hpp>
 #include <miopen/common.hpp>
 #include <miopen/invoker_cache.hpp>
+#include <miopen/solver_applicability_cache.hpp>
 #include <miopen/kernel.hpp>
 #include <miopen/miopen.h>
 #include <miopen/names.hpp>
@@ -152,6 +153,7 @@ struct MIOPEN_EXPORT Handle : miopenHandle
         return StartsWith(name, "gfx1") ? num_cu * 2 /* CUs per WGP */ : num_cu;
     }
 
+    /// Filled by the first GetMaxMemoryAllocSize() call, which is not synchronized.
     std::size_t m_MaxMemoryAllocSizeCached = 0;
     std::size_t GetMaxMemoryAllocSize();
     bool CooperativeLaunchSupported() const;
@@ -247,7 +249,7 @@ public:
     void
     SetAsFound1_0(const NetworkConfig& config, const AlgorithmName& algo, const std::string& solver)
     {
-        invokers.SetAsFound1_0(config, algo, solver);
+        invokers.SetAsFound1_0(config, algo.ToString(), solver);
     }
 
     boost::optional<const Invoker&>
@@ -261,19 +263,24 @@ public:
         {
             MIOPEN_LOG_I2("Returning an invoker for problem " << config.ToString() << " and solver "
                                                               << solver->ToString());
-            return invokers[std::make_pair(config.ToString(), solver->ToString())];
+            // The registered name is looked up without copying it.
+            if(solver->IsValid())
+                return invokers.Find(config, solver->GetName());
+            return invokers.Find(config, solver->ToString());
         }
         MIOPEN_LOG_I2("Returning an invoker for problem " << config.ToString() << " and algorithm "
                                                           << algo->ToString());
-        return invokers.GetFound1_0(config, *algo);
+        return invokers.GetFound1_0(config, algo->ToString());
     }
 
     boost::optional<const std::string&> GetFound1_0SolverId(const NetworkConfig& config,
                                                             const AlgorithmName& algo) const
     {
-        return invokers.GetFound1_0SolverId(config, algo);
+        return invokers.GetFound1_0SolverId(config, algo.ToString());
     }
 
+    SolverApplicabilityCache& GetApplicabilityCache() { return applicability; }
+
 #if MIOPEN_USE_ROCBLAS
     const rocblas_handle_ptr& rhandle() const;
 
@@ -283,6 +290,7 @@ private:
 private:
 #endif
     InvokerCache invokers;
+    SolverApplicabilityCache applicability;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Handle& handle) { return handle.Print(os); }
@@ -28,12 +28,16 @@
 
 #include <miopen/errors.hpp>
 #include <miopen/invoker.hpp>
+#include <miopen/names.hpp>
 
 #include <boost/optional.hpp>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 namespace miopen {
@@ -42,18 +46,23 @@ class InvokerCache
 {
 public:
     // network_config, solver_id
-    using Key = std::pair<std::string, std::string>;
+    using Key = std::pair<NetworkConfig, std::string>;
 
-    boost::optional<const Invoker&> operator[](const Key& key) const;
+    boost::optional<const Invoker&> Find(const NetworkConfig& network_config,
+                                         std::string_view solver_id) const;
+    boost::optional<const Invoker&> operator[](const Key& key) const
+    {
+        return Find(key.first, key.second);
+    }
     // For find 1.0
-    boost::optional<const Invoker&> GetFound1_0(const std::string& network_config,
-                                                const std::string& algorithm) const;
-    boost::optional<const std::string&> GetFound1_0SolverId(const std::string& network_config,
-                                                            const std::string& algorithm) const;
+    boost::optional<const Invoker&> GetFound1_0(const NetworkConfig& network_config,
+                                                std::string_view algorithm) const;
+    boost::optional<const std::string&> GetFound1_0SolverId(const NetworkConfig& network_config,
+                                                            std::string_view algorithm) const;
 
     void Register(const Key& key, const Invoker& invoker);
     // For find 1.0
-    void SetAsFound1_0(const std::string& network_config,
+    void SetAsFound1_0(const NetworkConfig& network_config,
                        const std::string& algorithm,
                        const std::string& solver_id);
 
@@ -62,13 +71,13 @@ private:
     {
         // algorithm -> solver_id
         // for find 1.0
-        std::map<std::string, std::string> found_1_0;
+        std::map<std::string, std::string, std::less<>> found_1_0;
         // solver_id -> invoker
-        std::map<std::string, Invoker> invokers;
+        std::map<std::string, Invoker, std::less<>> invokers;
     };
 
-    // network_config -> Item
-    std::map<std::string, Item> invokers;
+    // network_config -> Item, hashed with the hash the config carries
+    std::unordered_map<NetworkConfig, Item> invokers;
 };
 
 } // namespace miopen
@@ -32,6 +32,7 @@
 
 #include <miopen/sqlite_db.hpp>
 #include <miopen/bz2.hpp>
+#include <miopen/kernel_codec.hpp>
 #include <miopen/md5.hpp>
 
 #include <boost/core/explicit_operator_bool.hpp>
@@ -42,8 +43,14 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <tuple>
+#include <vector>
 
 namespace miopen {
+/// Kernels are stored by content: `kern_db` maps (kernel_name, kernel_args) to the md5 of
+/// the code object, and `kern_db_blob` holds each distinct code object once. Databases
+/// written by older versions hold the blobs in `kern_db` itself. Such system databases are
+/// read as they are, and user databases are converted on open.
 struct KernelConfig
 {
     static std::string table_name() { return "kern_db"; }
@@ -52,7 +59,11 @@ struct KernelConfig
     std::vector<char> kernel_blob;
     static std::vector<std::string> FieldNames()
     {
-        return {"kernel_name", "kernel_args", "kernel_blob"};
+        return {"kernel_name", "kernel_args", "kernel_hash"};
+    }
+    static std::vector<std::string> BlobFieldNames()
+    {
+        return {"kernel_hash", "kernel_blob", "uncompressed_size", "codec"};
     }
     static std::string CreateQuery()
     {
@@ -61,31 +72,131 @@ struct KernelConfig
            << "`id` INTEGER PRIMARY KEY ASC"
            << ",`kernel_name` TEXT NOT NULL"
            << ",`kernel_args` TEXT NOT NULL"
-           << ",`kernel_blob` BLOB NOT NULL"
            << ",`kernel_hash` TEXT NOT NULL"
-           << ",`uncompressed_size` INT NOT NULL"
+           << ",`last_access` INT NOT NULL DEFAULT 0"
            << ");"
            << "CREATE UNIQUE INDEX IF NOT EXISTS "
            << "`idx_" << KernelConfig::table_name() << "` "
-           << "ON " << KernelConfig::table_name() << "(kernel_name, kernel_args);";
+           << "ON " << KernelConfig::table_name() << "(kernel_name, kernel_args);"
+           << "CREATE INDEX IF NOT EXISTS "
+           << "`idx_" << KernelConfig::table_name() << "_hash` "
+           << "ON " << KernelConfig::table_name() << "(kernel_hash);"
+           << "CREATE TABLE IF NOT EXISTS `" << BlobTableName() << "` ("
+           << "`kernel_hash` TEXT PRIMARY KEY NOT NULL"
+           << ",`kernel_blob` BLOB NOT NULL"
+           << ",`uncompressed_size` INT NOT NULL"
+           << ",`codec` INT NOT NULL"
+           << ");"
+           << "CREATE TABLE IF NOT EXISTS `" << DictTableName() << "` ("
+           << "`id` INT NOT NULL UNIQUE"
+           << ",`dict` BLOB NOT NULL"
+           << ");";
         return ss.str();
     }
-    std::string Where() const
+    /// Moves the blobs of an old database to the blob table, keeping one copy per hash.
+    /// Rows of the databases created before the codec column are bz2.
+    static std::string MigrateQuery(bool has_codec_column)
     {
+        const auto codec = has_codec_column
+                               ? std::string{"codec"}
+                               : std::to_string(static_cast<int64_t>(KernelCodec::Bz2));
         std::ostringstream ss;
-        ss << "(kernel_name = '" << kernel_name.string() << "')"
-           << " AND (kernel_args = '" << kernel_args << "')";
+        ss << "INSERT OR IGNORE INTO `" << BlobTableName() << "` "
+           << "(kernel_hash, kernel_blob, uncompressed_size, codec) "
+           << "SELECT kernel_hash, kernel_blob, uncompressed_size, " << codec << " FROM `"
+           << KernelConfig::table_name() << "`;"
+           << "ALTER TABLE `" << KernelConfig::table_name() << "` RENAME TO `"
+           << KernelConfig::table_name() << "_old`;"
+           << "DROP INDEX IF EXISTS `idx_" << KernelConfig::table_name() << "`;"
+           << "DROP INDEX IF EXISTS `idx_" << KernelConfig::table_name() << "_hash`;"
+           << CreateQuery() << "INSERT INTO `" << KernelConfig::table_name() << "` "
+           << "(kernel_name, kernel_args, kernel_hash) "
+           << "SELECT kernel_name, kernel_args, kernel_hash FROM `" << KernelConfig::table_name()
+           << "_old`;"
+           << "DROP TABLE `" << KernelConfig::table_name() << "_old`;";
         return ss.str();
     }
+    /// Entries of the databases created before the access tracking count as the least recent.
+    static std::string AddLastAccessQuery()
+    {
+        std::ostringstream ss;
+        ss << "ALTER TABLE `" << KernelConfig::table_name()
+           << "` ADD COLUMN `last_access` INT NOT NULL DEFAULT 0;";
+        return ss.str();
+    }
+    static std::string BlobTableName() { return "kern_db_blob"; }
+    static std::string DictTableName() { return "kern_db_dict"; }
+    std::tuple<std::string, std::vector<std::string>> WhereClause() const
+    {
+        return std::make_tuple("(kernel_name = ?) AND (kernel_args = ?)",
+                               std::vector<std::string>{kernel_name.string(), kernel_args});
+    }
+};
+
+struct KernDbStats
+{
+    /// (kernel_name, kernel_args) entries.
+    std::size_t kernels = 0;
+    /// Distinct code objects.
+    std::size_t blobs = 0;
+    /// Size of the stored, possibly compressed, blobs.
+    std::size_t stored_bytes = 0;
+    /// Size of the blobs if every entry held its own copy.
+    std::size_t undeduplicated_bytes = 0;
+};
+
+struct KernDbConsumer
+{
+    std::string kernel_name;
+    std::size_t kernels = 0;
+    std::size_t bytes   = 0;
+    /// Seconds since the epoch.
+    int64_t last_access = 0;
 };
 
 class KernDb : public SQLiteBase<KernDb>
 {
     std::function<std::vector<char>(const std::vector<char>&, bool*)> compress_fn;
     std::function<std::vector<char>(const std::vector<char>&, unsigned int)> decompress_fn;
+    // Codec of the new rows. Bz2 rows go through compress_fn/decompress_fn.
+    KernelCodec codec = KernelCodec::Bz2;
+    // Only read-only system databases may still hold the blobs in the kern_db table.
+    bool content_addressed = true;
+    bool has_codec_column  = true;
+    // Only user databases record when their entries are used.
+    bool track_access = false;
+    // The dictionaries are read on first use, most instances only ever read rows without one.
+    bool dicts_loaded = false;
+    KernelCodecDicts dicts;
+    // Dictionary of the new zstd rows, 0 for none.
+    uint32_t dict_id = 0;
+
+    MIOPEN_INTERNALS_EXPORT std::vector<char> CompressRow(const std::vector<char>& blob,
+                                                          KernelCodec& row_codec);
+    MIOPEN_INTERNALS_EXPORT std::vector<char> DecompressRow(const std::vector<char>& blob,
+                                                            int64_t uncompressed_size,
+                                                            KernelCodec row_codec);
+    bool Migrate();
+    void LoadDictionaries();
+    boost::optional<std::string> FindHash(const std::string& clause,
+                                          const std::vector<std::string>& values);
+    std::size_t RemoveBlobIfUnused(const std::string& hash);
+    void TouchKernel(const std::string& clause, const std::vector<std::string>& values);
+
+    MIOPEN_INTERNALS_EXPORT boost::optional<std::vector<char>>
+    FindKernel(const std::string& clause, const std::vector<std::string>& values);
+    MIOPEN_INTERNALS_EXPORT void StoreKernel(const std::string& clause,
+                                             const std::vector<std::string>& values,
+                                             const fs::path& kernel_name,
+                                             const std::string& kernel_args,
+                                             const std::vector<char>& kernel_blob);
+    MIOPEN_INTERNALS_EXPORT void RemoveKernel(const std::string& clause,
+                                              const std::vector<std::string>& values);
 
 public:
     MIOPEN_INTERNALS_EXPORT KernDb(DbKinds db_kind, const fs::path& filename_, bool is_system);
+    MIOPEN_INTERNALS_EXPORT
+    KernDb(DbKinds db_kind, const fs::path& filename_, bool is_system_, KernelCodec codec_);
     // This constructor is only intended for testing
     MIOPEN_INTERNALS_EXPORT
     KernDb(DbKinds db_kind,
@@ -93,24 +204,34 @@ public:
            bool is_system_,
            std::function<std::vector<char>(const std::vector<char>&, bool*)> compress_fn_,
            std::function<std::vector<char>(const std::vector<char>&, unsigned int)> decompress_fn_);
+
+    /// Returns all the distinct kernel blobs of the database, decompressed.
+    MIOPEN_INTERNALS_EXPORT std::vector<std::vector<char>> LoadBlobsUnsafe();
+    /// Trains a zstd dictionary on the stored kernels and uses it for the rows stored
+    /// from then on. The existing rows are left as they are. Does nothing unless the new rows
+    /// are compressed with zstd. SaveBinary trains one for the user database in the background.
+    MIOPEN_INTERNALS_EXPORT bool TrainDictionaryUnsafe(std::size_t capacity = 110 * 1024);
+    MIOPEN_INTERNALS_EXPORT bool HasDictionary();
+    /// Reads the dictionaries again, so that the instance of GetCached() uses the one another
+    /// instance has trained for the rows it stores from then on.
+    MIOPEN_INTERNALS_EXPORT void ReloadDictionaries();
+    MIOPEN_INTERNALS_EXPORT KernDbStats GetStatsUnsafe();
+    /// Kernel names which take the most space, with their space and most recent use.
+    MIOPEN_INTERNALS_EXPORT std::vector<KernDbConsumer> GetTopConsumersUnsafe(std::size_t count);
+    /// Removes the least recently used entries until the blobs take 90% of max_bytes, if they
+    /// take more than max_bytes. Returns the number of removed entries.
+    MIOPEN_INTERNALS_EXPORT std::size_t EvictUnsafe(std::size_t max_bytes);
+
     template <typename T>
     bool RemoveRecordUnsafe(const T& problem_config)
     {
         if(filename.empty())
             return true;
-        auto del_query =
-            "DELETE FROM " + T::table_name() + " WHERE " + problem_config.Where() + ";";
-        auto stmt = SQLite::Statement{sql, del_query};
-        auto rc   = stmt.Step(sql);
-        if(rc == SQLITE_DONE)
-        {
-            return true;
-        }
-        else
-        {
-            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
-            return false;
-        }
+        std::string clause;
+        std::vector<std::string> values;
+        std::tie(clause, values) = problem_config.WhereClause();
+        RemoveKernel(clause, values);
+        return true;
     }
 
     template <typename T>
@@ -118,37 +239,10 @@ public:
     {
         if(filename.empty())
             return boost::none;
-        // Where clause with inserted values defeats the purpose of a prepraed statement
-        auto select_query = "SELECT kernel_blob, kernel_hash, uncompressed_size FROM " +
-                            T::table_name() + " WHERE " + problem_config.Where() + ";";
-        auto stmt = SQLite::Statement{sql, select_query};
-        // only one result field
-        // assert one row
-        auto rc = stmt.Step(sql);
-        if(rc == SQLITE_ROW)
-        {
-            auto compressed_blob                 = stmt.ColumnBlob(0);
-            auto md5_hash                        = stmt.ColumnText(1);
-            auto uncompressed_size               = stmt.ColumnInt64(2);
-            std::vector<char>& decompressed_blob = compressed_blob;
-            if(uncompressed_size != 0)
-            {
-                decompressed_blob = decompress_fn(compressed_blob, uncompressed_size);
-            }
-            auto new_md5 = md5(decompressed_blob);
-            if(new_md5 != md5_hash)
-                MIOPEN_THROW(miopenStatusInternalError, "Possible database corruption");
-            return decompressed_blob;
-        }
-        else if(rc == SQLITE_DONE)
-        {
-            return boost::none;
-        }
-        else
-        {
-            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
-        }
-        return boost::none;
+        std::string clause;
+        std::vector<std::string> values;
+        std::tie(clause, values) = problem_config.WhereClause();
+        return FindKernel(clause, values);
     }
 
     template <typename T>
@@ -156,31 +250,14 @@ public:
     {
         if(filename.empty())
             return false;
-        auto insert_query = "INSERT OR REPLACE INTO " + T::table_name() +
-                            "(kernel_name, kernel_args, kernel_blob, kernel_hash, "
-                            "uncompressed_size) VALUES(?, ?, ?, ?, ?);";
-        auto md5_sum           = md5(problem_config.kernel_blob);
-        auto uncompressed_size = problem_config.kernel_blob.size();
-        bool success           = false;
-        auto compressed_blob   = compress_fn(problem_config.kernel_blob, &success);
-        auto stmt              = SQLite::Statement{sql, insert_query};
-        stmt.BindPath(1, problem_config.kernel_name);
-        stmt.BindText(2, problem_config.kernel_args);
-        if(!success)
-        {
-            stmt.BindBlob(3, problem_config.kernel_blob);
-            stmt.BindInt64(5, 0);
-        }
-        else
-        {
-            stmt.BindBlob(3, compressed_blob);
-            stmt.BindInt64(5, uncompressed_size);
-        }
-        stmt.BindText(4, md5_sum);
-
-        auto rc = stmt.Step(sql);
-        if(rc != SQLITE_DONE)
-            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        std::string clause;
+        std::vector<std::string> values;
+        std::tie(clause, values) = problem_config.WhereClause();
+        StoreKernel(clause,
+                    values,
+                    problem_config.kernel_name,
+                    problem_config.kernel_args,
+                    problem_config.kernel_blob);
         return true;
     }
 };
@@ -62,7 +62,6 @@ class KernelCache
 
 public:
     using Key        = std::pair<fs::path, std::string>;
-    using KernelMap  = std::unordered_map<Key, std::vector<Kernel>, SimpleHash>;
     using ProgramMap = std::unordered_map<Key, Program, SimpleHash>;
 
     Kernel AddKernel(const Handle& h,
@@ -76,7 +75,10 @@ public:
                      std::size_t cache_index       = 0,
                      const std::string& kernel_src = "");
 
-    void AddKernel(Key key, Kernel k, std::size_t cache_index);
+    void AddKernel(const std::string& algorithm,
+                   const std::string& network_config,
+                   Kernel k,
+                   std::size_t cache_index);
 
     void ClearKernels(const std::string& algorithm, const std::string& network_config);
 
@@ -91,6 +93,31 @@ public:
     KernelCache();
 
 private:
+    struct KernelEntry
+    {
+        std::string algorithm;
+        std::string network_config;
+        std::vector<Kernel> kernels;
+    };
+
+    // Keyed by the hash of the algorithm and the network config, so that the lookups do not
+    // build a key. The strings only resolve the collisions.
+    using KernelMap = std::unordered_multimap<std::size_t, KernelEntry>;
+
+    /// The strings of a call with their combined hash, which is computed once and passed to
+    /// every lookup and insert the call makes.
+    struct KernelKey
+    {
+        KernelKey(const std::string& algorithm_, const std::string& network_config_);
+
+        const std::string& algorithm;
+        const std::string& network_config;
+        std::size_t hash;
+    };
+
+    std::vector<Kernel>* FindKernels(const KernelKey& key);
+    void AddKernel(const KernelKey& key, Kernel k, std::size_t cache_index);
+
     KernelMap kernel_map;
     ProgramMap program_map;
 };
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_KERNEL_CODEC_HPP_
+#define GUARD_MIOPEN_KERNEL_CODEC_HPP_
+
+#include <miopen/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace miopen {
+
+/// Compression of the kernel blobs stored in the kernel db. The value is stored
+/// per row, so it must never be renumbered.
+enum class KernelCodec : int64_t
+{
+    None = 0, ///< Stored as is.
+    Bz2  = 1, ///< Legacy format, the default for rows without the codec column.
+    Zstd = 2, ///< Zstandard frame, optionally compressed with a dictionary.
+};
+
+/// Zstd dictionaries by their dictionary id.
+using KernelCodecDicts = std::unordered_map<uint32_t, std::vector<char>>;
+
+MIOPEN_INTERNALS_EXPORT std::string ToString(KernelCodec codec);
+MIOPEN_INTERNALS_EXPORT bool IsCodecAvailable(KernelCodec codec);
+
+/// Codec for the new kernel db rows: MIOPEN_DEBUG_KERN_DB_CODEC ("bz2", "zstd" or "none")
+/// if set, otherwise zstd when it is available and bz2 when it is not.
+MIOPEN_INTERNALS_EXPORT KernelCodec GetDefaultKernelCodec();
+
+/// Sets *compressed to false and returns the input if the output would not be smaller.
+/// dict is only used by zstd and may be null.
+MIOPEN_INTERNALS_EXPORT std::vector<char> CompressBlob(KernelCodec codec,
+                                                       const std::vector<char>& v,
+                                                       bool* compressed,
+                                                       const std::vector<char>* dict = nullptr);
+
+/// The dictionary a zstd frame has been compressed with is looked up in dicts
+/// by the id recorded in the frame.
+MIOPEN_INTERNALS_EXPORT std::vector<char> DecompressBlob(KernelCodec codec,
+                                                         const std::vector<char>& v,
+                                                         std::size_t size,
+                                                         const KernelCodecDicts& dicts = {});
+
+/// Trains a zstd dictionary of at most capacity bytes. Returns an empty vector if zstd
+/// is not available or there are too few samples.
+MIOPEN_INTERNALS_EXPORT std::vector<char>
+TrainKernelCodecDict(const std::vector<std::vector<char>>& samples, std::size_t capacity);
+
+/// Returns 0 for anything which is not a zstd dictionary.
+MIOPEN_INTERNALS_EXPORT uint32_t GetKernelCodecDictId(const std::vector<char>& dict);
+
+/// Id of the dictionary a blob has been compressed with, 0 for none.
+MIOPEN_INTERNALS_EXPORT uint32_t GetKernelCodecFrameDictId(KernelCodec codec,
+                                                           const std::vector<char>& v);
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_KERNEL_CODEC_HPP_
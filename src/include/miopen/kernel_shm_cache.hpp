@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_KERNEL_SHM_CACHE_HPP_
+#define GUARD_MIOPEN_KERNEL_SHM_CACHE_HPP_
+
+#include <miopen/config.hpp>
+#include <miopen/filesystem.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace miopen {
+
+/// Code objects shared by the processes of a node through a POSIX shared memory segment.
+/// The first process to load a kernel publishes it, and the others read it from the
+/// mapping instead of the kernel db.
+///
+/// Entries are only ever added. The index is an open addressing hash table whose slots are
+/// claimed with a compare-and-swap, and the blobs are bump allocated from the rest of the
+/// segment. Once the segment is full, new kernels are no longer shared.
+class MIOPEN_INTERNALS_EXPORT KernelShmCache
+{
+public:
+    /// Maps the segment, creating it with room for slots entries and capacity bytes of
+    /// keys and blobs if it does not exist. The size of an existing segment is kept.
+    KernelShmCache(const std::string& name, std::size_t capacity, std::size_t slots);
+    ~KernelShmCache();
+
+    KernelShmCache(const KernelShmCache&) = delete;
+    KernelShmCache& operator=(const KernelShmCache&) = delete;
+
+    /// False if the segment could not be mapped, e.g. shared memory is not available.
+    bool IsValid() const { return header != nullptr; }
+
+    /// The blob points into the mapping and is valid for the lifetime of this object.
+    /// Entries whose blob does not match the md5 stored with it are skipped.
+    std::optional<std::string_view> Find(std::string_view key) const;
+
+    /// Returns false if the entry does not fit. Publishing a key which is already
+    /// there succeeds and keeps the first blob.
+    bool Insert(std::string_view key, std::string_view blob);
+
+    /// Removes the segment name. Processes which have the segment mapped keep using it.
+    static void Unlink(const std::string& name);
+
+private:
+    struct Header;
+    struct Slot;
+
+    Header* header          = nullptr;
+    Slot* slots             = nullptr;
+    char* data              = nullptr;
+    std::size_t mapped_size = 0;
+};
+
+/// The device and inode of a file, empty if it does not exist. Shared entries are keyed by the
+/// identity of the cache they were read from, so they are not served once it is removed.
+MIOPEN_INTERNALS_EXPORT std::string GetFileIdentity(const fs::path& path);
+
+/// The node wide cache of the user kernel cache, if MIOPEN_KERNEL_SHM_CACHE_MB is set.
+/// nullptr otherwise or if it could not be mapped.
+MIOPEN_INTERNALS_EXPORT KernelShmCache* GetKernelShmCache();
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_KERNEL_SHM_CACHE_HPP_
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_KEY_WRITER_HPP_
+#define GUARD_MIOPEN_KEY_WRITER_HPP_
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace miopen {
+
+/// Formats the network configs and the db keys in a buffer on the stack, as
+/// std::ostringstream with the default flags would. The heap is only used by the keys
+/// which outgrow the buffer.
+class KeyWriter
+{
+public:
+    static constexpr std::size_t capacity = 256;
+
+    KeyWriter() = default;
+    KeyWriter(const KeyWriter&) = delete;
+    KeyWriter& operator=(const KeyWriter&) = delete;
+
+    KeyWriter& operator<<(char c) { return Append(&c, 1); }
+    KeyWriter& operator<<(std::string_view s) { return Append(s.data(), s.size()); }
+    KeyWriter& operator<<(const char* s) { return Append(s, std::strlen(s)); }
+    KeyWriter& operator<<(const std::string& s) { return Append(s.data(), s.size()); }
+    KeyWriter& operator<<(bool value) { return *this << static_cast<int>(value); }
+    // The streams write the small integer types as characters.
+    KeyWriter& operator<<(signed char c) { return *this << static_cast<char>(c); }
+    KeyWriter& operator<<(unsigned char c) { return *this << static_cast<char>(c); }
+
+    template <class T,
+              std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> &&
+                                   !std::is_same_v<T, signed char> &&
+                                   !std::is_same_v<T, unsigned char> && !std::is_same_v<T, bool>,
+                               int> = 0>
+    KeyWriter& operator<<(T value)
+    {
+        char digits[24];
+        const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        return Append(digits, result.ptr - digits);
+    }
+
+    /// Enumerations are written as their promoted values, as the streams do with the unscoped
+    /// ones.
+    template <class T, std::enable_if_t<std::is_enum_v<T>, int> = 0>
+    KeyWriter& operator<<(T value)
+    {
+        return *this << +static_cast<std::underlying_type_t<T>>(value);
+    }
+
+    template <class T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    KeyWriter& operator<<(T value)
+    {
+        // The default stream format.
+        char digits[32];
+        const auto length =
+            std::snprintf(digits, sizeof(digits), "%g", static_cast<double>(value));
+        return Append(digits, static_cast<std::size_t>(length));
+    }
+
+    /// Writes the elements of the range separated by sep.
+    template <class Range>
+    KeyWriter& Join(const Range& range, char sep)
+    {
+        auto first = true;
+        for(const auto& value : range)
+        {
+            if(!first)
+                *this << sep;
+            *this << value;
+            first = false;
+        }
+        return *this;
+    }
+
+    std::string_view View() const
+    {
+        return spilled.empty() ? std::string_view{buffer.data(), size} : std::string_view{spilled};
+    }
+    std::string Str() const { return std::string{View()}; }
+    bool Empty() const { return View().empty(); }
+
+private:
+    KeyWriter& Append(const char* data, std::size_t length)
+    {
+        if(spilled.empty() && size + length <= capacity)
+        {
+            std::memcpy(buffer.data() + size, data, length);
+            size += length;
+            return *this;
+        }
+        if(spilled.empty())
+            spilled.assign(buffer.data(), size);
+        spilled.append(data, length);
+        return *this;
+    }
+
+    std::array<char, capacity> buffer;
+    std::size_t size = 0;
+    std::string spilled;
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_KEY_WRITER_HPP_
@@ -2,6 +2,7 @@
 #define GUARD_MLOPEN_MD5_HPP
 
 #include <miopen/config.hpp>
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -9,6 +10,7 @@ namespace miopen {
 
 MIOPEN_INTERNALS_EXPORT std::string md5(const std::string&);
 MIOPEN_INTERNALS_EXPORT std::string md5(const std::vector<char>&);
+MIOPEN_INTERNALS_EXPORT std::string md5(const void* data, std::size_t length);
 
 } // namespace miopen
 
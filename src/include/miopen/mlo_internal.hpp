@@ -67,6 +67,7 @@ POSSIBILITY OF SUCH DAMAGE.
 #include <miopen/sqlite_db.hpp>
 #else
 #include <miopen/readonlyramdb.hpp>
+#include <miopen/readonly_binary_db.hpp>
 #endif
 #include <miopen/execution_context.hpp>
 #include <miopen/handle.hpp>
@@ -127,6 +128,7 @@ template <class TInstalled, class TUser, bool merge_records>
 class MultiFileDb;
 
 class ReadonlyRamDb;
+class ReadonlyBinaryDb;
 class PlainTextDb;
 
 template <class TInnerDb>
@@ -136,6 +138,8 @@ struct AnyInvokeParams;
 
 #if MIOPEN_ENABLE_SQLITE && MIOPEN_USE_SQLITE_PERFDB
 using PerformanceDb = DbTimer<MultiFileDb<SQLitePerfDb, SQLitePerfDb, true>>;
+#elif MIOPEN_USE_BINARY_SYSDB
+using PerformanceDb = DbTimer<MultiFileDb<ReadonlyBinaryDb, RamDb, true>>;
 #else
 using PerformanceDb = DbTimer<MultiFileDb<ReadonlyRamDb, RamDb, true>>;
 #endif
@@ -26,34 +26,243 @@
 
 #pragma once
 
-#include <queue>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
 
+/// Bounded multi-producer multi-consumer queue of movable items.
+///
+/// The items live in a ring of cells, each with a sequence number telling whether it is free
+/// or full for the current lap, so that try_push() and try_pop() take no lock. push() and pop()
+/// block while the queue is full or empty, which keeps producers from running ahead of the
+/// consumers. Blocked threads yield for a while, then sleep on a condition variable that the
+/// other side only locks when someone waits. close() ends the queue: push() fails and pop()
+/// returns nothing once the remaining items are taken.
 template <typename T>
 class ThreadSafeQueue
 {
-    std::mutex mutex;
-    std::condition_variable cond_var;
-    std::queue<T> queue;
-
 public:
-    void push(T&& item)
+    /// The capacity is rounded up to a power of two, and is at least two: the sequence of a
+    /// single cell could not tell a full queue from an empty one.
+    explicit ThreadSafeQueue(std::size_t capacity = 1024)
+    {
+        auto size = std::size_t{2};
+        while(size < capacity)
+            size *= 2;
+        mask  = size - 1;
+        cells = std::make_unique<Cell[]>(size);
+        for(auto i = std::size_t{0}; i < size; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~ThreadSafeQueue()
+    {
+        while(try_pop())
+        {
+        }
+    }
+
+    ThreadSafeQueue(const ThreadSafeQueue&) = delete;
+    ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    /// Takes the item unless the queue is full or closed, in which case it is left as it is.
+    bool try_push(T&& item)
+    {
+        if(is_closed.load())
+            return false;
+        if(!TryPush(item))
+            return false;
+        Wake(not_empty);
+        return true;
+    }
+
+    /// Waits for room. Returns false, leaving the item as it is, if the queue is closed.
+    bool push(T&& item)
     {
+        for(auto attempt = 0; !try_push(std::move(item)); ++attempt)
+        {
+            if(is_closed.load())
+                return false;
+            if(attempt < spin_attempts)
+                std::this_thread::yield();
+            else
+                Wait(not_full, [&]() { return CanPush(); }, nullptr);
+        }
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        auto item = TryPop();
+        if(item)
+            Wake(not_full);
+        return item;
+    }
 
+    /// Waits for an item. Returns nothing once the queue is closed and empty.
+    std::optional<T> pop()
+    {
+        for(auto attempt = 0;; ++attempt)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            queue.push(item);
+            if(auto item = try_pop())
+                return item;
+            if(is_closed.load() && !CanPop())
+                return std::nullopt;
+            if(attempt < spin_attempts)
+                std::this_thread::yield();
+            else
+                Wait(not_empty, [&]() { return CanPop(); }, nullptr);
         }
+    }
 
-        cond_var.notify_one();
+    /// As pop(), but also returns nothing after the timeout.
+    template <class Rep, class Period>
+    std::optional<T> pop_for(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while(true)
+        {
+            if(auto item = try_pop())
+                return item;
+            if(is_closed.load() && !CanPop())
+                return std::nullopt;
+            if(!Wait(not_empty, [&]() { return CanPop(); }, &deadline))
+                return try_pop();
+        }
     }
-    T pop()
+
+    void close()
+    {
+        is_closed.store(true);
+        std::lock_guard<std::mutex> lock(mutex);
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    bool closed() const { return is_closed.load(); }
+
+private:
+    // Yielding a few times before sleeping spares most waits their system calls.
+    static constexpr int spin_attempts = 16;
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* item() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // A cell is free for the push at position pos when its sequence is pos, and holds the item
+    // for the pop at position pos when its sequence is pos + 1.
+    static std::ptrdiff_t Lag(std::size_t sequence, std::size_t pos)
+    {
+        return static_cast<std::ptrdiff_t>(sequence - pos);
+    }
+
+    bool TryPush(T& item)
+    {
+        auto pos = enqueue_pos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            auto& cell     = cells[pos & mask];
+            const auto lag = Lag(cell.sequence.load(std::memory_order_acquire), pos);
+            if(lag == 0)
+            {
+                if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    new(cell.storage) T(std::move(item));
+                    cell.sequence.store(pos + 1);
+                    return true;
+                }
+            }
+            else if(lag < 0)
+                return false; // Full, the cell still holds the item of the previous lap.
+            else
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::optional<T> TryPop()
+    {
+        auto pos = dequeue_pos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            auto& cell     = cells[pos & mask];
+            const auto lag = Lag(cell.sequence.load(std::memory_order_acquire), pos + 1);
+            if(lag == 0)
+            {
+                if(dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    auto item = std::optional<T>{std::move(*cell.item())};
+                    cell.item()->~T();
+                    cell.sequence.store(pos + mask + 1);
+                    return item;
+                }
+            }
+            else if(lag < 0)
+                return std::nullopt; // Empty, the cell is not filled yet.
+            else
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool CanPush() const
+    {
+        const auto pos = enqueue_pos.load();
+        return Lag(cells[pos & mask].sequence.load(), pos) >= 0;
+    }
+
+    bool CanPop() const
+    {
+        const auto pos = dequeue_pos.load();
+        return Lag(cells[pos & mask].sequence.load(), pos + 1) >= 0;
+    }
+
+    // The waiter count and the cell sequences are sequentially consistent, so either the waiter
+    // sees the change or the other side sees the waiter and notifies under the lock.
+    template <class Ready>
+    bool Wait(std::condition_variable& cond_var,
+              Ready ready,
+              const std::chrono::steady_clock::time_point* deadline)
     {
         std::unique_lock<std::mutex> lock(mutex);
-        cond_var.wait(lock, [&] { return !queue.empty(); });
-        T ret = queue.front();
-        queue.pop();
-        return ret;
+        waiting.fetch_add(1);
+        const auto wake = [&]() { return is_closed.load() || ready(); };
+        auto woken      = true;
+        if(deadline == nullptr)
+            cond_var.wait(lock, wake);
+        else
+            woken = cond_var.wait_until(lock, *deadline, wake);
+        waiting.fetch_sub(1);
+        return woken;
     }
+
+    void Wake(std::condition_variable& cond_var)
+    {
+        if(waiting.load() == 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex);
+        cond_var.notify_all();
+    }
+
+    std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(64) std::atomic<std::size_t> dequeue_pos{0};
+    alignas(64) std::atomic<int> waiting{0};
+    std::atomic<bool> is_closed{false};
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
 };
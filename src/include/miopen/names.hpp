@@ -26,19 +26,32 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <utility>
 
 namespace miopen {
 
 struct NetworkConfig
 {
     NetworkConfig() = default;
-    explicit NetworkConfig(const std::string& value_) : value(value_) {}
+    explicit NetworkConfig(const std::string& value_) : value(value_), hash(Hash(value)) {}
+    explicit NetworkConfig(std::string&& value_) : value(std::move(value_)), hash(Hash(value)) {}
     operator std::string() const { return value; }
     const std::string& ToString() const { return value; }
 
+    /// Computed once, so that the caches keyed by the config only hash integers.
+    std::size_t GetHash() const { return hash; }
+
+    bool operator==(const NetworkConfig& r) const { return hash == r.hash && value == r.value; }
+    bool operator!=(const NetworkConfig& r) const { return !(*this == r); }
+
 private:
+    static std::size_t Hash(const std::string& v) { return std::hash<std::string>{}(v); }
+
     std::string value;
+    std::size_t hash = Hash({});
 };
 
 struct AlgorithmName
@@ -55,3 +68,16 @@ private:
 };
 
 } // namespace miopen
+
+namespace std {
+
+template <>
+struct hash<miopen::NetworkConfig>
+{
+    std::size_t operator()(const miopen::NetworkConfig& config) const noexcept
+    {
+        return config.GetHash();
+    }
+};
+
+} // namespace std
@@ -27,52 +27,15 @@
 #ifndef MIOPEN_GUARD_MLOPEN_PAR_FOR_HPP
 #define MIOPEN_GUARD_MLOPEN_PAR_FOR_HPP
 
-#include <algorithm>
-#include <cassert>
-#include <cmath>
-#include <functional>
-#include <numeric>
-#include <vector>
+#include <miopen/thread_pool.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <thread>
 
 namespace miopen {
 
-struct joinable_thread : std::thread
-{
-    template <class... Xs>
-    joinable_thread(Xs&&... xs) : std::thread(std::forward<Xs>(xs)...) // NOLINT
-    {
-    }
-
-    joinable_thread& operator=(joinable_thread&& other) = default;
-    joinable_thread(joinable_thread&& other)            = default;
-
-    ~joinable_thread()
-    {
-        if(this->joinable())
-            this->join();
-    }
-};
-
-struct thread_factory
-{
-    template <class F>
-    joinable_thread operator()(std::size_t& work, std::size_t n, std::size_t grainsize, F f) const
-    {
-        auto result = joinable_thread([=] {
-            std::size_t start = work;
-            std::size_t last  = std::min(n, work + grainsize);
-            for(std::size_t i = start; i < last; i++)
-            {
-                f(i);
-            }
-        });
-        work += grainsize;
-        return result;
-    }
-};
-
+// The loops run on ThreadPool::Shared(), threadsize bounds the threads taking part.
 template <class F>
 void par_for_impl(std::size_t n, std::size_t threadsize, F f)
 {
@@ -83,14 +46,7 @@ void par_for_impl(std::size_t n, std::size_t threadsize, F f)
     }
     else
     {
-        std::vector<joinable_thread> threads(threadsize);
-        const std::size_t grainsize = std::ceil(static_cast<double>(n) / threads.size());
-
-        std::size_t work = 0;
-        std::generate(threads.begin(),
-                      threads.end(),
-                      std::bind(thread_factory{}, std::ref(work), n, grainsize, f));
-        assert(work >= n);
+        ThreadPool::Shared().ParallelFor(n, f, threadsize);
     }
 }
 
@@ -144,6 +100,17 @@ void par_for_strided(std::size_t n, max_threads mt, F f)
     });
 }
 
+/// Takes as many threads of ThreadPool::Shared() as there are.
+struct shared_pool
+{
+};
+
+template <class F>
+void par_for(std::size_t n, shared_pool, F f)
+{
+    ThreadPool::Shared().ParallelFor(n, f);
+}
+
 } // namespace miopen
 
 #endif
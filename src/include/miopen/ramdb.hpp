@@ -30,8 +30,12 @@
 
 #include <boost/optional.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 
@@ -41,10 +45,20 @@
 
 namespace miopen {
 
-using ramdb_clock = std::chrono::steady_clock;
-
 class LockFile;
 
+/// Reads are served from an immutable snapshot of the db file without taking the file lock.
+/// Writers publish a new snapshot and bump the generation counter which is kept in the
+/// memory-mapped "<db>.gen" file, so the other processes notice the change by a single atomic
+/// load and only then reload the file under the lock.
+///
+/// With MIOPEN_DEBUG_DB_WRITE_BEHIND enabled, writes are only applied to the cache and appended
+/// to a journal owned by this instance. The db file is updated by a single batch on Flush(). A write
+/// flushes the batch if the oldest pending write is older than a second or there are too many of
+/// them. The batches of the cached instances are also flushed by a timer once a second, and by
+/// FlushAll(), which handle destructors call. A batch that fails to be written is kept with its
+/// journal for the next flush. Journals left by the processes which exited without flushing are
+/// replayed by the next process which opens the db.
 class MIOPEN_INTERNALS_EXPORT RamDb : protected PlainTextDb
 {
 public:
@@ -58,14 +72,18 @@ public:
     }
 
     RamDb(DbKinds db_kind_, const fs::path& path, bool is_system = false);
+    /// Pending writes are not flushed, they are left in the journal for a replay.
+    ~RamDb();
 
     RamDb(const RamDb&) = delete;
     RamDb(RamDb&&)      = delete;
     RamDb& operator=(const RamDb&) = delete;
     RamDb& operator=(RamDb&&) = delete;
 
-    static fs::path GetTimeFilePath(const fs::path& path);
+    static fs::path GetGenerationFilePath(const fs::path& path);
     static RamDb& GetCached(DbKinds db_kind_, const fs::path& path, bool is_system);
+    /// Flushes pending writes of all the cached instances.
+    static void FlushAll();
 
     static RamDb& GetCached(DbKinds db_kind_,
                             const fs::path& path,
@@ -99,6 +117,9 @@ public:
     bool RemoveRecord(const std::string& key);
     bool Remove(const std::string& key, const std::string& id);
 
+    /// Writes the pending changes to the db file. Does nothing unless in write-behind mode.
+    bool Flush();
+
     template <class T>
     inline bool Remove(const T& problem_config, const std::string& id)
     {
@@ -133,16 +154,65 @@ private:
         std::string content;
     };
 
-    ramdb_clock::time_point file_read_time;
-    std::map<std::string, CacheItem> cache;
+    using Cache = std::map<std::string, CacheItem>;
+
+    struct Snapshot
+    {
+        std::uint64_t generation = 0;
+        std::shared_ptr<const Cache> cache = std::make_shared<const Cache>();
+        /// Writes made on top of the cache, none marks a removal. Kept apart to only copy them
+        /// on the next write and merged into the cache once there are too many.
+        std::map<std::string, boost::optional<CacheItem>> changes;
+    };
 
-    boost::optional<miopen::DbRecord> FindRecordUnsafe(const std::string& problem);
+    /// Published with std::atomic_load/std::atomic_store and never modified in place.
+    std::shared_ptr<const Snapshot> snapshot;
+    /// Used when the generation file can't be mapped, then only this process is tracked.
+    std::atomic<std::uint64_t> local_generation{0};
+    std::shared_ptr<void> generation_storage;
+    std::atomic<std::uint64_t>* generation = &local_generation;
+
+    /// Latest not yet flushed change of a record.
+    struct PendingWrite
+    {
+        /// Merge with the record in the file instead of replacing it.
+        bool is_merge;
+        bool is_removal;
+        std::string content;
+    };
 
-    bool ValidateUnsafe();
+    const bool write_behind;
+    /// Guards all the members below, taken before the file lock when both are needed.
+    std::mutex pending_mutex;
+    std::atomic<bool> has_pending{false};
+    std::map<std::string, PendingWrite> pending;
+    std::chrono::steady_clock::time_point first_pending_time;
+    std::unique_ptr<std::ostream> journal;
+    std::shared_ptr<void> journal_lock;
+    fs::path journal_path;
+
+    static std::string GetContent(const DbRecord& record);
+    std::shared_ptr<const Snapshot> GetSnapshot() const;
+    std::shared_ptr<const Snapshot> GetActualSnapshotUnsafe();
+    boost::optional<miopen::DbRecord> FindActualRecord(const std::string& problem);
+    boost::optional<miopen::DbRecord> FindRecord(const Snapshot& from,
+                                                 const std::string& problem) const;
+
+    boost::optional<DbRecord> FindLatestRecordUnsafe(const std::string& key);
+    bool EnqueueUnsafe(const std::string& key, PendingWrite write);
+    bool FlushPendingUnsafe();
+    void OpenJournalUnsafe();
+    void CloseJournalUnsafe();
+    void ReplayJournalsUnsafe();
+
+    void MapGeneration();
+    bool IsActual(const Snapshot* from) const;
     void Prefetch();
+    void CommitUnsafe();
 
 #if MIOPEN_DB_CACHE_WRITE_THROUGH
-    void UpdateCacheEntryUnsafe(const DbRecord& record);
+    template <class TModifier>
+    void UpdateCacheUnsafe(const std::shared_ptr<const Snapshot>& from, TModifier&& modifier);
 #endif
 };
 
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_READONLY_BINARY_DB_HPP_
+#define GUARD_MIOPEN_READONLY_BINARY_DB_HPP_
+
+#include <miopen/binary_db_format.hpp>
+#include <miopen/db_record.hpp>
+#include <miopen/filesystem.hpp>
+
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <string>
+
+namespace miopen {
+
+/// Read-only system db backed by the precompiled image produced by txt2bdb from the text db.
+/// The image is looked for next to the text db as "<db>.bin" and is used in place, thus
+/// loading costs a single mapping and a lookup costs a couple of hashes.
+class MIOPEN_INTERNALS_EXPORT ReadonlyBinaryDb
+{
+public:
+    ReadonlyBinaryDb(DbKinds db_kind_, const fs::path& path) : db_kind(db_kind_), db_path(path) {}
+
+    static ReadonlyBinaryDb&
+    GetCached(DbKinds db_kind_, const fs::path& path, bool warn_if_unreadable);
+
+    static fs::path GetImagePath(const fs::path& path) { return path + ".bin"; }
+
+    boost::optional<DbRecord> FindRecord(const std::string& problem) const;
+
+    template <class TProblem>
+    boost::optional<DbRecord> FindRecord(const TProblem& problem) const
+    {
+        const auto key = DbRecord::SerializeKey(db_kind, problem);
+        return FindRecord(key);
+    }
+
+    template <class TProblem, class TValue>
+    bool Load(const TProblem& problem, const std::string& id, TValue& value) const
+    {
+        const auto record = FindRecord(problem);
+        if(!record)
+            return false;
+        return record->GetValues(id, value);
+    }
+
+    std::size_t GetSize() const { return view.header != nullptr ? view.header->record_count : 0; }
+
+private:
+    DbKinds db_kind;
+    fs::path db_path;
+    /// Owns the memory which is referenced by the view.
+    std::shared_ptr<const void> storage;
+    binary_db::View view;
+
+    void Prefetch(bool warn_if_unreadable);
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_READONLY_BINARY_DB_HPP_
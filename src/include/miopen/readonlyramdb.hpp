@@ -31,8 +31,10 @@
 
 #include <boost/optional.hpp>
 
+#include <memory>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <sstream>
 
 namespace miopen {
@@ -41,6 +43,9 @@ namespace debug {
 MIOPEN_INTERNALS_EXPORT bool& rordb_embed_fs_override();
 } // namespace debug
 
+/// Keys and contents in the cache are views into the db file, which is mapped into memory
+/// read-only, so the pages are shared by all the processes which use the same system db. With
+/// MIOPEN_EMBED_DB they point directly into the embedded data.
 class MIOPEN_INTERNALS_EXPORT ReadonlyRamDb
 {
 public:
@@ -62,7 +67,7 @@ public:
         MIOPEN_LOG_I2("Key match: " << problem);
         MIOPEN_LOG_I2("Contents found: " << it->second.content);
 
-        if(!record.ParseContents(it->second.content))
+        if(!record.ParseContents(std::string{it->second.content}))
         {
             MIOPEN_LOG_E("Error parsing payload under the key: "
                          << problem << " form file " << db_path << "#" << it->second.line);
@@ -92,15 +97,17 @@ public:
     struct CacheItem
     {
         int line;
-        std::string content;
+        std::string_view content;
     };
 
-    const std::unordered_map<std::string, CacheItem>& GetCacheMap() const { return cache; }
+    const std::unordered_map<std::string_view, CacheItem>& GetCacheMap() const { return cache; }
 
 private:
     DbKinds db_kind;
     fs::path db_path;
-    std::unordered_map<std::string, CacheItem> cache;
+    /// Owns the memory which is referenced by the cache.
+    std::shared_ptr<const void> storage;
+    std::unordered_map<std::string_view, CacheItem> cache;
 
     ReadonlyRamDb(const ReadonlyRamDb&) = default;
     ReadonlyRamDb(ReadonlyRamDb&&)      = default;
@@ -108,7 +115,8 @@ private:
     ReadonlyRamDb& operator=(ReadonlyRamDb&&) = default;
 
     void Prefetch(bool warn_if_unreadable);
-    void ParseAndLoadDb(std::istream& input_stream, bool warn_if_unreadable);
+    void ParseAndLoadDb(std::string_view data);
+    bool MapFile();
 };
 
 } // namespace miopen
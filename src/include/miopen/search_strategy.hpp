@@ -0,0 +1,189 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+
+#include <miopen/config.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace miopen {
+namespace solver {
+namespace search {
+
+/// How GenericSearch walks through the performance configs of a solver.
+enum class Strategy
+{
+    /// Measures the configs in random order once, and averages a few more runs of those that
+    /// come within 5% of the best.
+    Random,
+    /// Measures every config once, then re-measures the best 1/reduction of them with more
+    /// runs, and so on, so that jitter of single runs does not decide the winner.
+    SuccessiveHalving,
+    /// Measures a random sample of configs, then those a nearest neighbor model of the
+    /// measured ones predicts to be the fastest. Meant to be used with patience.
+    ModelGuided,
+};
+
+MIOPEN_INTERNALS_EXPORT std::ostream& operator<<(std::ostream& stream, Strategy strategy);
+/// Accepts "random", "halving" and "model", nothing if the name is unknown.
+MIOPEN_INTERNALS_EXPORT std::optional<Strategy> ParseStrategy(std::string_view name);
+
+struct Options
+{
+    Strategy strategy = Strategy::Random;
+    /// The search ends once this many candidates in a row did not improve the best time.
+    /// 0 never ends it early.
+    std::size_t patience = 0;
+    /// The final number of runs averaged for the candidates that look promising.
+    std::size_t max_runs = 5;
+    /// SuccessiveHalving keeps the best 1/reduction of the candidates each round.
+    std::size_t reduction = 3;
+    /// ModelGuided measures this many candidates before it relies on the model, 0 picks a
+    /// number from the count of candidates.
+    std::size_t warmup = 0;
+    /// ModelGuided predicts from this many nearest measured candidates.
+    std::size_t neighbors = 3;
+};
+
+struct Trial
+{
+    std::size_t candidate;
+    std::size_t runs;
+};
+
+/// Runs the candidate the given number of times and returns the average time, nothing if it
+/// failed. GenericSearch benchmarks the kernels on the GPU, tests and benchmarks of the
+/// strategies use a model of the timings.
+using TimingOracle = std::function<std::optional<float>(std::size_t candidate, std::size_t runs)>;
+
+/// Decides which candidate to measure next from the times of the previous ones. Candidates are
+/// the indices of the configs, in the order the configs are given. Not synchronized.
+class MIOPEN_INTERNALS_EXPORT SearchStrategy
+{
+public:
+    virtual ~SearchStrategy() = default;
+
+    /// The next measurement, nothing when the search is over.
+    virtual std::optional<Trial> Next() = 0;
+    /// Like Next, but may take a candidate that is ready, compiled, ahead of the ones that are
+    /// not, where the order makes little difference to the strategy.
+    virtual std::optional<Trial> Next(const std::vector<bool>& /*ready*/) { return Next(); }
+    /// Has to be called with the result of each trial returned by Next before the next call.
+    virtual void Report(const Trial& trial, std::optional<float> time) = 0;
+    /// Up to max candidates the strategy expects to measure next, first the most likely ones.
+    /// Used to compile them ahead, so it is fine to guess.
+    virtual std::vector<std::size_t> Upcoming(std::size_t max) const = 0;
+
+    std::size_t Candidates() const { return candidates; }
+    std::optional<std::size_t> Best() const { return best; }
+    float BestTime() const { return best_time; }
+    std::size_t Trials() const { return trials; }
+    std::size_t Runs() const { return runs; }
+    std::size_t Failed() const { return failed; }
+
+protected:
+    SearchStrategy(std::size_t candidates_, std::size_t patience_)
+        : candidates(candidates_), patience(patience_)
+    {
+    }
+
+    /// Bookkeeping of each finished trial.
+    void Count(const Trial& trial, bool succeeded);
+    /// Ends a candidate, returns true if it is the new best.
+    bool Conclude(std::size_t candidate, std::optional<float> time);
+    bool OutOfPatience() const { return patience != 0 && stale >= patience; }
+    void ResetBest();
+
+private:
+    std::size_t candidates;
+    std::size_t patience;
+    std::size_t stale  = 0;
+    std::size_t trials = 0;
+    std::size_t runs   = 0;
+    std::size_t failed = 0;
+    std::optional<std::size_t> best;
+    float best_time = std::numeric_limits<float>::max();
+};
+
+/// features holds a vector of numbers per candidate that ModelGuided measures the distance
+/// between candidates with. The other strategies ignore it.
+MIOPEN_INTERNALS_EXPORT std::unique_ptr<SearchStrategy>
+MakeSearchStrategy(const Options& options,
+                   std::size_t candidates,
+                   std::vector<std::vector<double>> features = {});
+
+/// The numbers in the serialized form of a performance config, as features for ModelGuided.
+MIOPEN_INTERNALS_EXPORT std::vector<double> ParseFeatures(std::string_view serialized);
+
+struct Result
+{
+    std::optional<std::size_t> best;
+    float time;
+    std::size_t trials;
+    std::size_t runs;
+    std::size_t failed;
+};
+
+/// Runs the whole search on the calling thread.
+MIOPEN_INTERNALS_EXPORT Result Run(SearchStrategy& strategy, const TimingOracle& oracle);
+
+/// Shares a strategy between the thread that measures the candidates and the threads that
+/// compile them ahead. Each candidate is claimed once for compilation.
+class MIOPEN_INTERNALS_EXPORT Scheduler
+{
+public:
+    explicit Scheduler(std::unique_ptr<SearchStrategy> strategy_);
+
+    std::optional<Trial> Next();
+    void Report(const Trial& trial, std::optional<float> time);
+    /// Claims the next candidate to compile, nothing if there are none left for now.
+    std::optional<std::size_t> ClaimNext();
+    /// Claims the given candidate, false if it has already been claimed.
+    bool Claim(std::size_t candidate);
+    /// The candidate is compiled, Next prefers the ready ones.
+    void MarkReady(std::size_t candidate);
+
+    std::optional<std::size_t> Best() const;
+    float BestTime() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unique_ptr<SearchStrategy> strategy;
+    std::vector<bool> claimed;
+    std::vector<bool> ready;
+};
+
+} // namespace search
+} // namespace solver
+} // namespace miopen
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include <miopen/config.hpp>
+#include <miopen/env.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// Enables the evaluation of the solver predicates on the shared thread pool. Off by default: the
+/// workers do not set the device and stream of the handle, so the solvers which query them would
+/// not see the ones of the calling thread.
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_PARALLEL_APPLICABILITY)
+
+namespace miopen {
+
+/// Results of the solver predicates (IsApplicable, GetWorkspaceSize, GetWti) memoized by
+/// problem, so that repeated immediate mode calls on the same problem do not evaluate them again.
+///
+/// Holds at most capacity problems and drops the least recently used one when full. The
+/// predicates read environment variables, so everything is dropped once any of them is changed
+/// through miopen::env. Like the invoker cache, it belongs to a handle and is not synchronized.
+class MIOPEN_INTERNALS_EXPORT SolverApplicabilityCache
+{
+public:
+    struct Entry
+    {
+        bool applicable = false;
+        std::optional<std::size_t> workspace;
+        std::optional<float> wti;
+    };
+
+    // solver id -> results
+    using Results = std::unordered_map<uint64_t, Entry>;
+
+    /// The capacity is taken from MIOPEN_DEBUG_SOLVER_APPLICABILITY_CACHE_SIZE.
+    SolverApplicabilityCache();
+    explicit SolverApplicabilityCache(std::size_t capacity_);
+
+    /// Returns the results of the problem, empty if it is not known yet. The pointer is valid
+    /// until the next call. Returns nullptr if memoization is disabled with a capacity of 0.
+    Results* Get(std::string_view problem_key);
+
+    void Clear();
+    std::size_t Size() const { return lru.size(); }
+    std::size_t GetCapacity() const { return capacity; }
+
+private:
+    struct Item
+    {
+        std::string key;
+        Results results;
+    };
+
+    std::size_t capacity;
+    std::size_t env_updates;
+    // Most recently used first.
+    std::list<Item> lru;
+    // Views the keys owned by the items.
+    std::map<std::string_view, std::list<Item>::iterator> index;
+};
+
+} // namespace miopen
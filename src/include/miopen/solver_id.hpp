@@ -32,6 +32,8 @@
 #include <miopen/conv_algo_name.hpp>
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace miopen {
@@ -72,6 +74,8 @@ struct MIOPEN_INTERNALS_EXPORT Id
     Id(const char* str);
 
     std::string ToString() const;
+    /// The registered name, empty for the invalid ids. Unlike ToString(), does not allocate.
+    std::string_view GetName() const;
     AnySolver GetSolver() const;
     std::string GetAlgo(conv::Direction dir) const;
     miopenConvAlgorithm_t GetAlgo() const;
@@ -50,6 +50,8 @@
 
 #include <string>
 #include <chrono>
+#include <map>
+#include <memory>
 #include <unordered_map>
 
 MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_DISABLE_SQL_WAL)
@@ -204,6 +206,9 @@ public:
     int Retry(std::function<int()>) const;
     static int Retry(std::function<int()> f, fs::path filename);
     std::string ErrorMessage() const;
+    /// Number of statements the process has prepared, the ones reused from the statement cache
+    /// of their connection are not counted.
+    static std::size_t GetPreparedCount();
 };
 
 template <typename Derived>
@@ -292,7 +297,10 @@ public:
         }
     }
 
-    static Derived& GetCached(const fs::path& path, bool is_system);
+    /// Returns the instance of the process for the path, so that its connection and the
+    /// statements prepared on it are reused. MultiFileDb takes it instead of a new instance.
+    /// Instances are never destroyed, the calls below are serialized per instance.
+    static Derived& GetCached(DbKinds db_kind, const fs::path& path, bool is_system);
     // TODO: Fix this for the overhead of having fields per record
 
     inline auto CheckTableColumns(const std::string& tableName,
@@ -323,6 +331,7 @@ public:
         using Ret = decltype(reinterpret_cast<Derived*>(this)->FindRecordUnsafe(args...));
         if(!is_system && DisableUserDbFileIO)
             return Ret{};
+        const std::lock_guard<std::mutex> lock{mutex};
         return reinterpret_cast<Derived*>(this)->FindRecordUnsafe(args...);
     }
 
@@ -331,6 +340,7 @@ public:
     {
         if(!is_system && DisableUserDbFileIO)
             return true;
+        const std::lock_guard<std::mutex> lock{mutex};
         return reinterpret_cast<Derived*>(this)->RemoveRecordUnsafe(args...);
     }
 
@@ -339,6 +349,7 @@ public:
     {
         if(!is_system && DisableUserDbFileIO)
             return true;
+        const std::lock_guard<std::mutex> lock{mutex};
         return reinterpret_cast<Derived*>(this)->StoreRecordUnsafe(args...);
     }
 
@@ -347,6 +358,7 @@ public:
     {
         if(!is_system && DisableUserDbFileIO)
             return true;
+        const std::lock_guard<std::mutex> lock{mutex};
         return reinterpret_cast<Derived*>(this)->RemoveUnsafe(args...);
     }
 
@@ -356,6 +368,7 @@ public:
         using Ret = decltype(reinterpret_cast<Derived*>(this)->UpdateUnsafe(args...));
         if(!is_system && DisableUserDbFileIO)
             return Ret{};
+        const std::lock_guard<std::mutex> lock{mutex};
         return reinterpret_cast<Derived*>(this)->UpdateUnsafe(args...);
     }
 
@@ -364,6 +377,7 @@ public:
     {
         if(!is_system && DisableUserDbFileIO)
             return false;
+        const std::lock_guard<std::mutex> lock{mutex};
         return reinterpret_cast<Derived*>(this)->LoadUnsafe(args...);
     }
 
@@ -371,24 +385,29 @@ public:
     bool dbInvalid;
     SQLite sql;
     bool is_system;
+
+protected:
+    // The connection is shared by the threads using the instance of GetCached(). A transaction
+    // belongs to the connection, so the statements of one call must not interleave with another.
+    std::mutex mutex;
 };
 
 template <typename Derived>
-Derived& SQLiteBase<Derived>::GetCached(const fs::path& path, bool is_system)
+Derived& SQLiteBase<Derived>::GetCached(DbKinds db_kind, const fs::path& path, bool is_system)
 {
     // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-    static std::mutex mutex;
-    const std::lock_guard<std::mutex> lock{mutex};
+    static std::mutex instances_mutex;
+    const std::lock_guard<std::mutex> lock{instances_mutex};
 
     // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-    static auto instances = std::map<fs::path, Derived>{};
+    static auto instances = std::map<fs::path, std::unique_ptr<Derived>>{};
     const auto it         = instances.find(path);
 
     if(it != instances.end())
-        return it->second;
+        return *it->second;
 
-    instances.emplace(path, Derived{path, is_system});
-    return instances.at(path);
+    return *instances.emplace(path, std::make_unique<Derived>(db_kind, path, is_system))
+                .first->second;
 }
 
 class SQLitePerfDb : public SQLiteBase<SQLitePerfDb>
@@ -522,8 +541,9 @@ public:
             "WHERE config IN ("
             "SELECT id FROM config WHERE ( "
             + clause + " ) )"
-            "AND solver == '" +  id + "' ;";
+            "AND solver == ? ;";
         // clang-format on
+        values.push_back(id);
         auto stmt = SQLite::Statement{sql, query, values};
         auto rc   = stmt.Step(sql);
         if(rc == SQLITE_DONE)
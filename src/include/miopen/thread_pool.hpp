@@ -0,0 +1,118 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#ifndef GUARD_MIOPEN_THREAD_POOL_HPP_
+#define GUARD_MIOPEN_THREAD_POOL_HPP_
+
+#include <miopen/config.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace miopen {
+
+/// Worker threads that live as long as the pool, so that parallel loops and background tasks on
+/// the host do not start threads of their own.
+///
+/// Each worker has a deque of tasks. Tasks submitted from a worker go to its own deque and
+/// others go round-robin. A worker runs the newest task of its own deque first, and steals the
+/// oldest one of another deque when its own is empty. The workers are started on first use and
+/// again in the child after a fork, which does not inherit them.
+class MIOPEN_INTERNALS_EXPORT ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// The pool shared by the library. MIOPEN_THREAD_POOL_SIZE sets its number of workers, by
+    /// default one per hardware thread but the calling one.
+    static ThreadPool& Shared();
+
+    std::size_t GetWorkerCount() const { return workers.size(); }
+
+    /// Calls f(i) for each i in [0, n) on at most max_threads threads, the calling one included,
+    /// and returns when all calls are done. The calling thread takes part, so loops may be
+    /// nested. The first exception thrown by f is rethrown here once the loop is done.
+    void ParallelFor(std::size_t n,
+                     const std::function<void(std::size_t)>& f,
+                     std::size_t max_threads = std::numeric_limits<std::size_t>::max());
+
+    /// Runs the task on a worker, or right away if the pool has none. The future holds what the
+    /// task threw.
+    std::future<void> Submit(std::function<void()> task);
+
+    /// Runs the task on a worker, or on a thread of its own if the pool has none. Unlike
+    /// Submit(), the task never runs on the calling thread, so it may wait for the caller.
+    std::future<void> Spawn(std::function<void()> task);
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct Loop;
+
+    void Push(Task task);
+    bool TryRunOne(std::size_t self);
+    void Work(std::size_t self);
+    void StartUnsafe();
+    void Stop();
+
+    static void BeforeFork();
+    static void AfterForkInParent();
+    static void AfterForkInChild();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> next_worker{0};
+    // Tasks in the deques.
+    std::atomic<std::size_t> pending{0};
+
+    std::mutex mutex;
+    std::condition_variable has_work;
+    bool started  = false;
+    bool stopping = false;
+    std::vector<std::thread> threads;
+};
+
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_THREAD_POOL_HPP_
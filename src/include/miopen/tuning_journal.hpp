@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+
+#include <miopen/config.hpp>
+#include <miopen/db_record.hpp>
+#include <miopen/filesystem.hpp>
+#include <miopen/lock_file.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace miopen {
+namespace solver {
+
+/// Journal of the trials of a tuning search, so that a search that was interrupted does not
+/// measure them again when it is restarted.
+///
+/// There is one per solver, problem and device, in the "tuning" directory of the user db. Every
+/// trial is appended as "runs:config=time;" and flushed right away, failed ones have the time
+/// "failed". A line without the final ';' was cut short and is ignored, and the next trial starts
+/// on a line of its own. The first line is the problem key, to rule out collisions of the file
+/// names. The journal is removed once the result of the search is written to the perf db.
+///
+/// A journal is locked while it is open. A search which finds it locked by another process, or
+/// by another handle of this one, runs without a journal.
+///
+/// Disabled with the user db, or by MIOPEN_DEBUG_TUNING_JOURNAL=0.
+class MIOPEN_INTERNALS_EXPORT TuningJournal
+{
+public:
+    TuningJournal(const std::string& arch,
+                  const std::string& solver_id,
+                  const std::string& problem_key);
+
+    /// The result recorded for the trial, nothing if it is not in the journal. The inner
+    /// optional is empty if the trial failed.
+    std::optional<std::optional<float>> Find(const std::string& config, std::size_t runs) const;
+    void Record(const std::string& config, std::size_t runs, std::optional<float> time);
+    /// Closes and removes the file, nothing is recorded afterwards.
+    void Remove();
+
+    bool IsEnabled() const { return !path.empty(); }
+    std::size_t Size() const { return trials.size(); }
+    const fs::path& GetPath() const { return path; }
+
+    /// Empty if journals are disabled.
+    static fs::path GetPath(const std::string& arch,
+                            const std::string& solver_id,
+                            const std::string& problem_key);
+    static void Remove(const std::string& arch,
+                       const std::string& solver_id,
+                       const std::string& problem_key);
+
+private:
+    enum class LoadResult
+    {
+        OtherProblem, // Also if there is no file yet.
+        Complete,
+        CutShort, // The last line has no line break.
+    };
+
+    fs::path path;
+    std::unique_lock<LockFile> lock;
+    std::ofstream file;
+    std::map<std::pair<std::string, std::size_t>, std::optional<float>> trials;
+
+    LoadResult Load(const std::string& problem_key);
+};
+
+template <class Context, class Problem>
+TuningJournal
+OpenTuningJournal(const Context& context, const std::string& solver_id, const Problem& problem)
+{
+    return {context.GetStream().GetDbBasename(),
+            solver_id,
+            DbRecord{DbKinds::PerfDb, problem}.GetKey()};
+}
+
+template <class Context, class Problem>
+void RemoveTuningJournal(const Context& context,
+                         const std::string& solver_id,
+                         const Problem& problem)
+{
+    TuningJournal::Remove(context.GetStream().GetDbBasename(),
+                          solver_id,
+                          DbRecord{DbKinds::PerfDb, problem}.GetKey());
+}
+
+} // namespace solver
+} // namespace miopen
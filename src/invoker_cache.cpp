@@ -29,30 +29,31 @@
 
 namespace miopen {
 
-boost::optional<const Invoker&> InvokerCache::operator[](const Key& key) const
+boost::optional<const Invoker&> InvokerCache::Find(const NetworkConfig& network_config,
+                                                   std::string_view solver_id) const
 {
-    const auto item = invokers.find(key.first);
+    const auto item = invokers.find(network_config);
     if(item == invokers.end())
         return boost::none;
     const auto& item_invokers = item->second.invokers;
-    const auto invoker        = item_invokers.find(key.second);
+    const auto invoker        = item_invokers.find(solver_id);
     if(invoker == item_invokers.end())
         return boost::none;
     return invoker->second;
 }
 
-boost::optional<const Invoker&> InvokerCache::GetFound1_0(const std::string& network_config,
-                                                          const std::string& algorithm) const
+boost::optional<const Invoker&> InvokerCache::GetFound1_0(const NetworkConfig& network_config,
+                                                          std::string_view algorithm) const
 {
     const auto item = invokers.find(network_config);
     if(item == invokers.end())
     {
-        MIOPEN_LOG_I2("No invokers found for " << network_config);
+        MIOPEN_LOG_I2("No invokers found for " << network_config.ToString());
         return boost::none;
     }
     if(item->second.found_1_0.empty())
     {
-        MIOPEN_LOG_I2("Invokers found for " << network_config
+        MIOPEN_LOG_I2("Invokers found for " << network_config.ToString()
                                             << " but there is no find 1.0 result.");
         return boost::none;
     }
@@ -62,31 +63,32 @@ boost::optional<const Invoker&> InvokerCache::GetFound1_0(const std::string& net
     if(found_1_0_id == found_1_0_ids.end())
     {
         MIOPEN_LOG_I2("Invokers found for "
-                      << network_config << " but there is no one with an algorithm " << algorithm);
+                      << network_config.ToString()
+                      << " but there is no one with an algorithm " << algorithm);
         return boost::none;
     }
     const auto invoker = item_invokers.find(found_1_0_id->second);
     if(invoker == item_invokers.end())
     {
         MIOPEN_THROW("No invoker with solver_id of " + found_1_0_id->second +
-                     " was registered for " + network_config);
+                     " was registered for " + network_config.ToString());
     }
     return invoker->second;
 }
 
 boost::optional<const std::string&>
-InvokerCache::GetFound1_0SolverId(const std::string& network_config,
-                                  const std::string& algorithm) const
+InvokerCache::GetFound1_0SolverId(const NetworkConfig& network_config,
+                                  std::string_view algorithm) const
 {
     const auto item = invokers.find(network_config);
     if(item == invokers.end())
     {
-        MIOPEN_LOG_I2("No invokers found for " << network_config);
+        MIOPEN_LOG_I2("No invokers found for " << network_config.ToString());
         return boost::none;
     }
     if(item->second.found_1_0.empty())
     {
-        MIOPEN_LOG_I2("Invokers found for " << network_config
+        MIOPEN_LOG_I2("Invokers found for " << network_config.ToString()
                                             << " but there is no find 1.0 result.");
         return boost::none;
     }
@@ -95,7 +97,8 @@ InvokerCache::GetFound1_0SolverId(const std::string& network_config,
     if(found_1_0_id == found_1_0_ids.end())
     {
         MIOPEN_LOG_I2("Invokers found for "
-                      << network_config << " but there is no one with an algorithm " << algorithm);
+                      << network_config.ToString()
+                      << " but there is no one with an algorithm " << algorithm);
         return boost::none;
     }
     return found_1_0_id->second;
@@ -113,16 +116,17 @@ void InvokerCache::Register(const Key& key, const Invoker& invoker)
         auto& item = invokers.insert({key.first, Item{}}).first->second;
         item.invokers.insert({key.second, invoker});
     }
-    MIOPEN_LOG_I2("Invoker registered for algorithm " << key.first << " and solver " << key.second);
+    MIOPEN_LOG_I2("Invoker registered for algorithm " << key.first.ToString() << " and solver "
+                                                        << key.second);
 }
 
-void InvokerCache::SetAsFound1_0(const std::string& network_config,
+void InvokerCache::SetAsFound1_0(const NetworkConfig& network_config,
                                  const std::string& algorithm,
                                  const std::string& solver_id)
 {
     const auto item = invokers.find(network_config);
     if(item == invokers.end())
-        MIOPEN_THROW("No invoker was registered for " + network_config);
+        MIOPEN_THROW("No invoker was registered for " + network_config.ToString());
 
     {
         // Validating at find time
@@ -131,13 +135,13 @@ void InvokerCache::SetAsFound1_0(const std::string& network_config,
         if(invoker == item_invokers.end())
         {
             MIOPEN_THROW("No invoker with solver_id of " + solver_id + " was registered for " +
-                         network_config);
+                         network_config.ToString());
         }
     }
 
     item->second.found_1_0[algorithm] = solver_id;
     MIOPEN_LOG_I2("Solver " << solver_id << " registered as find 1.0 best for " << algorithm
-                            << " in " << network_config);
+                            << " in " << network_config.ToString());
 }
 
 } // namespace miopen
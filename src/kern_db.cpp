@@ -25,11 +25,76 @@
  *******************************************************************************/
 #include "miopen/bz2.hpp"
 #include <miopen/kern_db.hpp>
+#include <miopen/kernel_shm_cache.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 namespace miopen {
+
+namespace {
+// Entries used within this many seconds are not touched again, so that most of the loads do
+// not write to the database. That is the precision of the LRU eviction.
+constexpr int64_t access_granularity = 60 * 60;
+constexpr const char* now_query      = "CAST(strftime('%s', 'now') AS INTEGER)";
+
+/// What the constructor has found out about a user database file. The later instances of the
+/// same file skip the schema checks and updates. A file which is removed and created again is a
+/// new file. The system databases are read-only and only checked, and are cached by GetCached().
+struct KernDbLayout
+{
+    bool content_addressed;
+    bool has_codec_column;
+    bool track_access;
+};
+
+class KernDbLayouts
+{
+public:
+    static std::string MakeKey(const fs::path& path)
+    {
+        return path.string() + ":" + GetFileIdentity(path);
+    }
+
+    boost::optional<KernDbLayout> Find(const std::string& key)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const auto it = layouts.find(key);
+        if(it == layouts.end())
+            return boost::none;
+        return it->second;
+    }
+
+    void Insert(const std::string& key, const KernDbLayout& layout)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        layouts.insert_or_assign(key, layout);
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, KernDbLayout> layouts;
+};
+
+KernDbLayouts& GetKernDbLayouts()
+{
+    static KernDbLayouts layouts;
+    return layouts;
+}
+} // namespace
+
 KernDb::KernDb(DbKinds db_kind, const fs::path& filename_, bool is_system_)
+    : KernDb(db_kind, filename_, is_system_, GetDefaultKernelCodec())
+{
+}
+
+KernDb::KernDb(DbKinds db_kind, const fs::path& filename_, bool is_system_, KernelCodec codec_)
     : KernDb(db_kind, filename_, is_system_, compress, decompress)
 {
+    codec = codec_;
 }
 
 KernDb::KernDb(
@@ -53,8 +118,23 @@ KernDb::KernDb(
             MIOPEN_LOG_I(filename << " database invalid");
         return;
     }
+
+    const auto layout_key = is_system ? std::string{} : KernDbLayouts::MakeKey(filename);
+    if(!is_system)
+    {
+        if(const auto layout = GetKernDbLayouts().Find(layout_key))
+        {
+            content_addressed = layout->content_addressed;
+            has_codec_column  = layout->has_codec_column;
+            track_access      = layout->track_access;
+            return;
+        }
+    }
+
     if(!is_system)
     {
+        // Lets the file shrink after eviction. Only has an effect on a new database.
+        sql.Exec("PRAGMA auto_vacuum = INCREMENTAL;");
         const std::string create_table = KernelConfig::CreateQuery();
         sql.Exec(create_table);
         MIOPEN_LOG_I2("Database created successfully");
@@ -66,7 +146,480 @@ KernDb::KernDb(
            << filename;
         MIOPEN_LOG_W(ss.str());
         dbInvalid = true;
+        return;
+    }
+
+    content_addressed = !CheckTableColumns(KernelConfig::table_name(), {"kernel_blob"});
+    if(!content_addressed)
+    {
+        has_codec_column = CheckTableColumns(KernelConfig::table_name(), {"codec"});
+        if(!is_system && !Migrate())
+        {
+            dbInvalid = true;
+            return;
+        }
+    }
+
+    if(!is_system)
+    {
+        track_access = CheckTableColumns(KernelConfig::table_name(), {"last_access"});
+        if(!track_access)
+        {
+            // Fails if another process has added the column since it has been checked.
+            try
+            {
+                sql.Exec(KernelConfig::AddLastAccessQuery());
+            }
+            catch(const Exception&)
+            {
+            }
+            track_access = CheckTableColumns(KernelConfig::table_name(), {"last_access"});
+        }
+    }
+
+    if(!is_system)
+    {
+        GetKernDbLayouts().Insert(layout_key,
+                                  KernDbLayout{content_addressed, has_codec_column, track_access});
+    }
+}
+
+void KernDb::LoadDictionaries()
+{
+    dicts_loaded = true;
+    if(!CheckTableColumns(KernelConfig::DictTableName(), {"id", "dict"}))
+        return;
+    // The latest dictionary is used for the new rows.
+    auto stmt = SQLite::Statement{
+        sql, "SELECT id, dict FROM `" + KernelConfig::DictTableName() + "` ORDER BY rowid;"};
+    while(stmt.Step(sql) == SQLITE_ROW)
+    {
+        dict_id        = static_cast<uint32_t>(stmt.ColumnInt64(0));
+        dicts[dict_id] = stmt.ColumnBlob(1);
+    }
+}
+
+bool KernDb::Migrate()
+{
+    MIOPEN_LOG_I("Converting " << filename << " to content-addressed kernel storage");
+    try
+    {
+        sql.Exec("BEGIN IMMEDIATE;");
+        // Another process may have converted the database while this one waited for the lock.
+        if(CheckTableColumns(KernelConfig::table_name(), {"kernel_blob"}))
+            sql.Exec(KernelConfig::MigrateQuery(has_codec_column));
+        sql.Exec("COMMIT;");
+    }
+    catch(const Exception& ex)
+    {
+        try
+        {
+            sql.Exec("ROLLBACK;");
+        }
+        catch(const Exception&)
+        {
+        }
+        MIOPEN_LOG_W("Unable to convert " << filename << ": " << ex.what());
+        return false;
+    }
+    content_addressed = true;
+    has_codec_column  = true;
+    return true;
+}
+
+bool KernDb::HasDictionary()
+{
+    if(!dicts_loaded && !filename.empty() && !dbInvalid)
+        LoadDictionaries();
+    return dict_id != 0;
+}
+
+void KernDb::ReloadDictionaries()
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    if(!filename.empty() && !dbInvalid)
+        LoadDictionaries();
+}
+
+std::vector<char> KernDb::CompressRow(const std::vector<char>& blob, KernelCodec& row_codec)
+{
+    if(row_codec == KernelCodec::Zstd && !dicts_loaded)
+        LoadDictionaries();
+    bool success     = false;
+    const auto* dict = dict_id != 0 ? &dicts.at(dict_id) : nullptr;
+    auto result      = row_codec == KernelCodec::Bz2
+                           ? compress_fn(blob, &success)
+                           : CompressBlob(row_codec, blob, &success, dict);
+    if(!success)
+        row_codec = KernelCodec::None;
+    return result;
+}
+
+std::vector<char> KernDb::DecompressRow(const std::vector<char>& blob,
+                                        int64_t uncompressed_size,
+                                        KernelCodec row_codec)
+{
+    // Blobs which did not shrink are stored as is with zero size, whatever the codec.
+    if(uncompressed_size == 0)
+        return blob;
+    if(row_codec == KernelCodec::Bz2)
+        return decompress_fn(blob, static_cast<unsigned int>(uncompressed_size));
+    // Another process may have trained a dictionary since this instance has read them.
+    const auto row_dict = GetKernelCodecFrameDictId(row_codec, blob);
+    if(row_dict != 0 && dicts.find(row_dict) == dicts.end())
+        LoadDictionaries();
+    return DecompressBlob(row_codec, blob, static_cast<std::size_t>(uncompressed_size), dicts);
+}
+
+boost::optional<std::string> KernDb::FindHash(const std::string& clause,
+                                              const std::vector<std::string>& values)
+{
+    auto stmt = SQLite::Statement{sql,
+                                  "SELECT kernel_hash FROM `" + KernelConfig::table_name() +
+                                      "` WHERE " + clause + ";",
+                                  values};
+    auto rc = stmt.Step(sql);
+    if(rc == SQLITE_ROW)
+        return stmt.ColumnText(0);
+    if(rc != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return boost::none;
+}
+
+std::size_t KernDb::RemoveBlobIfUnused(const std::string& hash)
+{
+    auto stmt = SQLite::Statement{sql,
+                                  "DELETE FROM `" + KernelConfig::BlobTableName() +
+                                      "` WHERE kernel_hash = ? AND NOT EXISTS (SELECT 1 FROM `" +
+                                      KernelConfig::table_name() + "` WHERE kernel_hash = ?);",
+                                  {hash, hash}};
+    if(stmt.Step(sql) != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return sql.Changes();
+}
+
+void KernDb::TouchKernel(const std::string& clause, const std::vector<std::string>& values)
+{
+    auto stmt = SQLite::Statement{sql,
+                                  "UPDATE `" + KernelConfig::table_name() + "` SET last_access = " +
+                                      now_query + " WHERE " + clause + ";",
+                                  values};
+    // Not worth failing a load.
+    if(stmt.Step(sql) != SQLITE_DONE)
+        MIOPEN_LOG_I2("Unable to update the access time: " << sql.ErrorMessage());
+}
+
+boost::optional<std::vector<char>> KernDb::FindKernel(const std::string& clause,
+                                                      const std::vector<std::string>& values)
+{
+    const auto select_query =
+        content_addressed
+            ? "SELECT b.kernel_blob, kernel_hash, b.uncompressed_size, b.codec, " +
+                  std::string{track_access ? "last_access" : "0"} + " FROM `" +
+                  KernelConfig::table_name() + "` JOIN `" + KernelConfig::BlobTableName() +
+                  "` AS b USING(kernel_hash) WHERE " + clause + ";"
+            : std::string{"SELECT kernel_blob, kernel_hash, uncompressed_size"} +
+                  (has_codec_column ? ", codec" : "") + " FROM `" + KernelConfig::table_name() +
+                  "` WHERE " + clause + ";";
+    auto stmt = SQLite::Statement{sql, select_query, values};
+    // only one result field
+    // assert one row
+    auto rc = stmt.Step(sql);
+    if(rc == SQLITE_ROW)
+    {
+        auto md5_hash  = stmt.ColumnText(1);
+        auto row_codec = has_codec_column ? static_cast<KernelCodec>(stmt.ColumnInt64(3))
+                                          : KernelCodec::Bz2;
+        auto decompressed_blob = DecompressRow(stmt.ColumnBlob(0), stmt.ColumnInt64(2), row_codec);
+        auto new_md5           = md5(decompressed_blob);
+        if(new_md5 != md5_hash)
+            MIOPEN_THROW(miopenStatusInternalError, "Possible database corruption");
+        if(track_access && stmt.ColumnInt64(4) < std::time(nullptr) - access_granularity)
+            TouchKernel(clause, values);
+        return decompressed_blob;
+    }
+    else if(rc == SQLITE_DONE)
+    {
+        return boost::none;
+    }
+    else
+    {
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    }
+    return boost::none;
+}
+
+void KernDb::StoreKernel(const std::string& clause,
+                         const std::vector<std::string>& values,
+                         const fs::path& kernel_name,
+                         const std::string& kernel_args,
+                         const std::vector<char>& kernel_blob)
+{
+    if(!content_addressed)
+        MIOPEN_THROW(miopenStatusInternalError, filename.string() + " is read-only");
+
+    const auto md5_sum = md5(kernel_blob);
+
+    // Identical code objects built from different sources or options are stored once,
+    // and are not even compressed again.
+    const auto blob_exists = [&]() {
+        auto stmt = SQLite::Statement{sql,
+                                      "SELECT 1 FROM `" + KernelConfig::BlobTableName() +
+                                          "` WHERE kernel_hash = ?;",
+                                      {md5_sum}};
+        const auto rc = stmt.Step(sql);
+        if(rc != SQLITE_ROW && rc != SQLITE_DONE)
+            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        return rc == SQLITE_ROW;
+    };
+
+    auto row_codec       = codec;
+    auto compressed_blob = boost::optional<std::vector<char>>{};
+    // The compression is done before the transaction, so that the other processes do not wait
+    // for it. The blob may still be gone by the time the transaction starts.
+    if(!blob_exists())
+        compressed_blob = CompressRow(kernel_blob, row_codec);
+
+    sql.Exec("BEGIN IMMEDIATE;");
+    try
+    {
+        if(!compressed_blob && !blob_exists())
+            compressed_blob = CompressRow(kernel_blob, row_codec);
+
+        if(compressed_blob)
+        {
+            auto stmt = SQLite::Statement{
+                sql,
+                "INSERT OR IGNORE INTO `" + KernelConfig::BlobTableName() +
+                    "`(kernel_hash, kernel_blob, uncompressed_size, codec) VALUES(?, ?, ?, ?);"};
+            stmt.BindText(1, md5_sum);
+            if(row_codec == KernelCodec::None)
+            {
+                stmt.BindBlob(2, kernel_blob);
+                stmt.BindInt64(3, 0);
+            }
+            else
+            {
+                stmt.BindBlob(2, *compressed_blob);
+                stmt.BindInt64(3, kernel_blob.size());
+            }
+            stmt.BindInt64(4, static_cast<int64_t>(row_codec));
+            if(stmt.Step(sql) != SQLITE_DONE)
+                MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        }
+
+        const auto old_hash = FindHash(clause, values);
+        auto stmt           = SQLite::Statement{
+            sql,
+            "INSERT OR REPLACE INTO `" + KernelConfig::table_name() +
+                (track_access ? "`(kernel_name, kernel_args, kernel_hash, last_access) "
+                                "VALUES(?, ?, ?, " +
+                                    std::string{now_query} + ");"
+                              : "`(kernel_name, kernel_args, kernel_hash) VALUES(?, ?, ?);")};
+        stmt.BindPath(1, kernel_name);
+        stmt.BindText(2, kernel_args);
+        stmt.BindText(3, md5_sum);
+        if(stmt.Step(sql) != SQLITE_DONE)
+            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+
+        if(old_hash && *old_hash != md5_sum)
+            RemoveBlobIfUnused(*old_hash);
+        sql.Exec("COMMIT;");
+    }
+    catch(const Exception&)
+    {
+        sql.Exec("ROLLBACK;");
+        throw;
+    }
+}
+
+void KernDb::RemoveKernel(const std::string& clause, const std::vector<std::string>& values)
+{
+    sql.Exec("BEGIN IMMEDIATE;");
+    try
+    {
+        const auto hash = content_addressed ? FindHash(clause, values) : boost::none;
+        auto stmt       = SQLite::Statement{
+            sql, "DELETE FROM `" + KernelConfig::table_name() + "` WHERE " + clause + ";", values};
+        if(stmt.Step(sql) != SQLITE_DONE)
+            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        if(hash)
+            RemoveBlobIfUnused(*hash);
+        sql.Exec("COMMIT;");
+    }
+    catch(const Exception&)
+    {
+        sql.Exec("ROLLBACK;");
+        throw;
+    }
+}
+
+std::vector<std::vector<char>> KernDb::LoadBlobsUnsafe()
+{
+    auto blobs = std::vector<std::vector<char>>{};
+    if(filename.empty() || dbInvalid)
+        return blobs;
+    const auto query =
+        content_addressed
+            ? "SELECT kernel_blob, uncompressed_size, codec FROM `" +
+                  KernelConfig::BlobTableName() + "`;"
+            : std::string{"SELECT kernel_blob, uncompressed_size"} +
+                  (has_codec_column ? ", codec" : "") + " FROM `" + KernelConfig::table_name() +
+                  "`;";
+    auto stmt = SQLite::Statement{sql, query};
+    int rc    = SQLITE_ROW;
+    while((rc = stmt.Step(sql)) == SQLITE_ROW)
+    {
+        auto row_codec =
+            has_codec_column ? static_cast<KernelCodec>(stmt.ColumnInt64(2)) : KernelCodec::Bz2;
+        blobs.push_back(DecompressRow(stmt.ColumnBlob(0), stmt.ColumnInt64(1), row_codec));
+    }
+    if(rc != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return blobs;
+}
+
+KernDbStats KernDb::GetStatsUnsafe()
+{
+    auto stats = KernDbStats{};
+    if(filename.empty() || dbInvalid)
+        return stats;
+    const auto kernels = KernelConfig::table_name();
+    const auto blobs   = KernelConfig::BlobTableName();
+    const auto query =
+        content_addressed
+            ? "SELECT (SELECT COUNT(*) FROM `" + kernels +
+                  "`), COUNT(*), IFNULL(SUM(LENGTH(kernel_blob)), 0), "
+                  "(SELECT IFNULL(SUM(LENGTH(b.kernel_blob)), 0) FROM `" +
+                  kernels + "` JOIN `" + blobs + "` AS b USING(kernel_hash)) FROM `" + blobs +
+                  "`;"
+            : "SELECT COUNT(*), COUNT(DISTINCT kernel_hash), IFNULL(SUM(LENGTH(kernel_blob)), 0), "
+              "IFNULL(SUM(LENGTH(kernel_blob)), 0) FROM `" +
+                  kernels + "`;";
+    auto stmt = SQLite::Statement{sql, query};
+    if(stmt.Step(sql) != SQLITE_ROW)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    stats.kernels              = stmt.ColumnInt64(0);
+    stats.blobs                = stmt.ColumnInt64(1);
+    stats.stored_bytes         = stmt.ColumnInt64(2);
+    stats.undeduplicated_bytes = stmt.ColumnInt64(3);
+    return stats;
+}
+
+std::vector<KernDbConsumer> KernDb::GetTopConsumersUnsafe(std::size_t count)
+{
+    auto consumers = std::vector<KernDbConsumer>{};
+    if(filename.empty() || dbInvalid || !content_addressed)
+        return consumers;
+    auto stmt = SQLite::Statement{
+        sql,
+        "SELECT kernel_name, COUNT(*), SUM(LENGTH(b.kernel_blob)), MAX(" +
+            std::string{track_access ? "last_access" : "0"} + ") FROM `" +
+            KernelConfig::table_name() + "` JOIN `" + KernelConfig::BlobTableName() +
+            "` AS b USING(kernel_hash) GROUP BY kernel_name ORDER BY 3 DESC LIMIT ?;"};
+    stmt.BindInt64(1, count);
+    int rc = SQLITE_ROW;
+    while((rc = stmt.Step(sql)) == SQLITE_ROW)
+    {
+        auto consumer        = KernDbConsumer{};
+        consumer.kernel_name = stmt.ColumnText(0);
+        consumer.kernels     = stmt.ColumnInt64(1);
+        consumer.bytes       = stmt.ColumnInt64(2);
+        consumer.last_access = stmt.ColumnInt64(3);
+        consumers.push_back(std::move(consumer));
     }
+    if(rc != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return consumers;
+}
+
+std::size_t KernDb::EvictUnsafe(std::size_t max_bytes)
+{
+    if(filename.empty() || dbInvalid || !track_access)
+        return 0;
+
+    auto stored = GetStatsUnsafe().stored_bytes;
+    if(stored <= max_bytes)
+        return 0;
+
+    // Evicting some headroom keeps the following stores from evicting again right away.
+    const auto target = max_bytes / 10 * 9;
+    auto evicted      = std::size_t{0};
+    auto freed        = std::size_t{0};
+    MIOPEN_LOG_I("Evicting from " << filename << ": " << stored << " bytes, limit " << max_bytes);
+
+    while(stored > target)
+    {
+        // A blob goes with the last of its entries.
+        auto victims = std::vector<std::tuple<int64_t, std::string, std::size_t>>{};
+        {
+            auto stmt = SQLite::Statement{sql,
+                                          "SELECT id, kernel_hash, LENGTH(b.kernel_blob) FROM `" +
+                                              KernelConfig::table_name() + "` JOIN `" +
+                                              KernelConfig::BlobTableName() +
+                                              "` AS b USING(kernel_hash) ORDER BY "
+                                              "last_access, id LIMIT 256;"};
+            while(stmt.Step(sql) == SQLITE_ROW)
+                victims.emplace_back(stmt.ColumnInt64(0), stmt.ColumnText(1), stmt.ColumnInt64(2));
+        }
+        if(victims.empty())
+            break;
+
+        sql.Exec("BEGIN IMMEDIATE;");
+        try
+        {
+            for(const auto& victim : victims)
+            {
+                auto stmt = SQLite::Statement{
+                    sql, "DELETE FROM `" + KernelConfig::table_name() + "` WHERE id = ?;"};
+                stmt.BindInt64(1, std::get<0>(victim));
+                if(stmt.Step(sql) != SQLITE_DONE)
+                    MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+                ++evicted;
+                if(RemoveBlobIfUnused(std::get<1>(victim)) != 0)
+                {
+                    freed += std::get<2>(victim);
+                    stored -= std::min(stored, std::get<2>(victim));
+                    if(stored <= target)
+                        break;
+                }
+            }
+            sql.Exec("COMMIT;");
+        }
+        catch(const Exception&)
+        {
+            sql.Exec("ROLLBACK;");
+            throw;
+        }
+    }
+
+    sql.Exec("PRAGMA incremental_vacuum;");
+    MIOPEN_LOG_I("Evicted " << evicted << " kernels, " << freed << " bytes from " << filename);
+    return evicted;
+}
+
+bool KernDb::TrainDictionaryUnsafe(std::size_t capacity)
+{
+    if(filename.empty() || dbInvalid || is_system || codec != KernelCodec::Zstd)
+        return false;
+
+    const auto dict = TrainKernelCodecDict(LoadBlobsUnsafe(), capacity);
+    const auto id   = GetKernelCodecDictId(dict);
+    if(id == 0)
+        return false;
+
+    auto stmt = SQLite::Statement{sql,
+                                  "INSERT OR REPLACE INTO `" + KernelConfig::DictTableName() +
+                                      "`(id, dict) VALUES(?, ?);"};
+    stmt.BindInt64(1, id);
+    stmt.BindBlob(2, dict);
+    if(stmt.Step(sql) != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+
+    dicts[id] = dict;
+    dict_id   = id;
+    MIOPEN_LOG_I2("Kernel db dictionary " << id << " of " << dict.size() << " bytes");
+    return true;
 }
 
 } // namespace miopen
@@ -45,29 +45,48 @@
 #include <miopen/logger.hpp>
 #include <miopen/stringutils.hpp>
 
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <utility>
 
 MIOPEN_DECLARE_ENV_VAR_STR(MIOPEN_DEVICE_ARCH)
 
 namespace miopen {
 
-const std::vector<Kernel>& KernelCache::GetKernels(const std::string& algorithm,
-                                                   const std::string& network_config)
+KernelCache::KernelKey::KernelKey(const std::string& algorithm_,
+                                  const std::string& network_config_)
+    : algorithm(algorithm_), network_config(network_config_)
 {
+    const auto a = std::hash<std::string>{}(algorithm);
+    const auto n = std::hash<std::string>{}(network_config);
+    hash         = a ^ (n + 0x9e3779b97f4a7c15 + (a << 6) + (a >> 2));
+}
 
-    std::pair<std::string, std::string> key = std::make_pair(algorithm, network_config);
+std::vector<Kernel>* KernelCache::FindKernels(const KernelKey& key)
+{
+    const auto range = kernel_map.equal_range(key.hash);
+    for(auto it = range.first; it != range.second; ++it)
+    {
+        if(it->second.algorithm == key.algorithm &&
+           it->second.network_config == key.network_config)
+            return &it->second.kernels;
+    }
+    return nullptr;
+}
 
-    const auto it = kernel_map.find(key);
-    if(it != kernel_map.end())
+const std::vector<Kernel>& KernelCache::GetKernels(const std::string& algorithm,
+                                                   const std::string& network_config)
+{
+    if(const auto* kernels = FindKernels({algorithm, network_config}))
     {
-        MIOPEN_LOG_I2(it->second.size()
-                      << " kernels for key: " << key.first << " \"" << key.second << '\"');
-        return it->second;
+        MIOPEN_LOG_I2(kernels->size()
+                      << " kernels for key: " << algorithm << " \"" << network_config << '\"');
+        return *kernels;
     }
 
     static const std::vector<Kernel> empty{};
-    MIOPEN_LOG_I2("0 kernels for key: " << key.first << " \"" << key.second << '\"');
+    MIOPEN_LOG_I2("0 kernels for key: " << algorithm << " \"" << network_config << '\"');
     return empty;
 }
 
@@ -102,9 +121,8 @@ Kernel KernelCache::AddKernel(const Handle& h,
                               std::size_t cache_index,
                               const std::string& kernel_src)
 {
-    const std::pair<std::string, std::string> key = std::make_pair(algorithm, network_config);
     if(!network_config.empty() || !algorithm.empty()) // Don't log only _empty_ keys.
-        MIOPEN_LOG_I2("Key: " << key.first << " \"" << key.second << '\"');
+        MIOPEN_LOG_I2("Key: " << algorithm << " \"" << network_config << '\"');
 
     Program program;
 
@@ -132,19 +150,32 @@ Kernel KernelCache::AddKernel(const Handle& h,
 
     if(!network_config.empty() && !algorithm.empty())
     {
-        this->AddKernel(key, kernel, cache_index);
+        this->AddKernel({algorithm, network_config}, kernel, cache_index);
     }
     return kernel;
 }
 
-void KernelCache::AddKernel(Key key, Kernel k, std::size_t cache_index)
+void KernelCache::AddKernel(const std::string& algorithm,
+                            const std::string& network_config,
+                            Kernel k,
+                            std::size_t cache_index)
 {
-    auto&& v = kernel_map[key];
-    if(cache_index >= v.size())
+    this->AddKernel({algorithm, network_config}, std::move(k), cache_index);
+}
+
+void KernelCache::AddKernel(const KernelKey& key, Kernel k, std::size_t cache_index)
+{
+    auto* v = FindKernels(key);
+    if(v == nullptr)
+    {
+        v = &kernel_map.emplace(key.hash, KernelEntry{key.algorithm, key.network_config, {}})
+                 ->second.kernels;
+    }
+    if(cache_index >= v->size())
     {
-        v.resize(cache_index + 1);
+        v->resize(cache_index + 1);
     }
-    v[cache_index] = k;
+    (*v)[cache_index] = k;
 }
 
 void KernelCache::ClearKernels(const std::string& algorithm, const std::string& network_config)
@@ -153,13 +184,13 @@ void KernelCache::ClearKernels(const std::string& algorithm, const std::string&
     {
         MIOPEN_THROW("Network config or algorithm empty.");
     }
-    const std::pair<std::string, std::string> key = std::make_pair(algorithm, network_config);
-    auto&& v                                      = this->kernel_map[key];
-    if(!v.empty())
+    auto* v = FindKernels({algorithm, network_config});
+    if(v != nullptr && !v->empty())
     {
-        MIOPEN_LOG_I2(v.size() << " kernels for key: " << key.first << " \"" << key.second << '\"');
+        MIOPEN_LOG_I2(v->size() << " kernels for key: " << algorithm << " \"" << network_config
+                                << '\"');
+        v->clear();
     }
-    v.clear();
 }
 
 KernelCache::KernelCache() {}
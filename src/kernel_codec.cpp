@@ -0,0 +1,295 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/kernel_codec.hpp>
+#include <miopen/bz2.hpp>
+#include <miopen/env.hpp>
+#include <miopen/errors.hpp>
+#include <miopen/logger.hpp>
+
+#if MIOPEN_USE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+#include <memory>
+#include <numeric>
+#include <tuple>
+
+MIOPEN_DECLARE_ENV_VAR_STR(MIOPEN_DEBUG_KERN_DB_CODEC)
+
+namespace miopen {
+
+#if MIOPEN_USE_ZSTD
+namespace {
+
+// Compression happens once per compiled kernel, while the decompression speed of zstd
+// barely depends on the level, so a slow level is affordable.
+constexpr int zstd_level = 12;
+
+struct ZstdDeleter
+{
+    void operator()(ZSTD_CCtx* p) const { ZSTD_freeCCtx(p); }
+    void operator()(ZSTD_DCtx* p) const { ZSTD_freeDCtx(p); }
+    void operator()(ZSTD_DDict* p) const { ZSTD_freeDDict(p); }
+};
+
+void CheckZstdError(std::size_t rc, const std::string& name)
+{
+    if(ZSTD_isError(rc) != 0u)
+        MIOPEN_THROW(miopenStatusInternalError, name + " failed: " + ZSTD_getErrorName(rc));
+}
+
+ZSTD_CCtx& GetCCtx()
+{
+    thread_local const auto ctx = std::unique_ptr<ZSTD_CCtx, ZstdDeleter>{ZSTD_createCCtx()};
+    return *ctx;
+}
+
+ZSTD_DCtx& GetDCtx()
+{
+    thread_local const auto ctx = std::unique_ptr<ZSTD_DCtx, ZstdDeleter>{ZSTD_createDCtx()};
+    return *ctx;
+}
+
+// Digesting a dictionary costs about as much as decompressing a small kernel, so the
+// digested ones are kept. The id is a hash of the dictionary content.
+const ZSTD_DDict& GetDDict(uint32_t id, const std::vector<char>& dict)
+{
+    thread_local auto ddicts =
+        std::unordered_map<uint32_t, std::unique_ptr<ZSTD_DDict, ZstdDeleter>>{};
+    auto& ddict = ddicts[id];
+    if(!ddict)
+        ddict.reset(ZSTD_createDDict(dict.data(), dict.size()));
+    if(!ddict)
+        MIOPEN_THROW(miopenStatusInternalError, "ZSTD_createDDict failed");
+    return *ddict;
+}
+
+std::vector<char> ZstdCompress(const std::vector<char>& v,
+                               bool* compressed,
+                               const std::vector<char>* dict)
+{
+    auto result = std::vector<char>(ZSTD_compressBound(v.size()));
+    const auto len =
+        dict == nullptr
+            ? ZSTD_compressCCtx(
+                  &GetCCtx(), result.data(), result.size(), v.data(), v.size(), zstd_level)
+            : ZSTD_compress_usingDict(&GetCCtx(),
+                                      result.data(),
+                                      result.size(),
+                                      v.data(),
+                                      v.size(),
+                                      dict->data(),
+                                      dict->size(),
+                                      zstd_level);
+    CheckZstdError(len, "ZSTD_compress");
+    if(compressed != nullptr && len >= v.size())
+    {
+        *compressed = false;
+        return v;
+    }
+    result.resize(len);
+    if(compressed != nullptr)
+        *compressed = true;
+    return result;
+}
+
+std::vector<char>
+ZstdDecompress(const std::vector<char>& v, std::size_t size, const KernelCodecDicts& dicts)
+{
+    auto result        = std::vector<char>(size);
+    const auto dict_id = ZSTD_getDictID_fromFrame(v.data(), v.size());
+    std::size_t len    = 0;
+
+    if(dict_id == 0)
+    {
+        len = ZSTD_decompressDCtx(&GetDCtx(), result.data(), result.size(), v.data(), v.size());
+    }
+    else
+    {
+        const auto dict = dicts.find(dict_id);
+        if(dict == dicts.end())
+        {
+            MIOPEN_THROW(miopenStatusInternalError,
+                         "Missing zstd dictionary " + std::to_string(dict_id));
+        }
+        len = ZSTD_decompress_usingDDict(&GetDCtx(),
+                                         result.data(),
+                                         result.size(),
+                                         v.data(),
+                                         v.size(),
+                                         &GetDDict(dict_id, dict->second));
+    }
+    CheckZstdError(len, "ZSTD_decompress");
+    result.resize(len);
+    return result;
+}
+
+} // namespace
+#endif
+
+std::string ToString(KernelCodec codec)
+{
+    switch(codec)
+    {
+    case KernelCodec::None: return "none";
+    case KernelCodec::Bz2: return "bz2";
+    case KernelCodec::Zstd: return "zstd";
+    }
+    return "unknown(" + std::to_string(static_cast<int64_t>(codec)) + ")";
+}
+
+bool IsCodecAvailable(KernelCodec codec)
+{
+    switch(codec)
+    {
+    case KernelCodec::None:
+    case KernelCodec::Bz2: return true;
+    case KernelCodec::Zstd: return MIOPEN_USE_ZSTD != 0;
+    }
+    return false;
+}
+
+KernelCodec GetDefaultKernelCodec()
+{
+    static const auto codec = []() {
+        const auto fallback = IsCodecAvailable(KernelCodec::Zstd) ? KernelCodec::Zstd
+                                                                   : KernelCodec::Bz2;
+        const auto& name    = env::value(MIOPEN_DEBUG_KERN_DB_CODEC);
+        if(name.empty())
+            return fallback;
+        for(auto candidate : {KernelCodec::None, KernelCodec::Bz2, KernelCodec::Zstd})
+        {
+            if(name == ToString(candidate) && IsCodecAvailable(candidate))
+                return candidate;
+        }
+        MIOPEN_LOG_W("Kernel db codec " << name << " is not available, using "
+                                        << ToString(fallback));
+        return fallback;
+    }();
+    return codec;
+}
+
+std::vector<char> CompressBlob(KernelCodec codec,
+                               const std::vector<char>& v,
+                               bool* compressed,
+                               const std::vector<char>* dict)
+{
+    switch(codec)
+    {
+    case KernelCodec::None: break;
+    case KernelCodec::Bz2: return compress(v, compressed);
+    case KernelCodec::Zstd:
+#if MIOPEN_USE_ZSTD
+        return ZstdCompress(v, compressed, dict);
+#else
+        std::ignore = dict;
+        break;
+#endif
+    }
+    if(compressed != nullptr)
+        *compressed = false;
+    return v;
+}
+
+std::vector<char> DecompressBlob(KernelCodec codec,
+                                 const std::vector<char>& v,
+                                 std::size_t size,
+                                 const KernelCodecDicts& dicts)
+{
+    switch(codec)
+    {
+    case KernelCodec::None: return v;
+    case KernelCodec::Bz2: return decompress(v, static_cast<unsigned int>(size));
+    case KernelCodec::Zstd:
+#if MIOPEN_USE_ZSTD
+        return ZstdDecompress(v, size, dicts);
+#else
+        std::ignore = dicts;
+        break;
+#endif
+    }
+    MIOPEN_THROW(miopenStatusInternalError,
+                 "Kernel codec " + ToString(codec) + " is not supported by this build");
+}
+
+std::vector<char> TrainKernelCodecDict(const std::vector<std::vector<char>>& samples,
+                                       std::size_t capacity)
+{
+#if MIOPEN_USE_ZSTD
+    auto buffer = std::vector<char>{};
+    auto sizes  = std::vector<std::size_t>{};
+    buffer.reserve(std::accumulate(
+        samples.begin(), samples.end(), std::size_t{0}, [](auto acc, const auto& sample) {
+            return acc + sample.size();
+        }));
+    sizes.reserve(samples.size());
+    for(const auto& sample : samples)
+    {
+        buffer.insert(buffer.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    auto dict      = std::vector<char>(capacity);
+    const auto len = ZDICT_trainFromBuffer(
+        dict.data(), dict.size(), buffer.data(), sizes.data(), static_cast<unsigned>(sizes.size()));
+    if(ZDICT_isError(len) != 0u)
+    {
+        MIOPEN_LOG_I("Kernel codec dictionary training failed: " << ZDICT_getErrorName(len));
+        return {};
+    }
+    dict.resize(len);
+    return dict;
+#else
+    std::ignore = samples;
+    std::ignore = capacity;
+    return {};
+#endif
+}
+
+uint32_t GetKernelCodecDictId(const std::vector<char>& dict)
+{
+#if MIOPEN_USE_ZSTD
+    return ZDICT_getDictID(dict.data(), dict.size());
+#else
+    std::ignore = dict;
+    return 0;
+#endif
+}
+
+uint32_t GetKernelCodecFrameDictId(KernelCodec codec, const std::vector<char>& v)
+{
+#if MIOPEN_USE_ZSTD
+    if(codec == KernelCodec::Zstd)
+        return ZSTD_getDictID_fromFrame(v.data(), v.size());
+#else
+    std::ignore = v;
+#endif
+    std::ignore = codec;
+    return 0;
+}
+
+} // namespace miopen
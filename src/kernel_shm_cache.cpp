@@ -0,0 +1,335 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/kernel_shm_cache.hpp>
+#include <miopen/binary_cache.hpp>
+#include <miopen/env.hpp>
+#include <miopen/logger.hpp>
+#include <miopen/md5.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_KERNEL_SHM_CACHE_MB)
+
+namespace miopen {
+
+namespace {
+
+constexpr uint64_t shm_magic      = 0x4d494f70656e4b43; // "MIOpenKC"
+constexpr uint32_t shm_version    = 2;
+constexpr std::size_t header_size = 64;
+
+enum SlotState : uint32_t
+{
+    SlotEmpty     = 0,
+    SlotWriting   = 1,
+    SlotReady     = 2,
+    SlotAbandoned = 3,
+};
+
+uint64_t HashKey(std::string_view key)
+{
+    // FNV-1a, 0 marks the empty slots.
+    auto hash = uint64_t{0xcbf29ce484222325};
+    for(const auto c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+struct KernelShmCache::Header
+{
+    /// Stored last by the creator, the rest of the header is valid once it is set.
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t data_capacity;
+    std::atomic<uint64_t> data_used;
+};
+
+struct KernelShmCache::Slot
+{
+    std::atomic<uint64_t> hash;
+    std::atomic<uint32_t> state;
+    /// The key is stored in front of the blob.
+    uint32_t key_size;
+    uint64_t offset;
+    uint64_t size;
+    /// md5 of the blob, checked by every Find() as the kernel db does.
+    char digest[32];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory needs address free atomics");
+
+#ifdef _WIN32
+KernelShmCache::KernelShmCache(const std::string& name, std::size_t, std::size_t)
+{
+    MIOPEN_LOG_I("Shared memory kernel cache is not supported: " << name);
+}
+
+KernelShmCache::~KernelShmCache() {}
+
+void KernelShmCache::Unlink(const std::string&) {}
+#else
+KernelShmCache::KernelShmCache(const std::string& name,
+                               std::size_t capacity,
+                               std::size_t slot_count)
+{
+    static_assert(sizeof(Header) <= header_size, "");
+    if(slot_count == 0 || slot_count > std::numeric_limits<uint32_t>::max())
+        return;
+
+    const auto size    = header_size + AlignUp(slot_count * sizeof(Slot), 64) + capacity;
+    auto fd            = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    const auto created = fd >= 0;
+    if(!created && errno == EEXIST)
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+    if(fd < 0)
+    {
+        MIOPEN_LOG_W("Unable to open shared memory " << name << ": " << std::strerror(errno));
+        return;
+    }
+
+    auto actual_size = size;
+    if(created)
+    {
+        // The new pages are zero filled, which makes every slot empty.
+        if(ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            MIOPEN_LOG_W("Unable to size shared memory " << name << ": " << std::strerror(errno));
+            close(fd);
+            shm_unlink(name.c_str());
+            return;
+        }
+    }
+    else
+    {
+        // The creator may still be sizing the segment.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        struct stat st = {};
+        while(fstat(fd, &st) == 0 && st.st_size == 0 &&
+              std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        actual_size = static_cast<std::size_t>(st.st_size);
+    }
+
+    auto* const mapping =
+        actual_size < header_size
+            ? MAP_FAILED
+            : mmap(nullptr, actual_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        MIOPEN_LOG_W("Unable to map shared memory " << name);
+        return;
+    }
+    mapped_size = actual_size;
+
+    auto* const base = static_cast<char*>(mapping);
+    auto* const hdr  = reinterpret_cast<Header*>(base);
+    if(created)
+    {
+        hdr->version       = shm_version;
+        hdr->slot_count    = static_cast<uint32_t>(slot_count);
+        hdr->data_capacity = capacity;
+        hdr->magic.store(shm_magic, std::memory_order_release);
+    }
+    else
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while(hdr->magic.load(std::memory_order_acquire) != shm_magic &&
+              std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const auto layout_size = header_size + AlignUp(hdr->slot_count * sizeof(Slot), 64);
+    if(hdr->magic.load(std::memory_order_acquire) != shm_magic ||
+       hdr->version != shm_version || hdr->slot_count == 0 ||
+       layout_size + hdr->data_capacity > mapped_size)
+    {
+        MIOPEN_LOG_W("Incompatible shared memory kernel cache " << name);
+        munmap(mapping, mapped_size);
+        return;
+    }
+
+    header = hdr;
+    slots  = reinterpret_cast<Slot*>(base + header_size);
+    data   = base + layout_size;
+    MIOPEN_LOG_I2((created ? "Created" : "Opened") << " shared memory kernel cache " << name
+                                                   << ", " << header->slot_count << " slots, "
+                                                   << header->data_capacity << " bytes");
+}
+
+KernelShmCache::~KernelShmCache()
+{
+    if(header != nullptr)
+        munmap(header, mapped_size);
+}
+
+void KernelShmCache::Unlink(const std::string& name) { shm_unlink(name.c_str()); }
+#endif
+
+std::optional<std::string_view> KernelShmCache::Find(std::string_view key) const
+{
+    if(!IsValid())
+        return std::nullopt;
+
+    const auto hash = HashKey(key);
+    for(auto i = std::size_t{0}; i < header->slot_count; ++i)
+    {
+        const auto& slot     = slots[(hash + i) % header->slot_count];
+        const auto slot_hash = slot.hash.load(std::memory_order_acquire);
+        // Slots are never released, so the probe sequence of a key ends at the first empty slot.
+        if(slot_hash == 0)
+            break;
+        if(slot_hash != hash || slot.state.load(std::memory_order_acquire) != SlotReady)
+            continue;
+        // The segment is writable by every process of the user, so nothing in it is trusted.
+        if(slot.offset > header->data_capacity ||
+           slot.key_size > header->data_capacity - slot.offset ||
+           slot.size > header->data_capacity - slot.offset - slot.key_size)
+            continue;
+        const auto* const entry = data + slot.offset;
+        if(std::string_view{entry, slot.key_size} != key)
+            continue;
+        const auto blob = std::string_view{entry + slot.key_size, slot.size};
+        if(md5(blob.data(), blob.size()) != std::string_view{slot.digest, sizeof(slot.digest)})
+        {
+            MIOPEN_LOG_W("Corrupted kernel in shared memory: " << key);
+            continue;
+        }
+        return blob;
+    }
+    return std::nullopt;
+}
+
+bool KernelShmCache::Insert(std::string_view key, std::string_view blob)
+{
+    if(!IsValid() || key.size() > std::numeric_limits<uint32_t>::max())
+        return false;
+
+    const auto length = AlignUp(key.size() + blob.size(), 8);
+    const auto digest = md5(blob.data(), blob.size());
+    if(digest.size() != sizeof(Slot::digest))
+        return false;
+    // Slots claimed for entries which do not fit would only lengthen the probes.
+    if(header->data_used.load(std::memory_order_relaxed) + length > header->data_capacity)
+        return false;
+
+    const auto hash = HashKey(key);
+    for(auto i = std::size_t{0}; i < header->slot_count; ++i)
+    {
+        auto& slot    = slots[(hash + i) % header->slot_count];
+        auto expected = uint64_t{0};
+        if(!slot.hash.compare_exchange_strong(expected, hash, std::memory_order_acq_rel))
+        {
+            // An entry which is still being written is skipped, which may store the key twice.
+            // Find() returns whichever is ready first.
+            if(expected == hash && slot.state.load(std::memory_order_acquire) == SlotReady &&
+               std::string_view{data + slot.offset, slot.key_size} == key)
+                return true;
+            continue;
+        }
+
+        slot.state.store(SlotWriting, std::memory_order_relaxed);
+        const auto offset = header->data_used.fetch_add(length, std::memory_order_relaxed);
+        if(offset + length > header->data_capacity)
+        {
+            slot.state.store(SlotAbandoned, std::memory_order_release);
+            return false;
+        }
+        std::memcpy(data + offset, key.data(), key.size());
+        std::memcpy(data + offset + key.size(), blob.data(), blob.size());
+        slot.key_size = static_cast<uint32_t>(key.size());
+        slot.offset   = offset;
+        slot.size     = blob.size();
+        std::memcpy(slot.digest, digest.data(), sizeof(slot.digest));
+        slot.state.store(SlotReady, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+#ifdef _WIN32
+std::string GetFileIdentity(const fs::path&) { return {}; }
+#else
+std::string GetFileIdentity(const fs::path& path)
+{
+    struct stat st = {};
+    if(stat(path.c_str(), &st) != 0)
+        return {};
+    return std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino);
+}
+#endif
+
+KernelShmCache* GetKernelShmCache()
+{
+    static const auto cache = []() -> std::unique_ptr<KernelShmCache> {
+        const auto capacity = env::value(MIOPEN_KERNEL_SHM_CACHE_MB) * 1024 * 1024;
+        const auto user_dir = GetCachePath(false);
+        if(capacity == 0 || user_dir.empty())
+            return nullptr;
+        // One segment per user kernel cache, which also keeps the MIOpen versions apart. A cache
+        // directory which is removed and created again gets a new segment.
+        const auto name = "/miopen-kernels-" +
+                          md5(user_dir.string() + ":" + GetFileIdentity(user_dir)).substr(0, 16);
+        // Code objects average tens of kilobytes, so the index rarely gets crowded.
+        const auto slot_count = std::max<std::size_t>(1024, capacity / (4 * 1024));
+        auto shm = std::make_unique<KernelShmCache>(name, capacity, slot_count);
+        if(!shm->IsValid())
+            return nullptr;
+        return shm;
+    }();
+    return cache.get();
+}
+
+} // namespace miopen
@@ -25,17 +25,16 @@
  *******************************************************************************/
 
 #include <miopen/layernorm/problem_description.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/names.hpp>
 
-#include <sstream>
-
 namespace miopen {
 
 namespace layernorm {
 
 NetworkConfig ProblemDescription::MakeNetworkConfig() const
 {
-    auto dims         = xDesc.GetLengths();
+    const auto& dims  = xDesc.GetLengths();
     size_t outer_size = 1;
     size_t inner_size = 1;
 
@@ -53,26 +52,26 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
     }
     auto dtype = xDesc.GetType();
 
-    std::ostringstream ss;
+    KeyWriter key;
 
-    ss << "dtype" << dtype;
+    key << "dtype" << dtype;
     if((mode == MIOPEN_WEIGHT_BIAS_T5) || (mode == MIOPEN_ELEMENTWISE_AFFINE_T5))
     {
-        ss << "normalized_dim" << dims.size() - 1;
+        key << "normalized_dim" << dims.size() - 1;
     }
     else
     {
-        ss << "normalized_dim" << normalized_dim;
+        key << "normalized_dim" << normalized_dim;
     }
-    ss << "outer_size" << outer_size;
-    ss << "inner_size" << inner_size;
+    key << "outer_size" << outer_size;
+    key << "inner_size" << inner_size;
 
     if((mode == MIOPEN_WEIGHT_BIAS_FUSED_ADD) || (mode == MIOPEN_ELEMENTWISE_AFFINE_FUSED_ADD))
-        ss << "addlayernorm";
+        key << "addlayernorm";
     if((mode == MIOPEN_WEIGHT_BIAS_T5) || (mode == MIOPEN_ELEMENTWISE_AFFINE_T5))
-        ss << "t5layernorm";
+        key << "t5layernorm";
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 } // namespace layernorm
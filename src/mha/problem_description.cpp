@@ -25,33 +25,32 @@
  *******************************************************************************/
 
 #include <miopen/mha/problem_description.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/names.hpp>
 
-#include <sstream>
-
 namespace miopen {
 
 namespace mha {
 
 NetworkConfig ProblemDescription::MakeNetworkConfig() const
 {
-    std::ostringstream ss;
+    KeyWriter key;
 
-    ss << "mha";
+    key << "mha";
 
-    auto print_strides = [&ss](const TensorDescriptor& desc) {
+    auto print_strides = [&key](const TensorDescriptor& desc) {
         for(const auto& d : desc.GetStrides())
         {
-            ss << d << "x";
+            key << d << "x";
         }
     };
 
     if(isForward)
     {
-        ss << "fwd-";
+        key << "fwd-";
         for(auto s : mhaInputDescsForwardPtr->oDesc.GetLengths())
         {
-            ss << s << "x";
+            key << s << "x";
         }
 
         print_strides(mhaInputDescsForwardPtr->kDesc);
@@ -61,15 +60,15 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
         print_strides(mhaInputDescsForwardPtr->mDesc);
         print_strides(mhaInputDescsForwardPtr->zInvDesc);
 
-        ss << mhaInputDescsForwardPtr->oDesc.GetType();
+        key << mhaInputDescsForwardPtr->oDesc.GetType();
     }
     else
     {
-        ss << "bwd-";
+        key << "bwd-";
 
         for(auto s : mhaInputDescsBackwardPtr->oDesc.GetLengths())
         {
-            ss << s << "x";
+            key << s << "x";
         }
         print_strides(mhaInputDescsBackwardPtr->kDesc);
         print_strides(mhaInputDescsBackwardPtr->qDesc);
@@ -82,10 +81,10 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
         print_strides(mhaInputDescsBackwardPtr->dkDesc);
         print_strides(mhaInputDescsBackwardPtr->dvDesc);
 
-        ss << mhaInputDescsBackwardPtr->oDesc.GetType();
+        key << mhaInputDescsBackwardPtr->oDesc.GetType();
     }
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 } // namespace mha
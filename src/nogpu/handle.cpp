@@ -34,6 +34,7 @@
 #include <miopen/invoker.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/ramdb.hpp>
 #include <miopen/timer.hpp>
 #include <miopen/hipoc_program.hpp>
 
@@ -65,7 +66,7 @@ Handle::Handle() : impl(new HandleImpl())
     MIOPEN_LOG_NQI(*this);
 }
 
-Handle::~Handle() {}
+Handle::~Handle() { RamDb::FlushAll(); }
 
 void Handle::SetStream(miopenAcceleratorQueue_t /* streamID */) const {}
 
@@ -33,12 +33,16 @@
 #include <miopen/db_record.hpp>
 #include <miopen/env.hpp>
 #include <miopen/find_db.hpp>
+#include <miopen/find_db_index.hpp>
 #include <miopen/find_controls.hpp>
 #include <miopen/float_equal.hpp>
 #include <miopen/generic_search_controls.hpp>
 #include <miopen/invoker.hpp>
 #include <miopen/kernel.hpp>
+#include <miopen/key_writer.hpp>
+#include <miopen/par_for.hpp>
 #include <miopen/solver.hpp>
+#include <miopen/solver_applicability_cache.hpp>
 #include <miopen/tensor_ops.hpp>
 #include <miopen/tensor.hpp>
 #include <miopen/util.hpp>
@@ -61,6 +65,7 @@ MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_CONV_IMMED_FALLBACK)
 MIOPEN_DECLARE_ENV_VAR_STR(MIOPEN_DUMP_TENSOR_PATH)
 MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_ENABLE_AI_IMMED_MODE_FALLBACK)
 MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_FORCE_IMMED_MODE_FALLBACK)
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_DEBUG_CONV_IMMED_FALLBACK_NEAREST)
 
 namespace miopen {
 
@@ -590,6 +595,120 @@ std::size_t ConvolutionDescriptor::GetSolutionCount(const ExecutionContext& ctx,
     return GetSolutionCountFallback(ctx, problem);
 }
 
+namespace {
+
+/// The network config, and what the solver predicates depend on that it leaves out.
+void WriteApplicabilityKey(KeyWriter& key,
+                           const ExecutionContext& ctx,
+                           const conv::ProblemDescription& problem)
+{
+    problem.MakeNetworkConfig(key);
+    key << "-b" << problem.GetBias();
+    key << "-m" << problem.GetConv().mode;
+    key << "-a" << problem.IsGfx90aFp16altRequired();
+    key << static_cast<bool>(problem.GetConv().attribute.deterministic);
+    key << problem.GetConv().attribute.fp8rounding_mode.Get();
+    if(problem.HasNonPackedTensors())
+    {
+        key << "-s";
+        key.Join(problem.GetIn().GetStrides(), 'x') << 'x';
+        key.Join(problem.GetWeights().GetStrides(), 'x') << 'x';
+        key.Join(problem.GetOut().GetStrides(), 'x');
+    }
+    key << "-c" << ctx.use_asm_kernels << ctx.use_hip_kernels << ctx.use_opencl_convolutions;
+    key << ctx.use_dynamic_solutions_only << ctx.is_for_generic_search;
+    key << ctx.disable_perfdb_access << ctx.rmv.getValue();
+    key << '-' << ctx.general_compile_options;
+}
+
+/// The solver predicates for one problem, memoized in the SolverApplicabilityCache of the
+/// handle. Solvers shall not depend on the performance config for the workspace size, so it is
+/// memoized as well.
+class SolverPredicates
+{
+public:
+    SolverPredicates(const ExecutionContext& ctx_, const conv::ProblemDescription& problem_)
+        : ctx(ctx_), problem(problem_)
+    {
+        KeyWriter key;
+        WriteApplicabilityKey(key, ctx, problem);
+        results = ctx.GetStream().GetApplicabilityCache().Get(key.View());
+        if(results == nullptr)
+            results = &own_results;
+    }
+
+    /// Evaluates the predicates of the solvers that are not known yet on the shared thread pool,
+    /// so that the calls that follow are lookups. Workspace size and WTI are only evaluated for
+    /// applicable solvers. Does nothing unless MIOPEN_DEBUG_PARALLEL_APPLICABILITY is enabled.
+    void Prefetch(const std::vector<solver::Id>& ids, bool with_wti)
+    {
+        auto unknown = std::vector<solver::Id>{};
+        for(const auto& id : ids)
+        {
+            if(results->count(id.Value()) == 0)
+                unknown.push_back(id);
+        }
+        if(unknown.size() < 2 || !env::enabled(MIOPEN_DEBUG_PARALLEL_APPLICABILITY))
+            return;
+
+        // The gemm solvers query the allocation limit, which the handle caches on first use
+        // without a lock. It is filled here, so the workers only read it.
+        ctx.GetStream().GetMaxMemoryAllocSize();
+        auto entries = std::vector<SolverApplicabilityCache::Entry>(unknown.size());
+        par_for(unknown.size(), shared_pool{}, [&](auto i) {
+            const auto& solver = unknown[i].GetSolver();
+            auto& entry        = entries[i];
+            entry.applicable   = solver.IsApplicable(ctx, problem);
+            if(!entry.applicable)
+                return;
+            entry.workspace = solver.GetWorkspaceSize(ctx, problem);
+            if(with_wti)
+                entry.wti = solver.GetWti(ctx, problem);
+        });
+
+        // The memo is not synchronized, so it is only filled here.
+        for(auto i = std::size_t{0}; i < unknown.size(); ++i)
+            (*results)[unknown[i].Value()] = entries[i];
+    }
+
+    bool IsApplicable(solver::Id id, const solver::AnySolver& solver)
+    {
+        const auto found = results->find(id.Value());
+        if(found != results->end())
+            return found->second.applicable;
+        const auto applicable = solver.IsApplicable(ctx, problem);
+        (*results)[id.Value()].applicable = applicable;
+        return applicable;
+    }
+
+    /// Shall be called for applicable solvers only.
+    std::size_t GetWorkspaceSize(solver::Id id, const solver::AnySolver& solver)
+    {
+        auto& entry = (*results)[id.Value()];
+        if(!entry.workspace)
+            entry.workspace = solver.GetWorkspaceSize(ctx, problem);
+        return *entry.workspace;
+    }
+
+    /// Shall be called for applicable solvers only.
+    float GetWti(solver::Id id, const solver::AnySolver& solver)
+    {
+        auto& entry = (*results)[id.Value()];
+        if(!entry.wti)
+            entry.wti = solver.GetWti(ctx, problem);
+        return *entry.wti;
+    }
+
+private:
+    const ExecutionContext& ctx;
+    const conv::ProblemDescription& problem;
+    SolverApplicabilityCache::Results* results;
+    // Used when memoization in the handle is disabled.
+    SolverApplicabilityCache::Results own_results;
+};
+
+} // namespace
+
 struct SolutionTimeComparator
 {
     bool operator()(const miopenConvSolution_t& lhs, const miopenConvSolution_t& rhs) const
@@ -641,10 +760,50 @@ ConvolutionDescriptor::GetSolutionsFallback(const ExecutionContext& ctx,
 
     auto interim = std::vector<miopenConvSolution_t>{};
     interim.reserve(maxSolutionCount); // For speed. In most cases we have less entries than asked.
+    auto predicates = SolverPredicates{ctx, problem};
+
+    // Nearest Problem Fallback
+    // Solvers of the k closest problems recorded in the system find-db. Opt-in, as the index is
+    // built from the whole text find-db on first use.
+    if(const auto k = env::value(MIOPEN_DEBUG_CONV_IMMED_FALLBACK_NEAREST); k > 0)
+    {
+        const auto& index =
+            FindDbIndex::GetCached(FindDbRecord::GetInstalledPath(ctx.GetStream()));
+        const auto key         = DbRecord{DbKinds::FindDb, problem}.GetKey();
+        const auto suggestions = index.Suggest(key, k);
+        if(!suggestions.empty())
+        {
+            MIOPEN_LOG_I2("Using Nearest Problem Fallback");
+            int idx = 1;
+            for(const auto& suggestion : suggestions)
+            {
+                const auto solver_id = solver::Id{suggestion.solver};
+                if(!solver_id.IsValid())
+                    continue;
+                const auto algo = solver_id.GetAlgo();
+                if(conv::IsAlgorithmDisabled(algo))
+                    continue;
+                const auto& sol = solver_id.GetSolver();
+                if(sol.IsEmpty() || !sol.IsDynamic())
+                    continue;
+                if(!predicates.IsApplicable(solver_id, sol))
+                    continue;
+                // The recorded workspace belongs to the neighbor, not to this problem.
+                const auto ws = predicates.GetWorkspaceSize(solver_id, sol);
+                if(!conv::IsEnoughWorkspace(
+                       "GetSolutionsFallback Nearest", solver_id, ws, invokeParams))
+                    continue;
+                // Keep the order of the suggestions, idx == 1 is assumed to be 10 ms.
+                interim.emplace_back(miopenConvSolution_t{
+                    10.0f * static_cast<float>(idx), ws, solver_id.Value(), algo});
+                ++idx;
+            }
+        }
+    }
 
     // TunaNet Fallback
 #if MIOPEN_ENABLE_AI_IMMED_MODE_FALLBACK
-    if(!env::disabled(MIOPEN_DEBUG_ENABLE_AI_IMMED_MODE_FALLBACK))
+    if(interim.empty() && !env::disabled(MIOPEN_DEBUG_ENABLE_AI_IMMED_MODE_FALLBACK))
     {
         const static std::string arch = ctx.GetStream().GetDeviceName();
         auto solvers                  = ai::immed_mode::PredictSolver(problem, ctx, arch);
@@ -664,9 +823,9 @@ ConvolutionDescriptor::GetSolutionsFallback(const ExecutionContext& ctx,
                     continue;
                 if(!sol.IsDynamic())
                     continue; // branch should never be taken
-                if(!sol.IsApplicable(ctx, problem))
+                if(!predicates.IsApplicable(solver_id, sol))
                     continue;
-                const auto ws = sol.GetWorkspaceSize(ctx, problem);
+                const auto ws = predicates.GetWorkspaceSize(solver_id, sol);
                 if(!conv::IsEnoughWorkspace("GetSolutionsFallback AI", solver_id, ws, invokeParams))
                     continue;
                 interim.emplace_back(
@@ -678,7 +837,7 @@ ConvolutionDescriptor::GetSolutionsFallback(const ExecutionContext& ctx,
 #endif // MIOPEN_ENABLE_AI_IMMED_MODE_FALLBACK
 
     // WTI Fallback
-    // if TunaNet is not enabled or produces no applicable solvers then fallback to WTI
+    // if neither the nearest problems nor TunaNet produce applicable solvers then fallback to WTI
     if(interim.empty())
     {
         MIOPEN_LOG_I2("Using WTI Fallback");
@@ -689,22 +848,31 @@ ConvolutionDescriptor::GetSolutionsFallback(const ExecutionContext& ctx,
             return 10.0f / wti; // Assume WTI == 1.0 (100%) is 10 ms.
         };
 
+        auto candidates = std::vector<solver::Id>{};
         for(const auto& solver_id : solver::GetSolversByPrimitive(solver::Primitive::Convolution))
         {
             // solver_id is always valid here, because taken from registry.
             // Validity check is not required.
-            const auto algo = solver_id.GetAlgo();
-            if(conv::IsAlgorithmDisabled(algo)) // Algos can be disabled globally.
+            if(conv::IsAlgorithmDisabled(solver_id.GetAlgo())) // Algos can be disabled globally.
                 continue;
             const auto& s = solver_id.GetSolver();
             // Let's allow non-dynamic later, if necessary.
-            if(s.IsEmpty() || !s.IsDynamic() || !s.IsApplicable(ctx, problem))
+            if(!s.IsEmpty() && s.IsDynamic())
+                candidates.push_back(solver_id);
+        }
+        predicates.Prefetch(candidates, true);
+
+        for(const auto& solver_id : candidates)
+        {
+            const auto algo = solver_id.GetAlgo();
+            const auto& s   = solver_id.GetSolver();
+            if(!predicates.IsApplicable(solver_id, s))
                 continue;
-            const auto ws = s.GetWorkspaceSize(ctx, problem);
+            const auto ws = predicates.GetWorkspaceSize(solver_id, s);
             if(!conv::IsEnoughWorkspace("GetSolutionsFallback WTI", solver_id, ws, invokeParams))
                 continue;
 
-            const auto wti = s.GetWti(ctx, problem);
+            const auto wti = predicates.GetWti(solver_id, s);
             MIOPEN_LOG_I2(solver_id.ToString() << " Estimated WTI = " << wti);
             if(wti < 0.0f) // Skip unknown WTIs.
                 continue;
@@ -786,11 +954,12 @@ std::vector<miopenConvSolution_t> GetSolutions(const ExecutionContext& ctx,
     std::sort(begin(interim), end(interim), SolutionTimeComparator{});
     auto out = std::vector<miopenConvSolution_t>{};
     out.reserve(maxSolutionCount);
-    auto n_copied = 0;
+    auto predicates = SolverPredicates{ctx, problem};
+    auto n_copied   = 0;
     for(const auto& s : interim)
     {
         const auto solver_id = solver::Id{s.solution_id};
-        if(!solver_id.GetSolver().IsApplicable(ctx, problem))
+        if(!predicates.IsApplicable(solver_id, solver_id.GetSolver()))
             continue;
         if(!conv::IsEnoughWorkspace("GetSolutions", solver_id, s.workspace_size, invokeParams))
             continue;
@@ -846,8 +1015,9 @@ std::size_t ConvolutionDescriptor::GetForwardSolutionWorkspaceSize(Handle& handl
         conv::ProblemDescription{xDesc, wDesc, yDesc, *this, conv::Direction::Forward};
     auto ctx = ExecutionContext{};
     ctx.SetStream(&handle);
-    if(sol.IsApplicable(ctx, problem))
-        return sol.GetWorkspaceSize(ctx, problem);
+    auto predicates = SolverPredicates{ctx, problem};
+    if(predicates.IsApplicable(solver_id, sol))
+        return predicates.GetWorkspaceSize(solver_id, sol);
     MIOPEN_THROW(miopenStatusBadParm,
                  "The supplied solution id: " + solver_id.ToString() +
                      " is not applicable to the current problem");
@@ -1060,9 +1230,10 @@ std::size_t ConvolutionDescriptor::GetBackwardSolutionWorkspaceSize(Handle& hand
         conv::ProblemDescription{dyDesc, wDesc, dxDesc, *this, conv::Direction::BackwardData};
     auto ctx = ExecutionContext{};
     ctx.SetStream(&handle);
-    if(sol.IsApplicable(ctx, problem))
+    auto predicates = SolverPredicates{ctx, problem};
+    if(predicates.IsApplicable(solver_id, sol))
     {
-        return sol.GetWorkspaceSize(ctx, problem);
+        return predicates.GetWorkspaceSize(solver_id, sol);
     }
     else
     {
@@ -1272,9 +1443,10 @@ std::size_t ConvolutionDescriptor::GetWrwSolutionWorkspaceSize(Handle& handle,
         conv::ProblemDescription{dyDesc, dwDesc, xDesc, *this, conv::Direction::BackwardWeights};
     auto ctx = ExecutionContext{};
     ctx.SetStream(&handle);
-    if(sol.IsApplicable(ctx, problem))
+    auto predicates = SolverPredicates{ctx, problem};
+    if(predicates.IsApplicable(solver_id, sol))
     {
-        return sol.GetWorkspaceSize(ctx, problem);
+        return predicates.GetWorkspaceSize(solver_id, sol);
     }
     else
     {
@@ -37,6 +37,7 @@
 #include <miopen/logger.hpp>
 #include <miopen/manage_ptr.hpp>
 #include <miopen/ocldeviceinfo.hpp>
+#include <miopen/ramdb.hpp>
 #include <miopen/timer.hpp>
 
 #include <miopen/filesystem.hpp>
@@ -265,7 +266,7 @@ Handle::Handle() : impl(new HandleImpl())
 }
 
 Handle::Handle(Handle&&) noexcept = default;
-Handle::~Handle()                 = default;
+Handle::~Handle() { RamDb::FlushAll(); }
 
 void Handle::SetStream(miopenAcceleratorQueue_t streamID) const
 {
@@ -25,33 +25,17 @@
  *******************************************************************************/
 
 #include <miopen/pooling/problem_description.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/mlo_internal.hpp>
 #include <miopen/pooling.hpp>
 
-#include <sstream>
-
 namespace miopen {
 
 namespace pooling {
 
-namespace {
-
-template <typename T>
-std::string get_vect_config(const std::vector<T>& v)
-{
-    std::string str;
-    for(auto itr = v.begin(); itr < v.end(); itr++)
-    {
-        str += (std::to_string(*itr) + (itr == v.end() - 1 ? "" : "x"));
-    }
-    return str;
-}
-
-} // namespace
-
 NetworkConfig ProblemDescription::MakeNetworkConfig() const
 {
-    std::ostringstream ss;
+    KeyWriter key;
 
     int pooling_method =
         (pooling.GetMode() == miopenPoolingMax)
@@ -59,32 +43,43 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
             : ((pooling.GetMode() == miopenPoolingAverage) ? MLO_POOLING_OP_AVE
                                                            : MLO_POOLING_OP_AVE_INCLUSIVE);
 
-    ss << "m" + std::to_string(pooling_method);
-    ss << "_dt" << xDesc.GetType();
+    key << "m" << pooling_method;
+    key << "_dt" << xDesc.GetType();
     if(const auto ct = xDesc.GetCastType())
-        ss << "_dct" << GetDataTypeName(*ct);
-    ss << "_ker" << get_vect_config(pooling.lens);
-    ss << "_str" << get_vect_config(pooling.strides);
-    ss << "_pad" << get_vect_config(pooling.pads);
-    ss << "_it" << pooling.GetIndexType();
-    ss << "_im" << pooling.GetWorkspaceIndexMode();
+        key << "_dct" << GetDataTypeName(*ct);
+    key << "_ker";
+    key.Join(pooling.lens, 'x');
+    key << "_str";
+    key.Join(pooling.strides, 'x');
+    key << "_pad";
+    key.Join(pooling.pads, 'x');
+    key << "_it" << pooling.GetIndexType();
+    key << "_im" << pooling.GetWorkspaceIndexMode();
     if(direction == Direction::Forward)
     {
-        ss << "_is" << static_cast<int>(save_index);
+        key << "_is" << static_cast<int>(save_index);
     }
-    ss << "_xd" << get_vect_config(xDesc.GetLengths());
-    ss << "_xs" << get_vect_config(xDesc.GetStrides());
-    ss << "_yd" << get_vect_config(yDesc.GetLengths());
-    ss << "_ys" << get_vect_config(yDesc.GetStrides());
+    key << "_xd";
+    key.Join(xDesc.GetLengths(), 'x');
+    key << "_xs";
+    key.Join(xDesc.GetStrides(), 'x');
+    key << "_yd";
+    key.Join(yDesc.GetLengths(), 'x');
+    key << "_ys";
+    key.Join(yDesc.GetStrides(), 'x');
     if(direction == Direction::Backward)
     {
-        ss << "_dxd" << get_vect_config(dxDesc.GetLengths());
-        ss << "_dxs" << get_vect_config(dxDesc.GetStrides());
-        ss << "_dyd" << get_vect_config(dyDesc.GetLengths());
-        ss << "_dys" << get_vect_config(dyDesc.GetStrides());
+        key << "_dxd";
+        key.Join(dxDesc.GetLengths(), 'x');
+        key << "_dxs";
+        key.Join(dxDesc.GetStrides(), 'x');
+        key << "_dyd";
+        key.Join(dyDesc.GetLengths(), 'x');
+        key << "_dys";
+        key.Join(dyDesc.GetStrides(), 'x');
     }
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 } // namespace pooling
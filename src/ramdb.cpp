@@ -26,55 +26,135 @@
 
 #include <miopen/ramdb.hpp>
 
+#include <miopen/env.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/lock_file.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/stringutils.hpp>
 
 #include <miopen/filesystem.hpp>
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+
+#include <algorithm>
 #include <chrono>
-#include <ctime>
+#include <cmath>
+#include <condition_variable>
 #include <fstream>
-#include <limits>
 #include <map>
 #include <mutex>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_DB_WRITE_BEHIND)
 
 namespace miopen {
 
-fs::path RamDb::GetTimeFilePath(const fs::path& path) { return path + ".time"; }
+namespace {
 
-static ramdb_clock::time_point GetDbModificationTime(const fs::path& path)
+constexpr auto WriteBehindInterval        = std::chrono::seconds{1};
+constexpr std::size_t WriteBehindMaxWrites = 4096;
+
+std::mutex& GetInstancesMutex()
 {
-    const auto time_file_path = RamDb::GetTimeFilePath(path);
-    auto file                 = std::ifstream{time_file_path};
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static std::mutex mutex;
+    return mutex;
+}
 
-    if(!file.is_open())
-        // Zero time from epoch, considering file ancient if time can't be retrieved.
-        return {};
+// File locks are per process on POSIX, so our own journals can't be told from the orphaned ones
+// by the lock and closing any descriptor of a journal would release the lock on it.
+struct OwnJournals
+{
+    std::mutex mutex;
+    std::set<fs::path> paths;
+};
 
-    ramdb_clock::rep time;
-    file >> time;
-    return ramdb_clock::time_point{ramdb_clock::duration{time}};
+OwnJournals& GetOwnJournals()
+{
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static OwnJournals journals;
+    return journals;
 }
 
-static void UpdateDbModificationTime(const fs::path& path)
+// We don't have to store kind to properly index as different dbs would have different paths
+std::map<fs::path, std::unique_ptr<RamDb>>& GetInstances()
 {
-    MIOPEN_LOG_I2("Updating db modification time for " << path);
+    // The instances use the journals on destruction, so those have to be destroyed later.
+    std::ignore = GetOwnJournals();
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static auto instances = std::map<fs::path, std::unique_ptr<RamDb>>{};
+    return instances;
+}
 
-    const auto time           = ramdb_clock::now().time_since_epoch();
-    const auto time_file_path = RamDb::GetTimeFilePath(path);
-    auto file                 = std::ofstream{time_file_path};
+/// Flushes the batches of the cached instances once per WriteBehindInterval, so that they reach
+/// the db file even if no more writes come.
+class WriteBehindTimer
+{
+public:
+    WriteBehindTimer() : thread([this]() { Run(); }) {}
+
+    WriteBehindTimer(const WriteBehindTimer&) = delete;
+    WriteBehindTimer& operator=(const WriteBehindTimer&) = delete;
 
-    if(!file)
+    ~WriteBehindTimer()
     {
-        MIOPEN_LOG_E("Cannot update database modification time: " << time_file_path);
-        return;
+        {
+            const std::lock_guard<std::mutex> lock{mutex};
+            stop = true;
+        }
+        stopped.notify_all();
+        thread.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool stop = false;
+    std::thread thread;
+
+    void Run()
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex};
+        while(!stopped.wait_for(lock, WriteBehindInterval, [this]() { return stop; }))
+        {
+            lock.unlock();
+            RamDb::FlushAll();
+            lock.lock();
+        }
     }
+};
 
-    file << time.count();
+void StartWriteBehindTimer()
+{
+    // The timer flushes the instances, so those have to be destroyed later.
+    std::ignore = GetInstances();
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static WriteBehindTimer timer;
 }
 
+} // namespace
+
+std::string RamDb::GetContent(const DbRecord& record)
+{
+    auto ss = std::ostringstream{};
+    record.WriteIdsAndValues(ss);
+    auto content = ss.str();
+    // Drop the line break to keep the contents the same as they are read from the file.
+    if(!content.empty() && content.back() == '\n')
+        content.pop_back();
+    return content;
+}
+
+fs::path RamDb::GetGenerationFilePath(const fs::path& path) { return path + ".gen"; }
+
 #define MIOPEN_VALIDATE_LOCK(lock)                       \
     do                                                   \
     {                                                    \
@@ -87,20 +167,34 @@ static std::chrono::seconds GetLockTimeout() { return std::chrono::seconds{60};
 using exclusive_lock = std::unique_lock<LockFile>;
 
 RamDb::RamDb(DbKinds db_kind_, const fs::path& path, bool is_system)
-    : PlainTextDb(db_kind_, path, is_system)
+    : PlainTextDb(db_kind_, path, is_system),
+      write_behind(!DisableUserDbFileIO && env::enabled(MIOPEN_DEBUG_DB_WRITE_BEHIND))
 {
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "Generation counter is shared between processes and has to be lock-free");
+
+    if constexpr(DisableUserDbFileIO)
+        snapshot = std::make_shared<const Snapshot>();
+    else
+        MapGeneration();
+}
+
+RamDb::~RamDb()
+{
+    if(!journal)
+        return;
+
+    auto& own = GetOwnJournals();
+    const std::lock_guard<std::mutex> lock{own.mutex};
+    own.paths.erase(journal_path);
 }
 
 RamDb& RamDb::GetCached(DbKinds db_kind_, const fs::path& path, bool is_system)
 {
-    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-    static std::mutex mutex;
-    const std::lock_guard<std::mutex> lock{mutex};
+    const std::lock_guard<std::mutex> lock{GetInstancesMutex()};
 
-    // We don't have to store kind to properly index as different dbs would have different paths
-    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-    static auto instances = std::map<fs::path, std::unique_ptr<RamDb>>{};
-    const auto it         = instances.find(path);
+    auto& instances = GetInstances();
+    const auto it   = instances.find(path);
 
     if(it != instances.end())
         return *it->second;
@@ -111,23 +205,52 @@ RamDb& RamDb::GetCached(DbKinds db_kind_, const fs::path& path, bool is_system)
     {
         const auto prefetch_lock = exclusive_lock(instance.GetLockFile(), GetLockTimeout());
         MIOPEN_VALIDATE_LOCK(prefetch_lock);
+        instance.ReplayJournalsUnsafe();
         instance.Prefetch();
     }
     return instance;
 }
 
+void RamDb::FlushAll()
+{
+    const std::lock_guard<std::mutex> lock{GetInstancesMutex()};
+
+    for(auto& instance : GetInstances())
+    {
+        try
+        {
+            instance.second->Flush();
+        }
+        catch(const std::exception& ex)
+        {
+            MIOPEN_LOG_E("Unable to flush " << instance.first << ": " << ex.what());
+        }
+    }
+}
+
 boost::optional<DbRecord> RamDb::FindRecord(const std::string& problem)
 {
-    const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
-    MIOPEN_VALIDATE_LOCK(lock);
+    if(has_pending.load(std::memory_order_acquire))
+    {
+        const std::lock_guard<std::mutex> lock{pending_mutex};
+        return FindLatestRecordUnsafe(problem);
+    }
+
+    return FindActualRecord(problem);
+}
 
-    if(!ValidateUnsafe())
+boost::optional<DbRecord> RamDb::FindActualRecord(const std::string& problem)
+{
+    auto from = GetSnapshot();
+
+    if(!IsActual(from.get()))
     {
-        MIOPEN_LOG_I2("RamDb file is newer than cache, prefetching");
-        Prefetch();
+        const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
+        MIOPEN_VALIDATE_LOCK(lock);
+        from = GetActualSnapshotUnsafe();
     }
 
-    return FindRecordUnsafe(problem);
+    return FindRecord(*from, problem);
 }
 
 bool RamDb::StoreRecord(const DbRecord& record)
@@ -135,19 +258,29 @@ bool RamDb::StoreRecord(const DbRecord& record)
     const auto& key = record.GetKey();
     MIOPEN_LOG_I2("Trying to store record at key " << key << " in cache for file "
                                                    << GetFileName());
+
+    if(write_behind)
+    {
+        const std::lock_guard<std::mutex> pending_lock{pending_mutex};
+        return EnqueueUnsafe(key, PendingWrite{false, false, GetContent(record)});
+    }
+
     const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
     MIOPEN_VALIDATE_LOCK(lock);
 
+    const auto from = GetSnapshot();
+
     if constexpr(!DisableUserDbFileIO)
     {
         if(!StoreRecordUnsafe(record))
             return false;
-        UpdateDbModificationTime(GetFileName());
     }
 
 #if MIOPEN_DB_CACHE_WRITE_THROUGH
-    UpdateCacheEntryUnsafe(record);
+    UpdateCacheUnsafe(from,
+                      [&](auto& changes) { changes[key] = CacheItem{-1, GetContent(record)}; });
 #else
+    CommitUnsafe();
     Prefetch();
 #endif
     return true;
@@ -158,19 +291,35 @@ bool RamDb::UpdateRecord(DbRecord& record)
     const auto& key = record.GetKey();
     MIOPEN_LOG_I2("Trying to update record at key " << key << " in cache for file "
                                                     << GetFileName());
+
+    if(write_behind)
+    {
+        const std::lock_guard<std::mutex> pending_lock{pending_mutex};
+        const auto current = FindLatestRecordUnsafe(key);
+        if(current)
+            record.Merge(*current);
+        // After a pending store or removal the record in the file is already outdated.
+        const auto it       = pending.find(key);
+        const auto is_merge = it == pending.end() || it->second.is_merge;
+        return EnqueueUnsafe(key, PendingWrite{is_merge, false, GetContent(record)});
+    }
+
     const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
     MIOPEN_VALIDATE_LOCK(lock);
 
+    const auto from = GetSnapshot();
+
     if constexpr(!DisableUserDbFileIO)
     {
         if(!UpdateRecordUnsafe(record))
             return false;
-        UpdateDbModificationTime(GetFileName());
     }
 
 #if MIOPEN_DB_CACHE_WRITE_THROUGH
-    UpdateCacheEntryUnsafe(record);
+    UpdateCacheUnsafe(from,
+                      [&](auto& changes) { changes[key] = CacheItem{-1, GetContent(record)}; });
 #else
+    CommitUnsafe();
     Prefetch();
 #endif
     return true;
@@ -180,27 +329,28 @@ bool RamDb::RemoveRecord(const std::string& key)
 {
     MIOPEN_LOG_I2("Trying to remove record at key " << key << " from cache for file "
                                                     << GetFileName());
+
+    if(write_behind)
+    {
+        const std::lock_guard<std::mutex> pending_lock{pending_mutex};
+        return EnqueueUnsafe(key, PendingWrite{false, true, {}});
+    }
+
     const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
     MIOPEN_VALIDATE_LOCK(lock);
 
-#if MIOPEN_DB_CACHE_WRITE_THROUGH
-    const auto is_valid = ValidateUnsafe();
-#endif
+    const auto from = GetSnapshot();
 
     if constexpr(!DisableUserDbFileIO)
     {
         if(!RemoveRecordUnsafe(key))
             return false;
-        UpdateDbModificationTime(GetFileName());
     }
 
 #if MIOPEN_DB_CACHE_WRITE_THROUGH
-    if(is_valid)
-    {
-        cache.erase(key);
-        file_read_time = ramdb_clock::now();
-    }
+    UpdateCacheUnsafe(from, [&](auto& changes) { changes[key] = boost::none; });
 #else
+    CommitUnsafe();
     Prefetch();
 #endif
 
@@ -211,14 +361,23 @@ bool RamDb::Remove(const std::string& key, const std::string& id)
 {
     MIOPEN_LOG_I2("Trying to remove value at key " << key << " and id " << id
                                                    << " from cache for file " << GetFileName());
+
+    if(write_behind)
+    {
+        const std::lock_guard<std::mutex> pending_lock{pending_mutex};
+        auto record = FindLatestRecordUnsafe(key);
+        if(!record || !record->EraseValues(id))
+            return false;
+        if(record->GetSize() == 0)
+            return EnqueueUnsafe(key, PendingWrite{false, true, {}});
+        return EnqueueUnsafe(key, PendingWrite{false, false, GetContent(*record)});
+    }
+
     const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
     MIOPEN_VALIDATE_LOCK(lock);
 
-#if MIOPEN_DB_CACHE_WRITE_THROUGH
-    const auto is_valid = ValidateUnsafe();
-#endif
-
-    auto record = FindRecordUnsafe(key);
+    const auto from = GetActualSnapshotUnsafe();
+    auto record     = FindRecord(*from, key);
 
     if(!record || !record->EraseValues(id))
         return false;
@@ -227,59 +386,312 @@ bool RamDb::Remove(const std::string& key, const std::string& id)
     {
         if(!StoreRecordUnsafe(*record))
             return false;
-        UpdateDbModificationTime(GetFileName());
     }
 
 #if MIOPEN_DB_CACHE_WRITE_THROUGH
-    if(is_valid)
-    {
+    UpdateCacheUnsafe(from, [&](auto& changes) {
         if(record->GetSize() == 0)
-        {
-            cache.erase(key);
-        }
+            changes[key] = boost::none;
         else
-        {
-            auto it = cache.find(key);
-            auto ss = std::ostringstream{};
-            record->WriteIdsAndValues(ss);
-            it->second.content = ss.str();
-        }
-
-        file_read_time = ramdb_clock::now();
-    }
+            changes[key] = CacheItem{-1, GetContent(*record)};
+    });
 #else
+    CommitUnsafe();
     Prefetch();
 #endif
 
     return true;
 }
 
-boost::optional<miopen::DbRecord> RamDb::FindRecordUnsafe(const std::string& problem)
+std::shared_ptr<const RamDb::Snapshot> RamDb::GetSnapshot() const
+{
+    return std::atomic_load(&snapshot);
+}
+
+std::shared_ptr<const RamDb::Snapshot> RamDb::GetActualSnapshotUnsafe()
+{
+    // Another thread may have already reloaded the file while we were waiting for the lock.
+    auto from = GetSnapshot();
+    if(IsActual(from.get()))
+        return from;
+
+    MIOPEN_LOG_I2("RamDb file is newer than cache, prefetching");
+    Prefetch();
+    return GetSnapshot();
+}
+
+boost::optional<miopen::DbRecord> RamDb::FindRecord(const Snapshot& from,
+                                                    const std::string& problem) const
 {
     MIOPEN_LOG_I2("Looking for key " << problem << " in cache for file " << GetFileName());
-    const auto it = cache.find(problem);
+    const CacheItem* item = nullptr;
+    const auto change     = from.changes.find(problem);
 
-    if(it == cache.end())
-        return boost::none;
+    if(change != from.changes.end())
+    {
+        if(!change->second)
+            return boost::none;
+        item = change->second.get_ptr();
+    }
+    else
+    {
+        const auto it = from.cache->find(problem);
+        if(it == from.cache->end())
+            return boost::none;
+        item = &it->second;
+    }
 
     auto record = DbRecord{problem};
 
-    if(!record.ParseContents(it->second.content))
+    if(!record.ParseContents(item->content))
     {
         MIOPEN_LOG_E("Error parsing payload under the key: "
-                     << problem << " form file " << GetFileName() << "#" << it->second.line);
-        MIOPEN_LOG_E("Contents: " << it->second.content);
+                     << problem << " form file " << GetFileName() << "#" << item->line);
+        MIOPEN_LOG_E("Contents: " << item->content);
         return boost::none;
     }
 
     return record;
 }
 
+bool RamDb::Flush()
+{
+    if(!write_behind)
+        return true;
+
+    const std::lock_guard<std::mutex> lock{pending_mutex};
+    return FlushPendingUnsafe();
+}
+
+boost::optional<DbRecord> RamDb::FindLatestRecordUnsafe(const std::string& key)
+{
+    const auto it = pending.find(key);
+
+    if(it == pending.end())
+        return FindActualRecord(key);
+    if(it->second.is_removal)
+        return boost::none;
+
+    auto record = DbRecord{key};
+    record.ParseContents(it->second.content);
+    return record;
+}
+
+bool RamDb::EnqueueUnsafe(const std::string& key, PendingWrite write)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if(pending.empty())
+    {
+        first_pending_time = now;
+        OpenJournalUnsafe();
+        StartWriteBehindTimer();
+    }
+
+    if(journal)
+    {
+        const auto op = write.is_removal ? 'R' : (write.is_merge ? 'U' : 'S');
+        // Flushed on every write to survive a crash of the process.
+        *journal << op << ' ' << key << '=' << write.content << std::endl;
+    }
+
+    pending.insert_or_assign(key, std::move(write));
+    has_pending.store(true, std::memory_order_release);
+
+    if(pending.size() >= WriteBehindMaxWrites || now - first_pending_time >= WriteBehindInterval)
+        return FlushPendingUnsafe();
+    return true;
+}
+
+bool RamDb::FlushPendingUnsafe()
+{
+    if(pending.empty())
+        return true;
+
+    MIOPEN_LOG_I2("Flushing " << pending.size() << " pending writes to " << GetFileName());
+
+    const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
+    MIOPEN_VALIDATE_LOCK(lock);
+
+    const auto from = GetSnapshot();
+    auto writes     = std::vector<BatchWrite>{};
+    writes.reserve(pending.size());
+
+    for(const auto& item : pending)
+    {
+        auto record = DbRecord{item.first};
+        if(!item.second.is_removal)
+            record.ParseContents(item.second.content);
+        writes.push_back({std::move(record), item.second.is_merge});
+    }
+
+    if(!WriteRecordsUnsafe(writes))
+    {
+        // Part of the batch may have been written, so the cache is reloaded on the next read. The
+        // batch and its journal are kept for the next flush or a replay: the callers have already
+        // been told that the writes have succeeded.
+        CommitUnsafe();
+        MIOPEN_LOG_E("Unable to write " << pending.size() << " pending writes to "
+                                        << GetFileName() << ", they are kept for the next flush");
+        return false;
+    }
+
+#if MIOPEN_DB_CACHE_WRITE_THROUGH
+    UpdateCacheUnsafe(from, [&](auto& changes) {
+        for(const auto& write : writes)
+        {
+            if(write.record.GetSize() != 0)
+                changes[write.record.GetKey()] = CacheItem{-1, GetContent(write.record)};
+            else
+                changes[write.record.GetKey()] = boost::none;
+        }
+    });
+#else
+    CommitUnsafe();
+    Prefetch();
+#endif
+
+    // Snapshot is published first, so readers never miss the pending writes.
+    pending.clear();
+    has_pending.store(false, std::memory_order_release);
+    CloseJournalUnsafe();
+    return true;
+}
+
+void RamDb::OpenJournalUnsafe()
+{
+    namespace ipc = boost::interprocess;
+
+    // Taken to prevent a replay of the journal in between of its creation and locking.
+    const auto lock = exclusive_lock(GetLockFile(), GetLockTimeout());
+    MIOPEN_VALIDATE_LOCK(lock);
+
+    const auto path =
+        fs::path{GetFileName() + "." +
+                 boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%").string() + ".journal"};
+    auto file = std::make_unique<std::ofstream>(path, std::ios::binary);
+
+    if(!*file)
+    {
+        MIOPEN_LOG_W("Unable to create " << path << ", pending db writes would be lost on crash");
+        return;
+    }
+
+    try
+    {
+        auto file_lock = std::make_shared<ipc::file_lock>(path.string().c_str());
+        file_lock->lock();
+        journal_lock = std::move(file_lock);
+    }
+    catch(const ipc::interprocess_exception& ex)
+    {
+        MIOPEN_LOG_W("Unable to lock " << path << ": " << ex.what());
+        file.reset();
+        fs::remove(path);
+        return;
+    }
+
+    {
+        auto& own = GetOwnJournals();
+        const std::lock_guard<std::mutex> own_lock{own.mutex};
+        own.paths.insert(path);
+    }
+    journal      = std::move(file);
+    journal_path = path;
+}
+
+void RamDb::CloseJournalUnsafe()
+{
+    if(!journal)
+        return;
+
+    journal.reset();
+    auto ec = std::error_code{};
+    fs::remove(journal_path, ec);
+    journal_lock.reset();
+
+    auto& own = GetOwnJournals();
+    const std::lock_guard<std::mutex> own_lock{own.mutex};
+    own.paths.erase(journal_path);
+}
+
+void RamDb::ReplayJournalsUnsafe()
+{
+    namespace ipc = boost::interprocess;
+
+    const auto prefix    = GetFileName().filename().string() + ".";
+    const auto suffix    = std::string{".journal"};
+    const auto directory = GetFileName().has_parent_path() ? GetFileName().parent_path() : ".";
+    auto ec              = std::error_code{};
+    auto replayed        = false;
+
+    auto& own = GetOwnJournals();
+    const std::lock_guard<std::mutex> own_lock{own.mutex};
+
+    for(const auto& entry : fs::directory_iterator{directory, ec})
+    {
+        const auto& path = entry.path();
+        const auto name  = path.filename().string();
+
+        if(!StartsWith(name, prefix) || !EndsWith(name, suffix) ||
+           own.paths.find(path) != own.paths.end())
+            continue;
+
+        try
+        {
+            // The lock is held by the owner of the journal for as long as it's alive.
+            auto journal_file_lock = ipc::file_lock{path.string().c_str()};
+            if(!journal_file_lock.try_lock())
+                continue;
+
+            MIOPEN_LOG_I("Replaying db journal left by another process: " << path);
+
+            auto file   = std::ifstream{path};
+            auto line   = std::string{};
+            auto writes = std::vector<BatchWrite>{};
+
+            while(std::getline(file, line))
+            {
+                // The last line is incomplete if the owner has crashed while writing it.
+                if(file.eof())
+                    break;
+
+                const auto key_end = line.find('=');
+                if(line.size() < 3 || line[1] != ' ' || key_end == std::string::npos)
+                {
+                    MIOPEN_LOG_E("Ill-formed journal entry: " << path);
+                    continue;
+                }
+
+                auto record = DbRecord{line.substr(2, key_end - 2)};
+                if(line[0] != 'R')
+                    record.ParseContents(line.substr(key_end + 1));
+                writes.push_back({std::move(record), line[0] == 'U'});
+            }
+
+            file.close();
+            WriteRecordsUnsafe(writes);
+            fs::remove(path, ec);
+            replayed = true;
+        }
+        catch(const ipc::interprocess_exception& ex)
+        {
+            MIOPEN_LOG_W("Unable to replay " << path << ": " << ex.what());
+        }
+    }
+
+    if(replayed)
+        CommitUnsafe();
+}
+
 template <class TFunc>
 static void Measure(const std::string& funcName, TFunc&& func)
 {
     if(!miopen::IsLogging(LoggingLevel::Info))
+    {
         func();
+        return;
+    }
 
     const auto start = std::chrono::high_resolution_clock::now();
     func();
@@ -287,18 +699,55 @@ static void Measure(const std::string& funcName, TFunc&& func)
     MIOPEN_LOG_I("RamDb::" << funcName << " time: " << (end - start).count() * .000001f << " ms");
 }
 
-bool RamDb::ValidateUnsafe()
+void RamDb::MapGeneration()
+{
+    namespace ipc = boost::interprocess;
+
+    const auto generation_path = GetGenerationFilePath(GetFileName());
+
+    try
+    {
+        // Opening for append creates a missing file and keeps the contents of an existing one.
+        if(!std::ofstream{generation_path, std::ios::binary | std::ios::app})
+        {
+            MIOPEN_LOG_W("Unable to create " << generation_path
+                                             << ", db changes made by other processes may be "
+                                                "missed");
+            return;
+        }
+
+        if(fs::file_size(generation_path) < sizeof(std::uint64_t))
+            fs::resize_file(generation_path, sizeof(std::uint64_t));
+
+        const auto file = ipc::file_mapping{generation_path.string().c_str(), ipc::read_write};
+        auto region =
+            std::make_shared<ipc::mapped_region>(file, ipc::read_write, 0, sizeof(std::uint64_t));
+
+        // The region is page-aligned and the counter is lock-free, so it is address-free as well.
+        generation         = static_cast<std::atomic<std::uint64_t>*>(region->get_address());
+        generation_storage = std::move(region);
+    }
+    catch(const ipc::interprocess_exception& ex)
+    {
+        MIOPEN_LOG_W("Unable to map " << generation_path << ": " << ex.what());
+    }
+    catch(const fs::filesystem_error& ex)
+    {
+        MIOPEN_LOG_W("Unable to map " << generation_path << ": " << ex.what());
+    }
+}
+
+bool RamDb::IsActual(const Snapshot* from) const
 {
     if(DisableUserDbFileIO)
         return true;
-    if(!fs::exists(GetFileName()))
-        return cache.empty();
-    const auto file_mod_time     = GetDbModificationTime(GetFileName());
-    const auto validation_result = file_mod_time < file_read_time;
-    MIOPEN_LOG_I2("DB file is " << (validation_result ? "older" : "newer")
-                                << " than cache: " << file_mod_time.time_since_epoch().count()
-                                << ", " << file_read_time.time_since_epoch().count());
-    return validation_result;
+    return from != nullptr && from->generation == generation->load(std::memory_order_acquire);
+}
+
+void RamDb::CommitUnsafe()
+{
+    if constexpr(!DisableUserDbFileIO)
+        generation->fetch_add(1, std::memory_order_acq_rel);
 }
 
 void RamDb::Prefetch()
@@ -307,6 +756,11 @@ void RamDb::Prefetch()
         MIOPEN_THROW("Prefetch should never happen with disabled File IO");
 
     Measure("Prefetch", [this]() {
+        // Writers bump the generation under the same lock, so it matches the file contents.
+        auto loaded        = std::make_shared<Snapshot>();
+        auto cache         = std::make_shared<Cache>();
+        loaded->generation = generation->load(std::memory_order_acquire);
+
         auto file = std::ifstream{GetFileName()};
 
         if(!file)
@@ -314,10 +768,10 @@ void RamDb::Prefetch()
             const auto log_level =
                 IsWarningIfUnreadable() ? LoggingLevel::Warning : LoggingLevel::Info;
             MIOPEN_LOG(log_level, "File is unreadable: " << GetFileName());
+            std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>{std::move(loaded)});
             return;
         }
 
-        cache.clear();
         auto line   = std::string{};
         auto n_line = 0;
 
@@ -325,7 +779,8 @@ void RamDb::Prefetch()
         {
             ++n_line;
 
-            if(line.empty())
+            // Skip empty lines and records marked dead by PlainTextDb.
+            if(line.empty() || line[0] == '#')
                 continue;
 
             const auto key_size = line.find('=');
@@ -341,39 +796,52 @@ void RamDb::Prefetch()
             const auto key      = line.substr(0, key_size);
             const auto contents = line.substr(key_size + 1);
 
-            cache.emplace(key, CacheItem{n_line, contents});
+            // The last one wins as it has been appended later, like in the index of PlainTextDb.
+            cache->insert_or_assign(key, CacheItem{n_line, contents});
         }
 
-        file_read_time = ramdb_clock::now();
+        loaded->cache = std::move(cache);
+        std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>{std::move(loaded)});
     });
 }
 
 #if MIOPEN_DB_CACHE_WRITE_THROUGH
-void RamDb::UpdateCacheEntryUnsafe(const DbRecord& record)
+template <class TModifier>
+void RamDb::UpdateCacheUnsafe(const std::shared_ptr<const Snapshot>& from, TModifier&& modifier)
 {
-    const auto is_valid = ValidateUnsafe();
+    const auto is_valid = IsActual(from.get());
 
-    if constexpr(!DisableUserDbFileIO)
-        UpdateDbModificationTime(GetFileName());
+    CommitUnsafe();
 
-    if(is_valid)
-    {
-        const auto& key = record.GetKey();
-        const auto it   = cache.find(key);
-        auto ss         = std::ostringstream{};
-        record.WriteIdsAndValues(ss);
+    // The cache is behind changes made by another process, it is reloaded on the next read.
+    if(!is_valid)
+        return;
 
-        if(it != cache.end())
-        {
-            auto& item   = it->second;
-            item.content = ss.str();
-        }
-        else
+    // Readers may still hold the old snapshot, so the modified copy is published instead.
+    auto updated        = std::make_shared<Snapshot>(*from);
+    updated->generation = generation->load(std::memory_order_acquire);
+    modifier(updated->changes);
+
+    // Both copying of the changes on each write and merging them into the cache are linear, so
+    // the square root of the cache size as a limit keeps writes sublinear.
+    const auto max_changes =
+        std::max<std::size_t>(64, static_cast<std::size_t>(std::sqrt(updated->cache->size())));
+
+    if(updated->changes.size() > max_changes)
+    {
+        auto cache = std::make_shared<Cache>(*updated->cache);
+        for(auto& change : updated->changes)
         {
-            cache.emplace(key, CacheItem{-1, ss.str()});
+            if(change.second)
+                (*cache)[change.first] = std::move(*change.second);
+            else
+                cache->erase(change.first);
         }
-        file_read_time = ramdb_clock::now();
+        updated->cache = std::move(cache);
+        updated->changes.clear();
     }
+
+    std::atomic_store(&snapshot, std::shared_ptr<const Snapshot>{std::move(updated)});
 }
 #endif
 
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/readonly_binary_db.hpp>
+#include <miopen/logger.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <system_error>
+
+namespace miopen {
+
+ReadonlyBinaryDb&
+ReadonlyBinaryDb::GetCached(DbKinds db_kind_, const fs::path& path, bool warn_if_unreadable)
+{
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static std::mutex mutex;
+    const std::lock_guard<std::mutex> lock{mutex};
+
+    // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+    static auto instances = std::map<fs::path, std::unique_ptr<ReadonlyBinaryDb>>{};
+    const auto it         = instances.find(path);
+
+    if(it != instances.end())
+        return *it->second;
+
+    auto& instance = *instances.emplace(path, std::make_unique<ReadonlyBinaryDb>(db_kind_, path))
+                          .first->second;
+    instance.Prefetch(warn_if_unreadable);
+    return instance;
+}
+
+boost::optional<DbRecord> ReadonlyBinaryDb::FindRecord(const std::string& problem) const
+{
+    MIOPEN_LOG_I2("Looking for key " << problem << " in file " << db_path);
+
+    if(view.header == nullptr)
+        return boost::none;
+
+    const auto slot = view.Find(problem);
+    if(slot == nullptr)
+        return boost::none;
+
+    MIOPEN_LOG_I2("Key match: " << problem);
+
+    auto record = DbRecord{problem};
+    auto found  = 0;
+    for(auto i = slot->first_entry; i < slot->first_entry + slot->entry_count; ++i)
+    {
+        const auto& entry = view.entries[i];
+        if(record.AddItem(std::string{view.GetString(entry.id_offset, entry.id_size)},
+                          std::string{view.GetString(entry.values_offset, entry.values_size)}))
+            ++found;
+    }
+
+    // Same as the text db: a record without a single valid item is not a record.
+    if(found == 0)
+    {
+        MIOPEN_LOG_E("Error parsing payload under the key: " << problem << " form file "
+                                                             << db_path);
+        return boost::none;
+    }
+    return record;
+}
+
+void ReadonlyBinaryDb::Prefetch(bool warn_if_unreadable)
+{
+    namespace ipc = boost::interprocess;
+
+    if(db_path.empty())
+        return;
+
+    const auto start      = std::chrono::high_resolution_clock::now();
+    const auto image_path = GetImagePath(db_path);
+
+    try
+    {
+        const auto file = ipc::file_mapping{image_path.string().c_str(), ipc::read_only};
+        auto region     = std::make_shared<ipc::mapped_region>(file, ipc::read_only);
+
+        if(!view.Init(static_cast<const char*>(region->get_address()), region->get_size()))
+        {
+            MIOPEN_LOG_E("Ill-formed binary db: " << image_path);
+            view = {};
+            return;
+        }
+
+        storage = std::move(region);
+    }
+    catch(const ipc::interprocess_exception& ex)
+    {
+        const auto log_level = (warn_if_unreadable && !MIOPEN_DISABLE_SYSDB) ? LoggingLevel::Warning
+                                                                             : LoggingLevel::Info;
+        MIOPEN_LOG(log_level, "File is unreadable: " << image_path << ", " << ex.what());
+        return;
+    }
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    MIOPEN_LOG_I("ReadonlyBinaryDb::Prefetch time: " << (end - start).count() * .000001f
+                                                     << " ms, records: " << GetSize());
+}
+
+} // namespace miopen
@@ -33,10 +33,18 @@
 #include <miopen_data.hpp>
 #endif
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <mutex>
 #include <sstream>
 #include <map>
+#include <memory>
+#include <string_view>
+#include <system_error>
 
 namespace miopen {
 
@@ -91,28 +99,29 @@ static auto Measure(const std::string& funcName, TFunc&& func)
                                    << " ms");
 }
 
-void ReadonlyRamDb::ParseAndLoadDb(std::istream& input_stream, bool warn_if_unreadable)
+void ReadonlyRamDb::ParseAndLoadDb(std::string_view data)
 {
-    if(!input_stream)
-    {
-        const auto log_level = (warn_if_unreadable && !MIOPEN_DISABLE_SYSDB) ? LoggingLevel::Warning
-                                                                             : LoggingLevel::Info;
-        MIOPEN_LOG(log_level, "File is unreadable: " << db_path);
-        return;
-    }
+    // Reserve upfront, so the table is not rehashed while loading.
+    cache.reserve(std::count(data.begin(), data.end(), '\n') + 1);
 
-    auto line   = std::string{};
     auto n_line = 0;
 
-    while(std::getline(input_stream, line))
+    while(!data.empty())
     {
         ++n_line;
 
+        const auto line_size = data.find('\n');
+        auto line            = data.substr(0, line_size);
+        data.remove_prefix(line_size == std::string_view::npos ? data.size() : line_size + 1);
+
+        if(!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
         if(line.empty())
             continue;
 
         const auto key_size = line.find('=');
-        const bool is_key   = (key_size != std::string::npos && key_size != 0);
+        const bool is_key   = (key_size != std::string_view::npos && key_size != 0);
 
         if(!is_key)
         {
@@ -127,6 +136,47 @@ void ReadonlyRamDb::ParseAndLoadDb(std::istream& input_stream, bool warn_if_unre
     }
 }
 
+bool ReadonlyRamDb::MapFile()
+{
+    namespace ipc = boost::interprocess;
+
+    try
+    {
+        auto ec         = std::error_code{};
+        const auto size = fs::file_size(db_path, ec);
+        if(ec)
+            return false;
+        if(size == 0)
+            return true;
+
+        const auto file = ipc::file_mapping{db_path.string().c_str(), ipc::read_only};
+        auto region     = std::make_shared<ipc::mapped_region>(file, ipc::read_only);
+        region->advise(ipc::mapped_region::advice_willneed);
+
+        const auto data = std::string_view{static_cast<const char*>(region->get_address()),
+                                           region->get_size()};
+        storage         = std::move(region);
+        ParseAndLoadDb(data);
+        return true;
+    }
+    catch(const ipc::interprocess_exception& ex)
+    {
+        MIOPEN_LOG_I2("Unable to map " << db_path << ": " << ex.what());
+    }
+
+    // Mapping is not available, e.g. due to the file system, read the file into the memory.
+    auto input_stream = std::ifstream{db_path, std::ios::binary};
+    if(!input_stream)
+        return false;
+
+    auto contents = std::make_shared<std::string>(std::istreambuf_iterator<char>{input_stream},
+                                                  std::istreambuf_iterator<char>{});
+    const auto data = std::string_view{*contents};
+    storage         = std::move(contents);
+    ParseAndLoadDb(data);
+    return true;
+}
+
 void ReadonlyRamDb::Prefetch(bool warn_if_unreadable)
 {
     Measure("Prefetch", [this, warn_if_unreadable]() {
@@ -147,14 +197,16 @@ void ReadonlyRamDb::Prefetch(bool warn_if_unreadable)
             const auto& p = it_p->second;
             ptrdiff_t sz  = p.second - p.first;
             MIOPEN_LOG_I2("Loading In Memory file: " << filepath);
-            auto input_stream = std::stringstream(std::string(p.first, sz));
-            ParseAndLoadDb(input_stream, warn_if_unreadable);
+            // The embedded data lives as long as the library, no copy is required.
+            ParseAndLoadDb(std::string_view(p.first, sz));
 #endif
         }
-        else
+        else if(!MapFile())
         {
-            auto input_stream = std::ifstream{db_path};
-            ParseAndLoadDb(input_stream, warn_if_unreadable);
+            const auto log_level = (warn_if_unreadable && !MIOPEN_DISABLE_SYSDB)
+                                       ? LoggingLevel::Warning
+                                       : LoggingLevel::Info;
+            MIOPEN_LOG(log_level, "File is unreadable: " << db_path);
         }
     });
 }
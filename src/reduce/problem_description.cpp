@@ -25,23 +25,21 @@
  *******************************************************************************/
 
 #include <miopen/reduce/problem_description.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/names.hpp>
 
-#include <sstream>
-
 namespace miopen {
 
 namespace reduce {
 
 NetworkConfig ProblemDescription::MakeNetworkConfig() const
 {
-    auto xlength = xDesc.GetLengths();
-    std::vector<std::size_t> outputlength;
-    if((reduceExtremeOp == MIOPEN_REDUCE_EXTREME_MIN) ||
-       (reduceExtremeOp == MIOPEN_REDUCE_EXTREME_MAX))
-        outputlength = yDesc.GetLengths();
-    else
-        outputlength = indiceDesc.GetLengths();
+    const auto& xlength = xDesc.GetLengths();
+    const auto& outputlength =
+        ((reduceExtremeOp == MIOPEN_REDUCE_EXTREME_MIN) ||
+         (reduceExtremeOp == MIOPEN_REDUCE_EXTREME_MAX))
+            ? yDesc.GetLengths()
+            : indiceDesc.GetLengths();
 
     auto size         = xlength[dim];
     auto output_numel = std::accumulate(outputlength.begin(),
@@ -50,15 +48,15 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
                                         std::multiplies<size_t>());
     auto dtype        = xDesc.GetType();
 
-    std::ostringstream ss;
+    KeyWriter key;
 
-    ss << "dtype" << dtype;
-    ss << "dim" << dim;
-    ss << "size" << size;
-    ss << "output_numel" << output_numel;
-    ss << "reduceExtremeOp" << reduceExtremeOp;
+    key << "dtype" << dtype;
+    key << "dim" << dim;
+    key << "size" << size;
+    key << "output_numel" << output_numel;
+    key << "reduceExtremeOp" << reduceExtremeOp;
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 } // namespace reduce
@@ -0,0 +1,570 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/search_strategy.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace miopen {
+namespace solver {
+namespace search {
+
+std::ostream& operator<<(std::ostream& stream, Strategy strategy)
+{
+    switch(strategy)
+    {
+    case Strategy::Random: return stream << "random";
+    case Strategy::SuccessiveHalving: return stream << "halving";
+    case Strategy::ModelGuided: return stream << "model";
+    }
+    return stream << "<unknown>";
+}
+
+std::optional<Strategy> ParseStrategy(std::string_view name)
+{
+    if(name == "random")
+        return Strategy::Random;
+    if(name == "halving")
+        return Strategy::SuccessiveHalving;
+    if(name == "model")
+        return Strategy::ModelGuided;
+    return std::nullopt;
+}
+
+void SearchStrategy::Count(const Trial& trial, bool succeeded)
+{
+    ++trials;
+    runs += trial.runs;
+    if(!succeeded)
+        ++failed;
+}
+
+bool SearchStrategy::Conclude(std::size_t candidate, std::optional<float> time)
+{
+    if(time && *time < best_time)
+    {
+        best      = candidate;
+        best_time = *time;
+        stale     = 0;
+        return true;
+    }
+    ++stale;
+    return false;
+}
+
+void SearchStrategy::ResetBest()
+{
+    best.reset();
+    best_time = std::numeric_limits<float>::max();
+}
+
+namespace {
+
+// How far ahead of the planned order a ready candidate is taken.
+constexpr std::size_t ready_window = 32;
+
+class RandomSearch : public SearchStrategy
+{
+public:
+    RandomSearch(const Options& options, std::size_t candidates)
+        : SearchStrategy(candidates, options.patience),
+          max_runs(std::max<std::size_t>(options.max_runs, 1)),
+          done(candidates)
+    {
+    }
+
+    std::optional<Trial> Next() override
+    {
+        if(follow_up)
+            return Trial{follow_up->first, max_runs - 1};
+        if(OutOfPatience())
+            return std::nullopt;
+        const auto candidate = Pick();
+        if(!candidate)
+            return std::nullopt;
+        done[*candidate] = true;
+        return Trial{*candidate, 1};
+    }
+
+    std::optional<Trial> Next(const std::vector<bool>& ready) override
+    {
+        if(!follow_up && !OutOfPatience())
+        {
+            for(const auto candidate : Upcoming(ready_window))
+            {
+                if(ready[candidate])
+                {
+                    done[candidate] = true;
+                    return Trial{candidate, 1};
+                }
+            }
+        }
+        return Next();
+    }
+
+    void Report(const Trial& trial, std::optional<float> time) override
+    {
+        Count(trial, time.has_value());
+
+        if(follow_up)
+        {
+            // Smooth the jitter: decide on the average of all the runs.
+            const auto first = follow_up->second;
+            follow_up.reset();
+            if(time)
+                time = (first + *time * trial.runs) / static_cast<float>(trial.runs + 1);
+        }
+        else if(time && max_runs > 1 && *time / BestTime() < 1.05f)
+        {
+            // The first probe is not too bad, re-run it before deciding.
+            follow_up = {trial.candidate, *time};
+            return;
+        }
+
+        Observe(trial.candidate, time);
+        Conclude(trial.candidate, time);
+    }
+
+    std::vector<std::size_t> Upcoming(std::size_t max) const override
+    {
+        std::vector<std::size_t> upcoming;
+        for(auto i = cursor; i < done.size() && upcoming.size() < max; ++i)
+        {
+            if(!done[i])
+                upcoming.push_back(i);
+        }
+        return upcoming;
+    }
+
+protected:
+    /// The next candidate to measure, in the given order by default.
+    virtual std::optional<std::size_t> Pick()
+    {
+        while(cursor < done.size() && done[cursor])
+            ++cursor;
+        if(cursor == done.size())
+            return std::nullopt;
+        return cursor;
+    }
+
+    /// The final time of each candidate, nothing if it failed.
+    virtual void Observe(std::size_t, std::optional<float>) {}
+
+    bool IsDone(std::size_t candidate) const { return done[candidate]; }
+
+private:
+    std::size_t max_runs;
+    std::vector<bool> done;
+    std::size_t cursor = 0;
+    // The candidate re-run and the time of its first run.
+    std::optional<std::pair<std::size_t, float>> follow_up;
+};
+
+class ModelGuidedSearch : public RandomSearch
+{
+public:
+    ModelGuidedSearch(const Options& options,
+                      std::size_t candidates,
+                      std::vector<std::vector<double>> features_)
+        : RandomSearch(options, candidates),
+          neighbors(std::max<std::size_t>(options.neighbors, 1)),
+          warmup(options.warmup != 0 ? options.warmup
+                                     : std::clamp<std::size_t>(candidates / 20, 8, 64)),
+          refit(std::max<std::size_t>(warmup / 4, 1)),
+          features(std::move(features_))
+    {
+        if(features.size() != candidates)
+        {
+            // Nothing to learn from, falls back to the random order.
+            features.clear();
+            return;
+        }
+        Normalize();
+    }
+
+    std::vector<std::size_t> Upcoming(std::size_t max) const override
+    {
+        if(ranking.empty())
+            return RandomSearch::Upcoming(max);
+        std::vector<std::size_t> upcoming;
+        for(auto i = rank_cursor; i < ranking.size() && upcoming.size() < max; ++i)
+        {
+            if(!IsDone(ranking[i]))
+                upcoming.push_back(ranking[i]);
+        }
+        return upcoming;
+    }
+
+protected:
+    std::optional<std::size_t> Pick() override
+    {
+        if(features.empty() || observed.size() < warmup)
+            return RandomSearch::Pick();
+        // Keeps exploring a little, the model only knows the neighborhood of what it has seen.
+        if(++picks % explore_period == 0)
+            return RandomSearch::Pick();
+        if(ranking.empty() || observed.size() >= fitted + refit)
+            Fit();
+        while(rank_cursor < ranking.size() && IsDone(ranking[rank_cursor]))
+            ++rank_cursor;
+        if(rank_cursor == ranking.size())
+            return RandomSearch::Pick();
+        return ranking[rank_cursor];
+    }
+
+    void Observe(std::size_t candidate, std::optional<float> time) override
+    {
+        if(time && *time > 0.0f)
+            observed.emplace_back(candidate, std::log(*time));
+        else if(time)
+            observed.emplace_back(candidate, std::log(std::numeric_limits<float>::min()));
+        else
+            observed.emplace_back(candidate, std::nullopt);
+    }
+
+private:
+    static constexpr std::size_t explore_period = 8;
+
+    std::size_t neighbors;
+    std::size_t warmup;
+    std::size_t refit;
+    std::vector<std::vector<double>> features;
+    // Candidate and log of its time, nothing if it failed.
+    std::vector<std::pair<std::size_t, std::optional<double>>> observed;
+    // The candidates not measured when the model was fit, fastest predicted first.
+    std::vector<std::size_t> ranking;
+    std::size_t rank_cursor = 0;
+    std::size_t fitted      = 0;
+    std::size_t picks       = 0;
+
+    /// Scales every feature to [0, 1] so that none of them dominates the distance.
+    void Normalize()
+    {
+        std::size_t dims = 0;
+        for(const auto& f : features)
+            dims = std::max(dims, f.size());
+        for(auto& f : features)
+            f.resize(dims, 0.0);
+        for(std::size_t d = 0; d < dims; ++d)
+        {
+            const auto [lo, hi] = std::minmax_element(
+                features.begin(), features.end(), [&](const auto& a, const auto& b) {
+                    return a[d] < b[d];
+                });
+            const auto min   = (*lo)[d];
+            const auto range = (*hi)[d] - min;
+            for(auto& f : features)
+                f[d] = range > 0.0 ? (f[d] - min) / range : 0.0;
+        }
+    }
+
+    void Fit()
+    {
+        // Failed candidates count as twice as slow as the slowest one, so that their
+        // neighborhood is tried last.
+        auto penalty = std::optional<double>{};
+        for(const auto& o : observed)
+        {
+            if(o.second)
+                penalty = std::max(penalty.value_or(*o.second), *o.second);
+        }
+        const auto failed_value = penalty.value_or(0.0) + std::log(2.0);
+
+        std::vector<std::pair<double, std::size_t>> predicted;
+        for(std::size_t c = 0; c < features.size(); ++c)
+        {
+            if(!IsDone(c))
+                predicted.emplace_back(Predict(c, failed_value), c);
+        }
+        std::sort(predicted.begin(), predicted.end());
+
+        ranking.clear();
+        ranking.reserve(predicted.size());
+        for(const auto& p : predicted)
+            ranking.push_back(p.second);
+        rank_cursor = 0;
+        fitted      = observed.size();
+    }
+
+    /// Inverse distance weighted mean of the nearest measured candidates.
+    double Predict(std::size_t candidate, double failed_value) const
+    {
+        // Distance and value of the nearest ones, nearest first.
+        std::vector<std::pair<double, double>> nearest;
+        nearest.reserve(neighbors + 1);
+        const auto& x = features[candidate];
+        for(const auto& o : observed)
+        {
+            const auto& y = features[o.first];
+            auto distance = 0.0;
+            for(std::size_t d = 0; d < x.size(); ++d)
+                distance += (x[d] - y[d]) * (x[d] - y[d]);
+            if(nearest.size() == neighbors && distance >= nearest.back().first)
+                continue;
+            const auto at = std::upper_bound(
+                nearest.begin(), nearest.end(), distance, [](double v, const auto& n) {
+                    return v < n.first;
+                });
+            nearest.emplace(at, distance, o.second.value_or(failed_value));
+            if(nearest.size() > neighbors)
+                nearest.pop_back();
+        }
+
+        auto sum = 0.0;
+        auto sum_weights = 0.0;
+        for(const auto& n : nearest)
+        {
+            const auto weight = 1.0 / (std::sqrt(n.first) + 1e-6);
+            sum += weight * n.second;
+            sum_weights += weight;
+        }
+        return sum_weights > 0.0 ? sum / sum_weights : 0.0;
+    }
+};
+
+class SuccessiveHalvingSearch : public SearchStrategy
+{
+public:
+    SuccessiveHalvingSearch(const Options& options, std::size_t candidates)
+        : SearchStrategy(candidates, options.patience),
+          max_runs(std::max<std::size_t>(options.max_runs, 1)),
+          reduction(std::max<std::size_t>(options.reduction, 2)),
+          round(candidates)
+    {
+        for(std::size_t i = 0; i < candidates; ++i)
+            round[i] = i;
+    }
+
+    std::optional<Trial> Next() override
+    {
+        while(true)
+        {
+            // Patience only shortens the first round, the later ones are short anyway.
+            const auto stop = round_index == 0 && OutOfPatience();
+            if(!stop && position < round.size())
+                return Trial{round[position++], round_runs};
+            if(!NextRound())
+                return std::nullopt;
+        }
+    }
+
+    std::optional<Trial> Next(const std::vector<bool>& ready) override
+    {
+        const auto end = std::min(round.size(), position + ready_window);
+        if(!(round_index == 0 && OutOfPatience()))
+        {
+            for(auto i = position; i < end; ++i)
+            {
+                if(ready[round[i]])
+                {
+                    // The others keep their order.
+                    std::rotate(round.begin() + position, round.begin() + i, round.begin() + i + 1);
+                    break;
+                }
+            }
+        }
+        return Next();
+    }
+
+    void Report(const Trial& trial, std::optional<float> time) override
+    {
+        Count(trial, time.has_value());
+        if(time)
+            results.emplace_back(*time, trial.candidate);
+        Conclude(trial.candidate, time);
+    }
+
+    std::vector<std::size_t> Upcoming(std::size_t max) const override
+    {
+        const auto end = position + std::min(max, round.size() - position);
+        return {round.begin() + position, round.begin() + end};
+    }
+
+private:
+    std::size_t max_runs;
+    std::size_t reduction;
+    std::vector<std::size_t> round;
+    std::size_t round_index = 0;
+    std::size_t round_runs  = 1;
+    std::size_t position    = 0;
+    // Times of the current round.
+    std::vector<std::pair<float, std::size_t>> results;
+
+    bool NextRound()
+    {
+        std::sort(results.begin(), results.end());
+        if(!results.empty())
+        {
+            // The most runs decide the winner.
+            ResetBest();
+            Conclude(results.front().second, results.front().first);
+        }
+
+        const auto last = results.size() <= 1 || round_runs >= max_runs;
+        const auto keep = (results.size() + reduction - 1) / reduction;
+        round.clear();
+        position = 0;
+        if(!last)
+        {
+            for(std::size_t i = 0; i < keep; ++i)
+                round.push_back(results[i].second);
+            round_runs = std::min(round_runs * reduction, max_runs);
+            ++round_index;
+        }
+        results.clear();
+        return !last;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<SearchStrategy> MakeSearchStrategy(const Options& options,
+                                                   std::size_t candidates,
+                                                   std::vector<std::vector<double>> features)
+{
+    switch(options.strategy)
+    {
+    case Strategy::SuccessiveHalving:
+        return std::make_unique<SuccessiveHalvingSearch>(options, candidates);
+    case Strategy::ModelGuided:
+        return std::make_unique<ModelGuidedSearch>(options, candidates, std::move(features));
+    case Strategy::Random: break;
+    }
+    return std::make_unique<RandomSearch>(options, candidates);
+}
+
+std::vector<double> ParseFeatures(std::string_view serialized)
+{
+    std::vector<double> features;
+    std::size_t i = 0;
+    while(i < serialized.size())
+    {
+        const auto begin = i;
+        const auto negative =
+            serialized[i] == '-' && i + 1 < serialized.size() &&
+            std::isdigit(static_cast<unsigned char>(serialized[i + 1])) != 0 &&
+            (i == 0 || std::isalnum(static_cast<unsigned char>(serialized[i - 1])) == 0);
+        if(!negative && std::isdigit(static_cast<unsigned char>(serialized[i])) == 0)
+        {
+            ++i;
+            continue;
+        }
+        // Numbers that are part of a name like "xdlops" or "v4r1" are kept as well, they still
+        // tell the configs apart.
+        ++i;
+        while(i < serialized.size() &&
+              (std::isdigit(static_cast<unsigned char>(serialized[i])) != 0 ||
+               serialized[i] == '.'))
+            ++i;
+        features.push_back(std::strtod(std::string{serialized.substr(begin, i - begin)}.c_str(),
+                                       nullptr));
+    }
+    return features;
+}
+
+Result Run(SearchStrategy& strategy, const TimingOracle& oracle)
+{
+    while(const auto trial = strategy.Next())
+        strategy.Report(*trial, oracle(trial->candidate, trial->runs));
+    return {strategy.Best(),
+            strategy.BestTime(),
+            strategy.Trials(),
+            strategy.Runs(),
+            strategy.Failed()};
+}
+
+Scheduler::Scheduler(std::unique_ptr<SearchStrategy> strategy_)
+    : strategy(std::move(strategy_)),
+      claimed(strategy->Candidates()),
+      ready(strategy->Candidates())
+{
+}
+
+std::optional<Trial> Scheduler::Next()
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    return strategy->Next(ready);
+}
+
+void Scheduler::Report(const Trial& trial, std::optional<float> time)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    strategy->Report(trial, time);
+}
+
+std::optional<std::size_t> Scheduler::ClaimNext()
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    // The claimed candidates not measured yet are few, they are at most a queue ahead.
+    for(std::size_t max = 16;; max *= 2)
+    {
+        const auto upcoming = strategy->Upcoming(max);
+        for(const auto candidate : upcoming)
+        {
+            if(!claimed[candidate])
+            {
+                claimed[candidate] = true;
+                return candidate;
+            }
+        }
+        if(upcoming.size() < max)
+            return std::nullopt;
+    }
+}
+
+bool Scheduler::Claim(std::size_t candidate)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    if(claimed[candidate])
+        return false;
+    claimed[candidate] = true;
+    return true;
+}
+
+void Scheduler::MarkReady(std::size_t candidate)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    ready[candidate] = true;
+}
+
+std::optional<std::size_t> Scheduler::Best() const
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    return strategy->Best();
+}
+
+float Scheduler::BestTime() const
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    return strategy->BestTime();
+}
+
+} // namespace search
+} // namespace solver
+} // namespace miopen
@@ -26,9 +26,9 @@
 
 #include <miopen/datatype.hpp>
 #include <miopen/softmax/problem_description.hpp>
+#include <miopen/key_writer.hpp>
 #include <miopen/names.hpp>
 
-#include <sstream>
 #include <string_view>
 
 namespace miopen {
@@ -37,28 +37,29 @@ namespace softmax {
 
 NetworkConfig ProblemDescription::MakeNetworkConfig() const
 {
-    std::ostringstream ss(isForward ? "sfmfwd-" : "sfmbwd-");
+    KeyWriter key;
+    key << (isForward ? "sfmfwd-" : "sfmbwd-");
 
     // all the tensors must be the same size and types
     // so we can use only one set of values
     const auto& desc            = isForward ? xdxDesc : yDesc;
     const auto [sn, sc, sh, sw] = tien<4>(desc.GetLengths());
-    ss << "n" << sn << "c" << sc << "h" << sh << "w" << sw;
-    ss << GetDataType(desc.GetType());
-    ss << "a" << alpha;
-    ss << "b" << beta;
-    ss << "algo" << static_cast<int>(algorithm);
-    ss << "mode" << static_cast<int>(mode);
+    key << "n" << sn << "c" << sc << "h" << sh << "w" << sw;
+    key << GetDataType(desc.GetType());
+    key << "a" << alpha;
+    key << "b" << beta;
+    key << "algo" << static_cast<int>(algorithm);
+    key << "mode" << static_cast<int>(mode);
 
-    auto printStrides = [&ss](std::string_view name, const miopen::TensorDescriptor& d) {
+    auto printStrides = [&key](std::string_view name, const miopen::TensorDescriptor& d) {
         if(d.IsPacked())
         {
-            ss << name << "pk1";
+            key << name << "pk1";
         }
         else
         {
             const auto [n, c, h, w] = tien<4>(d.GetStrides());
-            ss << name << "pk0strides" << n << "x" << c << "x" << h << "x" << w;
+            key << name << "pk0strides" << n << "x" << c << "x" << h << "x" << w;
         }
     };
 
@@ -74,7 +75,7 @@ NetworkConfig ProblemDescription::MakeNetworkConfig() const
         printStrides("dx", xdxDesc);
     }
 
-    return NetworkConfig{ss.str()};
+    return NetworkConfig{key.Str()};
 }
 
 } // namespace softmax
@@ -175,6 +175,13 @@ std::string Id::ToString() const
     return IdRegistry().value_to_entry[value].str_value;
 }
 
+std::string_view Id::GetName() const
+{
+    const auto it = IdRegistry().value_to_entry.find(value);
+    return it != IdRegistry().value_to_entry.end() ? std::string_view{it->second.str_value}
+                                                   : std::string_view{};
+}
+
 AnySolver Id::GetSolver() const
 {
     const auto it = IdRegistry().value_to_entry.find(value);
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/solver_applicability_cache.hpp>
+
+#include <miopen/env.hpp>
+
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_DEBUG_SOLVER_APPLICABILITY_CACHE_SIZE, 256)
+
+namespace miopen {
+
+SolverApplicabilityCache::SolverApplicabilityCache()
+    : SolverApplicabilityCache(env::value(MIOPEN_DEBUG_SOLVER_APPLICABILITY_CACHE_SIZE))
+{
+}
+
+SolverApplicabilityCache::SolverApplicabilityCache(std::size_t capacity_)
+    : capacity(capacity_), env_updates(env::getUpdateCount())
+{
+}
+
+SolverApplicabilityCache::Results* SolverApplicabilityCache::Get(std::string_view problem_key)
+{
+    if(capacity == 0)
+        return nullptr;
+
+    const auto updates = env::getUpdateCount();
+    if(updates != env_updates)
+    {
+        Clear();
+        env_updates = updates;
+    }
+
+    const auto found = index.find(problem_key);
+    if(found != index.end())
+    {
+        lru.splice(lru.begin(), lru, found->second);
+        return &found->second->results;
+    }
+
+    if(lru.size() >= capacity)
+    {
+        index.erase(lru.back().key);
+        lru.pop_back();
+    }
+
+    lru.push_front({std::string{problem_key}, {}});
+    index.emplace(lru.front().key, lru.begin());
+    return &lru.front().results;
+}
+
+void SolverApplicabilityCache::Clear()
+{
+    index.clear();
+    lru.clear();
+}
+
+} // namespace miopen
@@ -41,20 +41,78 @@
 
 #include <memory>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
 #include <fstream>
 #include <ios>
+#include <list>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 extern "C" {
 int miopen_sqlite3_memvfs_init(sqlite3* db, char** pzErrMsg, const sqlite3_api_routines* pApi);
 }
 namespace miopen {
 
+using sqlite3_stmt_ptr = MIOPEN_MANAGE_PTR(sqlite3_stmt*, sqlite3_finalize);
+
+namespace {
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<std::size_t> prepared_count{0};
+} // namespace
+
+/// Keeps recently used prepared statements of a connection keyed by their query text. A statement
+/// is checked out exclusively while in use, so threads sharing a connection never step the same
+/// statement handle. Once returned it is reset and its bindings are cleared, which is all that is
+/// needed to run it again with new parameters.
+class StatementCache
+{
+public:
+    static constexpr std::size_t capacity = 64;
+
+    sqlite3_stmt_ptr Acquire(const std::string& query)
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+        const auto it = index.find(query);
+        if(it == index.end())
+            return nullptr;
+        auto stmt = std::move(it->second->second);
+        entries.erase(it->second);
+        index.erase(it);
+        return stmt;
+    }
+
+    void Release(const std::string& query, sqlite3_stmt_ptr stmt)
+    {
+        sqlite3_reset(stmt.get());
+        sqlite3_clear_bindings(stmt.get());
+
+        const std::lock_guard<std::mutex> lock{mutex};
+        // Another thread has already returned a statement for the same query.
+        if(index.find(query) != index.end())
+            return;
+        entries.emplace_front(query, std::move(stmt));
+        index.emplace(query, entries.begin());
+        if(entries.size() > capacity)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+private:
+    using Entries = std::list<std::pair<std::string, sqlite3_stmt_ptr>>;
+
+    std::mutex mutex;
+    Entries entries;
+    std::unordered_map<std::string, Entries::iterator> index;
+};
+
 class SQLite::impl
 {
     struct SQLiteCloser
@@ -189,6 +247,8 @@ public:
 
     sqlite3_ptr ptrDb = nullptr;
     bool isValid;
+    // Declared after the connection so that cached statements are finalized before it is closed.
+    StatementCache statements;
 };
 
 static int find_callback(void* _res, int argc, char** argv, char** azColName)
@@ -281,14 +341,17 @@ std::string SQLite::ErrorMessage() const
     return errMsg + sqlite3_errmsg(pImpl->ptrDb.get());
 }
 bool SQLite::Valid() const { return pImpl->isValid; }
+std::size_t SQLite::GetPreparedCount() { return prepared_count; }
 
 class SQLite::Statement::impl
 {
-    using sqlite3_stmt_ptr = MIOPEN_MANAGE_PTR(sqlite3_stmt*, sqlite3_finalize);
     sqlite3_stmt_ptr Prepare(const SQLite& sql, const std::string& query)
     {
-        sqlite3_stmt* ptr = nullptr;
         MIOPEN_LOG_I2(query);
+        auto cached = sql.pImpl->statements.Acquire(query);
+        if(cached)
+            return cached;
+        sqlite3_stmt* ptr = nullptr;
         auto rc =
             sqlite3_prepare_v2(sql.pImpl->ptrDb.get(), query.c_str(), query.size(), &ptr, nullptr);
         if(rc != SQLITE_OK)
@@ -296,14 +359,19 @@ class SQLite::Statement::impl
             std::string err_msg = "SQLite prepare error: ";
             MIOPEN_THROW(miopenStatusInternalError, err_msg + sql.ErrorMessage());
         }
+        ++prepared_count;
         return sqlite3_stmt_ptr{ptr};
     }
 
 public:
-    impl(const SQLite& sql, const std::string& query) { ptrStmt = Prepare(sql, query); }
-    impl(const SQLite& sql, const std::string& query, const std::vector<std::string>& vals)
+    impl(const SQLite& sql, const std::string& query_)
+        : cache(&sql.pImpl->statements), query(query_)
     {
         ptrStmt = Prepare(sql, query);
+    }
+    impl(const SQLite& sql, const std::string& query_, const std::vector<std::string>& vals)
+        : impl(sql, query_)
+    {
         int cnt = 1;
         for(auto& kinder : vals)
         {
@@ -314,7 +382,16 @@ public:
         }
         MIOPEN_LOG_I2("[" << JoinStrings(vals, ",") << "]");
     }
+    impl(const impl&) = delete;
+    impl& operator=(const impl&) = delete;
+    ~impl()
+    {
+        if(ptrStmt)
+            cache->Release(query, std::move(ptrStmt));
+    }
 
+    StatementCache* cache;
+    std::string query;
     sqlite3_stmt_ptr ptrStmt = nullptr;
 };
 
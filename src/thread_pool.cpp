@@ -0,0 +1,326 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/thread_pool.hpp>
+
+#include <miopen/env.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <tuple>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+MIOPEN_DECLARE_ENV_VAR_UINT64(MIOPEN_THREAD_POOL_SIZE)
+
+namespace miopen {
+
+namespace {
+
+// The pool and the index of the worker the thread is, if it is one.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker     = 0;
+
+// The shared pool, for the fork handlers.
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<ThreadPool*> forked_pool{nullptr};
+
+} // namespace
+
+struct ThreadPool::Loop
+{
+    Loop(std::size_t n_, std::size_t grain_, const std::function<void(std::size_t)>& f_)
+        : n(n_), grain(grain_), f(f_)
+    {
+    }
+
+    const std::size_t n;
+    const std::size_t grain;
+    const std::function<void(std::size_t)>& f;
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+
+    std::mutex mutex;
+    std::condition_variable all_done;
+    std::size_t done = 0;
+    std::exception_ptr error;
+
+    /// Takes chunks of indices until there are none left.
+    void Run()
+    {
+        auto finished = std::size_t{0};
+        auto failure  = std::exception_ptr{};
+        for(auto begin = next.fetch_add(grain); begin < n; begin = next.fetch_add(grain))
+        {
+            const auto end = std::min(n, begin + grain);
+            // Once a call failed the rest are only counted.
+            for(auto i = begin; i < end && !failed.load(std::memory_order_relaxed); ++i)
+            {
+                try
+                {
+                    f(i);
+                }
+                catch(...)
+                {
+                    failure = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            finished += end - begin;
+        }
+
+        if(finished == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if(failure && !error)
+            error = failure;
+        done += finished;
+        if(done == n)
+            all_done.notify_all();
+    }
+};
+
+ThreadPool::ThreadPool(std::size_t workers_)
+{
+    workers.reserve(workers_);
+    for(auto i = std::size_t{0}; i < workers_; ++i)
+        workers.emplace_back(std::make_unique<Worker>());
+}
+
+ThreadPool::~ThreadPool()
+{
+    auto* self = this;
+    forked_pool.compare_exchange_strong(self, nullptr);
+    Stop();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    static ThreadPool pool{env::value_or(
+        MIOPEN_THREAD_POOL_SIZE,
+        static_cast<unsigned long long>(std::max(std::thread::hardware_concurrency(), 1u) - 1))};
+    static const auto fork_handlers = []() {
+        forked_pool = &pool;
+#ifndef _WIN32
+        pthread_atfork(&BeforeFork, &AfterForkInParent, &AfterForkInChild);
+#endif
+        return true;
+    }();
+    std::ignore = fork_handlers;
+    return pool;
+}
+
+void ThreadPool::StartUnsafe()
+{
+    if(started)
+        return;
+    started  = true;
+    stopping = false;
+    threads.reserve(workers.size());
+    for(auto i = std::size_t{0}; i < workers.size(); ++i)
+        threads.emplace_back([this, i]() { Work(i); });
+}
+
+void ThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    has_work.notify_all();
+    for(auto& thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+void ThreadPool::Push(Task task)
+{
+    const auto index = current_pool == this ? current_worker
+                                            : next_worker.fetch_add(1) % workers.size();
+    {
+        auto& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+        pending.fetch_add(1);
+    }
+    {
+        // Sleeping workers check pending under this lock, so the notification is not lost.
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    has_work.notify_one();
+}
+
+bool ThreadPool::TryRunOne(std::size_t self)
+{
+    auto task = Task{};
+    for(auto k = std::size_t{0}; k < workers.size() && !task; ++k)
+    {
+        auto& worker = *workers[(self + k) % workers.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if(worker.tasks.empty())
+            continue;
+        // The newest task of its own, the oldest one of the others.
+        if(k == 0)
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        pending.fetch_sub(1);
+    }
+
+    if(!task)
+        return false;
+    task();
+    return true;
+}
+
+void ThreadPool::Work(std::size_t self)
+{
+    current_pool   = this;
+    current_worker = self;
+
+    while(true)
+    {
+        if(TryRunOne(self))
+            continue;
+        std::unique_lock<std::mutex> lock(mutex);
+        has_work.wait(lock, [&]() { return stopping || pending.load() != 0; });
+        if(stopping)
+            return;
+    }
+}
+
+void ThreadPool::ParallelFor(std::size_t n,
+                             const std::function<void(std::size_t)>& f,
+                             std::size_t max_threads)
+{
+    if(n == 0)
+        return;
+
+    const auto helpers =
+        std::min({workers.size(), n - 1, std::max<std::size_t>(max_threads, 1) - 1});
+    if(helpers == 0)
+    {
+        for(auto i = std::size_t{0}; i < n; ++i)
+            f(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        StartUnsafe();
+    }
+
+    // Several chunks per thread keep them busy when the calls take different time.
+    const auto grain = std::max<std::size_t>(1, n / ((helpers + 1) * 4));
+    const auto loop  = std::make_shared<Loop>(n, grain, f);
+    for(auto i = std::size_t{0}; i < helpers; ++i)
+        Push([loop]() { loop->Run(); });
+
+    loop->Run();
+
+    // Helpers that come late find no indices left and do not touch f.
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->all_done.wait(lock, [&]() { return loop->done == n; });
+    if(loop->error)
+        std::rethrow_exception(loop->error);
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    auto future   = packaged->get_future();
+    if(workers.empty())
+    {
+        (*packaged)();
+        return future;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        StartUnsafe();
+    }
+    Push([packaged]() { (*packaged)(); });
+    return future;
+}
+
+std::future<void> ThreadPool::Spawn(std::function<void()> task)
+{
+    if(workers.empty())
+        return std::async(std::launch::async, std::move(task));
+    return Submit(std::move(task));
+}
+
+void ThreadPool::BeforeFork()
+{
+    auto* const pool = forked_pool.load();
+    if(pool == nullptr)
+        return;
+    // The child gets the locks from this thread, so they are not held by threads it lacks.
+    pool->mutex.lock();
+    for(auto& worker : pool->workers)
+        worker->mutex.lock();
+}
+
+void ThreadPool::AfterForkInParent()
+{
+    auto* const pool = forked_pool.load();
+    if(pool == nullptr)
+        return;
+    for(auto& worker : pool->workers)
+        worker->mutex.unlock();
+    pool->mutex.unlock();
+}
+
+void ThreadPool::AfterForkInChild()
+{
+    auto* const pool = forked_pool.load();
+    if(pool == nullptr)
+        return;
+    for(auto& worker : pool->workers)
+    {
+        // The tasks belong to loops of threads the child does not have.
+        worker->tasks.clear();
+        worker->mutex.unlock();
+    }
+    pool->pending = 0;
+    // The threads do not exist here, so they can be neither joined nor destroyed.
+    // NOLINTNEXTLINE (cppcoreguidelines-owning-memory)
+    std::ignore = new std::vector<std::thread>(std::move(pool->threads));
+    pool->threads.clear();
+    pool->started = false;
+    pool->mutex.unlock();
+}
+
+} // namespace miopen
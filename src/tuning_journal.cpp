@@ -0,0 +1,202 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/tuning_journal.hpp>
+
+#include <miopen/db_path.hpp>
+#include <miopen/env.hpp>
+#include <miopen/logger.hpp>
+#include <miopen/md5.hpp>
+
+#include <iomanip>
+#include <limits>
+
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_TUNING_JOURNAL)
+
+namespace miopen {
+namespace solver {
+
+namespace {
+
+constexpr std::string_view failed = "failed";
+constexpr char end_of_trial        = ';';
+
+std::unique_lock<LockFile> TryLock(const fs::path& path)
+{
+    try
+    {
+        return {LockFile::Get(LockFilePath(path)), std::try_to_lock};
+    }
+    catch(const std::exception& ex)
+    {
+        MIOPEN_LOG_W("Unable to lock the tuning journal " << path << ": " << ex.what());
+        return {};
+    }
+}
+
+} // namespace
+
+fs::path TuningJournal::GetPath(const std::string& arch,
+                                const std::string& solver_id,
+                                const std::string& problem_key)
+{
+    if(MIOPEN_DISABLE_USERDB || env::disabled(MIOPEN_DEBUG_TUNING_JOURNAL))
+        return {};
+    const auto& udb = GetUserDbPath();
+    if(udb.empty())
+        return {};
+    return udb / "tuning" /
+           (arch + "_" + solver_id + "_" + md5(problem_key) + "." + GetUserDbSuffix() + ".txt");
+}
+
+void TuningJournal::Remove(const std::string& arch,
+                           const std::string& solver_id,
+                           const std::string& problem_key)
+{
+    const auto path = GetPath(arch, solver_id, problem_key);
+    if(path.empty() || !fs::exists(path))
+        return;
+    // Left to the search which has it open.
+    const auto lock = TryLock(path);
+    std::error_code ec;
+    if(lock.owns_lock() && fs::remove(path, ec))
+        MIOPEN_LOG_I2("Tuning journal removed: " << path);
+}
+
+TuningJournal::TuningJournal(const std::string& arch,
+                             const std::string& solver_id,
+                             const std::string& problem_key)
+    : path(GetPath(arch, solver_id, problem_key))
+{
+    if(path.empty())
+        return;
+
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    lock = TryLock(path);
+    if(!lock.owns_lock())
+    {
+        MIOPEN_LOG_W("The tuning journal is used by another search: " << path);
+        path.clear();
+        return;
+    }
+
+    const auto loaded = Load(problem_key);
+    // Starts over if the journal belongs to another problem.
+    const auto mode = loaded == LoadResult::OtherProblem ? std::ios::trunc : std::ios::app;
+    file.open(path, std::ios::out | mode);
+    if(!file)
+    {
+        MIOPEN_LOG_W("Unable to write the tuning journal: " << path);
+        path.clear();
+        lock = {};
+        return;
+    }
+    if(loaded == LoadResult::OtherProblem)
+        file << problem_key << std::endl;
+    else if(loaded == LoadResult::CutShort)
+        file << std::endl;
+    if(!trials.empty())
+        MIOPEN_LOG_W("Resuming the search from " << trials.size() << " trials in " << path);
+    file << std::setprecision(std::numeric_limits<float>::max_digits10);
+}
+
+TuningJournal::LoadResult TuningJournal::Load(const std::string& problem_key)
+{
+    std::ifstream in{path};
+    std::string line;
+    if(!std::getline(in, line) || line != problem_key)
+        return LoadResult::OtherProblem;
+    if(in.eof())
+        return LoadResult::CutShort;
+
+    auto result = LoadResult::Complete;
+    while(std::getline(in, line))
+    {
+        // Cut short by whatever interrupted the search. The line break written after it
+        // does not complete it.
+        if(in.eof())
+            result = LoadResult::CutShort;
+        if(line.empty() || line.back() != end_of_trial)
+            continue;
+        line.pop_back();
+        const auto colon = line.find(':');
+        const auto equal = line.rfind('=');
+        if(colon == std::string::npos || equal == std::string::npos || equal < colon)
+            continue;
+        try
+        {
+            const auto runs  = std::stoul(line.substr(0, colon));
+            const auto value = line.substr(equal + 1);
+            auto time        = std::optional<float>{};
+            if(value != failed)
+                time = std::stof(value);
+            trials[{line.substr(colon + 1, equal - colon - 1), runs}] = time;
+        }
+        catch(const std::exception&)
+        {
+            MIOPEN_LOG_W("Skipped a malformed line of the tuning journal: " << line);
+        }
+    }
+    return result;
+}
+
+std::optional<std::optional<float>> TuningJournal::Find(const std::string& config,
+                                                        std::size_t runs) const
+{
+    const auto found = trials.find({config, runs});
+    if(found == trials.end())
+        return std::nullopt;
+    return found->second;
+}
+
+void TuningJournal::Record(const std::string& config, std::size_t runs, std::optional<float> time)
+{
+    if(!IsEnabled())
+        return;
+    trials[{config, runs}] = time;
+    file << runs << ':' << config << '=';
+    if(time)
+        file << *time;
+    else
+        file << failed;
+    // Flushed, the process may not get to close the file.
+    file << end_of_trial << std::endl;
+}
+
+void TuningJournal::Remove()
+{
+    if(!IsEnabled())
+        return;
+    file.close();
+    std::error_code ec;
+    fs::remove(path, ec);
+    path.clear();
+    trials.clear();
+    lock = {};
+}
+
+} // namespace solver
+} // namespace miopen
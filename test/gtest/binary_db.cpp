@@ -0,0 +1,140 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/binary_db_format.hpp>
+#include <miopen/readonly_binary_db.hpp>
+#include <miopen/tmp_dir.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST(TestBinaryDb, ParseLine)
+{
+    auto record    = miopen::binary_db::Record{};
+    auto malformed = std::vector<std::string_view>{};
+
+    ASSERT_TRUE(miopen::binary_db::ParseLine("1x2=s0:1,2;s1:;bad;s2:3", record, &malformed));
+    ASSERT_EQ(malformed.size(), 1u);
+    EXPECT_EQ(malformed[0], "bad");
+    EXPECT_EQ(record.first, "1x2");
+    ASSERT_EQ(record.second.size(), 3u);
+    EXPECT_EQ(record.second[0].first, "s0");
+    EXPECT_EQ(record.second[0].second, "1,2");
+    EXPECT_EQ(record.second[1].first, "s1");
+    EXPECT_EQ(record.second[1].second, "");
+    EXPECT_EQ(record.second[2].first, "s2");
+
+    EXPECT_FALSE(miopen::binary_db::ParseLine("=s0:1", record));
+    EXPECT_FALSE(miopen::binary_db::ParseLine("s0:1", record));
+}
+
+TEST(TestBinaryDb, FindsEveryRecord)
+{
+    constexpr auto n_records = 1000u;
+
+    auto records = std::vector<miopen::binary_db::Record>{};
+    for(auto i = 0u; i < n_records; ++i)
+        records.push_back({std::to_string(i) + "x" + std::to_string(i * 7),
+                           {{"s0", std::to_string(i)}, {"s1", std::to_string(i * 3)}}});
+
+    const auto tmp   = miopen::TmpDir{"binary_db"};
+    const auto path  = tmp.path / "test.fdb.txt";
+    const auto image = miopen::binary_db::Build(records);
+    std::ofstream(miopen::ReadonlyBinaryDb::GetImagePath(path), std::ios::binary)
+        .write(image.data(), image.size());
+
+    const auto& db = miopen::ReadonlyBinaryDb::GetCached(miopen::DbKinds::PerfDb, path, true);
+    ASSERT_EQ(db.GetSize(), n_records);
+
+    for(const auto& record : records)
+    {
+        const auto found = db.FindRecord(record.first);
+        ASSERT_TRUE(found);
+        EXPECT_EQ(found->GetKey(), record.first);
+        EXPECT_EQ(found->GetSize(), record.second.size());
+    }
+
+    EXPECT_FALSE(db.FindRecord(std::string{"1x8"}));
+    EXPECT_FALSE(db.FindRecord(std::string{""}));
+}
+
+TEST(TestBinaryDb, RejectsMalformedImage)
+{
+    const auto records =
+        std::vector<miopen::binary_db::Record>{{"1x2", {{"s0", "1"}}}, {"3x4", {{"s0", "2"}}}};
+    const auto image = miopen::binary_db::Build(records);
+
+    auto view = miopen::binary_db::View{};
+    ASSERT_TRUE(view.Init(image.data(), image.size()));
+    EXPECT_FALSE(view.Init(image.data(), image.size() - 1));
+
+    const auto strings_offset = image.size() - view.header->strings_size;
+    const auto slots_offset =
+        sizeof(miopen::binary_db::Header) + view.header->bucket_count * sizeof(std::uint32_t);
+    const auto entries_offset = slots_offset + 2 * sizeof(miopen::binary_db::Slot);
+    ASSERT_EQ(entries_offset + 2 * sizeof(miopen::binary_db::Entry), strings_offset);
+
+    const auto corrupt = [&](std::size_t offset, std::uint32_t value) {
+        auto copy = image;
+        std::memcpy(copy.data() + offset, &value, sizeof(value));
+        return miopen::binary_db::View{}.Init(copy.data(), copy.size());
+    };
+
+    // Slot::key_size, Slot::entry_count, Entry::values_offset
+    EXPECT_FALSE(corrupt(slots_offset + 4, view.header->strings_size + 1));
+    EXPECT_FALSE(corrupt(slots_offset + 12, 3));
+    EXPECT_FALSE(corrupt(entries_offset + 8, 0xFFFFFFFF));
+}
+
+TEST(TestBinaryDb, RecordWithoutItems)
+{
+    const auto records =
+        std::vector<miopen::binary_db::Record>{{"1x2", {}}, {"3x4", {{"s0", "2"}}}};
+
+    const auto tmp   = miopen::TmpDir{"binary_db"};
+    const auto path  = tmp.path / "empty_items.fdb.txt";
+    const auto image = miopen::binary_db::Build(records);
+    std::ofstream(miopen::ReadonlyBinaryDb::GetImagePath(path), std::ios::binary)
+        .write(image.data(), image.size());
+
+    // Same as the text db, a key without items is not found.
+    const auto& db = miopen::ReadonlyBinaryDb::GetCached(miopen::DbKinds::PerfDb, path, true);
+    EXPECT_FALSE(db.FindRecord(std::string{"1x2"}));
+    EXPECT_TRUE(db.FindRecord(std::string{"3x4"}));
+}
+
+TEST(TestBinaryDb, MissingImage)
+{
+    const auto tmp = miopen::TmpDir{"binary_db"};
+    const auto& db =
+        miopen::ReadonlyBinaryDb::GetCached(miopen::DbKinds::PerfDb, tmp.path / "none", false);
+    EXPECT_EQ(db.GetSize(), 0u);
+    EXPECT_FALSE(db.FindRecord(std::string{"1x2"}));
+}
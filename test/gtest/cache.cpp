@@ -27,14 +27,23 @@
 #include <miopen/binary_cache.hpp>
 #include <miopen/bz2.hpp>
 #include <miopen/kern_db.hpp>
+#include <miopen/miopen.h>
 #include <miopen/temp_file.hpp>
+#include <miopen/tmp_dir.hpp>
 #include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
 #include <vector>
+#include "get_handle.hpp"
 #include "test.hpp"
 #include "random.hpp"
 
 #include <gtest/gtest.h>
 
+namespace fs = miopen::fs;
+
 #if MIOPEN_ENABLE_SQLITE
 std::vector<char> random_bytes(size_t length)
 {
@@ -133,6 +142,299 @@ TEST(TestCache, check_kern_db)
         EXPECT_TRUE(err_db.RemoveRecordUnsafe(cfg0));
     }
 }
+
+TEST(TestCache, check_kern_db_codecs)
+{
+    miopen::TempFile temp_file("tmp-kerndb");
+    auto header  = random_bytes(2048);
+    auto configs = std::vector<miopen::KernelConfig>{};
+    for(auto i = 0; i < 64; ++i)
+    {
+        miopen::KernelConfig cfg;
+        cfg.kernel_name = "kernel" + std::to_string(i);
+        cfg.kernel_args = "-DINDEX=" + std::to_string(i);
+        cfg.kernel_blob = header;
+        auto tail       = random_bytes(2048);
+        cfg.kernel_blob.insert(cfg.kernel_blob.end(), tail.begin(), tail.end());
+        configs.push_back(std::move(cfg));
+    }
+
+    // Rows of every codec can be read back whatever codec the db writes with.
+    const auto codecs = {
+        miopen::KernelCodec::None, miopen::KernelCodec::Bz2, miopen::KernelCodec::Zstd};
+    auto stored = std::vector<miopen::KernelConfig>{};
+    for(auto codec : codecs)
+    {
+        if(!miopen::IsCodecAvailable(codec))
+            continue;
+        miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false, codec);
+        stored.push_back(configs[stored.size()]);
+        EXPECT_TRUE(db.StoreRecordUnsafe(stored.back()));
+        for(const auto& cfg : stored)
+        {
+            auto readout = db.FindRecordUnsafe(cfg);
+            ASSERT_TRUE(readout);
+            EXPECT_TRUE(readout.get() == cfg.kernel_blob);
+        }
+    }
+
+    if(!miopen::IsCodecAvailable(miopen::KernelCodec::Zstd))
+        return;
+
+    {
+        miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false, miopen::KernelCodec::Zstd);
+        for(auto i = stored.size(); i < configs.size() / 2; ++i)
+        {
+            stored.push_back(configs[i]);
+            EXPECT_TRUE(db.StoreRecordUnsafe(stored.back()));
+        }
+        EXPECT_FALSE(db.HasDictionary());
+        ASSERT_TRUE(db.TrainDictionaryUnsafe(16 * 1024));
+        EXPECT_TRUE(db.HasDictionary());
+        for(auto i = stored.size(); i < configs.size(); ++i)
+        {
+            stored.push_back(configs[i]);
+            EXPECT_TRUE(db.StoreRecordUnsafe(stored.back()));
+        }
+    }
+
+    // The dictionary is loaded from the db file.
+    miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false, miopen::KernelCodec::Bz2);
+    for(const auto& cfg : stored)
+    {
+        auto readout = db.FindRecordUnsafe(cfg);
+        ASSERT_TRUE(readout);
+        EXPECT_TRUE(readout.get() == cfg.kernel_blob);
+    }
+    EXPECT_EQ(db.LoadBlobsUnsafe().size(), stored.size());
+}
+
+TEST(TestCache, check_kern_db_legacy_rows)
+{
+    miopen::KernelConfig cfg;
+    cfg.kernel_name = "kernel1";
+    cfg.kernel_args = "-DLEGACY=1";
+    cfg.kernel_blob = random_bytes(4096);
+
+    miopen::TempFile temp_file("tmp-kerndb");
+    {
+        // The table as it was before the codec column.
+        miopen::SQLite sql{temp_file, false};
+        sql.Exec("CREATE TABLE `kern_db` (`id` INTEGER PRIMARY KEY ASC, `kernel_name` TEXT NOT "
+                 "NULL, `kernel_args` TEXT NOT NULL, `kernel_blob` BLOB NOT NULL, `kernel_hash` "
+                 "TEXT NOT NULL, `uncompressed_size` INT NOT NULL);");
+        auto stmt = miopen::SQLite::Statement{
+            sql,
+            "INSERT INTO kern_db(kernel_name, kernel_args, kernel_blob, kernel_hash, "
+            "uncompressed_size) VALUES(?, ?, ?, ?, ?);"};
+        stmt.BindPath(1, cfg.kernel_name);
+        stmt.BindText(2, cfg.kernel_args);
+        stmt.BindBlob(3, miopen::compress(cfg.kernel_blob, nullptr));
+        stmt.BindText(4, miopen::md5(cfg.kernel_blob));
+        stmt.BindInt64(5, cfg.kernel_blob.size());
+        ASSERT_EQ(stmt.Step(sql), SQLITE_DONE);
+    }
+
+    // Read as it is through a system db.
+    {
+        miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, true);
+        auto readout = db.FindRecordUnsafe(cfg);
+        ASSERT_TRUE(readout);
+        EXPECT_TRUE(readout.get() == cfg.kernel_blob);
+    }
+
+    // Converted to the content-addressed tables through a user db.
+    miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+    auto readout = db.FindRecordUnsafe(cfg);
+    ASSERT_TRUE(readout);
+    EXPECT_TRUE(readout.get() == cfg.kernel_blob);
+    EXPECT_EQ(db.GetStatsUnsafe().blobs, 1u);
+    EXPECT_TRUE(db.StoreRecordUnsafe(cfg));
+}
+
+TEST(TestCache, check_kern_db_dedup)
+{
+    miopen::KernelConfig cfg0;
+    cfg0.kernel_name = "kernel1";
+    cfg0.kernel_args = "-DVARIANT=0";
+    cfg0.kernel_blob = random_bytes(4096);
+
+    // Different options which produce the same code object.
+    miopen::KernelConfig cfg1 = cfg0;
+    cfg1.kernel_args          = "-DVARIANT=1";
+
+    miopen::TempFile temp_file("tmp-kerndb");
+    miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+
+    EXPECT_TRUE(db.StoreRecordUnsafe(cfg0));
+    EXPECT_TRUE(db.StoreRecordUnsafe(cfg1));
+    auto stats = db.GetStatsUnsafe();
+    EXPECT_EQ(stats.kernels, 2u);
+    EXPECT_EQ(stats.blobs, 1u);
+    EXPECT_EQ(stats.undeduplicated_bytes, 2 * stats.stored_bytes);
+
+    // The shared blob outlives the first entry.
+    EXPECT_TRUE(db.RemoveRecordUnsafe(cfg0));
+    EXPECT_FALSE(db.FindRecordUnsafe(cfg0));
+    auto readout = db.FindRecordUnsafe(cfg1);
+    ASSERT_TRUE(readout);
+    EXPECT_TRUE(readout.get() == cfg1.kernel_blob);
+
+    // Replacing the last entry of a blob drops the blob.
+    cfg1.kernel_blob = random_bytes(4096);
+    EXPECT_TRUE(db.StoreRecordUnsafe(cfg1));
+    stats = db.GetStatsUnsafe();
+    EXPECT_EQ(stats.kernels, 1u);
+    EXPECT_EQ(stats.blobs, 1u);
+    readout = db.FindRecordUnsafe(cfg1);
+    ASSERT_TRUE(readout);
+    EXPECT_TRUE(readout.get() == cfg1.kernel_blob);
+
+    EXPECT_TRUE(db.RemoveRecordUnsafe(cfg1));
+    EXPECT_EQ(db.GetStatsUnsafe().blobs, 0u);
+}
+
+TEST(TestCache, check_kern_db_concurrent_stores)
+{
+    miopen::TempFile temp_file("tmp-kerndb");
+    {
+        miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+    }
+
+    // Connections of their own, as the processes sharing a user db have. Entries are replaced
+    // and removed while other connections store the same blobs.
+    auto blobs = std::vector<std::vector<char>>{};
+    for(auto i = 0; i < 4; ++i)
+        blobs.push_back(random_bytes(1024));
+    auto threads = std::vector<std::thread>{};
+    for(auto t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+            for(auto i = 0; i < 20; ++i)
+            {
+                miopen::KernelConfig cfg;
+                cfg.kernel_name = "kernel1";
+                cfg.kernel_args = "-DINDEX=" + std::to_string(i % 3);
+                cfg.kernel_blob = blobs[(t + i) % blobs.size()];
+                EXPECT_TRUE(db.StoreRecordUnsafe(cfg));
+                if(i % 4 == 0)
+                    EXPECT_TRUE(db.RemoveRecordUnsafe(cfg));
+            }
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+
+    // Every entry has its blob and every blob has an entry.
+    miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+    const auto orphans = db.sql.Exec(
+        "SELECT (SELECT COUNT(*) FROM kern_db WHERE kernel_hash NOT IN (SELECT kernel_hash FROM "
+        "kern_db_blob)) AS entries, (SELECT COUNT(*) FROM kern_db_blob WHERE kernel_hash NOT IN "
+        "(SELECT kernel_hash FROM kern_db)) AS blobs;");
+    ASSERT_EQ(orphans.size(), 1u);
+    EXPECT_EQ(orphans[0].at("entries"), "0");
+    EXPECT_EQ(orphans[0].at("blobs"), "0");
+}
+
+TEST(TestCache, check_kern_db_eviction)
+{
+    miopen::TempFile temp_file("tmp-kerndb");
+    miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+
+    std::vector<miopen::KernelConfig> cfgs(4);
+    for(std::size_t i = 0; i < cfgs.size(); ++i)
+    {
+        cfgs[i].kernel_name = "kernel" + std::to_string(i);
+        cfgs[i].kernel_args = "-DVARIANT=0";
+        cfgs[i].kernel_blob = random_bytes(4096);
+        EXPECT_TRUE(db.StoreRecordUnsafe(cfgs[i]));
+    }
+
+    // The lookup refreshes the stale access time of kernel0, leaving kernel2 as the LRU entry.
+    db.sql.Exec("UPDATE kern_db SET last_access = 0 WHERE kernel_name = 'kernel0';");
+    db.sql.Exec("UPDATE kern_db SET last_access = 1 WHERE kernel_name = 'kernel2';");
+    EXPECT_TRUE(db.FindRecordUnsafe(cfgs[0]));
+
+    const auto stored = db.GetStatsUnsafe().stored_bytes;
+    EXPECT_EQ(db.EvictUnsafe(stored), 0u);
+    EXPECT_EQ(db.EvictUnsafe(stored - 1), 1u);
+    EXPECT_FALSE(db.FindRecordUnsafe(cfgs[2]));
+    EXPECT_TRUE(db.FindRecordUnsafe(cfgs[0]));
+    EXPECT_EQ(db.GetStatsUnsafe().blobs, 3u);
+
+    const auto top = db.GetTopConsumersUnsafe(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_GE(top[0].bytes, top[1].bytes);
+}
+
+TEST(TestCache, check_kern_db_quoted_args)
+{
+    miopen::KernelConfig cfg0;
+    cfg0.kernel_name = "kernel1";
+    cfg0.kernel_args = "-DNAME='value' -DOTHER=\"'); DROP TABLE kern_db; --\"";
+    cfg0.kernel_blob = random_bytes(1024);
+
+    miopen::KernelConfig cfg1 = cfg0;
+    cfg1.kernel_args          = "-DNAME='value'";
+
+    miopen::TempFile temp_file("tmp-kerndb");
+    miopen::KernDb db(miopen::DbKinds::KernelDb, temp_file, false);
+
+    EXPECT_TRUE(db.StoreRecordUnsafe(cfg0));
+    // Repeated lookups run on the cached statement with fresh bindings every time.
+    for(auto i = 0; i < 3; ++i)
+    {
+        auto readout = db.FindRecordUnsafe(cfg0);
+        ASSERT_TRUE(readout);
+        EXPECT_TRUE(readout.get() == cfg0.kernel_blob);
+        EXPECT_FALSE(db.FindRecordUnsafe(cfg1));
+    }
+    EXPECT_TRUE(db.RemoveRecordUnsafe(cfg0));
+    EXPECT_FALSE(db.FindRecordUnsafe(cfg0));
+}
+
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+TEST(TestCache, check_load_binary_reuses_statements)
+{
+    if(miopen::IsCacheDisabled())
+        GTEST_SKIP();
+
+    const auto& handle = get_handle();
+    const auto target  = handle.GetTargetProperties();
+    const auto num_cu  = handle.GetMaxComputeUnits();
+    const auto load    = [&]() {
+        return miopen::LoadBinary(target, num_cu, "check_load_binary.s", "-DMISSING=1");
+    };
+
+    // The databases and their statements of the first load are reused by the second one.
+    EXPECT_TRUE(load().empty());
+    const auto prepared = miopen::SQLite::GetPreparedCount();
+    EXPECT_TRUE(load().empty());
+    EXPECT_EQ(miopen::SQLite::GetPreparedCount(), prepared);
+}
+
+TEST(TestCache, check_kernel_cache_stats)
+{
+    if(miopen::IsCacheDisabled())
+        GTEST_SKIP();
+
+    const auto& handle = get_handle();
+    auto before        = miopenKernelCacheStats_t{};
+    ASSERT_EQ(miopenGetKernelCacheStats(&before), miopenStatusSuccess);
+    EXPECT_TRUE(miopen::LoadBinary(handle.GetTargetProperties(),
+                                   handle.GetMaxComputeUnits(),
+                                   "check_kernel_cache_stats.s",
+                                   "-DMISSING=1")
+                    .empty());
+
+    auto after = miopenKernelCacheStats_t{};
+    ASSERT_EQ(miopenGetKernelCacheStats(&after), miopenStatusSuccess);
+    EXPECT_EQ(after.misses, before.misses + 1);
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(miopenGetKernelCacheStats(nullptr), miopenStatusBadParm);
+}
+#endif
 #endif
 
 TEST(TestCache, check_cache_file)
@@ -140,3 +442,33 @@ TEST(TestCache, check_cache_file)
     auto p = miopen::GetCacheFile("gfx", "base", "args");
     EXPECT_TRUE(p.filename() == miopen::make_object_file_name("base"));
 }
+
+TEST(TestCache, check_evict_cache_files)
+{
+    miopen::TmpDir dir("cache");
+    const auto write = [](const fs::path& path, std::size_t size) {
+        std::ofstream(path, std::ios::binary) << std::string(size, 'x');
+    };
+
+    const auto kernels = dir / "gfx";
+    fs::create_directories(kernels);
+    const auto now = fs::file_time_type::clock::now();
+    for(auto i = 0; i < 3; ++i)
+    {
+        const auto path = kernels / ("kernel" + std::to_string(i) + ".o");
+        write(path, 1000);
+        fs::last_write_time(path, now - std::chrono::hours(3 - i));
+    }
+    // Files at the top level are not kernels and are never evicted.
+    write(dir / "miopen.ukdb", 5000);
+
+    auto remaining = std::uintmax_t{0};
+    EXPECT_EQ(miopen::EvictCacheFiles(dir, 3000, &remaining), 0u);
+    EXPECT_EQ(remaining, 3000u);
+    EXPECT_EQ(miopen::EvictCacheFiles(dir, 2500, &remaining), 1u);
+    EXPECT_EQ(remaining, 2000u);
+    EXPECT_FALSE(fs::exists(kernels / "kernel0.o"));
+    EXPECT_TRUE(fs::exists(kernels / "kernel1.o"));
+    EXPECT_TRUE(fs::exists(kernels / "kernel2.o"));
+    EXPECT_TRUE(fs::exists(dir / "miopen.ukdb"));
+}
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/compile_scheduler.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using miopen::solver::CompileScheduler;
+
+TEST(TestCompileScheduler, Dedupes)
+{
+    CompileScheduler scheduler{8};
+    const CompileScheduler::ProgramKey program{"conv1x1u.s", "-Wa,-defsym,stride=1"};
+    const CompileScheduler::ProgramKey other{"conv1x1u.s", "-Wa,-defsym,stride=2"};
+
+    EXPECT_EQ(scheduler.Wait(program), CompileScheduler::State::Missing);
+    EXPECT_EQ(scheduler.Acquire(program), CompileScheduler::State::Missing);
+    EXPECT_EQ(scheduler.Acquire(program), CompileScheduler::State::Compiling);
+    EXPECT_EQ(scheduler.Acquire(other), CompileScheduler::State::Missing);
+
+    std::atomic<bool> done{false};
+    std::thread benchmark{[&]() {
+        EXPECT_EQ(scheduler.Wait(program), CompileScheduler::State::Compiled);
+        done = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    EXPECT_FALSE(done);
+    scheduler.Complete(program, true);
+    benchmark.join();
+    EXPECT_TRUE(done);
+
+    scheduler.Complete(other, false);
+    EXPECT_EQ(scheduler.Acquire(program), CompileScheduler::State::Compiled);
+    EXPECT_EQ(scheduler.Acquire(other), CompileScheduler::State::Failed);
+    EXPECT_EQ(scheduler.Wait(other), CompileScheduler::State::Failed);
+}
+
+TEST(TestCompileScheduler, Budget)
+{
+    CompileScheduler scheduler{4};
+    ASSERT_TRUE(scheduler.Reserve(3));
+    scheduler.Add(2); // Goes over the budget
+    EXPECT_EQ(scheduler.InFlight(), 5);
+
+    std::atomic<bool> reserved{false};
+    std::thread agent{[&]() {
+        EXPECT_TRUE(scheduler.Reserve(1));
+        reserved = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    EXPECT_FALSE(reserved);
+    scheduler.Release(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    EXPECT_FALSE(reserved);
+    scheduler.Release(1);
+    agent.join();
+    EXPECT_TRUE(reserved);
+    EXPECT_EQ(scheduler.InFlight(), 4);
+
+    // Lets a config larger than the budget through once nothing is in flight.
+    scheduler.Release(4);
+    EXPECT_TRUE(scheduler.Reserve(10));
+    scheduler.Release(10);
+}
+
+TEST(TestCompileScheduler, Close)
+{
+    CompileScheduler scheduler{1};
+    ASSERT_TRUE(scheduler.Reserve(1));
+
+    std::vector<std::thread> agents;
+    std::atomic<int> turned_away{0};
+    for(int i = 0; i < 3; ++i)
+    {
+        agents.emplace_back([&]() {
+            if(!scheduler.Reserve(1))
+                ++turned_away;
+        });
+    }
+    scheduler.Close();
+    for(auto& agent : agents)
+        agent.join();
+    EXPECT_EQ(turned_away, 3);
+    EXPECT_FALSE(scheduler.Reserve(1));
+}
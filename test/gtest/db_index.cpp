@@ -0,0 +1,149 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/db.hpp>
+#include <miopen/db_record.hpp>
+#include <miopen/temp_file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+struct TestValue
+{
+    int x = 0;
+
+    void Serialize(std::ostream& stream) const { stream << x; }
+
+    bool Deserialize(const std::string& str)
+    {
+        x = std::stoi(str);
+        return true;
+    }
+};
+
+miopen::DbRecord MakeRecord(const std::string& key, const std::string& id, int value)
+{
+    auto record = miopen::DbRecord{miopen::DbKinds::PerfDb, key};
+    record.SetValues(id, TestValue{value});
+    return record;
+}
+
+int LoadValue(miopen::PlainTextDb& db, const std::string& key, const std::string& id)
+{
+    const auto record = db.FindRecord(key);
+    auto value        = TestValue{-1};
+    if(record)
+        record->GetValues(id, value);
+    return value.x;
+}
+
+} // namespace
+
+TEST(TestPlainTextDbIndex, UpdatesInPlace)
+{
+    const auto temp_file = miopen::TempFile{"miopen.tests.db_index"};
+    auto db              = miopen::PlainTextDb{miopen::DbKinds::PerfDb, temp_file};
+
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("3x4", "s0", 2)));
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 3)));
+
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 3);
+    EXPECT_EQ(LoadValue(db, "3x4", "s0"), 2);
+    EXPECT_TRUE(miopen::fs::exists(temp_file.Path() + ".idx"));
+
+    ASSERT_TRUE(db.RemoveRecord(std::string{"1x2"}));
+    EXPECT_FALSE(db.FindRecord(std::string{"1x2"}));
+    EXPECT_EQ(LoadValue(db, "3x4", "s0"), 2);
+
+    // Another instance has to pick up the sidecar index.
+    auto other_db = miopen::PlainTextDb{miopen::DbKinds::PerfDb, temp_file};
+    EXPECT_FALSE(other_db.FindRecord(std::string{"1x2"}));
+    EXPECT_EQ(LoadValue(other_db, "3x4", "s0"), 2);
+}
+
+TEST(TestPlainTextDbIndex, RebuildsAfterExternalChange)
+{
+    const auto temp_file = miopen::TempFile{"miopen.tests.db_index"};
+    auto db              = miopen::PlainTextDb{miopen::DbKinds::PerfDb, temp_file};
+
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+
+    std::ofstream(temp_file.Path(), std::ios::trunc) << "5x6=s0:7\n1x2=s0:8\n";
+
+    EXPECT_EQ(LoadValue(db, "5x6", "s0"), 7);
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 8);
+}
+
+TEST(TestPlainTextDbIndex, ReplacesUnparsableRecords)
+{
+    const auto temp_file = miopen::TempFile{"miopen.tests.db_index"};
+    auto db              = miopen::PlainTextDb{miopen::DbKinds::PerfDb, temp_file};
+
+    std::ofstream(temp_file.Path(), std::ios::trunc) << "1x2=\n3x4=s0:2\n";
+
+    EXPECT_FALSE(db.FindRecord(std::string{"1x2"}));
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+    EXPECT_EQ(LoadValue(db, "3x4", "s0"), 2);
+
+    // The broken line has to be marked dead instead of being left next to the new one.
+    auto file  = std::ifstream{temp_file.Path()};
+    auto line  = std::string{};
+    auto lines = 0;
+    while(std::getline(file, line))
+    {
+        if(line.rfind("1x2=", 0) == 0)
+            ++lines;
+    }
+    EXPECT_EQ(lines, 1);
+}
+
+TEST(TestPlainTextDbIndex, CompactsDeadRecords)
+{
+    const auto temp_file = miopen::TempFile{"miopen.tests.db_index"};
+    auto db              = miopen::PlainTextDb{miopen::DbKinds::PerfDb, temp_file};
+
+    constexpr auto n_keys    = 16;
+    constexpr auto n_updates = 10000;
+
+    for(auto i = 0; i < n_updates; ++i)
+        ASSERT_TRUE(db.StoreRecord(MakeRecord(std::to_string(i % n_keys), "s0", i)));
+
+    for(auto i = 0; i < n_keys; ++i)
+        EXPECT_EQ(LoadValue(db, std::to_string(i), "s0"), n_updates - n_keys + i);
+
+    // Without compaction the file would hold a line per each store.
+    auto file        = std::ifstream{temp_file.Path()};
+    const auto lines = std::count(std::istreambuf_iterator<char>{file}, {}, '\n');
+    EXPECT_LT(lines, n_updates / 2);
+}
@@ -654,7 +654,7 @@ void CheckFDBEntry(size_t thread_index,
 
         std::vector<miopen::FDBVal> fdb_vals;
         std::unordered_map<std::string, std::string> pdb_vals;
-        miopen::ParseFDBbVal(kinder.second.content, fdb_vals);
+        miopen::ParseFDBbVal(std::string{kinder.second.content}, fdb_vals);
         std::string pdb_select_query;
         miopen::GetPerfDbVals(pdb_file_path, problem, pdb_vals, pdb_select_query);
         // This is an opportunity to link up fdb and pdb entries
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/find_db_index.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(TestFindDbIndex, ParseKey)
+{
+    const auto plain = miopen::ParseFindDbKey("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP32-F");
+    ASSERT_TRUE(plain);
+    EXPECT_EQ(plain->category, "2-0-NCHW-FP32-F");
+
+    const auto batch = miopen::ParseFindDbKey("16-14-14-3x3-32-14-14-31-1x1-1x1-1x1-0-NCHW-FP32-F");
+    ASSERT_TRUE(batch);
+    EXPECT_EQ(batch->category, plain->category);
+    EXPECT_EQ(batch->values.size(), plain->values.size());
+
+    const auto grouped =
+        miopen::ParseFindDbKey("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP32-F_g2");
+    ASSERT_TRUE(grouped);
+    EXPECT_EQ(grouped->category, "2-0-NCHW-FP32-F_g");
+
+    const auto layouts = miopen::ParseFindDbKey(
+        "16-4-14-14-3x3x3-32-4-14-14-32-1x1x1-1x1x1-1x1x1-0-NDHWC-NDHWC-NDHWC-FP16-B");
+    ASSERT_TRUE(layouts);
+    EXPECT_EQ(layouts->category, "3-0-NDHWC-NDHWC-NDHWC-FP16-B");
+
+    EXPECT_FALSE(miopen::ParseFindDbKey("16-14-14-32-1-NCHW-FP32-F"));
+    EXPECT_FALSE(miopen::ParseFindDbKey("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-FP32-F"));
+}
+
+TEST(TestFindDbIndex, Suggest)
+{
+    auto index = miopen::FindDbIndex{};
+    EXPECT_TRUE(index.Add("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP32-F",
+                          "Winograd:0.1,0,miopenConvolutionFwdAlgoWinograd;"
+                          "GemmFwd1x1:0.3,64,miopenConvolutionFwdAlgoGEMM"));
+    EXPECT_TRUE(index.Add("16-14-14-1x1-32-14-14-32-0x0-1x1-1x1-0-NCHW-FP32-F",
+                          "GemmFwd1x1:0.05,0,miopenConvolutionFwdAlgoGEMM"));
+    EXPECT_TRUE(index.Add("256-56-56-3x3-256-56-56-128-1x1-1x1-1x1-0-NCHW-FP32-F",
+                          "miopenConvolutionFwdAlgoDirect:Direct,2.5,0,"
+                          "miopenConvolutionFwdAlgoDirect,<unused>"));
+    EXPECT_TRUE(index.Add("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP16-F",
+                          "Fp16Only:0.1,0,miopenConvolutionFwdAlgoDirect"));
+    EXPECT_FALSE(
+        index.Add("16-14-14-32-1-NCHW-FP32-F", "Solver:0.1,0,miopenConvolutionFwdAlgoDirect"));
+    EXPECT_FALSE(index.Add("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP32-B", "broken"));
+    EXPECT_EQ(index.Size(), 4);
+
+    const auto* record = index.Find("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP32-F");
+    ASSERT_NE(record, nullptr);
+    ASSERT_EQ(record->entries.size(), 2);
+    EXPECT_EQ(index.GetSolverName(record->entries[0].solver), "Winograd");
+
+    // Only the batch size differs from the first record.
+    const auto query   = "16-14-14-3x3-32-14-14-31-1x1-1x1-1x1-0-NCHW-FP32-F";
+    const auto nearest = index.Nearest(query, 2);
+    ASSERT_EQ(nearest.size(), 2);
+    EXPECT_EQ(nearest[0].record, record);
+    EXPECT_LT(nearest[0].distance, nearest[1].distance);
+
+    const auto suggestions = index.Suggest(query, 1);
+    ASSERT_EQ(suggestions.size(), 2);
+    EXPECT_EQ(suggestions[0].solver, "Winograd");
+    EXPECT_EQ(suggestions[1].solver, "GemmFwd1x1");
+    EXPECT_EQ(suggestions[1].workspace, 64);
+
+    // The record of the query itself is not a substitute.
+    for(const auto& neighbor :
+        index.Nearest("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NCHW-FP32-F", 10))
+        EXPECT_NE(neighbor.record, record);
+
+    EXPECT_TRUE(index.Suggest("16-14-14-3x3-32-14-14-32-1x1-1x1-1x1-0-NHWC-FP32-F", 3).empty());
+}
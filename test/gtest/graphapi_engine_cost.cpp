@@ -0,0 +1,250 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/graphapi/convolution.hpp>
+#include <miopen/graphapi/engine_cost.hpp>
+#include <miopen/graphapi/engineheur.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "graphapi_gtest_common.hpp"
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+using gr::makeGraph;
+using gr::makePackedTensor;
+
+/// convolution + bias + relu over a batch of n
+struct ConvBiasRelu
+{
+    gr::Tensor x, w, c, bias, biased, y;
+    gr::Convolution conv{miopenFloat, miopenConvolution, 2, {0, 0}, {1, 1}, {1, 1}, {0, 0}};
+    gr::Pointwise add{MIOPEN_POINTWISE_ADD, miopenFloat};
+    gr::Pointwise relu{MIOPEN_POINTWISE_RELU_FWD, miopenFloat};
+    gr::OperationConvolutionForward convOp;
+    gr::OperationPointwise biasOp;
+    gr::OperationPointwise reluOp;
+    gr::OpGraph graph;
+
+    ConvBiasRelu(miopenHandle_t handle, int64_t n, int64_t firstId = 1, bool reversed = false)
+        : x(makePackedTensor(firstId, {n, 16, 32, 32})),
+          w(makePackedTensor(firstId + 1, {32, 16, 3, 3})),
+          c(makePackedTensor(firstId + 2, {n, 32, 30, 30}, true)),
+          bias(makePackedTensor(firstId + 3, {1, 32, 1, 1})),
+          biased(makePackedTensor(firstId + 4, {n, 32, 30, 30}, true)),
+          y(makePackedTensor(firstId + 5, {n, 32, 30, 30})),
+          convOp(&conv, &x, &w, &c, 1.0, 0.0),
+          biasOp(&add, &c, &bias, &biased),
+          reluOp(&relu, &biased, &y)
+    {
+        std::vector<gr::OpNode*> nodes{&convOp, &biasOp, &reluOp};
+        if(reversed)
+        {
+            std::reverse(nodes.begin(), nodes.end());
+        }
+        graph = makeGraph(handle, std::move(nodes));
+    }
+};
+
+gr::Engine makeEngine(const char* solver, size_t workspaceSize = 0)
+{
+    miopen::Solution solution;
+    solution.SetSolver(miopen::solver::Id{solver});
+    solution.SetWorkspaceSize(workspaceSize);
+    return gr::Engine{std::move(solution)};
+}
+
+/// Times measured for the convolution node of a graph, by solver
+class RecordedTimings : public gr::TimingRecords
+{
+public:
+    std::map<std::pair<const gr::OpNode*, std::string>, double> mTimes;
+
+    std::optional<double> find(const gr::OpNode& node, const gr::Engine& engine) const override
+    {
+        const auto it = mTimes.find({&node, engine.getSolution().GetSolver().ToString()});
+        if(it == mTimes.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+};
+
+} // namespace
+
+TEST(GraphApi, EngineCostStaticModel)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    ConvBiasRelu problem(handle, 4);
+    const std::vector<gr::Engine> engines{makeEngine("ConvDirectNaiveConvFwd"),
+                                          makeEngine("ConvBinWinograd3x3U"),
+                                          makeEngine("GemmFwdRest", 16 << 20)};
+
+    const auto direct   = gr::estimateCost(problem.graph, engines[0], 64);
+    const auto winograd = gr::estimateCost(problem.graph, engines[1], 64);
+    const auto gemm     = gr::estimateCost(problem.graph, engines[2], 64);
+
+    // 2 * n * 30 * 30 * 32 * 16 * 3 * 3 for the convolution, one per output element for the
+    // add and the relu
+    const size_t outputs = 4 * 32 * 30 * 30;
+    EXPECT_DOUBLE_EQ(direct.mFlops, 2.0 * 4 * 30 * 30 * 32 * 16 * 3 * 3 + 2.0 * outputs);
+    EXPECT_LT(winograd.mFlops, direct.mFlops);
+    EXPECT_LT(winograd.mTime, direct.mTime);
+    EXPECT_EQ(direct.mRecordedNodes, 0u);
+
+    // the bias and the relu are fused, so only c takes workspace
+    EXPECT_EQ(direct.mWorkspaceSize, outputs * sizeof(float));
+    EXPECT_EQ(gemm.mWorkspaceSize, direct.mWorkspaceSize + (16 << 20));
+    EXPECT_GT(gemm.mBytes, direct.mBytes);
+
+    // fewer compute units take longer
+    EXPECT_GT(gr::estimateCost(problem.graph, engines[0], 8).mTime, direct.mTime);
+
+    const auto ranking = gr::rankEngines(problem.graph, engines, MIOPEN_HEUR_MODE_INSTANT, 64);
+    EXPECT_EQ(ranking, (std::vector<size_t>{1, 0, 2}));
+    EXPECT_EQ(ranking, gr::rankEngines(problem.graph, engines, MIOPEN_HEUR_MODE_A, 64));
+    EXPECT_EQ(gr::rankEngines(problem.graph, engines, MIOPEN_HEUR_MODE_FALLBACK, 64),
+              (std::vector<size_t>{0, 1, 2}));
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, EngineCostRecordedTimings)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    ConvBiasRelu problem(handle, 4);
+    const std::vector<gr::Engine> engines{makeEngine("ConvDirectNaiveConvFwd"),
+                                          makeEngine("ConvBinWinograd3x3U"),
+                                          makeEngine("GemmFwdRest", 16 << 20)};
+
+    // on this device GEMM beats Winograd, whatever the static model thinks
+    RecordedTimings records;
+    records.mTimes[{&problem.convOp, "ConvDirectNaiveConvFwd"}] = 0.9;
+    records.mTimes[{&problem.convOp, "ConvBinWinograd3x3U"}]    = 0.3;
+    records.mTimes[{&problem.convOp, "GemmFwdRest"}]            = 0.1;
+
+    // the times of the whole graphs, as a benchmark would measure them
+    std::vector<double> measured;
+    for(const auto& engine : engines)
+    {
+        const auto cost = gr::estimateCost(problem.graph, engine, 64, &records);
+        EXPECT_EQ(cost.mRecordedNodes, 1u);
+        measured.push_back(cost.mTime);
+    }
+
+    const auto recorded =
+        gr::rankEngines(problem.graph, engines, MIOPEN_HEUR_MODE_B, 64, &records);
+    EXPECT_EQ(recorded, (std::vector<size_t>{2, 1, 0}));
+    const auto recordedScore = gr::scoreRanking(recorded, measured);
+    EXPECT_DOUBLE_EQ(recordedScore.mConcordance, 1.0);
+    EXPECT_DOUBLE_EQ(recordedScore.mRegret, 1.0);
+
+    // the other modes ignore the records
+    const auto instant =
+        gr::rankEngines(problem.graph, engines, MIOPEN_HEUR_MODE_INSTANT, 64, &records);
+    const auto instantScore = gr::scoreRanking(instant, measured);
+    EXPECT_LT(instantScore.mConcordance, 1.0);
+    EXPECT_GT(instantScore.mRegret, 1.0);
+
+    // nodes without records fall back to the model
+    RecordedTimings partial;
+    partial.mTimes[{&problem.convOp, "ConvDirectNaiveConvFwd"}] = 5.0;
+    EXPECT_EQ(gr::rankEngines(problem.graph, engines, MIOPEN_HEUR_MODE_B, 64, &partial),
+              (std::vector<size_t>{1, 2, 0}));
+
+    auto heur = gr::EngineHeurBuilder()
+                    .setOpGraph(&problem.graph)
+                    .setMode(MIOPEN_HEUR_MODE_B)
+                    .setTimingRecords(&records)
+                    .build();
+    EXPECT_EQ(heur.getResults().size(), problem.graph.getEngines().size());
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, EngineRankingCache)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto& cache = gr::EngineRankingCache::instance();
+    cache.clear();
+
+    ConvBiasRelu first(handle, 4);
+    // the same graph, built from other tensors in another order
+    ConvBiasRelu same(handle, 4, 101, true);
+    ConvBiasRelu larger(handle, 8);
+
+    EXPECT_EQ(first.graph.getShapeHash(), same.graph.getShapeHash());
+    EXPECT_NE(first.graph.getShapeHash(), larger.graph.getShapeHash());
+    EXPECT_EQ(first.graph.getCanonicalHash(), larger.graph.getCanonicalHash());
+
+    auto build = [](gr::OpGraph& graph, miopenBackendHeurMode_t mode, int32_t smCount) {
+        return gr::EngineHeurBuilder()
+            .setOpGraph(&graph)
+            .setMode(mode)
+            .setSmCount(smCount)
+            .build();
+    };
+
+    const auto heur = build(first.graph, MIOPEN_HEUR_MODE_INSTANT, 64);
+    ASSERT_EQ(heur.getResults().size(), 1u);
+    EXPECT_EQ(heur.getResults().front().getEngine().getGlobalIndex(), 0);
+    EXPECT_EQ(heur.getResults().front().getEngine().getSmCount(), 64);
+    EXPECT_EQ(cache.size(), 1u);
+
+    build(same.graph, MIOPEN_HEUR_MODE_INSTANT, 64);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.find(same.graph, MIOPEN_HEUR_MODE_INSTANT, 64).has_value());
+
+    build(larger.graph, MIOPEN_HEUR_MODE_INSTANT, 64);
+    build(first.graph, MIOPEN_HEUR_MODE_INSTANT, 32);
+    build(first.graph, MIOPEN_HEUR_MODE_FALLBACK, 64);
+    EXPECT_EQ(cache.size(), 4u);
+
+    // backed by the find-db of the handle of the graph
+    build(first.graph, MIOPEN_HEUR_MODE_B, 64);
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_FALSE(cache.find(first.graph, MIOPEN_HEUR_MODE_B, 64).has_value());
+
+    cache.clear();
+    EXPECT_FALSE(cache.find(first.graph, MIOPEN_HEUR_MODE_INSTANT, 64).has_value());
+
+    miopenDestroy(handle);
+}
@@ -24,10 +24,24 @@
  *
  *******************************************************************************/
 
+#include <miopen/config.h>
+#include <miopen/errors.hpp>
+#include <miopen/graphapi/convolution.hpp>
+#include <miopen/graphapi/engine.hpp>
 #include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/matmul.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+#include <miopen/graphapi/reduction.hpp>
 
 #include <gtest/gtest.h>
 
+#if MIOPEN_BACKEND_HIP
+#include <hip/hip_runtime_api.h>
+#endif
+
+#include <numeric>
+#include <vector>
+
 #include "graphapi_gtest_common.hpp"
 
 namespace {
@@ -112,3 +126,226 @@ TEST(GraphApi, ExecutionPlan)
 
     execute();
 }
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+using gr::makeGraph;
+using gr::makePackedTensor;
+
+gr::ExecutionPlan makePlan(miopenHandle_t handle, const gr::OpGraph& graph)
+{
+    auto engine = gr::EngineBuilder().setOpGraph(&graph).setGlobalIndex(0).build();
+    return ExecutionPlanBuilder().setHandle(handle).setEngineCfg(EngineCfg(engine)).build();
+}
+
+} // namespace
+
+TEST(GraphApi, ExecutionPlanMatmulBiasRelu)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto a    = makePackedTensor(1, {1, 2, 3});
+    auto b    = makePackedTensor(2, {1, 3, 2});
+    auto bias = makePackedTensor(3, {1, 1, 2});
+    auto c    = makePackedTensor(4, {1, 2, 2}, true);
+    auto d    = makePackedTensor(5, {1, 2, 2}, true);
+    auto y    = makePackedTensor(6, {1, 2, 2});
+
+    gr::Matmul matmul(miopenFloat);
+    gr::Pointwise add(MIOPEN_POINTWISE_ADD, miopenFloat);
+    gr::Pointwise relu(MIOPEN_POINTWISE_RELU_FWD, miopenFloat);
+    gr::OperationMatmul matmulOp(&a, &b, &c, 1, nullptr, nullptr, nullptr, &matmul);
+    gr::OperationPointwise addOp(&add, &c, &bias, &d);
+    gr::OperationPointwise reluOp(&relu, &d, &y);
+
+    // the order of the nodes does not matter
+    auto graph = makeGraph(handle, {&reluOp, &addOp, &matmulOp});
+
+    const gr::ExecutionSchedule unfused(graph, false);
+    ASSERT_EQ(unfused.getSteps().size(), 3u);
+    EXPECT_EQ(unfused.getSteps().front(), &matmulOp);
+    EXPECT_EQ(unfused.getSteps().back(), &reluOp);
+    // c and d are both alive while the add runs
+    EXPECT_EQ(unfused.getWorkspaceSize(), gr::ExecutionSchedule::alignment + 4 * sizeof(float));
+
+    // the add and the relu run as one step and d never reaches the workspace
+    auto plan = makePlan(handle, graph);
+    ASSERT_EQ(plan.getSchedule().getSteps().size(), 2u);
+    EXPECT_EQ(plan.getSchedule().getSteps().front(), &matmulOp);
+    EXPECT_EQ(plan.getWorkspaceSize(), 4 * sizeof(float));
+
+    std::vector<float> aData{1, 2, 3, 4, 5, 6};
+    std::vector<float> bData{1, -1, 0, 1, 1, -1};
+    std::vector<float> biasData{-5, 1};
+    std::vector<float> yData(4);
+    std::vector<char> workspace(plan.getWorkspaceSize());
+
+    const std::vector<void*> dataPointers{
+        aData.data(), bData.data(), biasData.data(), yData.data()};
+    plan.execute(gr::VariantPackBuilder()
+                     .setTensorIds({1, 2, 3, 6})
+                     .setDataPointers(dataPointers)
+                     .setWorkspace(workspace.data())
+                     .build());
+
+    // a * b = {{4, -2}, {10, -5}}
+    EXPECT_EQ(yData, (std::vector<float>{0, 0, 5, 0}));
+
+    EXPECT_ANY_THROW({
+        plan.execute(gr::VariantPackBuilder()
+                         .setTensorIds({1, 2, 3, 6})
+                         .setDataPointers(dataPointers)
+                         .setWorkspace(nullptr)
+                         .build());
+    }) << "ExecutionPlan ran without a workspace";
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, ExecutionPlanWorkspaceReuse)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    constexpr int64_t size = 64;
+    auto x                 = makePackedTensor(1, {size});
+    auto v1                = makePackedTensor(2, {size}, true);
+    auto v2                = makePackedTensor(3, {size}, true);
+    auto v3                = makePackedTensor(4, {size}, true);
+    auto y                 = makePackedTensor(5, {size});
+
+    gr::Pointwise neg(MIOPEN_POINTWISE_NEG, miopenFloat);
+    gr::OperationPointwise op1(&neg, &x, &v1);
+    gr::OperationPointwise op2(&neg, &v1, &v2, 2.0f);
+    gr::OperationPointwise op3(&neg, &v2, &v3);
+    gr::OperationPointwise op4(&neg, &v3, &y);
+
+    auto graph = makeGraph(handle, {&op1, &op2, &op3, &op4});
+
+    // v1 is dead by the time v3 is written, so they share the same bytes
+    const gr::ExecutionSchedule unfused(graph, false);
+    const auto& allocations = unfused.getAllocations();
+    ASSERT_EQ(allocations.size(), 3u);
+    EXPECT_EQ(allocations[0].mOffset, allocations[2].mOffset);
+    EXPECT_NE(allocations[0].mOffset, allocations[1].mOffset);
+    EXPECT_EQ(unfused.getWorkspaceSize(), 2 * size * sizeof(float));
+
+    // fused, the chain needs no workspace at all
+    auto plan = makePlan(handle, graph);
+    EXPECT_EQ(plan.getSchedule().getSteps().size(), 1u);
+    EXPECT_EQ(plan.getWorkspaceSize(), 0);
+
+    std::vector<float> xData(size);
+    std::iota(xData.begin(), xData.end(), 0.0f);
+    std::vector<float> yData(size);
+    // a variant pack needs a workspace even when the plan does not use it
+    std::vector<char> workspace(1);
+    plan.execute(gr::VariantPackBuilder()
+                     .setTensorIds({1, 5})
+                     .setDataPointers({xData.data(), yData.data()})
+                     .setWorkspace(workspace.data())
+                     .build());
+
+    for(int64_t i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(yData[i], 2.0f * xData[i]);
+    }
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, ExecutionPlanConvolutionReduction)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto x = makePackedTensor(1, {1, 1, 3, 3});
+    auto w = makePackedTensor(2, {1, 1, 2, 2});
+    auto c = makePackedTensor(3, {1, 1, 2, 2}, true);
+    auto y = makePackedTensor(4, {1, 1, 1, 2});
+
+    gr::Convolution conv(miopenFloat, miopenConvolution, 2, {0, 0}, {1, 1}, {1, 1}, {0, 0});
+    gr::Reduction sum(MIOPEN_REDUCE_TENSOR_ADD, miopenFloat);
+    gr::OperationConvolutionForward convOp(&conv, &x, &w, &c, 1.0, 0.0);
+    gr::OperationReduction sumOp(&sum, &c, &y);
+
+    auto graph = makeGraph(handle, {&convOp, &sumOp});
+    auto plan  = makePlan(handle, graph);
+
+    std::vector<float> xData{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<float> wData{1, 0, 0, -1};
+    std::vector<float> yData(2);
+    std::vector<char> workspace(plan.getWorkspaceSize());
+    plan.execute(gr::VariantPackBuilder()
+                     .setTensorIds({1, 2, 4})
+                     .setDataPointers({xData.data(), wData.data(), yData.data()})
+                     .setWorkspace(workspace.data())
+                     .build());
+
+    // every output of the convolution is x[i][j] - x[i + 1][j + 1] = -4, summed over the rows
+    EXPECT_EQ(yData, (std::vector<float>{-8, -8}));
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, ExecutionPlanVirtualInput)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto x = makePackedTensor(1, {4}, true);
+    auto y = makePackedTensor(2, {4});
+    gr::Pointwise abs(MIOPEN_POINTWISE_ABS, miopenFloat);
+    gr::OperationPointwise absOp(&abs, &x, &y);
+
+    auto graph = makeGraph(handle, {&absOp});
+    EXPECT_ANY_THROW({ makePlan(handle, graph); })
+        << "ExecutionPlanBuilder accepted a virtual tensor that nothing produces";
+
+    miopenDestroy(handle);
+}
+
+#if MIOPEN_BACKEND_HIP
+TEST(GraphApi, ExecutionPlanDeviceMemory)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto x = makePackedTensor(1, {4});
+    auto y = makePackedTensor(2, {4});
+    gr::Pointwise abs(MIOPEN_POINTWISE_ABS, miopenFloat);
+    gr::OperationPointwise absOp(&abs, &x, &y);
+    auto graph = makeGraph(handle, {&absOp});
+    auto plan  = makePlan(handle, graph);
+
+    void* xData = nullptr;
+    if(hipMalloc(&xData, 4 * sizeof(float)) != hipSuccess)
+    {
+        miopenDestroy(handle);
+        GTEST_SKIP() << "No device memory";
+    }
+    std::vector<float> yData(4);
+    std::vector<char> workspace(plan.getWorkspaceSize() + 1);
+
+    // The host executor would read the device memory as if it was on the host.
+    try
+    {
+        plan.execute(gr::VariantPackBuilder()
+                         .setTensorIds({1, 2})
+                         .setDataPointers({xData, yData.data()})
+                         .setWorkspace(workspace.data())
+                         .build());
+        ADD_FAILURE() << "ExecutionPlan ran on device memory";
+    }
+    catch(const miopen::Exception& ex)
+    {
+        EXPECT_EQ(ex.status, miopenStatusNotImplemented);
+    }
+
+    hipFree(xData);
+    miopenDestroy(handle);
+}
+#endif
@@ -0,0 +1,613 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/execution_plan_cache.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+/// y = relu(x + bias) * x, with a batch of rows
+struct BiasReluGate
+{
+    std::deque<gr::Tensor> tensors;
+    gr::Pointwise add{MIOPEN_POINTWISE_ADD, miopenFloat};
+    gr::Pointwise relu{MIOPEN_POINTWISE_RELU_FWD, miopenFloat};
+    gr::Pointwise mul{MIOPEN_POINTWISE_MUL, miopenFloat};
+    std::deque<gr::OperationPointwise> nodes;
+    gr::OpGraph graph;
+
+    BiasReluGate(miopenHandle_t handle, int64_t batch, int64_t firstId = 1, bool reversed = false)
+    {
+        auto tensor = [&](int64_t id, int64_t rows, bool isVirtual) {
+            return &tensors.emplace_back(gr::TensorBuilder{}
+                                             .setDataType(miopenFloat)
+                                             .setDim({rows, 4})
+                                             .setStride({4, 1})
+                                             .setId(firstId + id)
+                                             .setVirtual(isVirtual)
+                                             .build());
+        };
+        auto* x      = tensor(0, batch, false);
+        auto* bias   = tensor(1, 1, false);
+        auto* biased = tensor(2, batch, true);
+        auto* act    = tensor(3, batch, true);
+        auto* y      = tensor(4, batch, false);
+
+        nodes.emplace_back(&add, x, bias, biased);
+        nodes.emplace_back(&relu, biased, act);
+        nodes.emplace_back(&mul, act, x, y);
+
+        std::vector<gr::OpNode*> order;
+        for(auto& node : nodes)
+            order.push_back(&node);
+        if(reversed)
+            std::reverse(order.begin(), order.end());
+
+        gr::OpGraphBuilder builder;
+        builder.setHandle(handle);
+        builder.setNodes(std::move(order));
+        graph = std::move(builder).build();
+    }
+
+    gr::ExecutionPlan build(miopenHandle_t handle)
+    {
+        auto engine = gr::EngineBuilder().setOpGraph(&graph).setGlobalIndex(0).build();
+        return gr::ExecutionPlanBuilder()
+            .setHandle(handle)
+            .setEngineCfg(gr::EngineCfg(engine))
+            .build();
+    }
+};
+
+std::vector<float> run(gr::ExecutionPlan& plan, int64_t batch, int64_t firstId)
+{
+    std::vector<float> x(batch * 4);
+    for(size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+    }
+    std::vector<float> bias{0.5f, -0.5f, 1.0f, -1.0f};
+    std::vector<float> y(x.size());
+    std::vector<char> workspace(std::max<int64_t>(plan.getWorkspaceSize(), 1));
+
+    plan.execute(gr::VariantPackBuilder()
+                     .setTensorIds({firstId, firstId + 1, firstId + 4})
+                     .setDataPointers({x.data(), bias.data(), y.data()})
+                     .setWorkspace(workspace.data())
+                     .build());
+    return y;
+}
+
+std::vector<float> expected(int64_t batch)
+{
+    std::vector<float> bias{0.5f, -0.5f, 1.0f, -1.0f};
+    std::vector<float> y(batch * 4);
+    for(size_t i = 0; i < y.size(); ++i)
+    {
+        const float x = static_cast<float>(static_cast<int>(i % 5) - 2);
+        y[i]          = std::max(x + bias[i % 4], 0.0f) * x;
+    }
+    return y;
+}
+
+} // namespace
+
+TEST(GraphApi, ExecutionPlanJson)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    BiasReluGate problem(handle, 3);
+    const auto plan = problem.build(handle);
+    EXPECT_EQ(plan.getGraphHash(), problem.graph.getCanonicalHash());
+    EXPECT_EQ(plan.getShapeHash(), problem.graph.getShapeHash());
+
+    const auto json = plan.getJsonRepresentation();
+    ASSERT_FALSE(json.empty());
+
+    // without a graph the plan cannot run
+    auto loaded = gr::ExecutionPlanBuilder().setHandle(handle).setJsonRepresentation(json).build();
+    EXPECT_EQ(loaded.getGraphHash(), plan.getGraphHash());
+    EXPECT_EQ(loaded.getShapeHash(), plan.getShapeHash());
+    EXPECT_EQ(loaded.getWorkspaceSize(), plan.getWorkspaceSize());
+    EXPECT_EQ(loaded.getEngineCfg().getEngine().getOpGraph(), nullptr);
+    EXPECT_EQ(loaded.getJsonRepresentation(), json);
+    EXPECT_ANY_THROW({ run(loaded, 3, 1); });
+
+    // the same graph, built from other tensors in another order
+    BiasReluGate same(handle, 3, 21, true);
+    auto bound = gr::ExecutionPlanBuilder()
+                     .setHandle(handle)
+                     .setJsonRepresentation(json)
+                     .setOpGraph(&same.graph)
+                     .build();
+    EXPECT_EQ(bound.getEngineCfg().getEngine().getOpGraph(), &same.graph);
+    EXPECT_EQ(bound.getWorkspaceSize(), plan.getWorkspaceSize());
+    EXPECT_EQ(run(bound, 3, 21), expected(3));
+
+    BiasReluGate larger(handle, 5);
+    EXPECT_ANY_THROW({
+        gr::ExecutionPlanBuilder()
+            .setHandle(handle)
+            .setJsonRepresentation(json)
+            .setOpGraph(&larger.graph)
+            .build();
+    }) << "ExecutionPlanBuilder bound a plan to a graph of another shape";
+
+    EXPECT_ANY_THROW({
+        gr::ExecutionPlanBuilder().setHandle(handle).setJsonRepresentation("{\"version\": 0}");
+    }) << "ExecutionPlanBuilder accepted a plan of another version";
+    EXPECT_ANY_THROW({ gr::ExecutionPlanBuilder().setHandle(handle).setJsonRepresentation("[1"); })
+        << "ExecutionPlanBuilder accepted invalid JSON";
+
+    // fields of the wrong type or missing
+    auto wrongType     = nlohmann::json::parse(json);
+    wrongType["graph"] = "graph";
+    auto missing       = nlohmann::json::parse(json);
+    missing.erase("device");
+    for(const auto& item : {wrongType, missing})
+    {
+        try
+        {
+            gr::ExecutionPlanBuilder().setHandle(handle).setJsonRepresentation(item.dump());
+            ADD_FAILURE() << "ExecutionPlanBuilder accepted an invalid plan: " << item.dump();
+        }
+        catch(const miopen::Exception& ex)
+        {
+            EXPECT_EQ(ex.status, miopenStatusInvalidValue);
+        }
+    }
+
+    // a plan of another device
+    auto otherDevice      = nlohmann::json::parse(json);
+    otherDevice["device"] = "gfx-other";
+    EXPECT_ANY_THROW({
+        gr::ExecutionPlanBuilder()
+            .setHandle(handle)
+            .setJsonRepresentation(otherDevice.dump())
+            .setOpGraph(&same.graph)
+            .build();
+    }) << "ExecutionPlanBuilder bound a plan of another device";
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, ExecutionPlanCache)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto& cache = gr::ExecutionPlanCache::instance();
+    cache.clear();
+
+    BiasReluGate first(handle, 3);
+    EXPECT_FALSE(cache.find(first.graph, handle).has_value());
+    auto built = cache.findOrBuild(first.graph, handle);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(run(built, 3, 1), expected(3));
+
+    // every iteration rebuilds its graph, only new shapes add plans
+    for(int64_t batch : {3, 5, 3, 5, 7})
+    {
+        BiasReluGate iteration(handle, batch, 11, batch % 2 == 1);
+        auto plan = cache.findOrBuild(iteration.graph, handle);
+        EXPECT_EQ(plan.getEngineCfg().getEngine().getOpGraph(), &iteration.graph);
+        EXPECT_EQ(run(plan, batch, 11), expected(batch));
+    }
+    EXPECT_EQ(cache.size(), 3u);
+
+    // a warmed cache, saved at the end of one job and loaded by the next
+    const auto saved = cache.serialize();
+    cache.clear();
+    BiasReluGate next(handle, 5);
+    EXPECT_FALSE(cache.find(next.graph, handle).has_value());
+    cache.deserialize(saved);
+    EXPECT_EQ(cache.size(), 3u);
+    auto found = cache.find(next.graph, handle);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(run(*found, 5, 1), expected(5));
+
+    EXPECT_ANY_THROW({ cache.deserialize("[{\"version\": 0}]"); });
+    EXPECT_ANY_THROW({ cache.deserialize("{}"); });
+    EXPECT_EQ(cache.size(), 3u);
+
+    EXPECT_ANY_THROW({ cache.insert(gr::ExecutionPlan{}); })
+        << "ExecutionPlanCache accepted a plan never built on a graph";
+    EXPECT_ANY_THROW({ cache.insert(first.build(handle)); })
+        << "ExecutionPlanCache accepted a plan of an engine not chosen by heuristics";
+
+    cache.clear();
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, ExecutionPlanCacheKey)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto& cache = gr::ExecutionPlanCache::instance();
+    cache.clear();
+
+    // plans ranked by one mode do not stand for another
+    BiasReluGate problem(handle, 3);
+    auto instant = cache.findOrBuild(problem.graph, handle, MIOPEN_HEUR_MODE_INSTANT);
+    EXPECT_EQ(instant.getEngineCfg().getEngine().getHeurMode(), MIOPEN_HEUR_MODE_INSTANT);
+    EXPECT_FALSE(cache.find(problem.graph, handle, MIOPEN_HEUR_MODE_B).has_value());
+    auto modeB = cache.findOrBuild(problem.graph, handle, MIOPEN_HEUR_MODE_B);
+    EXPECT_EQ(modeB.getEngineCfg().getEngine().getHeurMode(), MIOPEN_HEUR_MODE_B);
+    EXPECT_EQ(cache.size(), 2u);
+    auto found = cache.find(problem.graph, handle, MIOPEN_HEUR_MODE_B);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->getEngineCfg().getEngine().getHeurMode(), MIOPEN_HEUR_MODE_B);
+
+    // nor do the plans of other devices
+    auto saved = nlohmann::json::parse(cache.serialize());
+    for(auto& plan : saved)
+    {
+        plan["device"] = "gfx-other";
+    }
+    cache.clear();
+    cache.deserialize(saved.dump());
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_FALSE(cache.find(problem.graph, handle, MIOPEN_HEUR_MODE_INSTANT).has_value());
+
+    // nor do the plans of graphs whose hashes collide with those of the graph
+    auto collided = nlohmann::json::parse(instant.getJsonRepresentation());
+    auto& label   = collided["graph"]["nodes"][0];
+    label         = label.get<size_t>() + 1;
+    cache.clear();
+    cache.deserialize("[" + collided.dump() + "]");
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_FALSE(cache.find(problem.graph, handle, MIOPEN_HEUR_MODE_INSTANT).has_value());
+    EXPECT_ANY_THROW({
+        gr::ExecutionPlanBuilder()
+            .setHandle(handle)
+            .setJsonRepresentation(collided.dump())
+            .setOpGraph(&problem.graph)
+            .build();
+    }) << "ExecutionPlanBuilder bound a plan to a graph with another canonical form";
+
+    cache.clear();
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, ExecutionPlanCacheCapacity)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto& cache = gr::ExecutionPlanCache::instance();
+    cache.clear();
+    EXPECT_EQ(cache.getCapacity(), gr::ExecutionPlanCache::defaultCapacity);
+    cache.setCapacity(2);
+
+    BiasReluGate small(handle, 3);
+    BiasReluGate medium(handle, 5);
+    BiasReluGate large(handle, 7);
+    cache.findOrBuild(small.graph, handle);
+    cache.findOrBuild(medium.graph, handle);
+    // the small plan becomes the most recently used, the medium one goes first
+    EXPECT_TRUE(cache.find(small.graph, handle).has_value());
+    cache.findOrBuild(large.graph, handle);
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_TRUE(cache.find(small.graph, handle).has_value());
+    EXPECT_FALSE(cache.find(medium.graph, handle).has_value());
+    EXPECT_TRUE(cache.find(large.graph, handle).has_value());
+
+    cache.setCapacity(1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.find(large.graph, handle).has_value());
+
+    cache.setCapacity(gr::ExecutionPlanCache::defaultCapacity);
+    cache.clear();
+    miopenDestroy(handle);
+}
+
+namespace {
+
+/// A backend descriptor created and destroyed through the C API
+class ApiDescriptor
+{
+    miopenBackendDescriptor_t mDescriptor = nullptr;
+
+public:
+    explicit ApiDescriptor(miopenBackendDescriptorType_t type)
+    {
+        EXPECT_EQ(miopenBackendCreateDescriptor(type, &mDescriptor), miopenStatusSuccess);
+    }
+    ApiDescriptor(const ApiDescriptor&) = delete;
+    ApiDescriptor& operator=(const ApiDescriptor&) = delete;
+    ~ApiDescriptor() { miopenBackendDestroyDescriptor(mDescriptor); }
+
+    miopenBackendDescriptor_t get() const noexcept { return mDescriptor; }
+
+    template <typename T>
+    miopenStatus_t set(miopenBackendAttributeName_t name,
+                       miopenBackendAttributeType_t type,
+                       std::vector<T> values)
+    {
+        return miopenBackendSetAttribute(mDescriptor, name, type, values.size(), values.data());
+    }
+    miopenStatus_t finalize() { return miopenBackendFinalize(mDescriptor); }
+};
+
+/// y = relu(x), built through the C API
+struct BackendRelu
+{
+    ApiDescriptor x{MIOPEN_BACKEND_TENSOR_DESCRIPTOR};
+    ApiDescriptor y{MIOPEN_BACKEND_TENSOR_DESCRIPTOR};
+    ApiDescriptor relu{MIOPEN_BACKEND_POINTWISE_DESCRIPTOR};
+    ApiDescriptor operation{MIOPEN_BACKEND_OPERATION_POINTWISE_DESCRIPTOR};
+    ApiDescriptor graph{MIOPEN_BACKEND_OPERATIONGRAPH_DESCRIPTOR};
+
+    BackendRelu(miopenHandle_t handle, int64_t batch, int64_t firstId)
+    {
+        for(auto* tensor : {&x, &y})
+        {
+            const int64_t id = tensor == &x ? firstId : firstId + 1;
+            EXPECT_EQ(tensor->set(MIOPEN_ATTR_TENSOR_DATA_TYPE,
+                                  MIOPEN_TYPE_DATA_TYPE,
+                                  std::vector<miopenDataType_t>{miopenFloat}),
+                      miopenStatusSuccess);
+            EXPECT_EQ(tensor->set(MIOPEN_ATTR_TENSOR_DIMENSIONS,
+                                  MIOPEN_TYPE_INT64,
+                                  std::vector<int64_t>{batch, 4}),
+                      miopenStatusSuccess);
+            EXPECT_EQ(tensor->set(MIOPEN_ATTR_TENSOR_STRIDES,
+                                  MIOPEN_TYPE_INT64,
+                                  std::vector<int64_t>{4, 1}),
+                      miopenStatusSuccess);
+            EXPECT_EQ(tensor->set(MIOPEN_ATTR_TENSOR_UNIQUE_ID,
+                                  MIOPEN_TYPE_INT64,
+                                  std::vector<int64_t>{id}),
+                      miopenStatusSuccess);
+            EXPECT_EQ(tensor->finalize(), miopenStatusSuccess);
+        }
+
+        EXPECT_EQ(relu.set(MIOPEN_ATTR_POINTWISE_MODE,
+                           MIOPEN_TYPE_POINTWISE_MODE,
+                           std::vector<miopenPointwiseMode_t>{MIOPEN_POINTWISE_RELU_FWD}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(relu.set(MIOPEN_ATTR_POINTWISE_MATH_PREC,
+                           MIOPEN_TYPE_DATA_TYPE,
+                           std::vector<miopenDataType_t>{miopenFloat}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(relu.finalize(), miopenStatusSuccess);
+
+        EXPECT_EQ(operation.set(MIOPEN_ATTR_OPERATION_POINTWISE_PW_DESCRIPTOR,
+                                MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                                std::vector{relu.get()}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(operation.set(MIOPEN_ATTR_OPERATION_POINTWISE_XDESC,
+                                MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                                std::vector{x.get()}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(operation.set(MIOPEN_ATTR_OPERATION_POINTWISE_YDESC,
+                                MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                                std::vector{y.get()}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(operation.finalize(), miopenStatusSuccess);
+
+        EXPECT_EQ(graph.set(MIOPEN_ATTR_OPERATIONGRAPH_HANDLE,
+                            MIOPEN_TYPE_HANDLE,
+                            std::vector<miopenHandle_t>{handle}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(graph.set(MIOPEN_ATTR_OPERATIONGRAPH_OPS,
+                            MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                            std::vector{operation.get()}),
+                  miopenStatusSuccess);
+        EXPECT_EQ(graph.finalize(), miopenStatusSuccess);
+    }
+};
+
+std::vector<float> runBackend(miopenHandle_t handle,
+                              miopenBackendDescriptor_t plan,
+                              int64_t batch,
+                              int64_t firstId,
+                              miopenStatus_t& status)
+{
+    int64_t workspaceSize = 0;
+    int64_t count         = 0;
+    EXPECT_EQ(miopenBackendGetAttribute(plan,
+                                        MIOPEN_ATTR_EXECUTION_PLAN_WORKSPACE_SIZE,
+                                        MIOPEN_TYPE_INT64,
+                                        1,
+                                        &count,
+                                        &workspaceSize),
+              miopenStatusSuccess);
+
+    std::vector<float> x(batch * 4);
+    for(size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+    }
+    std::vector<float> y(x.size());
+    std::vector<char> workspace(std::max<int64_t>(workspaceSize, 1));
+
+    ApiDescriptor variantPack(MIOPEN_BACKEND_VARIANT_PACK_DESCRIPTOR);
+    EXPECT_EQ(variantPack.set(MIOPEN_ATTR_VARIANT_PACK_UNIQUE_IDS,
+                              MIOPEN_TYPE_INT64,
+                              std::vector<int64_t>{firstId, firstId + 1}),
+              miopenStatusSuccess);
+    EXPECT_EQ(variantPack.set(MIOPEN_ATTR_VARIANT_PACK_DATA_POINTERS,
+                              MIOPEN_TYPE_VOID_PTR,
+                              std::vector<void*>{x.data(), y.data()}),
+              miopenStatusSuccess);
+    EXPECT_EQ(variantPack.set(MIOPEN_ATTR_VARIANT_PACK_WORKSPACE,
+                              MIOPEN_TYPE_VOID_PTR,
+                              std::vector<void*>{workspace.data()}),
+              miopenStatusSuccess);
+    EXPECT_EQ(variantPack.finalize(), miopenStatusSuccess);
+
+    status = miopenBackendExecute(handle, plan, variantPack.get());
+    return y;
+}
+
+} // namespace
+
+TEST(GraphApi, ExecutionPlanBackendJson)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto& cache = gr::ExecutionPlanCache::instance();
+    cache.clear();
+
+    // one job ranks the engines and saves the plan
+    BackendRelu first(handle, 3, 1);
+    ApiDescriptor heur(MIOPEN_BACKEND_ENGINEHEUR_DESCRIPTOR);
+    ASSERT_EQ(heur.set(MIOPEN_ATTR_ENGINEHEUR_MODE,
+                       MIOPEN_TYPE_HEUR_MODE,
+                       std::vector<miopenBackendHeurMode_t>{MIOPEN_HEUR_MODE_INSTANT}),
+              miopenStatusSuccess);
+    ASSERT_EQ(heur.set(MIOPEN_ATTR_ENGINEHEUR_OPERATION_GRAPH,
+                       MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                       std::vector{first.graph.get()}),
+              miopenStatusSuccess);
+    ASSERT_EQ(heur.finalize(), miopenStatusSuccess);
+
+    miopenBackendDescriptor_t engineCfg = nullptr;
+    int64_t count                       = 0;
+    ASSERT_EQ(miopenBackendGetAttribute(heur.get(),
+                                        MIOPEN_ATTR_ENGINEHEUR_RESULTS,
+                                        MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                                        1,
+                                        &count,
+                                        &engineCfg),
+              miopenStatusSuccess);
+    ASSERT_GE(count, 1);
+
+    ApiDescriptor plan(MIOPEN_BACKEND_EXECUTION_PLAN_DESCRIPTOR);
+    ASSERT_EQ(plan.set(MIOPEN_ATTR_EXECUTION_PLAN_HANDLE,
+                       MIOPEN_TYPE_HANDLE,
+                       std::vector<miopenHandle_t>{handle}),
+              miopenStatusSuccess);
+    ASSERT_EQ(plan.set(MIOPEN_ATTR_EXECUTION_PLAN_ENGINE_CONFIG,
+                       MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                       std::vector{engineCfg}),
+              miopenStatusSuccess);
+    ASSERT_EQ(plan.finalize(), miopenStatusSuccess);
+    EXPECT_EQ(cache.size(), 1u);
+
+    std::vector<char> json(4096);
+    ASSERT_EQ(miopenBackendGetAttribute(plan.get(),
+                                        MIOPEN_ATTR_EXECUTION_PLAN_JSON_REPRESENTATION,
+                                        MIOPEN_TYPE_CHAR,
+                                        json.size(),
+                                        &count,
+                                        json.data()),
+              miopenStatusSuccess);
+    ASSERT_LE(count, static_cast<int64_t>(json.size()));
+    json.resize(count - 1);
+
+    // the next one restores it, its engine heuristics then put the engine of the plan first
+    cache.clear();
+    ApiDescriptor restored(MIOPEN_BACKEND_EXECUTION_PLAN_DESCRIPTOR);
+    ASSERT_EQ(restored.set(MIOPEN_ATTR_EXECUTION_PLAN_HANDLE,
+                           MIOPEN_TYPE_HANDLE,
+                           std::vector<miopenHandle_t>{handle}),
+              miopenStatusSuccess);
+    ASSERT_EQ(restored.set(MIOPEN_ATTR_EXECUTION_PLAN_JSON_REPRESENTATION, MIOPEN_TYPE_CHAR, json),
+              miopenStatusSuccess);
+    ASSERT_EQ(restored.finalize(), miopenStatusSuccess);
+    EXPECT_EQ(cache.size(), 1u);
+
+    // without a graph the restored plan cannot run
+    miopenStatus_t status = miopenStatusUnknownError;
+    runBackend(handle, restored.get(), 3, 11, status);
+    EXPECT_NE(status, miopenStatusSuccess);
+
+    BackendRelu next(handle, 3, 11);
+    const auto* nextGraph =
+        dynamic_cast<gr::BackendOperationGraphDescriptor&>(miopen::deref(next.graph.get()))
+            .getOperationGraph();
+    const auto cached = cache.findEngineIndex(*nextGraph, handle, MIOPEN_HEUR_MODE_INSTANT);
+    ASSERT_TRUE(cached.has_value());
+
+    ApiDescriptor nextHeur(MIOPEN_BACKEND_ENGINEHEUR_DESCRIPTOR);
+    ASSERT_EQ(nextHeur.set(MIOPEN_ATTR_ENGINEHEUR_MODE,
+                           MIOPEN_TYPE_HEUR_MODE,
+                           std::vector<miopenBackendHeurMode_t>{MIOPEN_HEUR_MODE_INSTANT}),
+              miopenStatusSuccess);
+    ASSERT_EQ(nextHeur.set(MIOPEN_ATTR_ENGINEHEUR_OPERATION_GRAPH,
+                           MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                           std::vector{next.graph.get()}),
+              miopenStatusSuccess);
+    ASSERT_EQ(nextHeur.finalize(), miopenStatusSuccess);
+
+    miopenBackendDescriptor_t nextEngineCfg = nullptr;
+    ASSERT_EQ(miopenBackendGetAttribute(nextHeur.get(),
+                                        MIOPEN_ATTR_ENGINEHEUR_RESULTS,
+                                        MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                                        1,
+                                        &count,
+                                        &nextEngineCfg),
+              miopenStatusSuccess);
+    ASSERT_GE(count, 1);
+    const auto& nextEngine =
+        dynamic_cast<gr::BackendEngineCfgDescriptor&>(miopen::deref(nextEngineCfg))
+            .getEngineCfg()
+            .getEngine();
+    EXPECT_EQ(nextEngine.getGlobalIndex(), *cached);
+
+    ApiDescriptor nextPlan(MIOPEN_BACKEND_EXECUTION_PLAN_DESCRIPTOR);
+    ASSERT_EQ(nextPlan.set(MIOPEN_ATTR_EXECUTION_PLAN_HANDLE,
+                           MIOPEN_TYPE_HANDLE,
+                           std::vector<miopenHandle_t>{handle}),
+              miopenStatusSuccess);
+    ASSERT_EQ(nextPlan.set(MIOPEN_ATTR_EXECUTION_PLAN_ENGINE_CONFIG,
+                           MIOPEN_TYPE_BACKEND_DESCRIPTOR,
+                           std::vector{nextEngineCfg}),
+              miopenStatusSuccess);
+    ASSERT_EQ(nextPlan.finalize(), miopenStatusSuccess);
+
+    const auto y = runBackend(handle, nextPlan.get(), 3, 11, status);
+    EXPECT_EQ(status, miopenStatusSuccess);
+    for(size_t i = 0; i < y.size(); ++i)
+    {
+        EXPECT_EQ(y[i], std::max(static_cast<float>(static_cast<int>(i % 5) - 2), 0.0f));
+    }
+
+    // a graph of another shape does not take the plan
+    BackendRelu larger(handle, 5, 21);
+    const auto* largerGraph =
+        dynamic_cast<gr::BackendOperationGraphDescriptor&>(miopen::deref(larger.graph.get()))
+            .getOperationGraph();
+    EXPECT_FALSE(cache.findEngineIndex(*largerGraph, handle, MIOPEN_HEUR_MODE_INSTANT).has_value());
+
+    cache.clear();
+    miopenDestroy(handle);
+}
@@ -25,6 +25,7 @@
  *******************************************************************************/
 #pragma once
 
+#include <miopen/graphapi/opgraph.hpp>
 #include <miopen/graphapi/tensor.hpp>
 #include <miopen/miopen.h>
 
@@ -32,6 +33,7 @@
 #include <cassert>
 #include <cstdint>
 #include <initializer_list>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -40,6 +42,31 @@ namespace miopen {
 
 namespace graphapi {
 
+/// A float tensor with packed strides.
+inline Tensor makePackedTensor(int64_t id, std::vector<int64_t> dims, bool isVirtual = false)
+{
+    std::vector<int64_t> strides(dims.size(), 1);
+    for(size_t d = dims.size() - 1; d > 0; --d)
+    {
+        strides[d - 1] = strides[d] * dims[d];
+    }
+    return TensorBuilder{}
+        .setDataType(miopenFloat)
+        .setDim(std::move(dims))
+        .setStride(std::move(strides))
+        .setId(id)
+        .setVirtual(isVirtual)
+        .build();
+}
+
+inline OpGraph makeGraph(miopenHandle_t handle, std::vector<OpNode*> nodes)
+{
+    OpGraphBuilder builder;
+    builder.setHandle(handle);
+    builder.setNodes(std::move(nodes));
+    return std::move(builder).build();
+}
+
 template <typename T>
 struct ValidatedVector
 {
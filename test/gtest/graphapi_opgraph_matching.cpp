@@ -25,6 +25,64 @@
  *******************************************************************************/
 #include "graphapi_opgraph_common.hpp"
 
+#include <miopen/graphapi/convolution.hpp>
+#include <miopen/graphapi/pointwise.hpp>
+
+#include <deque>
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+/// relu(conv(x, w)) with the given convolution padding and relu lower clip
+struct ConvRelu
+{
+    std::deque<gr::Tensor> tensors;
+    gr::Convolution conv;
+    gr::Pointwise relu;
+    gr::OperationConvolutionForward convNode;
+    gr::OperationPointwise reluNode;
+    gr::OpGraph graph;
+
+    ConvRelu(miopenHandle_t handle, int64_t padding, float lowerClip)
+        : conv(miopenFloat,
+               miopenConvolution,
+               2,
+               {padding, padding},
+               {1, 1},
+               {1, 1},
+               {padding, padding}),
+          relu(MIOPEN_POINTWISE_RELU_FWD, miopenFloat, MIOPEN_NOT_PROPAGATE_NAN, lowerClip)
+    {
+        auto tensor = [&](int64_t id, std::vector<int64_t> dims, bool isVirtual) {
+            return &tensors.emplace_back(gr::TensorBuilder{}
+                                             .setDataType(miopenFloat)
+                                             .setDim(dims)
+                                             .setStride({dims[1] * dims[2] * dims[3],
+                                                         dims[2] * dims[3],
+                                                         dims[3],
+                                                         1})
+                                             .setId(id)
+                                             .setVirtual(isVirtual)
+                                             .build());
+        };
+        auto* x = tensor(1, {1, 1, 4, 4}, false);
+        auto* w = tensor(2, {1, 1, 3, 3}, false);
+        auto* a = tensor(3, {1, 1, 4, 4}, true);
+        auto* y = tensor(4, {1, 1, 4, 4}, false);
+
+        convNode = gr::OperationConvolutionForward(&conv, x, w, a, 1.0, 0.0);
+        reluNode = gr::OperationPointwise(&relu, a, y);
+
+        gr::OpGraphBuilder builder;
+        builder.setHandle(handle);
+        builder.setNodes({&convNode, &reluNode});
+        graph = std::move(builder).build();
+    }
+};
+
+} // namespace
+
 TEST(GraphMatchingAPI, DiamondGraphMatch)
 {
     using namespace graphapi_opgraph_tests;
@@ -68,3 +126,81 @@ TEST(GraphMatchingAPI, DiamondGraphMatch)
         ASSERT_FALSE(gr::isIsomorphic(dg1->graph(), dg5->graph()));
     }
 }
+
+TEST(GraphMatchingAPI, NodeOrderIndependent)
+{
+    using namespace graphapi_opgraph_tests;
+
+    auto dg1 = makeDiamondGraph();
+
+    auto dg2 = DummyOpGraphGenerator::Make({{"bottom", {"t_c", "t_d"}, {"t_out"}},
+                                            {"right", {"t_b"}, {"t_d"}},
+                                            {"left", {"t_a"}, {"t_c"}},
+                                            {"top", {"t_in"}, {"t_b", "t_a"}}});
+
+    ASSERT_EQ(dg1->graph().getCanonicalHash(), dg2->graph().getCanonicalHash());
+    ASSERT_TRUE(gr::isIsomorphic(dg1->graph(), dg2->graph()));
+}
+
+TEST(GraphMatchingAPI, ResidualGraphMatch)
+{
+    using namespace graphapi_opgraph_tests;
+
+    auto residual = DummyOpGraphGenerator::Make({{"conv", {"t_in", "t_w"}, {"t_a"}},
+                                                 {"act", {"t_a"}, {"t_b"}},
+                                                 {"add", {"t_b", "t_a"}, {"t_out"}}});
+
+    {
+        auto same = DummyOpGraphGenerator::Make({{"add", {"t_y", "t_x"}, {"t_z"}},
+                                                 {"conv", {"t_i", "t_j"}, {"t_x"}},
+                                                 {"act", {"t_x"}, {"t_y"}}});
+        ASSERT_TRUE(gr::isIsomorphic(residual->graph(), same->graph()));
+    }
+
+    {
+        // residual taken from the graph input instead of the conv output
+        auto skip = DummyOpGraphGenerator::Make({{"conv", {"t_in", "t_w"}, {"t_a"}},
+                                                 {"act", {"t_a"}, {"t_b"}},
+                                                 {"add", {"t_b", "t_in"}, {"t_out"}}});
+        ASSERT_FALSE(gr::isIsomorphic(residual->graph(), skip->graph()));
+    }
+
+    {
+        // same nodes, but the activation is applied after the add
+        auto swapped = DummyOpGraphGenerator::Make({{"conv", {"t_in", "t_w"}, {"t_a"}},
+                                                    {"add", {"t_a", "t_r"}, {"t_b"}},
+                                                    {"act", {"t_b"}, {"t_out"}}});
+        ASSERT_FALSE(gr::isIsomorphic(residual->graph(), swapped->graph()));
+    }
+}
+
+TEST(GraphMatchingAPI, CycleRejected)
+{
+    using namespace graphapi_opgraph_tests;
+
+    ASSERT_ANY_THROW(
+        DummyOpGraphGenerator::Make({{"a", {"t_x"}, {"t_y"}}, {"b", {"t_y"}, {"t_x"}}}));
+}
+
+TEST(GraphMatchingAPI, AttributesDistinguishNodes)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    const ConvRelu graph(handle, 1, 0.0f);
+    const ConvRelu same(handle, 1, 0.0f);
+    const ConvRelu clipped(handle, 1, 0.5f);
+    const ConvRelu unpadded(handle, 0, 0.0f);
+
+    EXPECT_EQ(graph.graph.getCanonicalForm(), same.graph.getCanonicalForm());
+    EXPECT_EQ(graph.graph.getShapeHash(), same.graph.getShapeHash());
+
+    for(const auto* other : {&clipped, &unpadded})
+    {
+        EXPECT_NE(graph.graph.getCanonicalForm(), other->graph.getCanonicalForm());
+        EXPECT_NE(graph.graph.getCanonicalHash(), other->graph.getCanonicalHash());
+        EXPECT_NE(graph.graph.getShapeHash(), other->graph.getShapeHash());
+    }
+
+    miopenDestroy(handle);
+}
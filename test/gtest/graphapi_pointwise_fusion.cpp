@@ -0,0 +1,210 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/graphapi/execution_plan.hpp>
+#include <miopen/graphapi/host_executor.hpp>
+#include <miopen/graphapi/matmul.hpp>
+#include <miopen/graphapi/pointwise_fusion.hpp>
+#include <miopen/graphapi/reduction.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "graphapi_gtest_common.hpp"
+
+namespace {
+
+namespace gr = miopen::graphapi;
+
+using gr::makeGraph;
+using gr::makePackedTensor;
+
+void run(const gr::ExecutionSchedule& schedule, const gr::VariantPack& variantPack)
+{
+    const auto buffers = schedule.bind(variantPack);
+    for(const gr::OpNode* step : schedule.getSteps())
+    {
+        gr::executeOnHost(*step, buffers);
+    }
+}
+
+std::vector<float> sequence(size_t size, float scale)
+{
+    std::vector<float> ret(size);
+    for(size_t i = 0; i < size; ++i)
+    {
+        ret[i] = scale * static_cast<float>(static_cast<int>(i % 7) - 3);
+    }
+    return ret;
+}
+
+} // namespace
+
+TEST(GraphApi, PointwiseFusionMatmulEpilogue)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    constexpr int64_t m = 8, k = 5, n = 16;
+
+    auto a        = makePackedTensor(1, {1, m, k});
+    auto b        = makePackedTensor(2, {1, k, n});
+    auto bias     = makePackedTensor(3, {1, 1, n});
+    auto scale    = makePackedTensor(4, {1, 1, 1});
+    auto residual = makePackedTensor(5, {1, m, n});
+    auto c        = makePackedTensor(6, {1, m, n}, true);
+    auto biased   = makePackedTensor(7, {1, m, n}, true);
+    auto scaled   = makePackedTensor(8, {1, m, n}, true);
+    auto act      = makePackedTensor(9, {1, m, n}, true);
+    auto y        = makePackedTensor(10, {1, m, n});
+
+    gr::Matmul matmul(miopenFloat);
+    gr::Pointwise add(MIOPEN_POINTWISE_ADD, miopenFloat);
+    gr::Pointwise mul(MIOPEN_POINTWISE_MUL, miopenFloat);
+    gr::Pointwise gelu(MIOPEN_POINTWISE_GELU_FWD, miopenFloat);
+    gr::OperationMatmul matmulOp(&a, &b, &c, 1, nullptr, nullptr, nullptr, &matmul);
+    gr::OperationPointwise biasOp(&add, &c, &bias, &biased);
+    gr::OperationPointwise scaleOp(&mul, &biased, &scale, &scaled);
+    gr::OperationPointwise geluOp(&gelu, &scaled, &act);
+    gr::OperationPointwise residualOp(&add, &act, &residual, &y, 1.0f, 0.5f);
+
+    auto graph = makeGraph(handle, {&residualOp, &geluOp, &scaleOp, &biasOp, &matmulOp});
+
+    const gr::ExecutionSchedule unfused(graph, false);
+    const gr::ExecutionSchedule fused(graph);
+
+    ASSERT_EQ(unfused.getSteps().size(), 5u);
+    ASSERT_EQ(fused.getSteps().size(), 2u);
+    EXPECT_EQ(fused.getSteps().front(), &matmulOp);
+    const auto* epilogue =
+        dynamic_cast<const gr::OperationFusedPointwise*>(fused.getSteps().back());
+    ASSERT_NE(epilogue, nullptr);
+    // c, bias, scale and residual come in, only y goes out
+    EXPECT_EQ(epilogue->getInputs().size(), 4u);
+    EXPECT_EQ(epilogue->getInstructions().size(), 4u);
+    ASSERT_EQ(epilogue->getOutTensors().size(), 1u);
+    EXPECT_EQ(epilogue->getOutTensors().front(), &y);
+    // only c is left in the workspace
+    EXPECT_EQ(fused.getAllocations().size(), 1u);
+    EXPECT_EQ(fused.getWorkspaceSize(), m * n * sizeof(float));
+    EXPECT_LT(fused.getWorkspaceSize(), unfused.getWorkspaceSize());
+
+    auto aData        = sequence(m * k, 0.25f);
+    auto bData        = sequence(k * n, -0.5f);
+    auto biasData     = sequence(n, 0.125f);
+    auto scaleData    = std::vector<float>{0.75f};
+    auto residualData = sequence(m * n, 1.0f);
+    std::vector<float> yUnfused(m * n);
+    std::vector<float> yFused(m * n);
+    std::vector<char> workspace(unfused.getWorkspaceSize());
+
+    auto variantPack = [&](std::vector<float>& yData) {
+        return gr::VariantPackBuilder()
+            .setTensorIds({1, 2, 3, 4, 5, 10})
+            .setDataPointers({aData.data(),
+                              bData.data(),
+                              biasData.data(),
+                              scaleData.data(),
+                              residualData.data(),
+                              yData.data()})
+            .setWorkspace(workspace.data())
+            .build();
+    };
+    run(unfused, variantPack(yUnfused));
+    run(fused, variantPack(yFused));
+
+    for(size_t i = 0; i < yFused.size(); ++i)
+    {
+        EXPECT_NEAR(yFused[i], yUnfused[i], 1e-5f * (1.0f + std::fabs(yUnfused[i]))) << i;
+    }
+
+    miopenDestroy(handle);
+}
+
+TEST(GraphApi, PointwiseFusionBoundaries)
+{
+    miopenHandle_t handle;
+    ASSERT_EQ(miopenCreate(&handle), miopenStatusSuccess) << "miopenCreate() failed";
+
+    auto x    = makePackedTensor(1, {4, 4});
+    auto neg  = makePackedTensor(2, {4, 4}, true);
+    auto sum  = makePackedTensor(3, {4, 1}, true);
+    auto row  = makePackedTensor(4, {1, 4});
+    auto half = makePackedTensor(5, {1, 4}, true);
+    auto y    = makePackedTensor(6, {4, 4});
+    auto z    = makePackedTensor(7, {4, 4});
+
+    gr::Pointwise negate(MIOPEN_POINTWISE_NEG, miopenFloat);
+    gr::Pointwise add(MIOPEN_POINTWISE_ADD, miopenFloat);
+    gr::Pointwise identity(MIOPEN_POINTWISE_IDENTITY, miopenFloat);
+    gr::Reduction reduceAdd(MIOPEN_REDUCE_TENSOR_ADD, miopenFloat);
+    gr::OperationPointwise negOp(&negate, &x, &neg);
+    gr::OperationReduction sumOp(&reduceAdd, &neg, &sum);
+    // the path through the reduction keeps negOp and addOp apart
+    gr::OperationPointwise addOp(&add, &neg, &sum, &y);
+    // halfOp has other output dimensions than the operation it feeds
+    gr::OperationPointwise halfOp(&identity, &row, &half, 0.5f);
+    gr::OperationPointwise rowOp(&add, &half, &x, &z);
+
+    auto graph = makeGraph(handle, {&negOp, &sumOp, &addOp, &halfOp, &rowOp});
+    const gr::ExecutionSchedule schedule(graph);
+
+    EXPECT_EQ(schedule.getSteps().size(), 5u);
+    for(const gr::OpNode* step : schedule.getSteps())
+    {
+        EXPECT_EQ(dynamic_cast<const gr::OperationFusedPointwise*>(step), nullptr);
+    }
+
+    std::vector<float> xData(16);
+    for(size_t i = 0; i < xData.size(); ++i)
+    {
+        xData[i] = static_cast<float>(i);
+    }
+    std::vector<float> rowData{2, 4, 6, 8};
+    std::vector<float> yData(16);
+    std::vector<float> zData(16);
+    std::vector<char> workspace(schedule.getWorkspaceSize());
+    run(schedule,
+        gr::VariantPackBuilder()
+            .setTensorIds({1, 4, 6, 7})
+            .setDataPointers({xData.data(), rowData.data(), yData.data(), zData.data()})
+            .setWorkspace(workspace.data())
+            .build());
+
+    for(size_t i = 0; i < 4; ++i)
+    {
+        const float rowSum = -static_cast<float>(4 * 4 * i + 6);
+        for(size_t j = 0; j < 4; ++j)
+        {
+            EXPECT_EQ(yData[4 * i + j], -xData[4 * i + j] + rowSum);
+            EXPECT_EQ(zData[4 * i + j], rowData[j] / 2 + xData[4 * i + j]);
+        }
+    }
+
+    miopenDestroy(handle);
+}
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/kernel_shm_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct ShmName
+{
+    std::string name = "/miopen-test-kernels-" + std::to_string(getpid());
+
+    ShmName() { miopen::KernelShmCache::Unlink(name); }
+    ~ShmName() { miopen::KernelShmCache::Unlink(name); }
+};
+
+std::string Blob(int i) { return std::string(1000 + i, static_cast<char>('a' + i)); }
+
+} // namespace
+
+TEST(TestKernelShmCache, FindInsert)
+{
+    ShmName shm;
+    miopen::KernelShmCache cache{shm.name, 64 * 1024, 16};
+    ASSERT_TRUE(cache.IsValid());
+
+    EXPECT_FALSE(cache.Find("kernel0"));
+    EXPECT_TRUE(cache.Insert("kernel0", Blob(0)));
+    EXPECT_TRUE(cache.Insert("kernel0", Blob(1)));
+    const auto blob = cache.Find("kernel0");
+    ASSERT_TRUE(blob);
+    EXPECT_EQ(*blob, Blob(0));
+
+    // A second mapping sees the same entries and keeps the size of the segment.
+    miopen::KernelShmCache other{shm.name, 1024, 1};
+    ASSERT_TRUE(other.IsValid());
+    ASSERT_TRUE(other.Find("kernel0"));
+    EXPECT_TRUE(other.Insert("kernel1", Blob(1)));
+    ASSERT_TRUE(cache.Find("kernel1"));
+    EXPECT_EQ(*cache.Find("kernel1"), Blob(1));
+
+    // The entries which do not fit are not shared.
+    EXPECT_FALSE(cache.Insert("large", std::string(64 * 1024, 'x')));
+    EXPECT_FALSE(cache.Find("large"));
+}
+
+TEST(TestKernelShmCache, RejectsCorruptedBlob)
+{
+    ShmName shm;
+    miopen::KernelShmCache cache{shm.name, 64 * 1024, 16};
+    ASSERT_TRUE(cache.IsValid());
+    ASSERT_TRUE(cache.Insert("kernel0", Blob(0)));
+    ASSERT_TRUE(cache.Insert("kernel1", Blob(1)));
+
+    // Another process of the user overwrites a byte of the first blob.
+    const auto fd = shm_open(shm.name.c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    struct stat st = {};
+    ASSERT_EQ(fstat(fd, &st), 0);
+    const auto size     = static_cast<std::size_t>(st.st_size);
+    auto* const mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    ASSERT_NE(mapping, MAP_FAILED);
+    const auto entry = std::string{"kernel0"} + Blob(0);
+    auto* const found = static_cast<char*>(memmem(mapping, size, entry.data(), entry.size()));
+    ASSERT_NE(found, nullptr);
+    found[entry.size() - 1] = 'x';
+    munmap(mapping, size);
+
+    EXPECT_FALSE(cache.Find("kernel0"));
+    ASSERT_TRUE(cache.Find("kernel1"));
+    EXPECT_EQ(*cache.Find("kernel1"), Blob(1));
+}
+
+TEST(TestKernelShmCache, FullIndex)
+{
+    ShmName shm;
+    miopen::KernelShmCache cache{shm.name, 64 * 1024, 4};
+    ASSERT_TRUE(cache.IsValid());
+
+    for(auto i = 0; i < 4; ++i)
+        EXPECT_TRUE(cache.Insert("kernel" + std::to_string(i), Blob(i)));
+    EXPECT_FALSE(cache.Insert("kernel4", Blob(4)));
+    EXPECT_FALSE(cache.Find("kernel4"));
+    for(auto i = 0; i < 4; ++i)
+        EXPECT_TRUE(cache.Find("kernel" + std::to_string(i)));
+}
+
+TEST(TestKernelShmCache, MultiProcess)
+{
+    constexpr auto processes = 4;
+    constexpr auto kernels   = 64;
+
+    ShmName shm;
+    miopen::KernelShmCache cache{shm.name, 1024 * 1024, 256};
+    ASSERT_TRUE(cache.IsValid());
+
+    // Every process publishes every kernel, as the ranks of a node loading the same network.
+    std::vector<pid_t> children;
+    for(auto p = 0; p < processes; ++p)
+    {
+        const auto pid = fork();
+        ASSERT_GE(pid, 0);
+        if(pid == 0)
+        {
+            miopen::KernelShmCache child{shm.name, 1024 * 1024, 256};
+            auto ok = child.IsValid();
+            for(auto i = 0; i < kernels && ok; ++i)
+            {
+                const auto idx  = (i + p * 7) % kernels;
+                const auto key  = "kernel" + std::to_string(idx);
+                const auto blob = Blob(idx % 16);
+                ok = child.Insert(key, blob) && child.Find(key) && *child.Find(key) == blob;
+            }
+            _exit(ok ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+
+    // Readers in this process race with the writers.
+    std::thread reader([&]() {
+        for(auto i = 0; i < kernels; ++i)
+        {
+            const auto blob = cache.Find("kernel" + std::to_string(i));
+            if(blob)
+            {
+                EXPECT_EQ(*blob, Blob(i % 16));
+            }
+        }
+    });
+
+    for(const auto pid : children)
+    {
+        auto status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    reader.join();
+
+    for(auto i = 0; i < kernels; ++i)
+    {
+        const auto blob = cache.Find("kernel" + std::to_string(i));
+        ASSERT_TRUE(blob);
+        EXPECT_EQ(*blob, Blob(i % 16));
+    }
+}
+#endif
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/key_writer.hpp>
+#include <miopen/miopen.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The keys were written with default std::ostringstreams, which the db files still hold.
+template <class Write>
+void ExpectSameAsStream(const Write& write)
+{
+    std::ostringstream ss;
+    write(ss);
+    miopen::KeyWriter writer;
+    write(writer);
+    EXPECT_EQ(writer.View(), ss.str());
+}
+
+enum class Scoped : int8_t
+{
+    Value = 3,
+};
+
+} // namespace
+
+TEST(TestKeyWriter, Integers)
+{
+    ExpectSameAsStream([](auto& w) {
+        w << 0 << 'x' << -1 << 'x' << std::numeric_limits<int64_t>::min() << 'x'
+          << std::numeric_limits<uint64_t>::max() << 'x' << static_cast<short>(-7) << 'x'
+          << std::size_t{42} << 'x' << true << false;
+    });
+    // The streams write them as characters.
+    ExpectSameAsStream([](auto& w) {
+        w << static_cast<int8_t>('a') << static_cast<uint8_t>('b') << static_cast<signed char>('c');
+    });
+}
+
+TEST(TestKeyWriter, FloatingPoint)
+{
+    for(const auto value : {0.0, -0.0, 1.0, 0.1, -2.5, 1e-7, 1e-5, 123456.0, 1234567.0, 3.14159265,
+                            1e300, std::numeric_limits<double>::infinity(),
+                            -std::numeric_limits<double>::infinity()})
+    {
+        ExpectSameAsStream([&](auto& w) { w << value << '-' << static_cast<float>(value); });
+    }
+    ExpectSameAsStream([](auto& w) { w << 0.1f << 'x' << 1e-5f << 'x' << 0.0001f; });
+}
+
+TEST(TestKeyWriter, Enums)
+{
+    ExpectSameAsStream([](auto& w) {
+        w << miopenHalf << '-' << miopenBFloat16 << '-' << miopenBNSpatial << '-'
+          << miopenPoolingMax << '-' << MIOPEN_SOFTMAX_LOG;
+    });
+    // The streams have no operator for the scoped ones, they are compared with the promoted value.
+    miopen::KeyWriter writer;
+    writer << Scoped::Value;
+    EXPECT_EQ(writer.View(), "3");
+}
+
+TEST(TestKeyWriter, Strings)
+{
+    const auto layout = std::string{"NCHW"};
+    ExpectSameAsStream([&](auto& w) {
+        w << "fwd" << layout << std::string_view{"-"} << 'c' << static_cast<const char*>("");
+    });
+}
+
+TEST(TestKeyWriter, NetworkConfig)
+{
+    // The shape of the convolution and batchnorm configs.
+    const auto lengths = std::vector<int>{128, 64, 56, 56};
+    const auto key     = [&](auto& w) {
+        w << lengths[0] << 'x' << lengths[1] << 'x' << lengths[2] << 'x' << lengths[3] << '-'
+          << miopenFloat << '-' << miopenBNSpatial << '-' << 1e-5 << '-' << 0.1f << "-fp32"
+          << "-NCHW";
+    };
+    ExpectSameAsStream(key);
+
+    miopen::KeyWriter joined;
+    joined.Join(lengths, 'x');
+    EXPECT_EQ(joined.View(), "128x64x56x56");
+}
+
+TEST(TestKeyWriter, LongKey)
+{
+    // Keys which outgrow the buffer keep their text.
+    ExpectSameAsStream([](auto& w) {
+        for(auto i = 0; i < 100; ++i)
+            w << i << 'x' << i * 0.5 << '-';
+    });
+}
@@ -0,0 +1,258 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/db_record.hpp>
+#include <miopen/env.hpp>
+#include <miopen/filesystem.hpp>
+#include <miopen/ramdb.hpp>
+#include <miopen/temp_file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_DB_WRITE_BEHIND)
+
+namespace {
+
+struct TestValue
+{
+    int x = 0;
+
+    void Serialize(std::ostream& stream) const { stream << x; }
+
+    bool Deserialize(const std::string& str)
+    {
+        x = std::stoi(str);
+        return true;
+    }
+};
+
+miopen::DbRecord MakeRecord(const std::string& key, const std::string& id, int value)
+{
+    auto record = miopen::DbRecord{miopen::DbKinds::PerfDb, key};
+    record.SetValues(id, TestValue{value});
+    return record;
+}
+
+int LoadValue(miopen::RamDb& db, const std::string& key, const std::string& id)
+{
+    const auto record = db.FindRecord(key);
+    auto value        = TestValue{-1};
+    if(record)
+        record->GetValues(id, value);
+    return value.x;
+}
+
+} // namespace
+
+TEST(TestRamDb, SeesChangesOfAnotherInstance)
+{
+    if(miopen::DisableUserDbFileIO)
+        GTEST_SKIP();
+
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+    // Separate instances map the generation file independently, like different processes do.
+    auto writer = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    auto reader = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+
+    ASSERT_TRUE(writer.StoreRecord(MakeRecord("1x2", "s0", 1)));
+    EXPECT_EQ(LoadValue(reader, "1x2", "s0"), 1);
+
+    ASSERT_TRUE(writer.StoreRecord(MakeRecord("1x2", "s0", 2)));
+    EXPECT_EQ(LoadValue(reader, "1x2", "s0"), 2);
+
+    ASSERT_TRUE(writer.RemoveRecord(std::string{"1x2"}));
+    EXPECT_EQ(LoadValue(reader, "1x2", "s0"), -1);
+}
+
+TEST(TestRamDb, ReadsDuringWrites)
+{
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+    auto db              = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 0)));
+
+    constexpr int writes = 200;
+    auto done            = std::atomic<bool>{false};
+    auto readers         = std::vector<std::thread>{};
+
+    for(auto i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]() {
+            auto last = 0;
+            while(!done.load())
+            {
+                // Values are only increasing, a reader must never observe going back.
+                const auto value = LoadValue(db, "1x2", "s0");
+                EXPECT_GE(value, last);
+                last = value;
+            }
+        });
+    }
+
+    for(auto i = 1; i <= writes; ++i)
+        EXPECT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", i)));
+
+    done = true;
+    for(auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), writes);
+}
+
+TEST(TestRamDb, WriteBehindBatchesWrites)
+{
+    if(miopen::DisableUserDbFileIO)
+        GTEST_SKIP();
+
+    miopen::env::update(MIOPEN_DEBUG_DB_WRITE_BEHIND, true);
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+    auto db              = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    miopen::env::clear(MIOPEN_DEBUG_DB_WRITE_BEHIND);
+
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("3x4", "s0", 2)));
+    auto update = MakeRecord("1x2", "s1", 3);
+    ASSERT_TRUE(db.UpdateRecord(update));
+    ASSERT_TRUE(db.Remove(std::string{"3x4"}, "s0"));
+
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+    EXPECT_EQ(LoadValue(db, "1x2", "s1"), 3);
+    EXPECT_EQ(LoadValue(db, "3x4", "s0"), -1);
+
+    auto other = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    EXPECT_EQ(LoadValue(other, "1x2", "s0"), -1);
+
+    ASSERT_TRUE(db.Flush());
+    EXPECT_EQ(LoadValue(other, "1x2", "s0"), 1);
+    EXPECT_EQ(LoadValue(other, "1x2", "s1"), 3);
+    EXPECT_EQ(LoadValue(other, "3x4", "s0"), -1);
+}
+
+TEST(TestRamDb, WriteBehindReplaysJournal)
+{
+    if(miopen::DisableUserDbFileIO)
+        GTEST_SKIP();
+
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+
+    {
+        miopen::env::update(MIOPEN_DEBUG_DB_WRITE_BEHIND, true);
+        auto db = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+        miopen::env::clear(MIOPEN_DEBUG_DB_WRITE_BEHIND);
+
+        ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+        ASSERT_TRUE(db.StoreRecord(MakeRecord("3x4", "s0", 2)));
+        // Destroyed without a flush, as if the process has crashed.
+    }
+
+    auto& db = miopen::RamDb::GetCached(miopen::DbKinds::PerfDb, temp_file, false);
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+    EXPECT_EQ(LoadValue(db, "3x4", "s0"), 2);
+}
+
+TEST(TestRamDb, WriteBehindKeepsBatchOnFailure)
+{
+    if(miopen::DisableUserDbFileIO)
+        GTEST_SKIP();
+
+    miopen::env::update(MIOPEN_DEBUG_DB_WRITE_BEHIND, true);
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+    auto db              = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    miopen::env::clear(MIOPEN_DEBUG_DB_WRITE_BEHIND);
+
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+
+    // The db file can't be created in place of a directory.
+    const auto path = temp_file.Path();
+    miopen::fs::remove(path);
+    miopen::fs::create_directory(path);
+    EXPECT_FALSE(db.Flush());
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+
+    auto journals = 0;
+    for(const auto& entry : miopen::fs::directory_iterator{path.parent_path()})
+    {
+        if(entry.path().extension() == ".journal")
+            ++journals;
+    }
+    EXPECT_EQ(journals, 1);
+
+    miopen::fs::remove(path);
+    ASSERT_TRUE(db.Flush());
+    auto other = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    EXPECT_EQ(LoadValue(other, "1x2", "s0"), 1);
+}
+
+TEST(TestRamDb, WriteBehindFlushesOnTimer)
+{
+    if(miopen::DisableUserDbFileIO)
+        GTEST_SKIP();
+
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+
+    miopen::env::update(MIOPEN_DEBUG_DB_WRITE_BEHIND, true);
+    auto& db = miopen::RamDb::GetCached(miopen::DbKinds::PerfDb, temp_file, false);
+    miopen::env::clear(MIOPEN_DEBUG_DB_WRITE_BEHIND);
+
+    ASSERT_TRUE(db.StoreRecord(MakeRecord("1x2", "s0", 1)));
+
+    // No more writes come, the timer flushes the batch within a couple of seconds.
+    auto other = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    auto value = -1;
+    for(auto i = 0; i < 50 && value != 1; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        value = LoadValue(other, "1x2", "s0");
+    }
+    EXPECT_EQ(value, 1);
+}
+
+TEST(TestRamDb, DuplicateKeysLastWins)
+{
+    if(miopen::DisableUserDbFileIO)
+        GTEST_SKIP();
+
+    const auto temp_file = miopen::TempFile{"miopen.tests.ramdb"};
+    // Left by a failure in between of appending a record and marking its old line dead.
+    std::ofstream(temp_file.Path(), std::ios::trunc) << "1x2=s0:1\n3x4=s0:2\n1x2=s0:3\n";
+
+    auto db = miopen::RamDb{miopen::DbKinds::PerfDb, temp_file};
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 3);
+
+    auto plain        = miopen::PlainTextDb{miopen::DbKinds::PerfDb, temp_file};
+    const auto record = plain.FindRecord(std::string{"1x2"});
+    auto value        = TestValue{-1};
+    ASSERT_TRUE(record);
+    record->GetValues("s0", value);
+    EXPECT_EQ(value.x, 3);
+}
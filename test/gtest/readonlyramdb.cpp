@@ -0,0 +1,148 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/db_record.hpp>
+#include <miopen/readonlyramdb.hpp>
+#include <miopen/temp_file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+namespace {
+
+struct TestValue
+{
+    int x = 0;
+
+    void Serialize(std::ostream& stream) const { stream << x; }
+
+    bool Deserialize(const std::string& str)
+    {
+        x = std::stoi(str);
+        return true;
+    }
+};
+
+/// Reads the file instead of the embedded data
+class EmbedFsOverride
+{
+public:
+    EmbedFsOverride() : cached(miopen::debug::rordb_embed_fs_override())
+    {
+        miopen::debug::rordb_embed_fs_override() = true;
+    }
+    ~EmbedFsOverride() { miopen::debug::rordb_embed_fs_override() = cached; }
+
+private:
+    bool cached;
+};
+
+int LoadValue(const miopen::ReadonlyRamDb& db, const std::string& key, const std::string& id)
+{
+    const auto record = db.FindRecord(key);
+    auto value        = TestValue{-1};
+    if(record)
+        record->GetValues(id, value);
+    return value.x;
+}
+
+} // namespace
+
+TEST(TestReadonlyRamDb, FindsRecordsOfMappedFile)
+{
+    const auto override  = EmbedFsOverride{};
+    const auto temp_file = miopen::TempFile{"miopen.tests.readonlyramdb"};
+    // The last line has no line break.
+    std::ofstream(temp_file.Path(), std::ios::binary) << "1x2=s0:1;s1:2\n"
+                                                         "3x4=s0:3\n"
+                                                         "5x6=s0:4";
+
+    const auto& db = miopen::ReadonlyRamDb::GetCached(miopen::DbKinds::PerfDb, temp_file, true);
+
+    EXPECT_EQ(db.GetCacheMap().size(), 3u);
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+    EXPECT_EQ(LoadValue(db, "1x2", "s1"), 2);
+    EXPECT_EQ(LoadValue(db, "3x4", "s0"), 3);
+    EXPECT_EQ(LoadValue(db, "5x6", "s0"), 4);
+    EXPECT_EQ(LoadValue(db, "1x2", "s2"), -1);
+    EXPECT_FALSE(db.FindRecord(std::string{"7x8"}));
+    EXPECT_FALSE(db.FindRecord(std::string{"1x"}));
+}
+
+TEST(TestReadonlyRamDb, StripsCarriageReturns)
+{
+    const auto override  = EmbedFsOverride{};
+    const auto temp_file = miopen::TempFile{"miopen.tests.readonlyramdb"};
+    std::ofstream(temp_file.Path(), std::ios::binary) << "1x2=s0:1\r\n"
+                                                         "\r\n"
+                                                         "3x4=s0:2\r\n";
+
+    const auto& db = miopen::ReadonlyRamDb::GetCached(miopen::DbKinds::PerfDb, temp_file, true);
+
+    const auto& cache = db.GetCacheMap();
+    ASSERT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.at("1x2").content, "s0:1");
+    EXPECT_EQ(cache.at("3x4").content, "s0:2");
+    EXPECT_EQ(cache.at("3x4").line, 3);
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 1);
+}
+
+TEST(TestReadonlyRamDb, SkipsMalformedLines)
+{
+    const auto override  = EmbedFsOverride{};
+    const auto temp_file = miopen::TempFile{"miopen.tests.readonlyramdb"};
+    std::ofstream(temp_file.Path(), std::ios::binary) << "no key here\n"
+                                                         "=s0:1\n"
+                                                         "1x2=s0:2\n"
+                                                         "3x4=broken\n";
+
+    const auto& db = miopen::ReadonlyRamDb::GetCached(miopen::DbKinds::PerfDb, temp_file, true);
+
+    EXPECT_EQ(db.GetCacheMap().size(), 2u);
+    EXPECT_EQ(db.GetCacheMap().at("1x2").line, 3);
+    EXPECT_EQ(LoadValue(db, "1x2", "s0"), 2);
+    // The key is there, but its contents don't parse.
+    EXPECT_FALSE(db.FindRecord(std::string{"3x4"}));
+}
+
+TEST(TestReadonlyRamDb, LoadsEmptyAndMissingFiles)
+{
+    const auto override = EmbedFsOverride{};
+    const auto empty    = miopen::TempFile{"miopen.tests.readonlyramdb"};
+    std::ofstream(empty.Path(), std::ios::binary);
+    const auto missing = miopen::TempFile{"miopen.tests.readonlyramdb"};
+
+    const auto& empty_db =
+        miopen::ReadonlyRamDb::GetCached(miopen::DbKinds::PerfDb, empty, false);
+    EXPECT_TRUE(empty_db.GetCacheMap().empty());
+    EXPECT_FALSE(empty_db.FindRecord(std::string{"1x2"}));
+
+    const auto& missing_db =
+        miopen::ReadonlyRamDb::GetCached(miopen::DbKinds::PerfDb, missing, false);
+    EXPECT_TRUE(missing_db.GetCacheMap().empty());
+}
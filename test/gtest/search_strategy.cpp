@@ -0,0 +1,266 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/search_strategy.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace search = miopen::solver::search;
+
+namespace {
+
+// 32x32 configs in random order, with the fastest at (20, 7) and a smooth bowl around it, like
+// tile sizes that fit the problem better the closer they get to it.
+struct Landscape
+{
+    std::vector<std::pair<int, int>> configs;
+    float jitter = 0.0f;
+    std::mt19937 rng{42};
+
+    explicit Landscape(float jitter_ = 0.0f) : jitter(jitter_)
+    {
+        for(int a = 1; a <= 32; ++a)
+            for(int b = 1; b <= 32; ++b)
+                configs.emplace_back(a, b);
+        std::shuffle(configs.begin(), configs.end(), rng);
+    }
+
+    float Time(std::size_t candidate) const
+    {
+        const auto [a, b] = configs[candidate];
+        return 1.0f + 0.01f * static_cast<float>((a - 20) * (a - 20) + (b - 7) * (b - 7));
+    }
+
+    std::size_t Fastest() const
+    {
+        std::vector<std::size_t> all(configs.size());
+        std::iota(all.begin(), all.end(), 0);
+        return *std::min_element(all.begin(), all.end(), [&](auto x, auto y) {
+            return Time(x) < Time(y);
+        });
+    }
+
+    std::vector<std::vector<double>> Features() const
+    {
+        std::vector<std::vector<double>> features;
+        for(const auto& config : configs)
+        {
+            const auto serialized =
+                std::to_string(config.first) + "," + std::to_string(config.second);
+            features.push_back(search::ParseFeatures(serialized));
+        }
+        return features;
+    }
+
+    // Each run is off by up to the jitter, so the average of more runs is closer.
+    search::TimingOracle Oracle()
+    {
+        return [this](std::size_t candidate, std::size_t runs) -> std::optional<float> {
+            std::uniform_real_distribution<float> noise{-jitter, jitter};
+            auto sum = 0.0f;
+            for(std::size_t i = 0; i < runs; ++i)
+                sum += Time(candidate) * (1.0f + noise(rng));
+            return sum / static_cast<float>(runs);
+        };
+    }
+};
+
+search::Result Search(Landscape& landscape, const search::Options& options)
+{
+    const auto strategy =
+        search::MakeSearchStrategy(options, landscape.configs.size(), landscape.Features());
+    return search::Run(*strategy, landscape.Oracle());
+}
+
+} // namespace
+
+TEST(TestSearchStrategy, RandomMeasuresAll)
+{
+    Landscape landscape;
+    const auto result = Search(landscape, {});
+
+    ASSERT_TRUE(result.best);
+    EXPECT_EQ(*result.best, landscape.Fastest());
+    EXPECT_FLOAT_EQ(result.time, 1.0f);
+    EXPECT_EQ(result.failed, 0);
+    // Only those that come close to the best are run again.
+    EXPECT_GE(result.trials, landscape.configs.size());
+    EXPECT_LT(result.trials, landscape.configs.size() + 64);
+}
+
+TEST(TestSearchStrategy, Patience)
+{
+    Landscape landscape;
+    search::Options options;
+    options.patience  = 100;
+    const auto result = Search(landscape, options);
+
+    ASSERT_TRUE(result.best);
+    EXPECT_LT(result.trials, landscape.configs.size());
+}
+
+TEST(TestSearchStrategy, SuccessiveHalving)
+{
+    Landscape landscape{0.3f};
+    search::Options options;
+    options.strategy  = search::Strategy::SuccessiveHalving;
+    const auto result = Search(landscape, options);
+
+    // All once, the best third 3 times, the best ninth 5 times.
+    const auto n = landscape.configs.size();
+    EXPECT_EQ(result.trials, n + (n + 2) / 3 + ((n + 2) / 3 + 2) / 3);
+    EXPECT_EQ(result.runs, n + (n + 2) / 3 * 3 + ((n + 2) / 3 + 2) / 3 * 5);
+    ASSERT_TRUE(result.best);
+    // Single runs are off by up to 30%, the winner is still among the best few.
+    EXPECT_LT(landscape.Time(*result.best), 1.1f);
+}
+
+TEST(TestSearchStrategy, ModelGuided)
+{
+    Landscape landscape;
+    search::Options options;
+    options.strategy  = search::Strategy::ModelGuided;
+    options.patience  = 32;
+    const auto result = Search(landscape, options);
+
+    ASSERT_TRUE(result.best);
+    EXPECT_EQ(*result.best, landscape.Fastest());
+    EXPECT_LT(result.trials, landscape.configs.size() / 4);
+}
+
+TEST(TestSearchStrategy, ModelGuidedWithoutFeatures)
+{
+    Landscape landscape;
+    search::Options options;
+    options.strategy    = search::Strategy::ModelGuided;
+    const auto strategy = search::MakeSearchStrategy(options, landscape.configs.size());
+    const auto result   = search::Run(*strategy, landscape.Oracle());
+
+    ASSERT_TRUE(result.best);
+    EXPECT_EQ(*result.best, landscape.Fastest());
+    EXPECT_GE(result.trials, landscape.configs.size());
+}
+
+TEST(TestSearchStrategy, Failures)
+{
+    for(const auto strategy : {search::Strategy::Random,
+                               search::Strategy::SuccessiveHalving,
+                               search::Strategy::ModelGuided})
+    {
+        Landscape landscape;
+        auto oracle        = landscape.Oracle();
+        search::Options options;
+        options.strategy = strategy;
+        const auto s = search::MakeSearchStrategy(options, 64, landscape.Features());
+        const auto result =
+            search::Run(*s, [&](std::size_t candidate, std::size_t runs) -> std::optional<float> {
+                if(candidate % 2 == 0)
+                    return std::nullopt;
+                return oracle(candidate, runs);
+            });
+
+        ASSERT_TRUE(result.best) << strategy;
+        EXPECT_EQ(*result.best % 2, 1) << strategy;
+        EXPECT_GE(result.failed, 32) << strategy;
+
+        const auto all_fail = search::MakeSearchStrategy(options, 8);
+        const auto none     = search::Run(
+            *all_fail, [](std::size_t, std::size_t) -> std::optional<float> { return {}; });
+        EXPECT_FALSE(none.best) << strategy;
+        EXPECT_EQ(none.failed, 8) << strategy;
+    }
+}
+
+TEST(TestSearchStrategy, ParseFeatures)
+{
+    EXPECT_EQ(search::ParseFeatures("16,4,1,0"), (std::vector<double>{16, 4, 1, 0}));
+    EXPECT_EQ(search::ParseFeatures("-1:2.5"), (std::vector<double>{-1, 2.5}));
+    EXPECT_EQ(search::ParseFeatures("v4r1,xdlops"), (std::vector<double>{4, 1}));
+    EXPECT_TRUE(search::ParseFeatures("").empty());
+}
+
+TEST(TestSearchStrategy, Scheduler)
+{
+    search::Scheduler scheduler{search::MakeSearchStrategy({}, 40)};
+
+    EXPECT_TRUE(scheduler.Claim(5));
+    EXPECT_FALSE(scheduler.Claim(5));
+
+    std::vector<std::size_t> claimed;
+    while(const auto candidate = scheduler.ClaimNext())
+        claimed.push_back(*candidate);
+    ASSERT_EQ(claimed.size(), 39);
+    EXPECT_EQ(claimed.front(), 0);
+    EXPECT_TRUE(std::find(claimed.begin(), claimed.end(), 5) == claimed.end());
+    EXPECT_FALSE(scheduler.Claim(7));
+
+    const auto trial = scheduler.Next();
+    ASSERT_TRUE(trial);
+    EXPECT_EQ(trial->candidate, 0);
+    scheduler.Report(*trial, 1.0f);
+    EXPECT_EQ(scheduler.Best(), std::nullopt); // Waits for the re-runs.
+}
+
+TEST(TestSearchStrategy, ReadyFirst)
+{
+    for(const auto strategy : {search::Strategy::Random,
+                               search::Strategy::SuccessiveHalving,
+                               search::Strategy::ModelGuided})
+    {
+        search::Options options;
+        options.strategy = strategy;
+        search::Scheduler scheduler{search::MakeSearchStrategy(options, 100)};
+
+        // A slow compile of the first candidates does not hold up the measurements.
+        ASSERT_EQ(scheduler.ClaimNext(), 0);
+        ASSERT_EQ(scheduler.ClaimNext(), 1);
+        ASSERT_EQ(scheduler.ClaimNext(), 2);
+        scheduler.MarkReady(2);
+
+        const auto trial = scheduler.Next();
+        ASSERT_TRUE(trial) << strategy;
+        EXPECT_EQ(trial->candidate, 2) << strategy;
+        scheduler.Report(*trial, 1.0f);
+
+        // Nothing else is ready, back to the planned order.
+        auto next = scheduler.Next();
+        ASSERT_TRUE(next) << strategy;
+        if(next->candidate == 2)
+        {
+            // The re-runs come first.
+            scheduler.Report(*next, 1.0f);
+            next = scheduler.Next();
+            ASSERT_TRUE(next) << strategy;
+        }
+        EXPECT_EQ(next->candidate, 0) << strategy;
+    }
+}
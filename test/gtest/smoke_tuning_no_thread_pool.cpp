@@ -0,0 +1,90 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/generic_search.hpp>
+#include <miopen/thread_pool.hpp>
+
+#include <tuple>
+#include <string_view>
+
+#include "gtest_common.hpp"
+
+#include "../conv2d.hpp"
+
+namespace {
+
+auto GetTestCases()
+{
+    const auto env = std::tuple{std::pair{MIOPEN_FIND_ENFORCE, "SEARCH_DB_UPDATE"},
+                                std::pair{MIOPEN_DEBUG_TUNING_ITERATIONS_MAX, 5},
+                                std::pair{MIOPEN_FIND_MODE, "normal"},
+                                std::pair{MIOPEN_DEBUG_FIND_ONLY_SOLVER, "ConvAsm1x1U"}};
+
+    const std::string vf = " --verbose --disable-backward-data --disable-backward-weights";
+
+    return std::vector{
+        // clang-format off
+    std::pair{env, vf + " --input 1 4 2 2 --weights 4 4 1 1 --pads_strides_dilations 0 0 1 1 1 1"}
+        // clang-format on
+    };
+}
+
+using TestCase = decltype(GetTestCases())::value_type;
+
+bool SkipTest() { return get_handle_xnack(); }
+
+bool IsTestSupportedForDevice()
+{
+    using e_mask = enabled<Gpu::Default>;
+    using d_mask = disabled<Gpu::Default>;
+    return ::IsTestSupportedForDevMask<d_mask, e_mask>();
+}
+
+} // namespace
+
+class Conv2dTuningNoThreadPool : public FloatTestCase<std::vector<TestCase>>
+{
+};
+
+TEST_P(Conv2dTuningNoThreadPool, FloatTest_smoke_tuning_no_thread_pool)
+{
+    if(IsTestSupportedForDevice() && !SkipTest())
+    {
+        // Without pool workers the compile agents of the search get threads of their own. The
+        // shared pool may have been started by the tests run before, so the search is given a
+        // pool of its own.
+        auto pool              = miopen::ThreadPool{0};
+        const auto tuning_pool = miopen::solver::debug::TuningThreadPoolScopedOverride{pool};
+        invoke_with_params<conv2d_driver, Conv2dTuningNoThreadPool>(tuning_check);
+    }
+    else
+    {
+        GTEST_SKIP();
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(SmokeTuningNoThreadPool,
+                         Conv2dTuningNoThreadPool,
+                         testing::Values(GetTestCases()));
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/env.hpp>
+#include <miopen/solver_applicability_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_TEST_APPLICABILITY_CACHE_DUMMY)
+
+namespace {
+
+void Fill(miopen::SolverApplicabilityCache& cache, const std::string& problem, uint64_t solver)
+{
+    auto* results = cache.Get(problem);
+    ASSERT_NE(results, nullptr);
+    (*results)[solver].applicable = true;
+    (*results)[solver].workspace  = solver * 1024;
+}
+
+bool Known(miopen::SolverApplicabilityCache& cache, const std::string& problem, uint64_t solver)
+{
+    const auto* results = cache.Get(problem);
+    return results != nullptr && results->count(solver) != 0;
+}
+
+} // namespace
+
+TEST(TestSolverApplicabilityCache, Memoizes)
+{
+    miopen::SolverApplicabilityCache cache{4};
+    Fill(cache, "problem0", 1);
+    Fill(cache, "problem0", 2);
+    Fill(cache, "problem1", 1);
+
+    const auto* results = cache.Get("problem0");
+    ASSERT_NE(results, nullptr);
+    ASSERT_EQ(results->size(), 2);
+    EXPECT_TRUE(results->at(2).applicable);
+    EXPECT_EQ(results->at(2).workspace, 2048);
+    EXPECT_FALSE(results->at(2).wti);
+    EXPECT_TRUE(Known(cache, "problem1", 1));
+    EXPECT_FALSE(Known(cache, "problem1", 2));
+    EXPECT_EQ(cache.Size(), 2);
+}
+
+TEST(TestSolverApplicabilityCache, EvictsLeastRecentlyUsed)
+{
+    miopen::SolverApplicabilityCache cache{2};
+    Fill(cache, "problem0", 1);
+    Fill(cache, "problem1", 1);
+    EXPECT_TRUE(Known(cache, "problem0", 1)); // problem1 is now the least recently used
+    Fill(cache, "problem2", 1);
+
+    EXPECT_EQ(cache.Size(), 2);
+    EXPECT_TRUE(Known(cache, "problem0", 1));
+    EXPECT_TRUE(Known(cache, "problem2", 1));
+    EXPECT_FALSE(Known(cache, "problem1", 1));
+}
+
+TEST(TestSolverApplicabilityCache, DroppedOnEnvChange)
+{
+    miopen::SolverApplicabilityCache cache{2};
+    Fill(cache, "problem0", 1);
+    miopen::env::update(MIOPEN_TEST_APPLICABILITY_CACHE_DUMMY, true);
+    EXPECT_FALSE(Known(cache, "problem0", 1));
+    Fill(cache, "problem0", 1);
+    miopen::env::clear(MIOPEN_TEST_APPLICABILITY_CACHE_DUMMY);
+    EXPECT_FALSE(Known(cache, "problem0", 1));
+}
+
+TEST(TestSolverApplicabilityCache, Disabled)
+{
+    miopen::SolverApplicabilityCache cache{0};
+    EXPECT_EQ(cache.Get("problem0"), nullptr);
+    EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(TestSolverApplicabilityCache, ParallelEvaluationIsOptIn)
+{
+    if(MIOPEN_DEBUG_PARALLEL_APPLICABILITY)
+        GTEST_SKIP() << "Set in the environment";
+    EXPECT_FALSE(miopen::env::enabled(MIOPEN_DEBUG_PARALLEL_APPLICABILITY));
+}
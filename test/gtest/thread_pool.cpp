@@ -0,0 +1,197 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/mt_queue.hpp>
+#include <miopen/par_for.hpp>
+#include <miopen/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+TEST(TestThreadPool, CallsEachIndexOnce)
+{
+    miopen::ThreadPool pool{4};
+    for(const auto n : {0, 1, 3, 1000})
+    {
+        auto calls = std::vector<std::atomic<int>>(n);
+        pool.ParallelFor(n, [&](auto i) { ++calls[i]; });
+        for(const auto& count : calls)
+            EXPECT_EQ(count, 1);
+    }
+}
+
+TEST(TestThreadPool, NoWorkers)
+{
+    miopen::ThreadPool pool{0};
+    auto sum = 0;
+    pool.ParallelFor(10, [&](auto i) { sum += static_cast<int>(i); });
+    EXPECT_EQ(sum, 45);
+}
+
+TEST(TestThreadPool, Nested)
+{
+    miopen::ThreadPool pool{2};
+    auto sum = std::atomic<int>{0};
+    pool.ParallelFor(8, [&](auto) { pool.ParallelFor(8, [&](auto j) { sum += j; }); });
+    EXPECT_EQ(sum, 8 * 28);
+}
+
+TEST(TestThreadPool, RethrowsAfterAllCallsEnded)
+{
+    miopen::ThreadPool pool{4};
+    auto running = std::atomic<int>{0};
+    EXPECT_THROW(pool.ParallelFor(100,
+                                  [&](auto i) {
+                                      ++running;
+                                      if(i == 10)
+                                      {
+                                          --running;
+                                          throw std::runtime_error("failed");
+                                      }
+                                      --running;
+                                  }),
+                 std::runtime_error);
+    EXPECT_EQ(running, 0);
+
+    // The pool is still usable.
+    auto calls = std::atomic<int>{0};
+    pool.ParallelFor(100, [&](auto) { ++calls; });
+    EXPECT_EQ(calls, 100);
+}
+
+TEST(TestThreadPool, MaxThreads)
+{
+    miopen::ThreadPool pool{4};
+    std::mutex mutex;
+    auto ids = std::set<std::thread::id>{};
+    pool.ParallelFor(
+        1000,
+        [&](auto) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        },
+        2);
+    EXPECT_LE(ids.size(), 2);
+}
+
+TEST(TestThreadPool, Submit)
+{
+    miopen::ThreadPool pool{2};
+    auto ran = std::atomic<int>{0};
+    auto ok  = pool.Submit([&]() { ++ran; });
+    auto bad = pool.Submit([]() { throw std::runtime_error("failed"); });
+    ok.get();
+    EXPECT_THROW(bad.get(), std::runtime_error);
+    EXPECT_EQ(ran, 1);
+
+    // Without workers the task runs right away.
+    miopen::ThreadPool inline_pool{0};
+    inline_pool.Submit([&]() { ++ran; });
+    EXPECT_EQ(ran, 2);
+}
+
+TEST(TestThreadPool, Spawn)
+{
+    // A producer which waits for its consumer, as the compile agents of the tuning do.
+    for(const auto workers : {0, 2})
+    {
+        miopen::ThreadPool pool{static_cast<std::size_t>(workers)};
+        ThreadSafeQueue<int> queue{1};
+        auto producer = pool.Spawn([&]() {
+            for(auto i = 0; i < 100; ++i)
+                queue.push(int{i});
+            queue.close();
+        });
+        auto sum = 0;
+        while(const auto item = queue.pop())
+            sum += *item;
+        producer.get();
+        EXPECT_EQ(sum, 4950);
+    }
+}
+
+TEST(TestThreadPool, LoopsOfTasks)
+{
+    // The tasks of a worker are stolen by the others when it is busy with a loop.
+    miopen::ThreadPool pool{3};
+    auto sum     = std::atomic<int>{0};
+    auto futures = std::vector<std::future<void>>{};
+    for(auto i = 0; i < 8; ++i)
+    {
+        futures.push_back(
+            pool.Submit([&]() { pool.ParallelFor(100, [&](auto j) { sum += j; }); }));
+    }
+    for(auto& future : futures)
+        future.get();
+    EXPECT_EQ(sum, 8 * 4950);
+}
+
+#ifndef _WIN32
+TEST(TestThreadPool, Fork)
+{
+    auto& pool = miopen::ThreadPool::Shared();
+    auto sum   = std::atomic<int>{0};
+    pool.ParallelFor(100, [&](auto i) { sum += i; });
+
+    const auto child = fork();
+    ASSERT_NE(child, -1);
+    if(child == 0)
+    {
+        // The workers are started again in the child.
+        auto child_sum = std::atomic<int>{0};
+        pool.ParallelFor(100, [&](auto i) { child_sum += i; });
+        pool.Submit([&]() { child_sum += 1; }).get();
+        _exit(child_sum == 4951 ? 0 : 1);
+    }
+
+    auto status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(sum, 4950);
+}
+#endif
+
+TEST(TestThreadPool, ParFor)
+{
+    auto calls = std::vector<std::atomic<int>>(100);
+    miopen::par_for(calls.size(), miopen::shared_pool{}, [&](auto i) { ++calls[i]; });
+    miopen::par_for(calls.size(), miopen::max_threads{3}, [&](auto i) { ++calls[i]; });
+    miopen::par_for_strided(calls.size(), miopen::max_threads{3}, [&](auto i) { ++calls[i]; });
+    for(const auto& count : calls)
+        EXPECT_EQ(count, 3);
+}
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/env.hpp>
+#include <miopen/tuning_journal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+MIOPEN_DECLARE_ENV_VAR_BOOL(MIOPEN_DEBUG_TUNING_JOURNAL)
+
+namespace {
+
+const std::string arch      = "gfx000_0";
+const std::string solver_id = "TestTuningJournal";
+const std::string key       = "1-16-16-3x3-8-16-16-4-1x1-1x1-1x1-0-NCHW-FP32-F";
+
+class TestTuningJournal : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        miopen::solver::TuningJournal::Remove(arch, solver_id, key);
+        if(miopen::solver::TuningJournal::GetPath(arch, solver_id, key).empty())
+            GTEST_SKIP() << "The user db is disabled";
+    }
+
+    void TearDown() override { miopen::solver::TuningJournal::Remove(arch, solver_id, key); }
+};
+
+} // namespace
+
+TEST_F(TestTuningJournal, Resumes)
+{
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+        ASSERT_TRUE(journal.IsEnabled());
+        EXPECT_EQ(journal.Size(), 0);
+        journal.Record("16,4,1", 1, 0.125f);
+        journal.Record("16,4,1", 4, 0.1f);
+        journal.Record("32,8,0", 1, std::nullopt);
+    }
+
+    miopen::solver::TuningJournal journal{arch, solver_id, key};
+    EXPECT_EQ(journal.Size(), 3);
+    EXPECT_EQ(journal.Find("16,4,1", 1), std::make_optional(std::make_optional(0.125f)));
+    EXPECT_EQ(journal.Find("16,4,1", 4), std::make_optional(std::make_optional(0.1f)));
+    EXPECT_EQ(journal.Find("32,8,0", 1), std::make_optional(std::optional<float>{}));
+    EXPECT_FALSE(journal.Find("32,8,0", 4));
+    EXPECT_FALSE(journal.Find("8,2,1", 1));
+}
+
+TEST_F(TestTuningJournal, CutShort)
+{
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+        journal.Record("16,4,1", 1, 0.125f);
+    }
+    {
+        std::ofstream file{miopen::solver::TuningJournal::GetPath(arch, solver_id, key),
+                           std::ios::app};
+        file << "1:32,8,0=0.2"; // "0.25" was being written
+    }
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+        EXPECT_EQ(journal.Size(), 1);
+        EXPECT_FALSE(journal.Find("32,8,0", 1));
+        journal.Record("8,2,1", 1, 0.5f);
+    }
+
+    // The line break after the cut line does not make it a trial.
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+        EXPECT_EQ(journal.Size(), 2);
+        EXPECT_FALSE(journal.Find("32,8,0", 1));
+        EXPECT_EQ(journal.Find("8,2,1", 1), std::make_optional(std::make_optional(0.5f)));
+        journal.Record("32,8,0", 1, 0.25f);
+    }
+
+    miopen::solver::TuningJournal journal{arch, solver_id, key};
+    EXPECT_EQ(journal.Size(), 3);
+    EXPECT_EQ(journal.Find("32,8,0", 1), std::make_optional(std::make_optional(0.25f)));
+}
+
+TEST_F(TestTuningJournal, NoTrials)
+{
+    // A journal with no trials yet is appended to, not started over.
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+    }
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+        journal.Record("16,4,1", 1, 0.125f);
+    }
+
+    std::ifstream file{miopen::solver::TuningJournal::GetPath(arch, solver_id, key)};
+    std::string line;
+    ASSERT_TRUE(std::getline(file, line));
+    EXPECT_EQ(line, key);
+    ASSERT_TRUE(std::getline(file, line));
+    EXPECT_EQ(line, "1:16,4,1=0.125;");
+    EXPECT_FALSE(std::getline(file, line));
+}
+
+TEST_F(TestTuningJournal, Locked)
+{
+    const auto path = miopen::solver::TuningJournal::GetPath(arch, solver_id, key);
+    miopen::solver::TuningJournal journal{arch, solver_id, key};
+    ASSERT_TRUE(journal.IsEnabled());
+    journal.Record("16,4,1", 1, 0.125f);
+
+    // Another search of the problem does not write to it, nor remove it.
+    miopen::solver::TuningJournal other{arch, solver_id, key};
+    EXPECT_FALSE(other.IsEnabled());
+    other.Record("16,4,1", 4, 0.1f);
+    miopen::solver::TuningJournal::Remove(arch, solver_id, key);
+    EXPECT_TRUE(miopen::fs::exists(path));
+
+    journal.Remove();
+    miopen::solver::TuningJournal next{arch, solver_id, key};
+    EXPECT_TRUE(next.IsEnabled());
+    EXPECT_EQ(next.Size(), 0);
+}
+
+TEST_F(TestTuningJournal, OtherProblem)
+{
+    {
+        miopen::solver::TuningJournal journal{arch, solver_id, key};
+        journal.Record("16,4,1", 1, 0.125f);
+    }
+    // As if the names of the journals collided.
+    {
+        std::ofstream file{miopen::solver::TuningJournal::GetPath(arch, solver_id, key)};
+        file << "another-problem\n1:16,4,1=0.5;\n";
+    }
+
+    miopen::solver::TuningJournal journal{arch, solver_id, key};
+    EXPECT_EQ(journal.Size(), 0);
+}
+
+TEST_F(TestTuningJournal, Remove)
+{
+    const auto path = miopen::solver::TuningJournal::GetPath(arch, solver_id, key);
+    miopen::solver::TuningJournal journal{arch, solver_id, key};
+    journal.Record("16,4,1", 1, 0.125f);
+    EXPECT_TRUE(miopen::fs::exists(path));
+
+    journal.Remove();
+    EXPECT_FALSE(journal.IsEnabled());
+    EXPECT_FALSE(miopen::fs::exists(path));
+    journal.Record("16,4,1", 4, 0.1f);
+    EXPECT_FALSE(miopen::fs::exists(path));
+}
+
+TEST_F(TestTuningJournal, Disabled)
+{
+    miopen::env::update(MIOPEN_DEBUG_TUNING_JOURNAL, false);
+    miopen::solver::TuningJournal journal{arch, solver_id, key};
+    miopen::env::clear(MIOPEN_DEBUG_TUNING_JOURNAL);
+
+    EXPECT_FALSE(journal.IsEnabled());
+    journal.Record("16,4,1", 1, 0.125f);
+    EXPECT_FALSE(miopen::fs::exists(miopen::solver::TuningJournal::GetPath(arch, solver_id, key)));
+}
@@ -0,0 +1,72 @@
+#include <miopen/kern_db.hpp>
+#include <miopen/filesystem.hpp>
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void Print(const std::string& title, const miopen::KernDbStats& stats, std::uintmax_t file_size)
+{
+    std::cout << title << ": " << stats.kernels << " kernels, " << stats.blobs << " blobs, "
+              << stats.stored_bytes << " blob bytes, " << file_size << " file bytes" << std::endl;
+}
+
+} // namespace
+
+int main(int argn, char** args)
+{
+    if(argn != 2)
+    {
+        std::cerr << "Usage:" << std::endl;
+        std::cerr << args[0] << " path" << std::endl;
+        std::cerr << "path - path to a user kernel cache (.ukdb). It is converted in place to "
+                     "store each distinct code object once."
+                  << std::endl;
+        return 1;
+    }
+
+    const miopen::fs::path path = args[1];
+    if(!miopen::fs::exists(path))
+    {
+        std::cerr << "Unable to open " << path << std::endl;
+        return 1;
+    }
+
+    // Opened as a system db, so that it is read as it is.
+    auto before = miopen::KernDbStats{};
+    {
+        auto db = miopen::KernDb{miopen::DbKinds::KernelDb, path, true};
+        if(db.dbInvalid)
+        {
+            std::cerr << path << " is not a kernel cache" << std::endl;
+            return 1;
+        }
+        before = db.GetStatsUnsafe();
+    }
+    Print("Before", before, miopen::fs::file_size(path));
+
+    auto after = miopen::KernDbStats{};
+    {
+        auto db = miopen::KernDb{miopen::DbKinds::KernelDb, path, false};
+        if(db.dbInvalid)
+        {
+            std::cerr << "Unable to convert " << path << std::endl;
+            return 1;
+        }
+        after = db.GetStatsUnsafe();
+        // Give the space of the duplicates back to the file system.
+        db.sql.Exec("VACUUM;");
+    }
+    Print("After", after, miopen::fs::file_size(path));
+
+    if(after.stored_bytes != 0)
+    {
+        std::cout << "Dedupe ratio: " << std::fixed << std::setprecision(2)
+                  << static_cast<double>(after.undeduplicated_bytes) / after.stored_bytes
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <miopen/kern_db.hpp>
+#include <miopen/filesystem.hpp>
+
+#include <cstddef>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+std::string Age(int64_t last_access)
+{
+    if(last_access == 0)
+        return "never";
+    const auto seconds = std::time(nullptr) - last_access;
+    if(seconds < 60 * 60)
+        return "<1h";
+    if(seconds < 24 * 60 * 60)
+        return std::to_string(seconds / (60 * 60)) + "h";
+    return std::to_string(seconds / (24 * 60 * 60)) + "d";
+}
+
+void Print(const miopen::KernDbStats& stats, std::uintmax_t file_size)
+{
+    std::cout << stats.kernels << " kernels, " << stats.blobs << " blobs, " << stats.stored_bytes
+              << " blob bytes, " << file_size << " file bytes" << std::endl;
+}
+
+} // namespace
+
+int main(int argn, char** args)
+{
+    if(argn < 2 || argn > 4)
+    {
+        std::cerr << "Usage:" << std::endl;
+        std::cerr << args[0] << " path [top] [limit_mb]" << std::endl;
+        std::cerr << "path - path to a user kernel cache (.ukdb)" << std::endl;
+        std::cerr << "top - number of the largest kernels to list, 10 by default" << std::endl;
+        std::cerr << "limit_mb - evict the least recently used kernels down to this size"
+                  << std::endl;
+        return 1;
+    }
+
+    const miopen::fs::path path = args[1];
+    if(!miopen::fs::exists(path))
+    {
+        std::cerr << "Unable to open " << path << std::endl;
+        return 1;
+    }
+    const auto top = argn > 2 ? std::stoul(args[2]) : 10;
+
+    auto db = miopen::KernDb{miopen::DbKinds::KernelDb, path, false};
+    if(db.dbInvalid)
+    {
+        std::cerr << path << " is not a kernel cache" << std::endl;
+        return 1;
+    }
+    Print(db.GetStatsUnsafe(), miopen::fs::file_size(path));
+
+    std::cout << std::left << std::setw(48) << "kernel" << std::right << std::setw(10)
+              << "entries" << std::setw(14) << "bytes" << std::setw(12) << "last used"
+              << std::endl;
+    for(const auto& consumer : db.GetTopConsumersUnsafe(top))
+    {
+        std::cout << std::left << std::setw(48) << consumer.kernel_name << std::right
+                  << std::setw(10) << consumer.kernels << std::setw(14) << consumer.bytes
+                  << std::setw(12) << Age(consumer.last_access) << std::endl;
+    }
+
+    if(argn > 3)
+    {
+        const auto limit = static_cast<std::size_t>(std::stoull(args[3])) * 1024 * 1024;
+        std::cout << "Evicted " << db.EvictUnsafe(limit) << " kernels" << std::endl;
+        Print(db.GetStatsUnsafe(), miopen::fs::file_size(path));
+    }
+    return 0;
+}
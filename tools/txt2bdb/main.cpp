@@ -0,0 +1,87 @@
+#include <miopen/binary_db_format.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+int main(int argn, char** args)
+{
+    if(argn < 2 || argn > 3)
+    {
+        std::cerr << "Usage:" << std::endl;
+        std::cerr << args[0] << " input_path [output_path]" << std::endl;
+        std::cerr << "input_path - path to the input file, expected to be a text find-db or perf-db."
+                  << std::endl;
+        std::cerr << "output_path - optional path to the output file. Existing file would be "
+                     "replaced. Defaults to the input_path with .bin appended to the end"
+                  << std::endl;
+        return 1;
+    }
+
+    const std::string in_filename  = args[1];
+    const std::string out_filename = argn > 2 ? args[2] : (in_filename + ".bin");
+
+    auto in = std::ifstream{in_filename, std::ios::binary};
+    if(!in)
+    {
+        std::cerr << "Unable to open " << in_filename << std::endl;
+        return 1;
+    }
+
+    auto records = std::vector<miopen::binary_db::Record>{};
+    auto keys    = std::unordered_set<std::string>{};
+    auto line    = std::string{};
+    auto n_line  = 0;
+
+    while(std::getline(in, line))
+    {
+        ++n_line;
+
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if(line.empty())
+            continue;
+
+        auto record    = miopen::binary_db::Record{};
+        auto malformed = std::vector<std::string_view>{};
+        if(!miopen::binary_db::ParseLine(line, record, &malformed))
+        {
+            std::cerr << "Ill-formed record: key not found: " << in_filename << "#" << n_line
+                      << std::endl;
+            continue;
+        }
+
+        for(const auto& item : malformed)
+            std::cerr << "Ill-formed item: ID not found; skipped: " << in_filename << "#"
+                      << n_line << ": " << item << std::endl;
+
+        if(record.second.empty())
+        {
+            std::cerr << "Ill-formed record: no items: " << in_filename << "#" << n_line
+                      << std::endl;
+            continue;
+        }
+
+        // Same as ReadonlyRamDb, the first record wins.
+        if(!keys.insert(record.first).second)
+            continue;
+
+        records.push_back(std::move(record));
+    }
+
+    const auto image = miopen::binary_db::Build(records);
+
+    auto out = std::ofstream{out_filename, std::ios::binary | std::ios::trunc};
+    out.write(image.data(), image.size());
+    if(!out)
+    {
+        std::cerr << "Unable to write " << out_filename << std::endl;
+        return 1;
+    }
+
+    std::cout << records.size() << " records, " << image.size() << " bytes" << std::endl;
+    return 0;
+}